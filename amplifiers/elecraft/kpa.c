@@ -19,8 +19,14 @@
  *
  */
 
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include "misc.h"
 #include "kpa.h"
 
 struct fault_list
@@ -69,7 +75,7 @@ int kpa_init(AMP *amp)
     }
 
     priv = (struct kpa_priv_data *)
-           malloc(sizeof(struct kpa_priv_data));
+           calloc(1, sizeof(struct kpa_priv_data));
 
     if (!priv)
     {
@@ -94,24 +100,16 @@ int kpa_flushbuffer(AMP *amp)
     return serial_flush(&rs->ampport);
 }
 
-int kpa_transaction(AMP *amp, const char *cmd, char *response, int response_len)
+// wake up the amp by sending ; until we receive ;
+static int kpa_wakeup(AMP *amp)
 {
-    struct amp_state *rs;
+    struct amp_state *rs = &amp->state;
+    char responsebuf[KPABUFSZ];
     int err;
     int len = 0;
-    char responsebuf[KPABUFSZ];
-
-    rig_debug(RIG_DEBUG_VERBOSE, "%s called, cmd=%s\n", __func__, cmd);
-
-    if (!amp) { return -RIG_EINVAL; }
-
-    kpa_flushbuffer(amp);
-
-    rs = &amp->state;
-
     int loop = 3;
 
-    do   // wake up the amp by sending ; until we receive ;
+    do
     {
         rig_debug(RIG_DEBUG_VERBOSE, "%s waiting for ;\n", __func__);
         char c = ';';
@@ -125,6 +123,26 @@ int kpa_transaction(AMP *amp, const char *cmd, char *response, int response_len)
     }
     while (--loop > 0 && (len != 1 || responsebuf[0] != ';'));
 
+    return RIG_OK;
+}
+
+int kpa_transaction(AMP *amp, const char *cmd, char *response, int response_len)
+{
+    struct amp_state *rs;
+    int err;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called, cmd=%s\n", __func__, cmd);
+
+    if (!amp) { return -RIG_EINVAL; }
+
+    kpa_flushbuffer(amp);
+
+    rs = &amp->state;
+
+    err = kpa_wakeup(amp);
+
+    if (err != RIG_OK) { return err; }
+
     // Now send our command
     err = write_block(&rs->ampport, cmd, strlen(cmd));
 
@@ -132,8 +150,8 @@ int kpa_transaction(AMP *amp, const char *cmd, char *response, int response_len)
 
     if (response) // if response expected get it
     {
-        responsebuf[0] = 0;
-        int len = read_string(&rs->ampport, responsebuf, KPABUFSZ, ";", 1);
+        response[0] = 0;
+        int len = read_string(&rs->ampport, response, response_len, ";", 1);
 
         if (len < 0)
         {
@@ -143,25 +161,13 @@ int kpa_transaction(AMP *amp, const char *cmd, char *response, int response_len)
         }
 
         rig_debug(RIG_DEBUG_VERBOSE, "%s called, response='%s'\n", __func__,
-                  responsebuf);
+                  response);
     }
     else   // if no response expected try to get one
     {
-        loop = 3;
-
-        do
-        {
-            rig_debug(RIG_DEBUG_VERBOSE, "%s waiting for ;\n", __func__);
-            char c = ';';
-            err = write_block(&rs->ampport, &c, 1);
-
-            if (err != RIG_OK) { return err; }
-
-            int len = read_string(&rs->ampport, responsebuf, KPABUFSZ, ";", 1);
+        err = kpa_wakeup(amp);
 
-            if (len < 0) { return len; }
-        }
-        while (--loop > 0 && (len != 1 || responsebuf[0] != ';'));
+        if (err != RIG_OK) { return err; }
     }
 
     return RIG_OK;
@@ -245,94 +251,284 @@ int kpa_set_freq(AMP *amp, freq_t freq)
     return RIG_OK;
 }
 
-int kpa_get_level(AMP *amp, setting_t level, value_t *val)
+/*
+ * Telemetry commands sent in one burst, and how their answers look.
+ * The answers are told apart by their prefix, which is the command.
+ */
+static const struct
+{
+    setting_t level;
+    const char *cmd;
+} kpa_telemetry_cmds[] =
+{
+    { AMP_LEVEL_SWR, "^SW" },
+    { AMP_LEVEL_PWR_INPUT, "^PWI" },
+    { AMP_LEVEL_PWR_FWD, "^PWF" },
+    { AMP_LEVEL_PWR_REFLECTED, "^PWR" },
+    { AMP_LEVEL_PWR_PEAK, "^PWK" },
+    { AMP_LEVEL_FAULT, "^SF" },
+    { AMP_LEVEL_NONE, NULL }
+};
+
+static int kpa_telemetry_parse(struct kpa_priv_data *priv,
+                               const char *responsebuf)
+{
+    int i;
+
+    for (i = 0; kpa_telemetry_cmds[i].cmd; i++)
+    {
+        const char *cmd = kpa_telemetry_cmds[i].cmd;
+        size_t len = strlen(cmd);
+        setting_t level = kpa_telemetry_cmds[i].level;
+        int nargs = 0;
+
+        if (strncmp(responsebuf, cmd, len) != 0
+                || isalpha((int)responsebuf[len]))
+        {
+            continue;
+        }
+
+        switch (level)
+        {
+        case AMP_LEVEL_SWR:
+            nargs = sscanf(responsebuf + len, "%f", &priv->swr);
+            priv->swr /= 10.0f;
+            break;
+
+        case AMP_LEVEL_PWR_INPUT:
+            nargs = sscanf(responsebuf + len, "%d", &priv->pwr_input);
+            break;
+
+        case AMP_LEVEL_PWR_FWD:
+            nargs = sscanf(responsebuf + len, "%d", &priv->pwr_fwd);
+            break;
+
+        case AMP_LEVEL_PWR_REFLECTED:
+            nargs = sscanf(responsebuf + len, "%d", &priv->pwr_reflected);
+            break;
+
+        case AMP_LEVEL_PWR_PEAK:
+            nargs = sscanf(responsebuf + len, "%d", &priv->pwr_peak);
+            break;
+
+        case AMP_LEVEL_FAULT:
+            nargs = sscanf(responsebuf + len, "%d", &priv->fault);
+            break;
+        }
+
+        if (nargs != 1)
+        {
+            rig_debug(RIG_DEBUG_ERR, "%s invalid value %s;='%s'\n", __func__, cmd,
+                      responsebuf);
+            return -RIG_EPROTO;
+        }
+
+        priv->telemetry_valid |= level;
+        return RIG_OK;
+    }
+
+    rig_debug(RIG_DEBUG_ERR, "%s unexpected response='%s'\n", __func__,
+              responsebuf);
+    return -RIG_EPROTO;
+}
+
+/*
+ * Read all the telemetry with one write of all the commands, instead of
+ * one transaction, each with its wake up, per level.
+ */
+static int kpa_telemetry_read(AMP *amp)
 {
+    struct amp_state *rs = &amp->state;
+    struct kpa_priv_data *priv = rs->priv;
+    char cmd[KPABUFSZ];
     char responsebuf[KPABUFSZ];
-    char *cmd;
+    int i, n, err, len = 0;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
-    if (!amp) { return -RIG_EINVAL; }
-
-    // get the current antenna selected
-    cmd = "^AE;";
-    int retval = kpa_transaction(amp, cmd, responsebuf, sizeof(responsebuf));
+    kpa_flushbuffer(amp);
 
-    if (retval != RIG_OK) { return retval; }
+    err = kpa_wakeup(amp);
 
-    int antenna = 0;
-    int nargs = sscanf(responsebuf, "^AE%d", &antenna);
+    if (err != RIG_OK) { return err; }
 
-    if (nargs != 1)
+    for (n = 0; kpa_telemetry_cmds[n].cmd; n++)
     {
-        rig_debug(RIG_DEBUG_ERR, "%s: invalid value %s='%s'\n", __func__, cmd,
-                  responsebuf);
-        return -RIG_EPROTO;
+        len += sprintf(cmd + len, "%s;", kpa_telemetry_cmds[n].cmd);
     }
 
-    rig_debug(RIG_DEBUG_VERBOSE, "%s: cmd=%s, antenna=%d\n", __func__, cmd,
-              antenna);
+    err = write_block(&rs->ampport, cmd, len);
 
-    switch (level)
+    if (err != RIG_OK) { return err; }
+
+    priv->telemetry_valid = 0;
+
+    for (i = 0; i < n; i++)
     {
-    case AMP_LEVEL_SWR:
-        cmd = "^SW;";
-        break;
+        len = read_string(&rs->ampport, responsebuf, KPABUFSZ, ";", 1);
 
-    case AMP_LEVEL_NH:
-        cmd = "^DF;";
-        break;
+        if (len < 0)
+        {
+            rig_debug(RIG_DEBUG_VERBOSE, "%s called, error=%s\n", __func__,
+                      rigerror(len));
+            break;
+        }
 
-    case AMP_LEVEL_PF:
-        cmd = "^DF;";
-        break;
+        rig_debug(RIG_DEBUG_VERBOSE, "%s called, response='%s'\n", __func__,
+                  responsebuf);
 
-    case AMP_LEVEL_PWR_INPUT:
-        cmd = "^PWI;";
-        break;
+        // an answer which cannot be parsed only loses its own level
+        kpa_telemetry_parse(priv, responsebuf);
+    }
 
-    case AMP_LEVEL_PWR_FWD:
-        cmd = "^PWF;";
-        break;
+    if (i == 0)
+    {
+        return len;
+    }
 
-    case AMP_LEVEL_PWR_REFLECTED:
-        cmd = "^PWR;";
-        break;
+    gettimeofday(&priv->telemetry_tv, NULL);
 
-    case AMP_LEVEL_PWR_PEAK:
-        cmd = "^PWK;";
-        break;
+    return RIG_OK;
+}
 
-    case AMP_LEVEL_FAULT:
-        cmd = "^SF;";
-        break;
+static char *kpa_fault_str(struct kpa_priv_data *priv, int fault)
+{
+    int i;
+
+    for (i = 0; kpa_fault_list[i].errmsg != NULL; ++i)
+    {
+        if (kpa_fault_list[i].code == fault)
+        {
+            return kpa_fault_list[i].errmsg;
+        }
     }
 
-    retval = kpa_transaction(amp, cmd, responsebuf, sizeof(responsebuf));
+    rig_debug(RIG_DEBUG_ERR, "%s unknown fault=%d\n", __func__, fault);
+    sprintf(priv->tmpbuf, "Unknown fault code=0x%02x", fault);
+    return priv->tmpbuf;
+}
 
-    if (retval != RIG_OK) { return retval; }
+/*
+ * Telemetry levels are answered from the last burst while it is less
+ * than KPA_TELEMETRY_MS old, so reading them one by one costs one burst.
+ */
+int kpa_get_levels(AMP *amp, struct amp_level_value *req, int count)
+{
+    struct kpa_priv_data *priv;
+    int retval = RIG_OK;
+    int i;
 
-    float float_value = 0;
-    int int_value = 0, int_value2 = 0;
-    struct amp_state *rs = &amp->state;
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
-    switch (level)
+    if (!amp) { return -RIG_EINVAL; }
+
+    priv = amp->state.priv;
+
+    for (i = 0; i < count; i++)
     {
-    case AMP_LEVEL_SWR:
-        nargs = sscanf(responsebuf, "^SW%f", &float_value);
+        if ((req[i].level & KPA_TELEMETRY_LEVELS)
+                && rig_check_cache_timeout(&priv->telemetry_tv,
+                                           KPA_TELEMETRY_MS))
+        {
+            retval = kpa_telemetry_read(amp);
+            break;
+        }
+    }
 
-        if (nargs != 1)
+    for (i = 0; i < count; i++)
+    {
+        struct amp_level_value *r = &req[i];
+
+        if (!(r->level & KPA_TELEMETRY_LEVELS))
         {
-            rig_debug(RIG_DEBUG_ERR, "%s invalid value %s='%s'\n", __func__, cmd,
-                      responsebuf);
-            return -RIG_EPROTO;
+            r->status = kpa_get_level(amp, r->level, &r->val);
+            continue;
         }
 
-        val->f = float_value / 10.0f;
-        return RIG_OK;
+        if (retval != RIG_OK)
+        {
+            r->status = retval;
+            continue;
+        }
 
+        if (!(priv->telemetry_valid & r->level))
+        {
+            r->status = -RIG_EPROTO;
+            continue;
+        }
+
+        r->status = RIG_OK;
+
+        switch (r->level)
+        {
+        case AMP_LEVEL_SWR:
+            r->val.f = priv->swr;
+            break;
+
+        case AMP_LEVEL_PWR_INPUT:
+            r->val.i = priv->pwr_input;
+            break;
+
+        case AMP_LEVEL_PWR_FWD:
+            r->val.i = priv->pwr_fwd;
+            break;
+
+        case AMP_LEVEL_PWR_REFLECTED:
+            r->val.i = priv->pwr_reflected;
+            break;
+
+        case AMP_LEVEL_PWR_PEAK:
+            r->val.i = priv->pwr_peak;
+            break;
+
+        case AMP_LEVEL_FAULT:
+            r->val.s = kpa_fault_str(priv, priv->fault);
+            break;
+
+        default:
+            r->status = -RIG_EINVAL;
+        }
+    }
+
+    return RIG_OK;
+}
+
+int kpa_get_level(AMP *amp, setting_t level, value_t *val)
+{
+    char responsebuf[KPABUFSZ];
+    char *cmd;
+    int retval;
+    int nargs;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (!amp) { return -RIG_EINVAL; }
+
+    if (level & KPA_TELEMETRY_LEVELS)
+    {
+        struct amp_level_value req;
+
+        req.level = level;
+        retval = kpa_get_levels(amp, &req, 1);
+
+        if (retval != RIG_OK) { return retval; }
+
+        *val = req.val;
+        return req.status;
+    }
+
+    int int_value = 0, int_value2 = 0;
+    struct amp_state *rs = &amp->state;
+
+    switch (level)
+    {
     case AMP_LEVEL_NH:
     case AMP_LEVEL_PF:
+        cmd = "^DF;";
+        retval = kpa_transaction(amp, cmd, responsebuf, sizeof(responsebuf));
+
+        if (retval != RIG_OK) { return retval; }
+
         nargs = sscanf(responsebuf, "^DF%d,%d", &int_value, &int_value2);
 
         if (nargs != 2)
@@ -378,106 +574,6 @@ int kpa_get_level(AMP *amp, setting_t level, value_t *val)
 
         break;
 
-
-    case AMP_LEVEL_PWR_INPUT:
-        cmd = "^PWI;";
-        int pwrinput;
-        nargs = sscanf(responsebuf, "^SW%d", &pwrinput);
-
-        if (nargs != 1)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s invalid value %s='%s'\n", __func__, cmd,
-                      responsebuf);
-            return -RIG_EPROTO;
-        }
-
-        val->i = pwrinput;
-        return RIG_OK;
-
-        break;
-
-    case AMP_LEVEL_PWR_FWD:
-        cmd = "^PWF;";
-        int pwrfwd;
-        nargs = sscanf(responsebuf, "^SW%d", &pwrfwd);
-
-        if (nargs != 1)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s invalid value %s='%s'\n", __func__, cmd,
-                      responsebuf);
-            return -RIG_EPROTO;
-        }
-
-        val->i = pwrfwd;
-        return RIG_OK;
-
-        break;
-
-    case AMP_LEVEL_PWR_REFLECTED:
-        cmd = "^PWR;";
-        int pwrref;
-        nargs = sscanf(responsebuf, "^SW%d", &pwrref);
-
-        if (nargs != 1)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s invalid value %s='%s'\n", __func__, cmd,
-                      responsebuf);
-            return -RIG_EPROTO;
-        }
-
-        val->i = pwrref;
-        return RIG_OK;
-
-        break;
-
-    case AMP_LEVEL_PWR_PEAK:
-        cmd = "^PWK;";
-        int pwrpeak;
-        nargs = sscanf(responsebuf, "^SW%d", &pwrpeak);
-
-        if (nargs != 1)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s invalid value %s='%s'\n", __func__, cmd,
-                      responsebuf);
-            return -RIG_EPROTO;
-        }
-
-        val->i = pwrpeak;
-        return RIG_OK;
-
-        break;
-
-    case AMP_LEVEL_FAULT:
-        cmd = "^SF;";
-        int fault;
-        nargs = sscanf(responsebuf, "^SW%d", &fault);
-
-        if (nargs != 1)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s invalid value %s='%s'\n", __func__, cmd,
-                      responsebuf);
-            return -RIG_EPROTO;
-        }
-
-        int i;
-
-        for (i = 0; kpa_fault_list[i].errmsg != NULL; ++i)
-        {
-            if (kpa_fault_list[i].code == fault)
-            {
-                val->s =  kpa_fault_list[i].errmsg;
-                return RIG_OK;
-            }
-        }
-
-        rig_debug(RIG_DEBUG_ERR, "%s unknown fault from %s\n", __func__, responsebuf);
-        struct kpa_priv_data *priv = amp->state.priv;
-        sprintf(priv->tmpbuf, "Unknown fault code=0x%02x", fault);
-        val->s = priv->tmpbuf;
-        return RIG_OK;
-
-        break;
-
     default:
         rig_debug(RIG_DEBUG_ERR, "%s unknown level=%s\n", __func__,
                   rig_strlevel(level));
@@ -570,6 +666,10 @@ int kpa_set_powerstat(AMP *amp, powerstat_t status)
 
     int retval = kpa_transaction(amp, cmd, NULL, 0);
 
+    // the readings change with the state
+    rig_force_cache_timeout(&((struct kpa_priv_data *)
+                              amp->state.priv)->telemetry_tv);
+
     if (retval != RIG_OK) { return retval; }
 
     return RIG_OK;
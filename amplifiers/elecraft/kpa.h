@@ -26,6 +26,8 @@
 #ifndef _AMP_ELECRAFT_H
 #define _AMP_ELECRAFT_H 1
 
+#include <sys/time.h>
+
 #include <hamlib/amplifier.h>
 #include <iofunc.h>
 #include <serial.h>
@@ -33,6 +35,14 @@
 // Is this big enough?
 #define KPABUFSZ 100
 
+// the levels read together by one burst of commands
+#define KPA_TELEMETRY_LEVELS (AMP_LEVEL_SWR|AMP_LEVEL_PWR_INPUT\
+                              |AMP_LEVEL_PWR_FWD|AMP_LEVEL_PWR_REFLECTED\
+                              |AMP_LEVEL_PWR_PEAK|AMP_LEVEL_FAULT)
+
+// telemetry younger than this is reused, in ms
+#define KPA_TELEMETRY_MS 100
+
 extern const struct amp_caps kpa1500_rot_caps;
 
 /*
@@ -41,6 +51,15 @@ extern const struct amp_caps kpa1500_rot_caps;
 struct kpa_priv_data
 {
   char tmpbuf[256];  // for unknown error msg 
+
+  struct timeval telemetry_tv;  // when the telemetry was read, 0 if never
+  setting_t telemetry_valid;    // levels of the last burst which parsed
+  float swr;
+  int pwr_input;
+  int pwr_fwd;
+  int pwr_reflected;
+  int pwr_peak;
+  int fault;
 };
 
 
@@ -53,6 +72,7 @@ int kpa_get_freq (AMP *amp, freq_t *freq);
 int kpa_set_freq (AMP *amp, freq_t freq);
 
 int kpa_get_level (AMP *amp, setting_t level, value_t *val);
+int kpa_get_levels (AMP *amp, struct amp_level_value *req, int count);
 int kpa_get_powerstat (AMP *amp, powerstat_t *status);
 int kpa_set_powerstat (AMP *amp, powerstat_t status);
 
@@ -83,7 +83,6 @@ const struct amp_caps kpa1500_amp_caps =
     .timeout =      2000,
     .retry =      2,
 
-    .amp_open = amp_open,
     .amp_init = kpa_init,
     .amp_cleanup = kpa1500_cleanup,
     .reset = kpa_reset,
@@ -93,6 +92,8 @@ const struct amp_caps kpa1500_amp_caps =
     .set_freq = kpa_set_freq,
     .get_freq = kpa_get_freq,
     .get_level = kpa_get_level,
+    .get_levels = kpa_get_levels,
+    .has_get_level = KPA_TELEMETRY_LEVELS | AMP_LEVEL_NH | AMP_LEVEL_PF,
 };
 
 
@@ -42,6 +42,7 @@
 
 #define CMD_MAX 32
 #define BUF_MAX 96
+#define MULTI_MAX 16    /* commands pipelined in one write */
 
 #define CHKSCN1ARG(a) if ((a) != 1) return -RIG_EPROTO; else do {} while(0)
 
@@ -1918,6 +1919,217 @@ static int netrigctl_get_channel(RIG *rig, channel_t *chan)
 }
 
 
+/*
+ * Reads one answer line of a pipelined batch.
+ * Returns the line length, or the RPRT code when rigctld reported
+ * an error in place of the values.
+ */
+static int netrigctl_multi_line(RIG *rig, char *buf)
+{
+    int ret;
+
+    ret = read_string(&rig->state.rigport, buf, BUF_MAX, "\n", 1);
+
+    if (ret <= 0)
+    {
+        return (ret < 0) ? ret : -RIG_EPROTO;
+    }
+
+    if (strncmp(buf, NETRIGCTL_RET, strlen(NETRIGCTL_RET)) == 0)
+    {
+        ret = atoi(buf + strlen(NETRIGCTL_RET));
+        return (ret < 0) ? ret : -RIG_EPROTO;
+    }
+
+    if (buf[ret - 1] == '\n') { buf[ret - 1] = '\0'; } /* chomp */
+
+    return ret;
+}
+
+
+/*
+ * Sends up to MULTI_MAX get commands in a single write, then reads
+ * the answers back in the same order. rigctld answers each of them
+ * either with the values or with an RPRT line, so a failed read only
+ * affects its own item.
+ */
+static int netrigctl_get_multi_chunk(RIG *rig, struct rig_multi *req,
+                                     int count)
+{
+    struct netrigctl_priv_data *priv;
+    char cmd[MULTI_MAX * CMD_MAX];
+    char buf[BUF_MAX];
+    char vfostr[6];
+    int i, ret, len = 0;
+
+    priv = (struct netrigctl_priv_data *)rig->state.priv;
+
+    for (i = 0; i < count; i++)
+    {
+        struct rig_multi *r = &req[i];
+
+        /* rigctld would not know what to read */
+        if (r->what == RIG_MULTI_LEVEL && !*rig_strlevel(r->level))
+        {
+            r->status = -RIG_EINVAL;
+            continue;
+        }
+
+        ret = netrigctl_vfostr(rig, vfostr, sizeof(vfostr),
+                               r->what == RIG_MULTI_FREQ
+                               || r->what == RIG_MULTI_MODE
+                               || r->what == RIG_MULTI_LEVEL
+                               ? r->vfo : RIG_VFO_A);
+
+        if (ret != RIG_OK) { return ret; }
+
+        switch (r->what)
+        {
+        case RIG_MULTI_FREQ:
+            len += sprintf(cmd + len, "f%s\n", vfostr);
+            break;
+
+        case RIG_MULTI_MODE:
+            len += sprintf(cmd + len, "m%s\n", vfostr);
+            break;
+
+        case RIG_MULTI_VFO:
+            len += sprintf(cmd + len, "v%s\n", vfostr);
+            break;
+
+        case RIG_MULTI_PTT:
+            len += sprintf(cmd + len, "t%s\n", vfostr);
+            break;
+
+        case RIG_MULTI_LEVEL:
+            len += snprintf(cmd + len, CMD_MAX, "l%s %s\n", vfostr,
+                            rig_strlevel(r->level));
+            break;
+
+        default:
+            return -RIG_EINVAL;
+        }
+    }
+
+    if (rig->state.rigport.type.rig == RIG_PORT_NETWORK
+            || rig->state.rigport.type.rig == RIG_PORT_UDP_NETWORK)
+    {
+        network_flush(&rig->state.rigport);
+    }
+    else
+    {
+        serial_flush(&rig->state.rigport);
+    }
+
+    if (len == 0)
+    {
+        return RIG_OK;
+    }
+
+    ret = write_block(&rig->state.rigport, cmd, len);
+
+    if (ret != RIG_OK)
+    {
+        return ret;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        struct rig_multi *r = &req[i];
+
+        if (r->what == RIG_MULTI_LEVEL && !*rig_strlevel(r->level))
+        {
+            continue;
+        }
+
+        ret = netrigctl_multi_line(rig, buf);
+
+        /* a timeout or I/O error leaves the stream out of step */
+        if (ret == -RIG_ETIMEOUT || ret == -RIG_EIO)
+        {
+            return ret;
+        }
+
+        r->status = (ret < 0) ? ret : RIG_OK;
+
+        if (ret < 0)
+        {
+            continue;
+        }
+
+        switch (r->what)
+        {
+        case RIG_MULTI_FREQ:
+            if (num_sscanf(buf, "%"SCNfreq, &r->val.freq) != 1)
+            {
+                r->status = -RIG_EPROTO;
+            }
+
+            break;
+
+        case RIG_MULTI_MODE:
+            r->val.mode.mode = rig_parse_mode(buf);
+
+            ret = netrigctl_multi_line(rig, buf);
+
+            if (ret == -RIG_ETIMEOUT || ret == -RIG_EIO)
+            {
+                return ret;
+            }
+
+            r->status = (ret < 0) ? ret : RIG_OK;
+            r->val.mode.width = atoi(buf);
+            break;
+
+        case RIG_MULTI_VFO:
+            r->val.vfo = rig_parse_vfo(buf);
+            priv->vfo_curr = r->val.vfo;
+            break;
+
+        case RIG_MULTI_PTT:
+            r->val.ptt = atoi(buf);
+            break;
+
+        case RIG_MULTI_LEVEL:
+            if (RIG_LEVEL_IS_FLOAT(r->level))
+            {
+                r->val.level.f = atof(buf);
+            }
+            else
+            {
+                r->val.level.i = atoi(buf);
+            }
+
+            break;
+        }
+    }
+
+    return RIG_OK;
+}
+
+
+static int netrigctl_get_multi(RIG *rig, struct rig_multi *req, int count)
+{
+    int i, ret;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called count=%d\n", __func__, count);
+
+    for (i = 0; i < count; i += MULTI_MAX)
+    {
+        ret = netrigctl_get_multi_chunk(rig, req + i,
+                                        count - i > MULTI_MAX
+                                        ? MULTI_MAX : count - i);
+
+        if (ret != RIG_OK)
+        {
+            return ret;
+        }
+    }
+
+    return RIG_OK;
+}
+
+
 static const char *netrigctl_get_info(RIG *rig)
 {
     int ret, len;
@@ -2142,4 +2354,5 @@ const struct rig_caps netrigctl_caps =
     .send_morse =  netrigctl_send_morse,
     .set_channel =    netrigctl_set_channel,
     .get_channel =    netrigctl_get_channel,
+    .get_multi =      netrigctl_get_multi,
 };
@@ -0,0 +1,604 @@
+/*
+ *  Hamlib CI-V backend - shared bus support
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>  /* String function definitions */
+#include <unistd.h>  /* UNIX standard function definitions */
+
+#ifdef HAVE_SYS_SELECT_H
+#include <sys/select.h>
+#endif
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include "hamlib/rig.h"
+#include "serial.h"
+#include "misc.h"
+#include "icom.h"
+#include "icom_defs.h"
+#include "frame.h"
+#include "civbus.h"
+
+struct civ_frame
+{
+    int len;
+    unsigned char buf[MAXFRAMELEN];
+};
+
+struct civ_bus;
+
+struct civ_member
+{
+    RIG *rig;
+    struct civ_bus *bus;
+    struct civ_member *next;
+    int fd;                     /* rig port fd it joined with */
+    int head;                   /* oldest queued frame */
+    int count;                  /* number of queued frames */
+    struct civ_frame queue[CIV_BUS_QUEUE_LEN];
+};
+
+struct civ_bus
+{
+    struct civ_bus *next;
+    struct civ_member *members;
+    int refcount;
+    hamlib_port_t port;         /* own copy, on a dup()'ed fd */
+#ifdef HAVE_PTHREAD
+    pthread_mutex_t lock;       /* held for a whole transaction */
+#endif
+};
+
+static struct civ_bus *civ_buses;
+
+#ifdef HAVE_PTHREAD
+/* protects civ_buses, the member lists and their queues */
+static pthread_mutex_t civ_buses_lock = PTHREAD_MUTEX_INITIALIZER;
+#define civ_lock()      pthread_mutex_lock(&civ_buses_lock)
+#define civ_unlock()    pthread_mutex_unlock(&civ_buses_lock)
+#else
+#define civ_lock()
+#define civ_unlock()
+#endif
+
+
+/*
+ * The bus member of rig, or NULL when it has none or when a signal
+ * handler runs the backend: the bus locks are not to be taken there.
+ */
+static struct civ_member *civ_member_of(RIG *rig)
+{
+    struct icom_priv_data *priv = (struct icom_priv_data *)rig->state.priv;
+
+    if (rig_decode_in_signal(rig))
+    {
+        return NULL;
+    }
+
+    return priv->bus_member;
+}
+
+
+static struct civ_member *civ_bus_join(RIG *rig)
+{
+    struct icom_priv_data *priv = (struct icom_priv_data *)rig->state.priv;
+    hamlib_port_t *rp = &rig->state.rigport;
+    struct civ_member *m;
+    struct civ_bus *bus;
+
+#ifdef _WIN32
+    /* win32 serial ports are not plain fds, leave them alone */
+    return NULL;
+#endif
+
+    if (rp->fd < 0 || !rp->pathname[0])
+    {
+        return NULL;
+    }
+
+    m = (struct civ_member *)calloc(1, sizeof(struct civ_member));
+
+    if (!m)
+    {
+        return NULL;
+    }
+
+    m->rig = rig;
+    m->fd = rp->fd;
+
+    civ_lock();
+
+    for (bus = civ_buses; bus; bus = bus->next)
+    {
+        if (bus->port.type.rig == rp->type.rig
+                && !strcmp(bus->port.pathname, rp->pathname))
+        {
+            break;
+        }
+    }
+
+    if (!bus)
+    {
+        bus = (struct civ_bus *)calloc(1, sizeof(struct civ_bus));
+
+        if (bus)
+        {
+            bus->port = *rp;
+            bus->port.fd = dup(rp->fd);
+            bus->port.rx.count = 0;
+            memset(&bus->port.io_count, 0, sizeof(bus->port.io_count));
+        }
+
+        if (!bus || bus->port.fd < 0)
+        {
+            civ_unlock();
+            free(bus);
+            free(m);
+            return NULL;
+        }
+
+#ifdef HAVE_PTHREAD
+        pthread_mutex_init(&bus->lock, NULL);
+#endif
+        bus->next = civ_buses;
+        civ_buses = bus;
+
+        rig_debug(RIG_DEBUG_TRACE, "%s: new CI-V bus on %s\n", __func__,
+                  rp->pathname);
+    }
+
+    m->bus = bus;
+    m->next = bus->members;
+    bus->members = m;
+    bus->refcount++;
+    priv->bus_member = m;
+
+    civ_unlock();
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: rig %#x on %s, %d on the bus\n",
+              __func__, priv->re_civ_addr, rp->pathname, bus->refcount);
+
+    return m;
+}
+
+
+/*
+ * Leaves the bus joined by civ_bus_acquire(), closing it with its
+ * last member. Called from icom_rig_close() and icom_cleanup().
+ */
+void civ_bus_leave(RIG *rig)
+{
+    struct icom_priv_data *priv = (struct icom_priv_data *)rig->state.priv;
+    struct civ_member *m = priv->bus_member;
+    struct civ_member **pm;
+    struct civ_bus *bus, **pb;
+
+    if (!m)
+    {
+        return;
+    }
+
+    bus = m->bus;
+
+    /* not while the decoder of another rig dispatches our frames */
+    Hold_Decode(rig);
+    civ_lock();
+
+    for (pm = &bus->members; *pm; pm = &(*pm)->next)
+    {
+        if (*pm == m)
+        {
+            *pm = m->next;
+            break;
+        }
+    }
+
+    priv->bus_member = NULL;
+
+    if (--bus->refcount > 0)
+    {
+        civ_unlock();
+        Unhold_Decode(rig);
+        free(m);
+        return;
+    }
+
+    for (pb = &civ_buses; *pb; pb = &(*pb)->next)
+    {
+        if (*pb == bus)
+        {
+            *pb = bus->next;
+            break;
+        }
+    }
+
+    civ_unlock();
+    Unhold_Decode(rig);
+
+    close(bus->port.fd);
+#ifdef HAVE_PTHREAD
+    pthread_mutex_destroy(&bus->lock);
+#endif
+    free(bus);
+    free(m);
+}
+
+
+/*
+ * Takes the bus for a transaction, joining it on first use.
+ * Returns the port to talk through, which is the rig's own port when
+ * it could not join a bus, or NULL when a signal handler runs the
+ * backend of a rig on a bus: it may not wait for the bus, and must not
+ * read its frames behind its back.
+ * A rig whose transceive mode is driven by signals rather than the
+ * event loop stays off the bus, since its handlers cannot wait for it.
+ */
+hamlib_port_t *civ_bus_acquire(RIG *rig)
+{
+    struct icom_priv_data *priv = (struct icom_priv_data *)rig->state.priv;
+    hamlib_port_t *rp = &rig->state.rigport;
+    struct civ_member *m = priv->bus_member;
+    struct civ_bus *bus;
+
+    if (rig_decode_in_signal(rig))
+    {
+        return m ? NULL : rp;
+    }
+
+    if (m && (rig_trn_by_signal(rig) || m->fd != rp->fd
+              || strcmp(m->bus->port.pathname, rp->pathname)))
+    {
+        /* off the bus, or the rig was reopened since it joined */
+        civ_bus_leave(rig);
+        m = NULL;
+    }
+
+    if (!m)
+    {
+        if (rig_trn_by_signal(rig))
+        {
+            return rp;
+        }
+
+        m = civ_bus_join(rig);
+
+        if (!m)
+        {
+            return rp;
+        }
+    }
+
+    bus = m->bus;
+
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&bus->lock);
+#endif
+
+    /* honor the settings of the rig now talking */
+    bus->port.timeout = rp->timeout;
+    bus->port.write_delay = rp->write_delay;
+    bus->port.post_write_delay = rp->post_write_delay;
+
+    return &bus->port;
+}
+
+
+void civ_bus_release(RIG *rig)
+{
+    struct civ_member *m = civ_member_of(rig);
+    hamlib_port_t *rp = &rig->state.rigport;
+    hamlib_port_t *bp;
+
+    if (!m)
+    {
+        return;
+    }
+
+    /* account the transaction to the rig's own port */
+    bp = &m->bus->port;
+    rp->io_count.select_calls += bp->io_count.select_calls;
+    rp->io_count.read_calls += bp->io_count.read_calls;
+    rp->io_count.write_calls += bp->io_count.write_calls;
+    rp->io_count.flush_calls += bp->io_count.flush_calls;
+    rp->io_count.tx_bytes += bp->io_count.tx_bytes;
+    rp->io_count.rx_bytes += bp->io_count.rx_bytes;
+    rp->io_count.timeouts += bp->io_count.timeouts;
+    memset(&bp->io_count, 0, sizeof(bp->io_count));
+
+#ifdef HAVE_PTHREAD
+    pthread_mutex_unlock(&m->bus->lock);
+#endif
+}
+
+
+static int civ_readable(hamlib_port_t *p)
+{
+#if defined(HAVE_SELECT) && !defined(_WIN32)
+    fd_set rfds;
+    struct timeval tv;
+
+    if (p->rx.count > 0)
+    {
+        return 1;
+    }
+
+    FD_ZERO(&rfds);
+    FD_SET(p->fd, &rfds);
+    tv.tv_sec = 0;
+    tv.tv_usec = 0;
+
+    return select(p->fd + 1, &rfds, NULL, NULL, &tv) > 0;
+#else
+    return 0;
+#endif
+}
+
+
+/*
+ * Replaces the serial_flush() before a command: frames already waiting
+ * may be broadcasts for one of the rigs on the bus, so they are routed
+ * rather than thrown away. Whatever is left after that is flushed.
+ */
+void civ_bus_drain(RIG *rig, hamlib_port_t *p)
+{
+    unsigned char buf[MAXFRAMELEN];
+    int i;
+
+    for (i = 0; i < CIV_BUS_MAX_SKIP && civ_readable(p); i++)
+    {
+        int frm_len = read_icom_frame(p, buf, sizeof(buf));
+
+        if (frm_len <= 0)
+        {
+            break;
+        }
+
+        if (buf[frm_len - 1] == FI)
+        {
+            civ_bus_route(rig, buf, frm_len);
+        }
+    }
+
+    serial_flush(p);
+}
+
+
+/* civ_lock held */
+static void civ_queue(struct civ_member *m, const unsigned char *frame,
+                      int frame_len)
+{
+    struct civ_frame *f;
+
+    if (m->count == CIV_BUS_QUEUE_LEN)
+    {
+        /* nobody is reading, drop the oldest */
+        m->head = (m->head + 1) % CIV_BUS_QUEUE_LEN;
+        m->count--;
+    }
+
+    f = &m->queue[(m->head + m->count) % CIV_BUS_QUEUE_LEN];
+    f->len = frame_len;
+    memcpy(f->buf, frame, frame_len);
+    m->count++;
+}
+
+
+/*
+ * Queues a frame nobody is waiting for to the rig on the bus that sent
+ * it, when it is a transceive broadcast. Frames between other stations
+ * are dropped.
+ *
+ * Returns 1 if the frame was queued, 0 otherwise.
+ */
+int civ_bus_route(RIG *rig, const unsigned char *frame, int frame_len)
+{
+    struct civ_member *self = civ_member_of(rig);
+    struct civ_member *m;
+
+    if (frame_len < 6 || frame_len > MAXFRAMELEN || frame[0] != PR
+            || frame[2] != BCASTID)
+    {
+        rig_debug(RIG_DEBUG_TRACE, "%s: skipping frame %#x->%#x, cmd %#x\n",
+                  __func__, frame[3], frame[2], frame[4]);
+        return 0;
+    }
+
+    if (!self)
+    {
+        return 0;
+    }
+
+    civ_lock();
+
+    for (m = self->bus->members; m; m = m->next)
+    {
+        const struct icom_priv_data *p =
+            (const struct icom_priv_data *)m->rig->state.priv;
+
+        if (p->re_civ_addr == frame[3])
+        {
+            break;
+        }
+    }
+
+    if (!m)
+    {
+        civ_unlock();
+        rig_debug(RIG_DEBUG_TRACE, "%s: no rig %#x on the bus\n", __func__,
+                  frame[3]);
+        return 0;
+    }
+
+    civ_queue(m, frame, frame_len);
+
+    civ_unlock();
+
+    return 1;
+}
+
+
+/*
+ * Takes the oldest frame queued to rig.
+ * Returns its length, or 0 when there is none.
+ */
+int civ_bus_pop(RIG *rig, unsigned char *frame, int frame_len)
+{
+    struct civ_member *m = civ_member_of(rig);
+    int len = 0;
+
+    if (!m)
+    {
+        return 0;
+    }
+
+    civ_lock();
+
+    if (m->count)
+    {
+        struct civ_frame *f = &m->queue[m->head];
+
+        len = f->len < frame_len ? f->len : frame_len;
+        memcpy(frame, f->buf, len);
+        m->head = (m->head + 1) % CIV_BUS_QUEUE_LEN;
+        m->count--;
+    }
+
+    civ_unlock();
+
+    return len;
+}
+
+
+/*
+ * Decodes the frames queued to rig while the bus was busy.
+ * Must be called with the bus released, as callbacks may talk to the rig.
+ */
+void civ_bus_dispatch(RIG *rig)
+{
+    unsigned char buf[MAXFRAMELEN];
+    int frm_len;
+
+    while ((frm_len = civ_bus_pop(rig, buf, sizeof(buf))) > 0)
+    {
+        if (rig->state.transceive != RIG_TRN_OFF)
+        {
+            icom_decode_frame(rig, buf);
+        }
+    }
+}
+
+
+/*
+ * Reads all the frames waiting on the bus port p, which rig holds.
+ * Its own frames are queued to rig, the broadcasts of the other rigs
+ * to them. The decoder reads this way rather than from the rig's own
+ * port, since the bus does not read through the latter.
+ */
+void civ_bus_collect(RIG *rig, hamlib_port_t *p)
+{
+    struct icom_priv_data *priv = (struct icom_priv_data *)rig->state.priv;
+    struct civ_member *m = civ_member_of(rig);
+    unsigned char buf[MAXFRAMELEN];
+    int i;
+
+    if (!m)
+    {
+        return;
+    }
+
+    for (i = 0; i < CIV_BUS_MAX_SKIP && civ_readable(p); i++)
+    {
+        int frm_len = read_icom_frame(p, buf, sizeof(buf));
+
+        if (frm_len <= 0)
+        {
+            break;
+        }
+
+        if (frm_len < ACKFRMLEN || buf[frm_len - 1] != FI)
+        {
+            continue;
+        }
+
+        if (buf[3] == priv->re_civ_addr)
+        {
+            civ_lock();
+            civ_queue(m, buf, frm_len);
+            civ_unlock();
+        }
+        else
+        {
+            civ_bus_route(rig, buf, frm_len);
+        }
+    }
+}
+
+
+/*
+ * Decodes the frames queued to every rig on the bus of rig, whose
+ * decoder is held by the caller. A rig busy with a transaction is
+ * skipped, it dispatches its frames itself once done.
+ */
+void civ_bus_dispatch_all(RIG *rig)
+{
+    struct civ_member *self;
+    RIG *held[CIV_BUS_MAX_DISPATCH];
+    struct civ_member *m;
+    int i, n = 0;
+
+    civ_bus_dispatch(rig);
+
+    self = civ_member_of(rig);
+
+    if (!self)
+    {
+        return;
+    }
+
+    civ_lock();
+
+    for (m = self->bus->members;
+            m && n < CIV_BUS_MAX_DISPATCH; m = m->next)
+    {
+        /* held, it cannot leave the bus until we are done */
+        if (m->rig != rig && m->count && rig_try_hold_decode(m->rig))
+        {
+            held[n++] = m->rig;
+        }
+    }
+
+    civ_unlock();
+
+    for (i = 0; i < n; i++)
+    {
+        civ_bus_dispatch(held[i]);
+        Unhold_Decode(held[i]);
+    }
+}
@@ -0,0 +1,52 @@
+/*
+ *  Hamlib CI-V backend - shared bus support
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef _CIVBUS_H
+#define _CIVBUS_H 1
+
+#include <hamlib/rig.h>
+
+/*
+ * RIG handles opened on the same port pathname join one CI-V bus. The
+ * bus owns a single port, so there is one reader per physical port, and
+ * a lock held for the length of a transaction. Frames read while waiting
+ * for a reply which belong to another rig on the bus are queued to that
+ * rig, and handed to icom_decode_event() once the bus is released.
+ */
+
+#define CIV_BUS_QUEUE_LEN   16  /* unsolicited frames kept per rig */
+#define CIV_BUS_MAX_SKIP    32  /* foreign frames skipped per reply */
+#define CIV_BUS_MAX_DISPATCH 16 /* other rigs dispatched per decode */
+
+struct civ_member;
+
+extern hamlib_port_t *civ_bus_acquire(RIG *rig);
+extern void civ_bus_release(RIG *rig);
+extern void civ_bus_leave(RIG *rig);
+
+extern void civ_bus_drain(RIG *rig, hamlib_port_t *p);
+extern int civ_bus_route(RIG *rig, const unsigned char *frame, int frame_len);
+extern int civ_bus_pop(RIG *rig, unsigned char *frame, int frame_len);
+extern void civ_bus_dispatch(RIG *rig);
+extern void civ_bus_collect(RIG *rig, hamlib_port_t *p);
+extern void civ_bus_dispatch_all(RIG *rig);
+
+#endif /* _CIVBUS_H */
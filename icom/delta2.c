@@ -153,6 +153,7 @@ const struct rig_caps delta2_caps =
     .priv = (void *)& delta2_priv_caps,
     .rig_init =   icom_init,
     .rig_cleanup =   icom_cleanup,
+    .rig_close =  icom_rig_close,
 
     .set_freq =  icom_set_freq,
     .get_freq =  icom_get_freq,
@@ -33,6 +33,7 @@
 #include "icom.h"
 #include "icom_defs.h"
 #include "frame.h"
+#include "civbus.h"
 
 /*
  * Build a CI-V frame.
@@ -90,52 +91,83 @@ int make_cmd_frame(char frame[], char re_id, char ctrl_id, char cmd, int subcmd,
 }
 
 /*
- * icom_one_transaction
- *
- * We assume that rig!=NULL, rig->state!= NULL, payload!=NULL, data!=NULL, data_len!=NULL
- * Otherwise, you'll get a nice seg fault. You've been warned!
- * payload can be NULL if payload_len == 0
- * subcmd can be equal to -1 (no subcmd wanted)
- * if no answer is to be expected, data_len must be set to NULL to tell so
+ * Reads frames until the one we wait for shows up: the reply of the rig
+ * to this controller, or when echo is not NULL, our own echo. Other
+ * stations' frames and transceive broadcasts are handed to
+ * civ_bus_route() instead of failing the transaction.
  *
- * return RIG_OK if transaction completed,
- * or a negative value otherwise indicating the error.
+ * Returns the frame length, or whatever read_icom_frame() returned when
+ * it did not read a whole frame.
  */
-int icom_one_transaction(RIG *rig, int cmd, int subcmd,
-                         const unsigned char *payload, int payload_len, unsigned char *data,
-                         int *data_len)
+static int read_civ_reply(RIG *rig, hamlib_port_t *p, int ctrl_id,
+                          const unsigned char *echo, int echo_len,
+                          unsigned char *buf, int buf_len)
+{
+    const struct icom_priv_data *priv =
+        (const struct icom_priv_data *)rig->state.priv;
+    const struct icom_priv_caps *priv_caps =
+        (const struct icom_priv_caps *)rig->caps->priv;
+    int i;
+
+    for (i = 0; i < CIV_BUS_MAX_SKIP; i++)
+    {
+        int frm_len = read_icom_frame(p, buf, buf_len);
+
+        if (frm_len < ACKFRMLEN || buf[frm_len - 1] != FI)
+        {
+            return frm_len;
+        }
+
+        if (echo && frm_len == echo_len && !memcmp(buf, echo, echo_len))
+        {
+            return frm_len;
+        }
+
+        /*
+         * Nobody else is on a full duplex line, but the rig may answer
+         * the default controller address. Its broadcasts are no reply.
+         */
+        if (buf[3] == priv->re_civ_addr
+                && (buf[2] == ctrl_id
+                    || (priv_caps->serial_full_duplex && buf[2] == CTRLID)))
+        {
+            return frm_len;
+        }
+
+        civ_bus_route(rig, buf, frm_len);
+    }
+
+    rig_debug(RIG_DEBUG_WARN, "%s: no reply among %d frames\n", __func__, i);
+
+    return -RIG_EPROTO;
+}
+
+/*
+ * The transaction proper, with the bus held. See icom_one_transaction.
+ */
+static int civ_transaction(RIG *rig, hamlib_port_t *p, int ctrl_id,
+                           const unsigned char *sendbuf, int frm_len,
+                           unsigned char *data, int *data_len)
 {
     struct icom_priv_data *priv;
     const struct icom_priv_caps *priv_caps;
-    struct rig_state *rs;
     // this buf needs to be large enough for 0xfe strings for power up
     // at 115,200 this is now at least 150
     unsigned char buf[200];
-    unsigned char sendbuf[MAXFRAMELEN];
-    int frm_len, retval;
-    int ctrl_id;
+    int retval;
 
-    rs = &rig->state;
-    priv = (struct icom_priv_data *)rs->priv;
+    priv = (struct icom_priv_data *)rig->state.priv;
     priv_caps = (struct icom_priv_caps *)rig->caps->priv;
 
-    ctrl_id = priv_caps->serial_full_duplex == 0 ? CTRLID : 0x80;
-
-    frm_len = make_cmd_frame((char *) sendbuf, priv->re_civ_addr, ctrl_id, cmd,
-                             subcmd, payload, payload_len);
-
     /*
      * should check return code and that write wrote cmd_len chars!
      */
-    Hold_Decode(rig);
+    civ_bus_drain(rig, p);
 
-    serial_flush(&rs->rigport);
-
-    retval = write_block(&rs->rigport, (char *) sendbuf, frm_len);
+    retval = write_block(p, (char *) sendbuf, frm_len);
 
     if (retval != RIG_OK)
     {
-        Unhold_Decode(rig);
         return retval;
     }
 
@@ -151,30 +183,25 @@ int icom_one_transaction(RIG *rig, int cmd, int subcmd,
          *          up to rs->retry times.
          */
 
-        retval = read_icom_frame(&rs->rigport, buf, sizeof(buf));
+        retval = read_civ_reply(rig, p, ctrl_id, sendbuf, frm_len,
+                                buf, sizeof(buf));
 
         if (retval == -RIG_ETIMEOUT || retval == 0)
         {
             /* Nothing recieved, CI-V interface is not echoing */
-            Unhold_Decode(rig);
             return -RIG_BUSERROR;
         }
 
         if (retval < 0)
         {
             /* Other error, return it */
-            Unhold_Decode(rig);
             return retval;
         }
-        if (retval < 1) {
-            return -RIG_EPROTO;
-        }
 
         switch (buf[retval - 1])
         {
         case COL:
             /* Collision */
-            Unhold_Decode(rig);
             return -RIG_BUSBUSY;
 
         case FI:
@@ -184,25 +211,12 @@ int icom_one_transaction(RIG *rig, int cmd, int subcmd,
         default:
             /* Timeout after reading at least one character */
             /* Problem on ci-v bus? */
-            Unhold_Decode(rig);
             return -RIG_BUSERROR;
         }
 
-        if (retval != frm_len)
+        if (retval != frm_len || memcmp(buf, sendbuf, frm_len))
         {
-            /* Not the same length??? */
-            /* Problem on ci-v bus? */
-            /* Someone else got a packet in? */
-            Unhold_Decode(rig);
-            return -RIG_EPROTO;
-        }
-
-        if (memcmp(buf, sendbuf, frm_len))
-        {
-            /* Frames are different? */
-            /* Problem on ci-v bus? */
-            /* Someone else got a packet in? */
-            Unhold_Decode(rig);
+            /* Got the reply instead, the interface is not echoing */
             return -RIG_EPROTO;
         }
     }
@@ -212,17 +226,14 @@ int icom_one_transaction(RIG *rig, int cmd, int subcmd,
      */
     if (data_len == NULL)
     {
-        Unhold_Decode(rig);
         return RIG_OK;
     }
 
     /*
      * wait for ACK ...
-     * FIXME: handle pading/collisions
      * ACKFRMLEN is the smallest frame we can expect from the rig
      */
-    frm_len = read_icom_frame(&rs->rigport, buf, sizeof(buf));
-    Unhold_Decode(rig);
+    frm_len = read_civ_reply(rig, p, ctrl_id, NULL, 0, buf, sizeof(buf));
 
     if (frm_len < 0)
     {
@@ -230,7 +241,9 @@ int icom_one_transaction(RIG *rig, int cmd, int subcmd,
         /* other error: return it */
         return frm_len;
     }
-    if (frm_len < 1) {
+
+    if (frm_len < 1)
+    {
         return -RIG_EPROTO;
     }
 
@@ -257,13 +270,62 @@ int icom_one_transaction(RIG *rig, int cmd, int subcmd,
     *data_len = frm_len - (ACKFRMLEN - 1);
     memcpy(data, buf + 4, *data_len);
 
-    /*
-     * TODO: check addresses in reply frame
-     */
-
     return RIG_OK;
 }
 
+/*
+ * icom_one_transaction
+ *
+ * We assume that rig!=NULL, rig->state!= NULL, payload!=NULL, data!=NULL, data_len!=NULL
+ * Otherwise, you'll get a nice seg fault. You've been warned!
+ * payload can be NULL if payload_len == 0
+ * subcmd can be equal to -1 (no subcmd wanted)
+ * if no answer is to be expected, data_len must be set to NULL to tell so
+ *
+ * The CI-V bus of the port is held for the whole transaction, so that
+ * several RIG handles may share it.
+ *
+ * return RIG_OK if transaction completed,
+ * or a negative value otherwise indicating the error.
+ */
+int icom_one_transaction(RIG *rig, int cmd, int subcmd,
+                         const unsigned char *payload, int payload_len, unsigned char *data,
+                         int *data_len)
+{
+    struct icom_priv_data *priv;
+    const struct icom_priv_caps *priv_caps;
+    unsigned char sendbuf[MAXFRAMELEN];
+    hamlib_port_t *p;
+    int frm_len, retval;
+    int ctrl_id;
+
+    priv = (struct icom_priv_data *)rig->state.priv;
+    priv_caps = (struct icom_priv_caps *)rig->caps->priv;
+
+    ctrl_id = priv_caps->serial_full_duplex == 0 ? CTRLID : 0x80;
+
+    frm_len = make_cmd_frame((char *) sendbuf, priv->re_civ_addr, ctrl_id, cmd,
+                             subcmd, payload, payload_len);
+
+    Hold_Decode(rig);
+
+    p = civ_bus_acquire(rig);
+
+    if (!p)
+    {
+        Unhold_Decode(rig);
+        return -RIG_BUSBUSY;
+    }
+
+    retval = civ_transaction(rig, p, ctrl_id, sendbuf, frm_len, data,
+                             data_len);
+    civ_bus_release(rig);
+
+    Unhold_Decode(rig);
+
+    return retval;
+}
+
 /*
  * icom_transaction
  *
@@ -294,9 +356,17 @@ int icom_transaction(RIG *rig, int cmd, int subcmd,
         {
             break;
         }
+
+        if (retry > 0)
+        {
+            rig->state.rigport.io_count.retries++;
+        }
     }
     while (retry-- > 0);
 
+    /* broadcasts that came in meanwhile */
+    civ_bus_dispatch(rig);
+
     return retval;
 }
 
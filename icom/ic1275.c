@@ -129,7 +129,7 @@ const struct rig_caps ic1275_caps =
     .rig_init =   icom_init,
     .rig_cleanup =   icom_cleanup,
     .rig_open =  NULL,
-    .rig_close =  NULL,
+    .rig_close =  icom_rig_close,
 
     .set_freq =  icom_set_freq,
     .get_freq =  icom_get_freq,
@@ -149,7 +149,7 @@ const struct rig_caps ic707_caps =
     .rig_init = icom_init,
     .rig_cleanup =  icom_cleanup,
     .rig_open =  NULL,
-    .rig_close =  NULL,
+    .rig_close =  icom_rig_close,
 
     .set_freq =  icom_set_freq,
     .get_freq =  icom_get_freq,
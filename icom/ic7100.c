@@ -314,7 +314,7 @@ const struct rig_caps ic7100_caps =
     .rig_init =   icom_init,
     .rig_cleanup =   icom_cleanup,
     .rig_open =  NULL,
-    .rig_close =  NULL,
+    .rig_close =  icom_rig_close,
 
     .cfgparams =  icom_cfg_params,
     .set_conf =  icom_set_conf,
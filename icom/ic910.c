@@ -548,6 +548,7 @@ const struct rig_caps ic910_caps =
     .priv =     &ic910_priv_caps,
     .rig_init =   icom_init,
     .rig_cleanup =    icom_cleanup,
+    .rig_close =  icom_rig_close,
 
     .cfgparams =    icom_cfg_params,
     .set_conf =   icom_set_conf,
@@ -212,7 +212,7 @@ const struct rig_caps ic92d_caps =
     .rig_init =   icom_init,
     .rig_cleanup =   icom_cleanup,
     .rig_open =  NULL,
-    .rig_close =  NULL,
+    .rig_close =  icom_rig_close,
 
     .get_info =  ic92d_get_info,
 
@@ -38,6 +38,7 @@
 #include "icom.h"
 #include "icom_defs.h"
 #include "frame.h"
+#include "civbus.h"
 
 // Newer Icoms like the 9700 and 910 have VFOA/B on both Main & Sub
 // Compared to older rigs which have one or the other
@@ -533,6 +534,40 @@ int icom_init(RIG *rig)
     priv->tx_vfo = RIG_VFO_NONE;
     priv->rx_vfo = RIG_VFO_NONE;
     priv->curr_vfo = RIG_VFO_NONE;
+
+    /* meters without a table in the caps use the Icom defaults */
+    if (caps->alc_cal.size == 0)
+    {
+        rig_set_cal_float(rig, RIG_CAL_ALC, &icom_default_alc_cal);
+    }
+
+    if (caps->swr_cal.size == 0)
+    {
+        rig_set_cal_float(rig, RIG_CAL_SWR, &icom_default_swr_cal);
+    }
+
+    if (caps->rfpower_meter_cal.size == 0)
+    {
+        rig_set_cal_float(rig, RIG_CAL_RFPOWER_METER,
+                          &icom_default_rfpower_meter_cal);
+    }
+
+    if (caps->comp_meter_cal.size == 0)
+    {
+        rig_set_cal_float(rig, RIG_CAL_COMP_METER,
+                          &icom_default_comp_meter_cal);
+    }
+
+    if (caps->vd_meter_cal.size == 0)
+    {
+        rig_set_cal_float(rig, RIG_CAL_VD_METER, &icom_default_vd_meter_cal);
+    }
+
+    if (caps->id_meter_cal.size == 0)
+    {
+        rig_set_cal_float(rig, RIG_CAL_ID_METER, &icom_default_id_meter_cal);
+    }
+
     rig_debug(RIG_DEBUG_TRACE, "%s: done\n", __func__);
 
     return RIG_OK;
@@ -553,6 +588,7 @@ int icom_cleanup(RIG *rig)
 
     if (rig->state.priv)
     {
+        civ_bus_leave(rig);
         free(rig->state.priv);
     }
 
@@ -605,6 +641,20 @@ int icom_rig_open(RIG *rig)
 }
 
 
+/*
+ * ICOM rig close routine
+ * Leaves the CI-V bus, so the port is really closed by the frontend
+ */
+int icom_rig_close(RIG *rig)
+{
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    civ_bus_leave(rig);
+
+    return RIG_OK;
+}
+
+
 /*
  * icom_set_freq
  * Assumes rig!=NULL, rig->state.priv!=NULL
@@ -2169,7 +2219,7 @@ int icom_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
     switch (level)
     {
     case RIG_LEVEL_STRENGTH:
-        val->i = round(rig_raw2val(icom_val, &rig->caps->str_cal));
+        val->i = round(rig_raw2val_meter(rig, RIG_CAL_STR, icom_val));
         break;
 
     case RIG_LEVEL_RAWSTR:
@@ -2228,75 +2278,27 @@ int icom_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
         break;
 
     case RIG_LEVEL_ALC:
-        if (rig->caps->alc_cal.size == 0)
-        {
-            val->f = rig_raw2val_float(icom_val, &icom_default_alc_cal);
-        }
-        else
-        {
-            val->f = rig_raw2val_float(icom_val, &rig->caps->alc_cal);
-        }
-
+        val->f = rig_raw2val_meter(rig, RIG_CAL_ALC, icom_val);
         break;
 
     case RIG_LEVEL_SWR:
-        if (rig->caps->swr_cal.size == 0)
-        {
-            val->f = rig_raw2val_float(icom_val, &icom_default_swr_cal);
-        }
-        else
-        {
-            val->f = rig_raw2val_float(icom_val, &rig->caps->swr_cal);
-        }
-
+        val->f = rig_raw2val_meter(rig, RIG_CAL_SWR, icom_val);
         break;
 
     case RIG_LEVEL_RFPOWER_METER:
-        if (rig->caps->rfpower_meter_cal.size == 0)
-        {
-            val->f = rig_raw2val_float(icom_val, &icom_default_rfpower_meter_cal);
-        }
-        else
-        {
-            val->f = rig_raw2val_float(icom_val, &rig->caps->rfpower_meter_cal);
-        }
-
+        val->f = rig_raw2val_meter(rig, RIG_CAL_RFPOWER_METER, icom_val);
         break;
 
     case RIG_LEVEL_COMP_METER:
-        if (rig->caps->comp_meter_cal.size == 0)
-        {
-            val->f = rig_raw2val_float(icom_val, &icom_default_comp_meter_cal);
-        }
-        else
-        {
-            val->f = rig_raw2val_float(icom_val, &rig->caps->comp_meter_cal);
-        }
-
+        val->f = rig_raw2val_meter(rig, RIG_CAL_COMP_METER, icom_val);
         break;
 
     case RIG_LEVEL_VD_METER:
-        if (rig->caps->vd_meter_cal.size == 0)
-        {
-            val->f = rig_raw2val_float(icom_val, &icom_default_vd_meter_cal);
-        }
-        else
-        {
-            val->f = rig_raw2val_float(icom_val, &rig->caps->vd_meter_cal);
-        }
-
+        val->f = rig_raw2val_meter(rig, RIG_CAL_VD_METER, icom_val);
         break;
 
     case RIG_LEVEL_ID_METER:
-        if (rig->caps->id_meter_cal.size == 0)
-        {
-            val->f = rig_raw2val_float(icom_val, &icom_default_id_meter_cal);
-        }
-        else
-        {
-            val->f = rig_raw2val_float(icom_val, &rig->caps->id_meter_cal);
-        }
-
+        val->f = rig_raw2val_meter(rig, RIG_CAL_ID_METER, icom_val);
         break;
 
     case RIG_LEVEL_CWPITCH:
@@ -4970,17 +4972,46 @@ int icom_decode_event(RIG *rig)
     struct icom_priv_data *priv;
     struct rig_state *rs;
     unsigned char buf[MAXFRAMELEN];
+    hamlib_port_t *p;
     int frm_len;
-    freq_t freq;
-    rmode_t mode;
-    pbwidth_t width;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
     rs = &rig->state;
     priv = (struct icom_priv_data *)rs->priv;
 
-    frm_len = read_icom_frame(&rs->rigport, buf, sizeof(buf));
+    /* first what the bus queued for us during other transactions */
+    frm_len = civ_bus_pop(rig, buf, sizeof(buf));
+
+    if (frm_len > 0)
+    {
+        return icom_decode_frame(rig, buf);
+    }
+
+    p = civ_bus_acquire(rig);
+
+    if (!p)
+    {
+        /* left to the bus, which collects it out of the handler */
+        return RIG_OK;
+    }
+
+    if (p != &rs->rigport)
+    {
+        /*
+         * On a shared bus, the frames of all the rigs come through the
+         * bus port: take all of them, the port buffer would otherwise
+         * keep some out of the sight of the event loop.
+         */
+        civ_bus_collect(rig, p);
+        civ_bus_release(rig);
+        civ_bus_dispatch_all(rig);
+
+        return RIG_OK;
+    }
+
+    frm_len = read_icom_frame(p, buf, sizeof(buf));
+    civ_bus_release(rig);
 
     if (frm_len == -RIG_ETIMEOUT)
     {
@@ -5010,16 +5041,42 @@ int icom_decode_event(RIG *rig)
         return  -RIG_EPROTO;
     }
 
-    if (buf[3] != BCASTID && buf[3] != priv->re_civ_addr)
+    if (frm_len < ACKFRMLEN)
     {
-        rig_debug(RIG_DEBUG_WARN, "%s: CI-V %#x called for %#x!\n", __func__,
-                  priv->re_civ_addr, buf[3]);
+        return -RIG_EPROTO;
     }
 
+    if (buf[3] != priv->re_civ_addr)
+    {
+        /* another rig on the bus, keep it for its own decoder */
+        if (!civ_bus_route(rig, buf, frm_len))
+        {
+            rig_debug(RIG_DEBUG_WARN, "%s: CI-V %#x called for %#x!\n", __func__,
+                      priv->re_civ_addr, buf[3]);
+        }
+
+        return RIG_OK;
+    }
+
+    return icom_decode_frame(rig, buf);
+}
+
+/*
+ * Decodes a transceive frame read from the rig, calling the callbacks
+ */
+int icom_decode_frame(RIG *rig, const unsigned char *buf)
+{
+    struct icom_priv_data *priv;
+    freq_t freq;
+    rmode_t mode;
+    pbwidth_t width;
+
+    priv = (struct icom_priv_data *)rig->state.priv;
+
     /*
      * the first 2 bytes must be 0xfe
-     * the 3rd one the emitter
-     * the 4rd one 0x00 since this is transceive mode
+     * the 3rd one 0x00 since this is transceive mode
+     * the 4rd one the emitter
      * then the command number
      * the rest is data
      * and don't forget one byte at the end for the EOM
@@ -144,6 +144,7 @@ struct icom_priv_data
     vfo_t curr_vfo; 
     vfo_t rx_vfo; 
     vfo_t tx_vfo; 
+    struct civ_member *bus_member;  /* CI-V bus shared with other rigs */
 };
 
 extern const struct ts_sc_list r8500_ts_sc_list[];
@@ -171,6 +172,7 @@ pbwidth_t icom_get_dsp_flt(RIG *rig, rmode_t mode);
 
 int icom_init(RIG *rig);
 int icom_rig_open(RIG *rig);
+int icom_rig_close(RIG *rig);
 int icom_cleanup(RIG *rig);
 int icom_set_freq(RIG *rig, vfo_t vfo, freq_t freq);
 int icom_get_freq(RIG *rig, vfo_t vfo, freq_t *freq);
@@ -234,6 +236,7 @@ int icom_get_powerstat(RIG *rig, powerstat_t *status);
 int icom_set_ant(RIG *rig, vfo_t vfo, ant_t ant);
 int icom_get_ant(RIG *rig, vfo_t vfo, ant_t *ant);
 int icom_decode_event(RIG *rig);
+int icom_decode_frame(RIG *rig, const unsigned char *buf);
 int icom_power2mW(RIG *rig, unsigned int *mwpower, float power, freq_t freq,
                   rmode_t mode);
 int icom_mW2power(RIG *rig, float *power, unsigned int mwpower, freq_t freq,
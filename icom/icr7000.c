@@ -150,7 +150,7 @@ const struct rig_caps icr7000_caps =
     .rig_init =   icom_init,
     .rig_cleanup =   icom_cleanup,
     .rig_open =  NULL,
-    .rig_close =  NULL,
+    .rig_close =  icom_rig_close,
 
     .set_freq =  r7000_set_freq,
     .get_freq =  icom_get_freq,
@@ -269,7 +269,7 @@ const struct rig_caps icr7100_caps =
     .rig_init =   icom_init,
     .rig_cleanup =   icom_cleanup,
     .rig_open =  NULL,
-    .rig_close =  NULL,
+    .rig_close =  icom_rig_close,
 
     .set_freq =  r7000_set_freq,    /* TBC for R7100 */
     .get_freq =  icom_get_freq,
@@ -161,6 +161,7 @@ const struct rig_caps omnivip_caps =
     .priv = (void *)& omnivip_priv_caps,
     .rig_init =   icom_init,
     .rig_cleanup =   icom_cleanup,
+    .rig_close =  icom_rig_close,
 
     .set_freq =  icom_set_freq,
     .get_freq =  icom_get_freq,
@@ -127,6 +127,7 @@ int optoscan_close(RIG *rig)
 
     if (retval != RIG_OK)
     {
+        icom_rig_close(rig);
         return retval;
     }
 
@@ -134,12 +135,13 @@ int optoscan_close(RIG *rig)
     {
         rig_debug(RIG_DEBUG_ERR, "optoscan_close: ack NG (%#.2x), "
                   "len=%d\n", ackbuf[0], ack_len);
+        icom_rig_close(rig);
         return -RIG_ERJCTED;
     }
 
     free(priv->pltstate);
 
-    return RIG_OK;
+    return icom_rig_close(rig);
 }
 
 /*
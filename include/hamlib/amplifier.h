@@ -126,6 +126,20 @@ enum amp_level_e
 #define AMP_LEVEL_IS_FLOAT(l) ((l)&AMP_LEVEL_FLOAT_LIST)
 #define AMP_LEVEL_IS_STRING(l) ((l)&AMP_LEVEL_STRING_LIST)
 
+/**
+ * \brief One level of an amp_get_levels() batch
+ *
+ * The caller fills in \a level. amp_get_levels() fills in \a status
+ * with the RIG_OK or -RIG_E* outcome of this level alone and, on
+ * success, \a val.
+ */
+struct amp_level_value
+{
+  setting_t level;  /*!< level to read, one AMP_LEVEL_* */
+  int status;       /*!< outcome of this level */
+  value_t val;      /*!< value read */
+};
+
 /* Basic amp type, can store some useful info about different amplifiers. Each
  * lib must be able to populate this structure, so we can make useful
  * enquiries about capablilities.
@@ -205,6 +219,7 @@ struct amp_caps
   int (*reset)(AMP *amp, amp_reset_t reset);
   int (*get_level)(AMP *amp, setting_t level, value_t *val);
   int (*get_ext_level)(AMP *amp, token_t level, value_t *val);
+  int (*get_levels)(AMP *amp, struct amp_level_value *req, int count);
   int (*set_powerstat)(AMP *amp, powerstat_t status);
   int (*get_powerstat)(AMP *amp, powerstat_t *status);
 
@@ -322,6 +337,11 @@ amp_get_info HAMLIB_PARAMS((AMP *amp));
 extern HAMLIB_EXPORT(int)
 amp_get_level HAMLIB_PARAMS((AMP *amp, setting_t level, value_t *val));
 
+extern HAMLIB_EXPORT(int)
+amp_get_levels HAMLIB_PARAMS((AMP *amp,
+                              struct amp_level_value *req,
+                              int count));
+
 extern HAMLIB_EXPORT(int)
 amp_register HAMLIB_PARAMS((const struct amp_caps *caps));
 
@@ -362,6 +382,10 @@ amp_token_lookup HAMLIB_PARAMS((AMP *amp,
 extern HAMLIB_EXPORT(const struct amp_caps *)
 amp_get_caps HAMLIB_PARAMS((amp_model_t amp_model));
 
+extern HAMLIB_EXPORT(amp_model_t)
+amp_get_model_by_name HAMLIB_PARAMS((const char *mfg_name,
+                                     const char *model_name));
+
 extern HAMLIB_EXPORT(setting_t)
 amp_has_get_level HAMLIB_PARAMS((AMP *amp,
                                  setting_t level));
@@ -171,6 +171,7 @@ typedef struct rig RIG;
 #define MAXDBLSTSIZ 8       /* max preamp/att levels supported, zero ended */
 #define CHANLSTSIZ 16       /* max mem_list size, zero ended */
 #define MAX_CAL_LENGTH 32   /* max calibration plots in cal_table_t */
+#define PORTRXBUFSIZ 1024   /* port receive buffer size */
 
 
 /**
@@ -1351,6 +1352,89 @@ typedef struct cal_table_float cal_table_float_t;
 
 #define EMPTY_FLOAT_CAL { 0, { { 0, 0f }, } }
 
+/**
+ * \brief Meters with a calibration table in rig_state
+ *
+ * \sa rig_set_cal(), rig_raw2val_meter()
+ */
+typedef enum {
+    RIG_CAL_STR = 0,        /*!< S-meter, rig_state.str_cal */
+    RIG_CAL_SWR,            /*!< SWR meter */
+    RIG_CAL_ALC,            /*!< ALC meter */
+    RIG_CAL_RFPOWER_METER,  /*!< RF power meter */
+    RIG_CAL_COMP_METER,     /*!< COMP meter */
+    RIG_CAL_VD_METER,       /*!< Voltage meter */
+    RIG_CAL_ID_METER,       /*!< Current draw meter */
+    RIG_CAL_NB              /*!< Number of meters, not a meter */
+} rig_cal_t;
+
+/**
+ * \brief Calibration table compiled into a lookup array
+ *
+ * Between the first and the last raw value of the table, val holds the
+ * calibrated value of every raw value, so that a conversion is a bounds
+ * check and an array access.  Tables spanning too many raw values are
+ * not compiled and are interpolated as by rig_raw2val_float().
+ */
+struct cal_lut {
+    cal_table_float_t cal;  /*!< Calibration table */
+    int raw_min;            /*!< Raw value of val[0] */
+    int size;               /*!< Number of entries of val, 0 if not compiled */
+    float *val;             /*!< Calibrated values from raw_min */
+};
+
+/**
+ * \brief What a rig_multi item reads
+ * \sa rig_get_multi()
+ */
+enum rig_multi_e {
+    RIG_MULTI_FREQ = 0,     /*!< frequency, rig_get_freq() */
+    RIG_MULTI_MODE,         /*!< mode and passband, rig_get_mode() */
+    RIG_MULTI_VFO,          /*!< current VFO, rig_get_vfo() */
+    RIG_MULTI_PTT,          /*!< PTT status, rig_get_ptt() */
+    RIG_MULTI_LEVEL         /*!< level given by \a level, rig_get_level() */
+};
+
+/**
+ * \brief One read of a rig_get_multi() batch
+ *
+ * The caller fills in \a what, \a vfo and, for RIG_MULTI_LEVEL,
+ * \a level. rig_get_multi() fills in \a status with the RIG_OK or
+ * -RIG_E* outcome of this item alone and, on success, the matching
+ * member of \a val.
+ */
+struct rig_multi {
+    enum rig_multi_e what;  /*!< what to read */
+    vfo_t vfo;              /*!< target VFO, ignored by RIG_MULTI_VFO */
+    setting_t level;        /*!< level to read for RIG_MULTI_LEVEL */
+    int status;             /*!< outcome of this item */
+    union {
+        freq_t freq;        /*!< RIG_MULTI_FREQ */
+        struct {
+            rmode_t mode;
+            pbwidth_t width;
+        } mode;             /*!< RIG_MULTI_MODE */
+        vfo_t vfo;          /*!< RIG_MULTI_VFO */
+        ptt_t ptt;          /*!< RIG_MULTI_PTT */
+        value_t level;      /*!< RIG_MULTI_LEVEL */
+    } val;                  /*!< value read */
+};
+
+/**
+ * \brief Completion callback of the asynchronous requests
+ *
+ * \a result is the request as submitted, with its status and, for
+ * reads, its value filled in. It is only valid during the call.
+ *
+ * \sa rig_async_start(), rig_get_async(), rig_set_async()
+ */
+typedef void (*rig_async_cb_t)(RIG *rig,
+                               const struct rig_multi *result,
+                               rig_ptr_t arg);
+
+/** \brief rig_async_start() flag, complete through rig_async_fd() */
+#define RIG_ASYNC_FD    (1<<0)
+
 typedef int (* chan_cb_t)(RIG *, channel_t **, int, const chan_t *, rig_ptr_t);
 typedef int (* confval_cb_t)(RIG *,
                              const struct confparams *,
@@ -1618,6 +1702,11 @@ struct rig_caps {
 
     const char *clone_combo_set;    /*!< String describing key combination to enter load cloning mode */
     const char *clone_combo_get;    /*!< String describing key combination to enter save cloning mode */
+
+    int (*get_multi)(RIG *rig, struct rig_multi *req, int count);
+
+    int (*get_channels)(RIG *rig, channel_t chans[], int count);
+    int (*set_channels)(RIG *rig, const channel_t chans[], int count);
 };
 
 
@@ -1682,6 +1771,23 @@ typedef struct hamlib_port {
             int value;      /*!< Toggle PTT ON or OFF */
         } gpio;             /*!< GPIO attributes */
     } parm;                 /*!< Port parameter union */
+
+    struct {
+        unsigned char buf[PORTRXBUFSIZ];    /*!< Received bytes not yet consumed */
+        int head;           /*!< Index of the oldest buffered byte */
+        int count;          /*!< Number of buffered bytes */
+    } rx;                   /*!< Receive ring buffer, hamlib internal use */
+
+    struct {
+        unsigned long select_calls; /*!< Number of select() calls */
+        unsigned long read_calls;   /*!< Number of read() calls */
+        unsigned long write_calls;  /*!< Number of write() calls */
+        unsigned long flush_calls;  /*!< Number of flush related calls */
+        unsigned long tx_bytes;     /*!< Number of bytes written */
+        unsigned long rx_bytes;     /*!< Number of bytes read */
+        unsigned long timeouts;     /*!< Number of reads that timed out */
+        unsigned long retries;      /*!< Number of commands sent again */
+    } io_count;             /*!< System call counters, hamlib internal use */
 } hamlib_port_t;
 
 #if !defined(__APPLE__) || !defined(__cplusplus)
@@ -1689,6 +1795,151 @@ typedef hamlib_port_t port_t;
 #endif
 
 
+/**
+ * \brief Number of VFOs tracked by the frontend cache
+ */
+#define RIG_CACHE_VFO_SLOTS 8
+
+/**
+ * \brief Frontend cache entry of one VFO
+ *
+ * Dates are in milliseconds, 0 when the value has not been read
+ * or has been invalidated.
+ */
+struct rig_cache_vfo {
+    vfo_t vfo;              /*!< VFO of the entry, RIG_VFO_NONE when unused */
+    freq_t freq;            /*!< Last frequency read */
+    int64_t time_freq;      /*!< Date of freq */
+    rmode_t mode;           /*!< Last mode read */
+    pbwidth_t width;        /*!< Last passband width read */
+    int64_t time_mode;      /*!< Date of mode and width */
+    ptt_t ptt;              /*!< Last PTT status read */
+    int64_t time_ptt;       /*!< Date of ptt */
+    split_t split;          /*!< Last split status read */
+    vfo_t tx_vfo;           /*!< Last TX VFO read */
+    int64_t time_split;     /*!< Date of split and tx_vfo */
+};
+
+/**
+ * \brief Frontend cache of the rig state
+ *
+ * Values read by rig_get_freq(), rig_get_mode(), rig_get_vfo(),
+ * rig_get_ptt() and rig_get_split_vfo() are kept per VFO and served
+ * again for rig_state.cache_timeout ms.  The rig_set_* calls invalidate
+ * what they may have changed.
+ *
+ * \sa rig_get_cache_stats()
+ */
+struct rig_cache {
+    struct rig_cache_vfo vfo[RIG_CACHE_VFO_SLOTS];  /*!< Per VFO entries */
+    int next_slot;          /*!< Next entry to recycle when all are used */
+    vfo_t curr_vfo;         /*!< Last current VFO read */
+    int64_t time_vfo;       /*!< Date of curr_vfo */
+    unsigned long hits;     /*!< Number of reads served from the cache */
+    unsigned long misses;   /*!< Number of reads that went to the rig */
+};
+
+
+/**
+ * \brief Operations accounted in the rig statistics
+ *
+ * \sa rig_get_stats(), rig_strstatsop()
+ */
+enum rig_stats_op_e {
+    RIG_STATS_SET_FREQ = 0,     /*!< rig_set_freq() */
+    RIG_STATS_GET_FREQ,         /*!< rig_get_freq() */
+    RIG_STATS_SET_MODE,         /*!< rig_set_mode() */
+    RIG_STATS_GET_MODE,         /*!< rig_get_mode() */
+    RIG_STATS_SET_VFO,          /*!< rig_set_vfo() */
+    RIG_STATS_GET_VFO,          /*!< rig_get_vfo() */
+    RIG_STATS_SET_PTT,          /*!< rig_set_ptt() */
+    RIG_STATS_GET_PTT,          /*!< rig_get_ptt() */
+    RIG_STATS_GET_DCD,          /*!< rig_get_dcd() */
+    RIG_STATS_SET_SPLIT_FREQ,   /*!< rig_set_split_freq() */
+    RIG_STATS_GET_SPLIT_FREQ,   /*!< rig_get_split_freq() */
+    RIG_STATS_SET_SPLIT_MODE,   /*!< rig_set_split_mode() */
+    RIG_STATS_GET_SPLIT_MODE,   /*!< rig_get_split_mode() */
+    RIG_STATS_SET_SPLIT_VFO,    /*!< rig_set_split_vfo() */
+    RIG_STATS_GET_SPLIT_VFO,    /*!< rig_get_split_vfo() */
+    RIG_STATS_SET_RIT,          /*!< rig_set_rit() */
+    RIG_STATS_GET_RIT,          /*!< rig_get_rit() */
+    RIG_STATS_SET_XIT,          /*!< rig_set_xit() */
+    RIG_STATS_GET_XIT,          /*!< rig_get_xit() */
+    RIG_STATS_SET_TS,           /*!< rig_set_ts() */
+    RIG_STATS_GET_TS,           /*!< rig_get_ts() */
+    RIG_STATS_SET_ANT,          /*!< rig_set_ant() */
+    RIG_STATS_GET_ANT,          /*!< rig_get_ant() */
+    RIG_STATS_SET_LEVEL,        /*!< rig_set_level() */
+    RIG_STATS_GET_LEVEL,        /*!< rig_get_level() */
+    RIG_STATS_SET_FUNC,         /*!< rig_set_func() */
+    RIG_STATS_GET_FUNC,         /*!< rig_get_func() */
+    RIG_STATS_SET_PARM,         /*!< rig_set_parm() */
+    RIG_STATS_GET_PARM,         /*!< rig_get_parm() */
+    RIG_STATS_SET_MEM,          /*!< rig_set_mem() */
+    RIG_STATS_GET_MEM,          /*!< rig_get_mem() */
+    RIG_STATS_SET_CHANNEL,      /*!< rig_set_channel() */
+    RIG_STATS_GET_CHANNEL,      /*!< rig_get_channel() */
+    RIG_STATS_VFO_OP,           /*!< rig_vfo_op() */
+    RIG_STATS_SCAN,             /*!< rig_scan() */
+    RIG_STATS_SET_POWERSTAT,    /*!< rig_set_powerstat() */
+    RIG_STATS_GET_POWERSTAT,    /*!< rig_get_powerstat() */
+    RIG_STATS_SEND_MORSE,       /*!< rig_send_morse() */
+    RIG_STATS_SET_PTT_AT,       /*!< rig_set_ptt_at(), from the time asked for */
+    RIG_STATS_NB_OPS            /*!< Number of operations, not an operation */
+};
+
+/**
+ * \brief Number of buckets of the latency histograms
+ *
+ * Bucket 0 counts the calls shorter than 1 us, bucket i the calls
+ * from 2^(i-1) up to 2^i us, and the last one everything longer.
+ */
+#define RIG_STATS_HIST_SIZE 24
+
+/**
+ * \brief Statistics of one operation
+ *
+ * Retries, timeouts and bytes are those of the rig port during the calls.
+ */
+struct rig_op_stats {
+    unsigned long count;        /*!< Number of calls */
+    unsigned long errors;       /*!< Number of calls which failed */
+    unsigned long timeouts;     /*!< Port reads which timed out */
+    unsigned long retries;      /*!< Commands sent again by the backend */
+    unsigned long tx_bytes;     /*!< Bytes written to the rig port */
+    unsigned long rx_bytes;     /*!< Bytes read from the rig port */
+    double total_us;            /*!< Time spent in the calls, in us */
+    double max_us;              /*!< Longest call, in us */
+    double total_sq_us;         /*!< Sum of the squared call times, in us^2 */
+    unsigned long hist[RIG_STATS_HIST_SIZE];    /*!< Latency histogram */
+};
+
+/**
+ * \brief Counters of one port, see hamlib_port_t.io_count
+ *
+ * The histogram is that of the latency of the accounted calls served by
+ * the port, as for struct rig_op_stats.
+ */
+struct rig_port_stats {
+    unsigned long tx_bytes;     /*!< Bytes written */
+    unsigned long rx_bytes;     /*!< Bytes read */
+    unsigned long timeouts;     /*!< Reads which timed out */
+    unsigned long retries;      /*!< Commands sent again */
+    unsigned long syscalls;     /*!< select/read/write/flush calls */
+    unsigned long hist[RIG_STATS_HIST_SIZE];    /*!< Latency histogram */
+};
+
+/**
+ * \brief Rig statistics, as returned by rig_get_stats()
+ */
+struct rig_stats {
+    struct rig_op_stats op[RIG_STATS_NB_OPS];   /*!< Per operation */
+    struct rig_port_stats rigport;  /*!< Rig port counters */
+    struct rig_port_stats pttport;  /*!< PTT port counters */
+    struct rig_port_stats dcdport;  /*!< DCD port counters */
+};
+
+
 /**
  * \brief Rig state containing live data and customized fields.
  *
@@ -1744,7 +1995,7 @@ struct rig_state {
      * non overridable fields, internal use
      */
 
-    int hold_decode;    /*!< set to 1 to hold the event decoder (async) otherwise 0 */
+    int hold_decode;    /*!< non zero while a transaction or the event decoder owns the port */
     vfo_t current_vfo;  /*!< VFO currently set */
     int vfo_list;       /*!< Complete list of VFO for this rig */
     int comm_state;     /*!< Comm port state, opened/closed. */
@@ -1763,6 +2014,17 @@ struct rig_state {
                                      don't do CAT while in Tx */
     freq_t lo_freq;             /*!< Local oscillator frequency of any
 				     transverter */
+    int cache_timeout;          /*!< Frontend cache validity in ms, 0 to disable */
+    struct rig_cache cache;     /*!< Frontend cache, hamlib internal use */
+    rig_ptr_t async;            /*!< Async request worker, hamlib internal use */
+    rig_ptr_t stats;            /*!< Operation statistics, NULL when disabled */
+    struct cal_lut cal_lut[RIG_CAL_NB]; /*!< Meter calibrations, hamlib internal use */
+    int vfo_restore_delay;      /*!< Delay in ms before selecting back the VFO left for a non targetable operation, 0 for at once */
+    vfo_t restore_vfo;          /*!< VFO to select back, RIG_VFO_NONE if none, hamlib internal use */
+    int64_t restore_time;       /*!< When to select it back, hamlib internal use */
+    int ptt_hold;               /*!< Keep a separate PTT serial port open between transmissions */
+    int ptt_shared;             /*!< PTT line on the rig port, hamlib internal use */
+    rig_ptr_t decode_lock;      /*!< Serializes transactions with the event decoder, hamlib internal use */
 };
 
 
@@ -1781,6 +2043,7 @@ typedef int (*pltune_cb_t)(RIG *,
                            rmode_t *,
                            pbwidth_t *,
                            rig_ptr_t);
+typedef int (*chan_progress_cb_t)(RIG *, int, int, rig_ptr_t);
 
 
 /**
@@ -1813,6 +2076,8 @@ struct rig_callbacks {
     rig_ptr_t dcd_arg;      /*!< DCD change argument */
     pltune_cb_t pltune;     /*!< Pipeline tuning module freq/mode/width callback */
     rig_ptr_t pltune_arg;   /*!< Pipeline tuning argument */
+    chan_progress_cb_t chan_progress;   /*!< Channel memory transfer progress */
+    rig_ptr_t chan_progress_arg;        /*!< Channel memory transfer argument */
     /* etc.. */
 };
 
@@ -1870,6 +2135,8 @@ rig_set_vfo HAMLIB_PARAMS((RIG *rig,
 extern HAMLIB_EXPORT(int)
 rig_get_vfo HAMLIB_PARAMS((RIG *rig,
                            vfo_t *vfo));
+extern HAMLIB_EXPORT(int)
+rig_restore_vfo HAMLIB_PARAMS((RIG *rig));
 
 extern HAMLIB_EXPORT(int)
 netrigctl_get_vfo_mode HAMLIB_PARAMS((RIG *rig));
@@ -1879,6 +2146,11 @@ rig_set_ptt HAMLIB_PARAMS((RIG *rig,
                            vfo_t vfo,
                            ptt_t ptt));
 extern HAMLIB_EXPORT(int)
+rig_set_ptt_at HAMLIB_PARAMS((RIG *rig,
+                              vfo_t vfo,
+                              ptt_t ptt,
+                              int64_t when));
+extern HAMLIB_EXPORT(int)
 rig_get_ptt HAMLIB_PARAMS((RIG *rig,
                            vfo_t vfo,
                            ptt_t *ptt));
@@ -2235,6 +2507,19 @@ extern HAMLIB_EXPORT(int)
 rig_get_channel HAMLIB_PARAMS((RIG *rig,
                                channel_t *chan));
 
+extern HAMLIB_EXPORT(int)
+rig_set_channels HAMLIB_PARAMS((RIG *rig,
+                                const channel_t chans[],
+                                int count));
+extern HAMLIB_EXPORT(int)
+rig_get_channels HAMLIB_PARAMS((RIG *rig,
+                                channel_t chans[],
+                                int count));
+extern HAMLIB_EXPORT(int)
+rig_set_chan_progress_callback HAMLIB_PARAMS((RIG *rig,
+                                              chan_progress_cb_t cb,
+                                              rig_ptr_t arg));
+
 extern HAMLIB_EXPORT(int)
 rig_set_chan_all HAMLIB_PARAMS((RIG *rig,
                                 const channel_t chans[]));
@@ -2287,6 +2572,11 @@ extern HAMLIB_EXPORT(int)
 rig_get_trn HAMLIB_PARAMS((RIG *rig,
                            int *trn));
 
+extern HAMLIB_EXPORT(int)
+rig_event_loop_start HAMLIB_PARAMS((void));
+extern HAMLIB_EXPORT(int)
+rig_event_loop_stop HAMLIB_PARAMS((void));
+
 extern HAMLIB_EXPORT(int)
 rig_set_freq_callback HAMLIB_PARAMS((RIG *,
                                      freq_cb_t,
@@ -2319,9 +2609,111 @@ rig_set_pltune_callback HAMLIB_PARAMS((RIG *,
 extern HAMLIB_EXPORT(const char *)
 rig_get_info HAMLIB_PARAMS((RIG *rig));
 
+extern HAMLIB_EXPORT(int)
+rig_get_multi HAMLIB_PARAMS((RIG *rig,
+                             struct rig_multi *req,
+                             int count));
+
+extern HAMLIB_EXPORT(int)
+rig_async_start HAMLIB_PARAMS((RIG *rig, int flags));
+extern HAMLIB_EXPORT(int)
+rig_async_stop HAMLIB_PARAMS((RIG *rig));
+extern HAMLIB_EXPORT(int)
+rig_async_fd HAMLIB_PARAMS((RIG *rig));
+extern HAMLIB_EXPORT(int)
+rig_async_dispatch HAMLIB_PARAMS((RIG *rig));
+
+extern HAMLIB_EXPORT(int)
+rig_get_async HAMLIB_PARAMS((RIG *rig,
+                             const struct rig_multi *req,
+                             rig_async_cb_t cb,
+                             rig_ptr_t arg));
+extern HAMLIB_EXPORT(int)
+rig_set_async HAMLIB_PARAMS((RIG *rig,
+                             const struct rig_multi *req,
+                             rig_async_cb_t cb,
+                             rig_ptr_t arg));
+
+extern HAMLIB_EXPORT(int)
+rig_get_freq_async HAMLIB_PARAMS((RIG *rig,
+                                  vfo_t vfo,
+                                  rig_async_cb_t cb,
+                                  rig_ptr_t arg));
+extern HAMLIB_EXPORT(int)
+rig_set_freq_async HAMLIB_PARAMS((RIG *rig,
+                                  vfo_t vfo,
+                                  freq_t freq,
+                                  rig_async_cb_t cb,
+                                  rig_ptr_t arg));
+extern HAMLIB_EXPORT(int)
+rig_get_mode_async HAMLIB_PARAMS((RIG *rig,
+                                  vfo_t vfo,
+                                  rig_async_cb_t cb,
+                                  rig_ptr_t arg));
+extern HAMLIB_EXPORT(int)
+rig_set_mode_async HAMLIB_PARAMS((RIG *rig,
+                                  vfo_t vfo,
+                                  rmode_t mode,
+                                  pbwidth_t width,
+                                  rig_async_cb_t cb,
+                                  rig_ptr_t arg));
+extern HAMLIB_EXPORT(int)
+rig_get_ptt_async HAMLIB_PARAMS((RIG *rig,
+                                 vfo_t vfo,
+                                 rig_async_cb_t cb,
+                                 rig_ptr_t arg));
+extern HAMLIB_EXPORT(int)
+rig_set_ptt_async HAMLIB_PARAMS((RIG *rig,
+                                 vfo_t vfo,
+                                 ptt_t ptt,
+                                 rig_async_cb_t cb,
+                                 rig_ptr_t arg));
+extern HAMLIB_EXPORT(int)
+rig_set_ptt_at_async HAMLIB_PARAMS((RIG *rig,
+                                    vfo_t vfo,
+                                    ptt_t ptt,
+                                    int64_t when,
+                                    rig_async_cb_t cb,
+                                    rig_ptr_t arg));
+
+extern HAMLIB_EXPORT(int)
+rig_get_cache_stats HAMLIB_PARAMS((RIG *rig,
+                                   unsigned long *hits,
+                                   unsigned long *misses));
+
+extern HAMLIB_EXPORT(int)
+rig_set_cal HAMLIB_PARAMS((RIG *rig,
+                           rig_cal_t meter,
+                           const cal_table_t *cal));
+extern HAMLIB_EXPORT(int)
+rig_set_cal_float HAMLIB_PARAMS((RIG *rig,
+                                 rig_cal_t meter,
+                                 const cal_table_float_t *cal));
+extern HAMLIB_EXPORT(float)
+rig_raw2val_meter HAMLIB_PARAMS((RIG *rig, rig_cal_t meter, int rawval));
+extern HAMLIB_EXPORT(int)
+rig_raw2val_batch HAMLIB_PARAMS((RIG *rig,
+                                 rig_cal_t meter,
+                                 const int *rawval,
+                                 float *val,
+                                 int count));
+
+extern HAMLIB_EXPORT(int)
+rig_set_stats HAMLIB_PARAMS((RIG *rig, int enable));
+extern HAMLIB_EXPORT(int)
+rig_get_stats HAMLIB_PARAMS((RIG *rig, struct rig_stats *stats));
+extern HAMLIB_EXPORT(int)
+rig_reset_stats HAMLIB_PARAMS((RIG *rig));
+extern HAMLIB_EXPORT(const char *)
+rig_strstatsop HAMLIB_PARAMS((enum rig_stats_op_e op));
+
 extern HAMLIB_EXPORT(const struct rig_caps *)
 rig_get_caps HAMLIB_PARAMS((rig_model_t rig_model));
 
+extern HAMLIB_EXPORT(rig_model_t)
+rig_get_model_by_name HAMLIB_PARAMS((const char *mfg_name,
+                                     const char *model_name));
+
 extern HAMLIB_EXPORT(const freq_range_t *)
 rig_get_range HAMLIB_PARAMS((const freq_range_t range_list[],
                              freq_t freq,
@@ -2359,17 +2751,40 @@ rig_set_debug_time_stamp HAMLIB_PARAMS((int flag));
 extern HAMLIB_EXPORT(int)
 rig_need_debug HAMLIB_PARAMS((enum rig_debug_level_e debug_level));
 
+/* current debug level, set by rig_set_debug(), read only */
+extern HAMLIB_EXPORT_VAR(int) rig_debug_level;
+
+/*
+ * Highest debug level compiled in. Hamlib itself can be configured
+ * with --disable-debug-trace to drop the VERBOSE and TRACE messages.
+ */
+#ifndef RIG_DEBUG_MAX
+#define RIG_DEBUG_MAX RIG_DEBUG_TRACE
+#endif
 
+/* inline version of rig_need_debug() */
+#define RIG_DEBUG_ENABLED(debug_level) \
+    ((int)(debug_level) <= (int)RIG_DEBUG_MAX \
+     && (int)(debug_level) <= rig_debug_level)
 
 #ifndef __cplusplus
-#ifdef __GNUC__
-// doing the debug macro with a dummy sprintf allows gcc to check the format string
-#define rig_debug(debug_level,fmt,...) { char xxxbuf[16384];snprintf(xxxbuf,sizeof(xxxbuf),fmt,__VA_ARGS__);rig_debug(debug_level,fmt,##__VA_ARGS__); }
-#endif
+/* check the level before evaluating the arguments or making the call */
+#define rig_debug(debug_level, ...) \
+    do { \
+        if (RIG_DEBUG_ENABLED(debug_level)) \
+        { \
+            rig_debug(debug_level, __VA_ARGS__); \
+        } \
+    } while (0)
 #endif
+
 extern HAMLIB_EXPORT(void)
 rig_debug HAMLIB_PARAMS((enum rig_debug_level_e debug_level,
-                         const char *fmt, ...));
+                         const char *fmt, ...))
+#ifdef __GNUC__
+__attribute__((format(printf, 2, 3)))
+#endif
+;
 
 extern HAMLIB_EXPORT(vprintf_cb_t)
 rig_set_debug_callback HAMLIB_PARAMS((vprintf_cb_t cb,
@@ -2378,6 +2793,13 @@ rig_set_debug_callback HAMLIB_PARAMS((vprintf_cb_t cb,
 extern HAMLIB_EXPORT(FILE *)
 rig_set_debug_file HAMLIB_PARAMS((FILE *stream));
 
+extern HAMLIB_EXPORT(int)
+rig_set_debug_ring HAMLIB_PARAMS((int size,
+                                  enum rig_debug_level_e dump_level));
+
+extern HAMLIB_EXPORT(int)
+rig_debug_ring_dump HAMLIB_PARAMS((FILE *stream));
+
 extern HAMLIB_EXPORT(int)
 rig_register HAMLIB_PARAMS((const struct rig_caps *caps));
 
@@ -436,6 +436,10 @@ rot_token_lookup HAMLIB_PARAMS((ROT *rot,
 extern HAMLIB_EXPORT(const struct rot_caps *)
 rot_get_caps HAMLIB_PARAMS((rot_model_t rot_model));
 
+extern HAMLIB_EXPORT(rot_model_t)
+rot_get_model_by_name HAMLIB_PARAMS((const char *mfg_name,
+                                     const char *model_name));
+
 extern HAMLIB_EXPORT(int)
 qrb HAMLIB_PARAMS((double lon1,
                    double lat1,
@@ -444,6 +448,16 @@ qrb HAMLIB_PARAMS((double lon1,
                    double *distance,
                    double *azimuth));
 
+extern HAMLIB_EXPORT(int)
+qrb_batch HAMLIB_PARAMS((double lon1,
+                         double lat1,
+                         const double *lon2,
+                         const double *lat2,
+                         double *distance,
+                         double *azimuth,
+                         int *status,
+                         int count));
+
 extern HAMLIB_EXPORT(double)
 distance_long_path HAMLIB_PARAMS((double distance));
 
@@ -461,6 +475,13 @@ locator2longlat HAMLIB_PARAMS((double *longitude,
                                double *latitude,
                                const char *locator));
 
+extern HAMLIB_EXPORT(int)
+locator2longlat_batch HAMLIB_PARAMS((double *longitude,
+                                     double *latitude,
+                                     int *status,
+                                     const char *const *locator,
+                                     int count));
+
 extern HAMLIB_EXPORT(double)
 dms2dec HAMLIB_PARAMS((int degrees,
                        int minutes,
@@ -238,6 +238,7 @@ const struct rig_caps k2_caps =
     .get_ext_level =    k2_get_ext_level,
     .vfo_op =       kenwood_vfo_op,
     .set_trn =      kenwood_set_trn,
+    .decode_event =      kenwood_decode_event,
     .get_powerstat =    kenwood_get_powerstat,
     .get_trn =      kenwood_get_trn,
     .set_ant =      kenwood_set_ant,
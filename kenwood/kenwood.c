@@ -200,6 +200,49 @@ const struct confparams kenwood_cfg_params[] =
 };
 
 
+/*
+ * Auto Information reports read while waiting for a reply. They are
+ * decoded once the transaction is over, as callbacks may talk to the rig.
+ */
+struct kenwood_reports
+{
+    int count;
+    int seen;       /* kept or dropped, bounds the wait for the reply */
+    char report[KENWOOD_MAX_REPORTS][KENWOOD_REPORT_LEN];
+};
+
+
+static void kenwood_keep_report(struct kenwood_reports *r, const char *report)
+{
+    r->seen++;
+
+    if (r->count == KENWOOD_MAX_REPORTS || strlen(report) >= KENWOOD_REPORT_LEN)
+    {
+        rig_debug(RIG_DEBUG_WARN, "%s: dropping '%s'\n", __func__, report);
+        return;
+    }
+
+    strcpy(r->report[r->count++], report);
+}
+
+
+static void kenwood_decode_reports(RIG *rig, const struct kenwood_reports *r)
+{
+    int i;
+
+    /* AI may have been turned off by the transaction itself */
+    if (rig->state.transceive == RIG_TRN_OFF)
+    {
+        return;
+    }
+
+    for (i = 0; i < r->count; i++)
+    {
+        kenwood_decode_report(rig, r->report[i]);
+    }
+}
+
+
 /**
  * kenwood_transaction
  * Assumes rig!=NULL rig->state!=NULL rig->caps!=NULL
@@ -218,6 +261,11 @@ const struct confparams kenwood_cfg_params[] =
  *   RIG_ETIMEOUT - if timeout expires without any characters received.
  *   RIG_REJECTED - if a negative acknowledge was received or command not
  *          recognized by rig.
+ *
+ * With AI on, reports which come in before the reply are passed to
+ * kenwood_decode_report() once the transaction is over, and the reply
+ * is waited for without using up a retry. With AI off, a wrong reply
+ * is retried right away.
  */
 int kenwood_transaction(RIG *rig, const char *cmdstr, char *data,
                         size_t datasize)
@@ -243,15 +291,18 @@ int kenwood_transaction(RIG *rig, const char *cmdstr, char *data,
 
     char cmdtrm[2];  /* Default Command/Reply termination char */
 
-    char *cmd;
+    const char *cmd;
 
-    int len;
+    int len, cmdlen = 0, verifylen = 0;
 
     int retry_read = 0;
 
+    struct kenwood_reports reports;
+
     rs = &rig->state;
+    reports.count = reports.seen = 0;
 
-    rs->hold_decode = 1;
+    Hold_Decode(rig);
 
     /* Emulators don't need any post_write_delay */
     if (priv->is_emulation) { rs->rigport.post_write_delay = 0; }
@@ -259,31 +310,41 @@ int kenwood_transaction(RIG *rig, const char *cmdstr, char *data,
     cmdtrm[0] = caps->cmdtrm;
     cmdtrm[1] = '\0';
 
-transaction_write:
-
     if (cmdstr)
     {
         rig_debug(RIG_DEBUG_TRACE, "%s: cmdstr = %s\n", __func__, cmdstr);
 
-        len = strlen(cmdstr);
-
-        cmd = malloc(len + 2);
+        cmd = cmdstr;
+        cmdlen = strlen(cmdstr);
 
-        if (cmd == NULL)
+        /* XXX the if is temporary, until all invocations are fixed */
+        if (cmdstr[cmdlen - 1] != ';' && cmdstr[cmdlen - 1] != '\r')
         {
-            retval = -RIG_ENOMEM;
-            goto transaction_quit;
+            /* append the terminator in the per rig buffer, so that the
+               command still goes out in a single write */
+            if ((size_t) cmdlen >= sizeof(priv->cmd_buf))
+            {
+                rig_debug(RIG_DEBUG_ERR, "%s: command too long '%s'\n",
+                          __func__, cmdstr);
+                retval = -RIG_EINVAL;
+                goto transaction_quit;
+            }
+
+            memcpy(priv->cmd_buf, cmdstr, cmdlen);
+            priv->cmd_buf[cmdlen++] = caps->cmdtrm;
+            cmd = priv->cmd_buf;
         }
+    }
 
-        memcpy(cmd, cmdstr, len);
+    if (!datasize)
+    {
+        verifylen = strlen(priv->verify_cmd);
+    }
 
-        /* XXX the if is temporary, until all invocations are fixed */
-        if (cmdstr[len - 1] != ';' && cmdstr[len - 1] != '\r')
-        {
-            cmd[len] = caps->cmdtrm;
-            len++;
-        }
+transaction_write:
 
+    if (cmdstr)
+    {
         /* flush anything in the read buffer before command is sent */
         if (rs->rigport.type.rig == RIG_PORT_NETWORK
                 || rs->rigport.type.rig == RIG_PORT_UDP_NETWORK)
@@ -295,9 +356,7 @@ transaction_write:
             serial_flush(&rs->rigport);
         }
 
-        retval = write_block(&rs->rigport, cmd, len);
-
-        free(cmd);
+        retval = write_block(&rs->rigport, cmd, cmdlen);
 
         if (retval != RIG_OK)
         {
@@ -307,28 +366,26 @@ transaction_write:
 
     if (!datasize)
     {
-        rig->state.hold_decode = 0;
-
         /* no reply expected so we need to write a command that always
            gives a reply so we can read any error replies from the actual
            command being sent without blocking */
-        if (RIG_OK != (retval = write_block(&rs->rigport, priv->verify_cmd
-                                            , strlen(priv->verify_cmd))))
+        if (RIG_OK != (retval = write_block(&rs->rigport, priv->verify_cmd,
+                                            verifylen)))
         {
             goto transaction_quit;
         }
     }
 
 transaction_read:
-    /* allow one extra byte for terminator we don't return */
-    len = min(datasize ? datasize + 1 : strlen(priv->verify_cmd) + 13,
-              KENWOOD_MAX_BUF_LEN);
-    retval = read_string(&rs->rigport, buffer, len, cmdtrm, strlen(cmdtrm));
+    /* read up to the terminator even when the caller expects less, so
+       that a longer report coming in first is read whole */
+    retval = read_string(&rs->rigport, buffer, sizeof(buffer), cmdtrm, 1);
 
     if (retval < 0)
     {
         if (retry_read++ < rs->rigport.retry)
         {
+            rs->rigport.io_count.retries++;
             goto transaction_write;
         }
 
@@ -336,13 +393,14 @@ transaction_read:
     }
 
     /* Check that command termination is correct */
-    if (strchr(cmdtrm, buffer[strlen(buffer) - 1]) == NULL)
+    if (retval == 0 || buffer[retval - 1] != caps->cmdtrm)
     {
         rig_debug(RIG_DEBUG_ERR, "%s: Command is not correctly terminated '%s'\n",
                   __func__, buffer);
 
         if (retry_read++ < rs->rigport.retry)
         {
+            rs->rigport.io_count.retries++;
             goto transaction_write;
         }
 
@@ -350,7 +408,7 @@ transaction_read:
         goto transaction_quit;
     }
 
-    if (strlen(buffer) == 2)
+    if (retval == 2)
     {
         switch (buffer[0])
         {
@@ -375,6 +433,7 @@ transaction_read:
 
             if (retry_read++ < rs->rigport.retry)
             {
+                rs->rigport.io_count.retries++;
                 goto transaction_write;
             }
 
@@ -392,6 +451,7 @@ transaction_read:
 
             if (retry_read++ < rs->rigport.retry)
             {
+                rs->rigport.io_count.retries++;
                 goto transaction_write;
             }
 
@@ -409,6 +469,7 @@ transaction_read:
 
             if (retry_read++ < rs->rigport.retry)
             {
+                rs->rigport.io_count.retries++;
                 rig_debug(RIG_DEBUG_ERR, "%s: Retrying shortly\n", __func__);
                 usleep(rig->caps->timeout * 1000);
                 goto transaction_read;
@@ -429,16 +490,22 @@ transaction_read:
     {
         if (cmdstr && (buffer[0] != cmdstr[0] || (cmdstr[1] && buffer[1] != cmdstr[1])))
         {
-            /*
-             * TODO: When RIG_TRN is enabled, we can pass the string to
-             * the decoder for callback. That way we don't ignore any
-             * commands.
-             */
+            if (rs->transceive != RIG_TRN_OFF
+                    && reports.seen < KENWOOD_MAX_REPORTS)
+            {
+                /* most likely Auto Information, keep waiting */
+                rig_debug(RIG_DEBUG_TRACE, "%s: report '%s' before reply\n",
+                          __func__, buffer);
+                kenwood_keep_report(&reports, buffer);
+                goto transaction_read;
+            }
+
             rig_debug(RIG_DEBUG_ERR, "%s: wrong reply %c%c for command %c%c\n",
                       __func__, buffer[0], buffer[1], cmdstr[0], cmdstr[1]);
 
             if (retry_read++ < rs->rigport.retry)
             {
+                rs->rigport.io_count.retries++;
                 goto transaction_write;
             }
 
@@ -446,6 +513,22 @@ transaction_read:
             goto transaction_quit;
         }
 
+        if ((size_t)retval > datasize)
+        {
+            /* allow one extra byte for terminator we don't return */
+            rig_debug(RIG_DEBUG_ERR, "%s: reply too long '%s'\n", __func__,
+                      buffer);
+
+            if (retry_read++ < rs->rigport.retry)
+            {
+                rs->rigport.io_count.retries++;
+                goto transaction_write;
+            }
+
+            retval = -RIG_EPROTO;
+            goto transaction_quit;
+        }
+
         if (retval > 0)
         {
             /* move the result excluding the command terminator into the
@@ -460,17 +543,22 @@ transaction_read:
         if (priv->verify_cmd[0] != buffer[0]
                 || (priv->verify_cmd[1] && priv->verify_cmd[1] != buffer[1]))
         {
-            /*
-             * TODO: When RIG_TRN is enabled, we can pass the string to
-             * the decoder for callback. That way we don't ignore any
-             * commands.
-             */
+            if (rs->transceive != RIG_TRN_OFF
+                    && reports.seen < KENWOOD_MAX_REPORTS)
+            {
+                rig_debug(RIG_DEBUG_TRACE, "%s: report '%s' before reply\n",
+                          __func__, buffer);
+                kenwood_keep_report(&reports, buffer);
+                goto transaction_read;
+            }
+
             rig_debug(RIG_DEBUG_ERR, "%s: wrong reply %c%c for command verification %c%c\n",
                       __func__, buffer[0], buffer[1]
                       , priv->verify_cmd[0], priv->verify_cmd[1]);
 
             if (retry_read++ < rs->rigport.retry)
             {
+                rs->rigport.io_count.retries++;
                 goto transaction_write;
             }
 
@@ -483,7 +571,13 @@ transaction_read:
 
 transaction_quit:
 
-    rs->hold_decode = 0;
+    Unhold_Decode(rig);
+
+    if (reports.count)
+    {
+        kenwood_decode_reports(rig, &reports);
+    }
+
     return retval;
 }
 
@@ -527,6 +621,11 @@ int kenwood_safe_transaction(RIG *rig, const char *cmd, char *buf,
 
     do
     {
+        if (retry > 0)
+        {
+            rig->state.rigport.io_count.retries++;
+        }
+
         err = kenwood_transaction(rig, cmd, buf, buf_size);
 
         if (err != RIG_OK)        /* return immediately on error as any
@@ -2352,9 +2451,9 @@ int kenwood_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
 
         sscanf(lvlbuf + len, "%d", &val->i); /* rawstr */
 
-        if (rig->caps->str_cal.size)
+        if (rig->state.str_cal.size)
         {
-            val->i = (int) rig_raw2val(val->i, &rig->caps->str_cal);
+            val->i = (int) rig_raw2val_meter(rig, RIG_CAL_STR, val->i);
         }
         else
         {
@@ -3496,6 +3595,118 @@ int kenwood_get_trn(RIG *rig, int *trn)
     return RIG_OK;
 }
 
+/*
+ * kenwood_decode_event
+ * Reads one Auto Information report sent by the rig and decodes it.
+ */
+int kenwood_decode_event(RIG *rig)
+{
+    struct kenwood_priv_caps *caps = kenwood_caps(rig);
+    char buf[KENWOOD_MAX_BUF_LEN];
+    char cmdtrm[2];
+    int retval;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    cmdtrm[0] = caps->cmdtrm;
+    cmdtrm[1] = '\0';
+
+    retval = read_string(&rig->state.rigport, buf, sizeof(buf), cmdtrm, 1);
+
+    if (retval < 0)
+    {
+        return retval;
+    }
+
+    if (retval == 0 || buf[retval - 1] != caps->cmdtrm)
+    {
+        return -RIG_EPROTO;
+    }
+
+    return kenwood_decode_report(rig, buf);
+}
+
+/*
+ * kenwood_decode_report
+ * Calls the callbacks matching an Auto Information report, terminator
+ * included, whether read by kenwood_decode_event() or found by
+ * kenwood_transaction() while waiting for a reply.
+ */
+int kenwood_decode_report(RIG *rig, const char *report)
+{
+    struct kenwood_priv_caps *caps = kenwood_caps(rig);
+    size_t len = strlen(report);
+    freq_t freq;
+    rmode_t mode;
+
+    rig_debug(RIG_DEBUG_TRACE, "%s: '%s'\n", __func__, report);
+
+    if ((report[0] == 'F' && (report[1] == 'A' || report[1] == 'B'))
+            && len >= 14)
+    {
+        if (!rig->callbacks.freq_event)
+        {
+            return -RIG_ENAVAIL;
+        }
+
+        sscanf(report + 2, "%"SCNfreq, &freq);
+
+        return rig->callbacks.freq_event(rig,
+                                         report[1] == 'A' ? RIG_VFO_A : RIG_VFO_B,
+                                         freq, rig->callbacks.freq_arg);
+    }
+
+    if (!strncmp(report, "MD", 2) && len >= 4)
+    {
+        if (!rig->callbacks.mode_event)
+        {
+            return -RIG_ENAVAIL;
+        }
+
+        mode = kenwood2rmode(report[2] - '0', caps->mode_table);
+
+        return rig->callbacks.mode_event(rig, RIG_VFO_CURR, mode,
+                                         rig_passband_normal(rig, mode),
+                                         rig->callbacks.mode_arg);
+    }
+
+    if (!strncmp(report, "IF", 2) && len >= 38)
+    {
+        if (rig->callbacks.freq_event)
+        {
+            char freqbuf[12];
+
+            memcpy(freqbuf, report + 2, 11);
+            freqbuf[11] = '\0';
+            sscanf(freqbuf, "%"SCNfreq, &freq);
+            rig->callbacks.freq_event(rig, RIG_VFO_CURR, freq,
+                                      rig->callbacks.freq_arg);
+        }
+
+        if (rig->callbacks.mode_event)
+        {
+            mode = kenwood2rmode(report[29] - '0', caps->mode_table);
+            rig->callbacks.mode_event(rig, RIG_VFO_CURR, mode,
+                                      rig_passband_normal(rig, mode),
+                                      rig->callbacks.mode_arg);
+        }
+
+        if (rig->callbacks.ptt_event)
+        {
+            rig->callbacks.ptt_event(rig, RIG_VFO_CURR,
+                                     report[28] == '1' ? RIG_PTT_ON : RIG_PTT_OFF,
+                                     rig->callbacks.ptt_arg);
+        }
+
+        return RIG_OK;
+    }
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: unsupported report '%s'\n", __func__,
+              report);
+
+    return -RIG_ENIMPL;
+}
+
 /*
  * kenwood_set_powerstat
  */
@@ -3891,36 +4102,24 @@ int kenwood_get_mem_if(RIG *rig, vfo_t vfo, int *ch)
     return RIG_OK;
 }
 
-int kenwood_get_channel(RIG *rig, channel_t *chan)
+static char kenwood_mem_bank(RIG *rig, const channel_t *chan)
 {
-    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
-
-    if (!rig || !chan)
-    {
-        return -RIG_EINVAL;
-    }
-
-    int err;
-    char buf[26];
-    char cmd[8];
-    struct kenwood_priv_caps *caps = kenwood_caps(rig);
-
-    /* put channel num in the command string */
-    char bank = ' ';
-
     if (rig->caps->rig_model == RIG_MODEL_TS940)
     {
-        bank = '0' + chan->bank_num;
+        return '0' + chan->bank_num;
     }
 
-    snprintf(cmd, sizeof(cmd), "MR0%c%02d", bank, chan->channel_num);
+    return ' ';
+}
 
-    err = kenwood_safe_transaction(rig, cmd, buf, 26, 23);
 
-    if (err != RIG_OK)
-    {
-        return err;
-    }
+/*
+ * Parses a MR0 reply, without its terminator, into chan.
+ * Returns -RIG_ENAVAIL when the channel is empty.
+ */
+static int kenwood_parse_mr0(RIG *rig, channel_t *chan, char *buf)
+{
+    struct kenwood_priv_caps *caps = kenwood_caps(rig);
 
     memset(chan, 0x00, sizeof(channel_t));
 
@@ -3975,14 +4174,14 @@ int kenwood_get_channel(RIG *rig, channel_t *chan)
         chan->bank_num = buf[3] - '0';
     }
 
-    /* split freq */
-    cmd[2] = '1';
-    err = kenwood_safe_transaction(rig, cmd, buf, 26, 23);
+    return RIG_OK;
+}
 
-    if (err != RIG_OK)
-    {
-        return err;
-    }
+
+/* Parses the split part of a channel from a MR1 reply */
+static void kenwood_parse_mr1(RIG *rig, channel_t *chan, char *buf)
+{
+    struct kenwood_priv_caps *caps = kenwood_caps(rig);
 
     chan->tx_mode = kenwood2rmode(buf[17] - '0', caps->mode_table);
 
@@ -3999,27 +4198,246 @@ int kenwood_get_channel(RIG *rig, channel_t *chan)
     {
         chan->split = RIG_SPLIT_ON;
     }
+}
+
+
+int kenwood_get_channel(RIG *rig, channel_t *chan)
+{
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (!rig || !chan)
+    {
+        return -RIG_EINVAL;
+    }
+
+    int err;
+    char buf[26];
+    char cmd[8];
+
+    /* put channel num in the command string */
+    snprintf(cmd, sizeof(cmd), "MR0%c%02d", kenwood_mem_bank(rig, chan),
+             chan->channel_num);
+
+    err = kenwood_safe_transaction(rig, cmd, buf, 26, 23);
+
+    if (err != RIG_OK)
+    {
+        return err;
+    }
+
+    err = kenwood_parse_mr0(rig, chan, buf);
+
+    if (err != RIG_OK)
+    {
+        return err;
+    }
+
+    /* split freq */
+    cmd[2] = '1';
+    err = kenwood_safe_transaction(rig, cmd, buf, 26, 23);
+
+    if (err != RIG_OK)
+    {
+        return err;
+    }
+
+    kenwood_parse_mr1(rig, chan, buf);
 
     return RIG_OK;
 }
 
-int kenwood_set_channel(RIG *rig, const channel_t *chan)
+
+/*
+ * Reads n channels with all their MR0 and MR1 commands sent in a single
+ * write, so that the rig is not waited on once per command. Any reply
+ * out of place fails the whole burst.
+ */
+static int kenwood_get_channel_burst(RIG *rig, channel_t chans[], int n)
+{
+    struct kenwood_priv_caps *caps = kenwood_caps(rig);
+    struct rig_state *rs = &rig->state;
+    struct kenwood_reports reports;
+    char cmd[KENWOOD_MEM_BURST * 14 + 1];
+    char mr0[KENWOOD_MAX_BUF_LEN];
+    char buf[KENWOOD_MAX_BUF_LEN];
+    char cmdtrm[2];
+    int i, len = 0;
+    int retval;
+
+    cmdtrm[0] = caps->cmdtrm;
+    cmdtrm[1] = '\0';
+
+    for (i = 0; i < n; i++)
+    {
+        char bank = kenwood_mem_bank(rig, &chans[i]);
+
+        len += snprintf(cmd + len, sizeof(cmd) - len,
+                        "MR0%c%02d%cMR1%c%02d%c",
+                        bank, chans[i].channel_num, caps->cmdtrm,
+                        bank, chans[i].channel_num, caps->cmdtrm);
+    }
+
+    reports.count = reports.seen = 0;
+    Hold_Decode(rig);
+
+    if (rs->rigport.type.rig == RIG_PORT_NETWORK
+            || rs->rigport.type.rig == RIG_PORT_UDP_NETWORK)
+    {
+        network_flush(&rs->rigport);
+    }
+    else
+    {
+        serial_flush(&rs->rigport);
+    }
+
+    retval = write_block(&rs->rigport, cmd, len);
+
+    /* two replies per channel, MR0 then MR1 */
+    for (i = 0; retval == RIG_OK && i < 2 * n;)
+    {
+        retval = read_string(&rs->rigport, buf, sizeof(buf), cmdtrm, 1);
+
+        if (retval < 0)
+        {
+            break;
+        }
+
+        if (retval == 0 || buf[retval - 1] != caps->cmdtrm)
+        {
+            retval = -RIG_EPROTO;
+            break;
+        }
+
+        buf[--retval] = '\0';
+
+        if (buf[0] != 'M' || buf[1] != 'R')
+        {
+            if (buf[0] == '?' || rs->transceive == RIG_TRN_OFF
+                    || reports.seen >= KENWOOD_MAX_REPORTS)
+            {
+                retval = -RIG_EPROTO;
+                break;
+            }
+
+            kenwood_keep_report(&reports, buf);
+            retval = RIG_OK;
+            continue;
+        }
+
+        if (retval != 23 || buf[2] != '0' + (i & 1))
+        {
+            rig_debug(RIG_DEBUG_ERR, "%s: unexpected reply '%s'\n", __func__,
+                      buf);
+            retval = -RIG_EPROTO;
+            break;
+        }
+
+        retval = RIG_OK;
+
+        if (!(i & 1))
+        {
+            strcpy(mr0, buf);
+        }
+        else if (kenwood_parse_mr0(rig, &chans[i / 2], mr0) == RIG_OK)
+        {
+            kenwood_parse_mr1(rig, &chans[i / 2], buf);
+        }
+
+        i++;
+    }
+
+    if (retval != RIG_OK)
+    {
+        /* let the rest of the burst go by, so that it is not taken for
+           the replies of the next commands */
+        for (i = 0; i < 2 * n
+                && read_string(&rs->rigport, buf, sizeof(buf), cmdtrm, 1) > 0;
+                i++)
+        {
+        }
+    }
+
+    Unhold_Decode(rig);
+
+    if (reports.count)
+    {
+        kenwood_decode_reports(rig, &reports);
+    }
+
+    return retval;
+}
+
+
+/*
+ * Reads channels KENWOOD_MEM_BURST at a time. Rigs which cannot take
+ * a burst are read one channel at a time from then on.
+ * Empty channels are returned with freq set to RIG_FREQ_NONE.
+ */
+int kenwood_get_channels(RIG *rig, channel_t chans[], int count)
 {
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
-    if (!rig || !chan)
+    if (!rig || !chans)
     {
         return -RIG_EINVAL;
     }
 
-    char buf[128];
-    char mode, tx_mode = 0;
+    struct kenwood_priv_data *priv = rig->state.priv;
+    int i, k, n;
     int err;
-    int tone = 0;
 
+    for (i = 0; i < count; i += n)
+    {
+        n = count - i < KENWOOD_MEM_BURST ? count - i : KENWOOD_MEM_BURST;
+
+        if (!priv->no_mem_burst)
+        {
+            err = kenwood_get_channel_burst(rig, &chans[i], n);
+
+            if (err == RIG_OK)
+            {
+                continue;
+            }
+
+            rig_debug(RIG_DEBUG_WARN, "%s: burst read failed (%s), "
+                      "reading one channel at a time\n", __func__,
+                      rigerror(err));
+            priv->no_mem_burst = 1;
+        }
+
+        for (k = i; k < i + n; k++)
+        {
+            err = kenwood_get_channel(rig, &chans[k]);
+
+            if (err == -RIG_ENAVAIL)
+            {
+                chans[k].freq = RIG_FREQ_NONE;
+            }
+            else if (err != RIG_OK)
+            {
+                return err;
+            }
+        }
+    }
+
+    return RIG_OK;
+}
+
+
+/*
+ * Formats the MW0 command storing chan, or MW1 with its split part when
+ * tx is set, with its terminator appended. Returns the length written.
+ */
+static int kenwood_format_mw(RIG *rig, const channel_t *chan, int tx,
+                             char *buf, size_t buf_size)
+{
     struct kenwood_priv_caps *caps = kenwood_caps(rig);
+    char mode, tx_mode = 0;
+    int tone = 0;
 
-    mode = rmode2kenwood(chan->mode, caps->mode_table);
+    /* an empty channel is stored with all its fields zeroed */
+    mode = chan->freq == RIG_FREQ_NONE ? 0 :
+           rmode2kenwood(chan->mode, caps->mode_table);
 
     if (mode < 0)
     {
@@ -4059,23 +4477,51 @@ int kenwood_set_channel(RIG *rig, const channel_t *chan)
         }
     }
 
-    char bank = ' ';
+    if (!tx)
+    {
+        return snprintf(buf, buf_size,
+                        "MW0%c%02d%011"PRIll"%c%c%c%02d %c", /* note the
+                                                    space at the end */
+                        kenwood_mem_bank(rig, chan),
+                        chan->channel_num,
+                        (int64_t)chan->freq,
+                        '0' + mode,
+                        (chan->flags & RIG_CHFLAG_SKIP) ? '1' : '0',
+                        chan->ctcss_tone ? '1' : '0',
+                        chan->ctcss_tone ? (tone + 1) : 0,
+                        caps->cmdtrm);
+    }
+
+    return snprintf(buf, buf_size, "MW1%c%02d%011"PRIll"%c%c%c%02d %c",
+                    kenwood_mem_bank(rig, chan),
+                    chan->channel_num,
+                    (int64_t)(chan->split == RIG_SPLIT_ON ? chan->tx_freq : 0),
+                    (chan->split == RIG_SPLIT_ON) ? ('0' + tx_mode) : '0',
+                    (chan->flags & RIG_CHFLAG_SKIP) ? '1' : '0',
+                    chan->ctcss_tone ? '1' : '0',
+                    chan->ctcss_tone ? (tone + 1) : 0,
+                    caps->cmdtrm);
+}
+
 
-    if (rig->caps->rig_model == RIG_MODEL_TS940)
+int kenwood_set_channel(RIG *rig, const channel_t *chan)
+{
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (!rig || !chan)
     {
-        bank = '0' + chan->bank_num;
+        return -RIG_EINVAL;
     }
 
-    snprintf(buf, sizeof(buf),
-             "MW0%c%02d%011"PRIll"%c%c%c%02d ", /* note the space at
-                                                     the end */
-             bank,
-             chan->channel_num,
-             (int64_t)chan->freq,
-             '0' + mode,
-             (chan->flags & RIG_CHFLAG_SKIP) ? '1' : '0',
-             chan->ctcss_tone ? '1' : '0',
-             chan->ctcss_tone ? (tone + 1) : 0);
+    char buf[128];
+    int err;
+
+    err = kenwood_format_mw(rig, chan, 0, buf, sizeof(buf));
+
+    if (err < 0)
+    {
+        return err;
+    }
 
     err = kenwood_transaction(rig, buf, NULL, 0);
 
@@ -4084,18 +4530,71 @@ int kenwood_set_channel(RIG *rig, const channel_t *chan)
         return err;
     }
 
-    snprintf(buf, sizeof(buf), "MW1%c%02d%011"PRIll"%c%c%c%02d ",
-             bank,
-             chan->channel_num,
-             (int64_t)(chan->split == RIG_SPLIT_ON ? chan->tx_freq : 0),
-             (chan->split == RIG_SPLIT_ON) ? ('0' + tx_mode) : '0',
-             (chan->flags & RIG_CHFLAG_SKIP) ? '1' : '0',
-             chan->ctcss_tone ? '1' : '0',
-             chan->ctcss_tone ? (tone + 1) : 0);
+    kenwood_format_mw(rig, chan, 1, buf, sizeof(buf));
 
     return kenwood_transaction(rig, buf, NULL, 0);
 }
 
+
+/*
+ * Writes channels KENWOOD_MEM_BURST at a time, with their MW commands
+ * sent in one write and verified once. A burst the rig did not take is
+ * written again one channel at a time.
+ */
+int kenwood_set_channels(RIG *rig, const channel_t chans[], int count)
+{
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (!rig || !chans)
+    {
+        return -RIG_EINVAL;
+    }
+
+    char buf[KENWOOD_MEM_BURST * 64];
+    int i, k, n, len;
+    int err;
+
+    for (i = 0; i < count; i += n)
+    {
+        n = count - i < KENWOOD_MEM_BURST ? count - i : KENWOOD_MEM_BURST;
+
+        for (k = 2 * i, len = 0; k < 2 * (i + n); k++)
+        {
+            err = kenwood_format_mw(rig, &chans[k / 2], k & 1, buf + len,
+                                    sizeof(buf) - len);
+
+            if (err < 0)
+            {
+                return err;
+            }
+
+            len += err;
+        }
+
+        err = kenwood_transaction(rig, buf, NULL, 0);
+
+        if (err == RIG_OK)
+        {
+            continue;
+        }
+
+        rig_debug(RIG_DEBUG_WARN, "%s: burst write failed (%s), "
+                  "writing one channel at a time\n", __func__, rigerror(err));
+
+        for (k = i; k < i + n; k++)
+        {
+            err = kenwood_set_channel(rig, &chans[k]);
+
+            if (err != RIG_OK)
+            {
+                return err;
+            }
+        }
+    }
+
+    return RIG_OK;
+}
+
 int kenwood_set_ext_parm(RIG *rig, token_t token, value_t val)
 {
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
@@ -34,6 +34,9 @@
 
 #define KENWOOD_MODE_TABLE_MAX  24
 #define KENWOOD_MAX_BUF_LEN   128 /* max answer len, arbitrary */
+#define KENWOOD_MAX_REPORTS   8   /* reports kept during a transaction */
+#define KENWOOD_REPORT_LEN    64  /* longest report kept, IF is 38 */
+#define KENWOOD_MEM_BURST     8   /* channels per MR/MW burst */
 
 
 /* Tokens for Parameters common to multiple rigs.
@@ -84,6 +87,8 @@ struct kenwood_priv_data
     int is_emulation;     /* flag for TS-2000 emulations */
     void *data;           /* model specific data */
     rmode_t curr_mode;     /* used for is_emulation to avoid get_mode on VFOB */
+    char cmd_buf[KENWOOD_MAX_BUF_LEN]; /* command plus terminator to send */
+    int no_mem_burst;     /* MR bursts failed, read one channel at a time */
 };
 
 
@@ -99,6 +104,9 @@ int kenwood_transaction(RIG *rig, const char *cmd, char *data, size_t data_len);
 int kenwood_safe_transaction(RIG *rig, const char *cmd, char *buf,
                              size_t buf_size, size_t expected);
 
+int kenwood_decode_event(RIG *rig);
+int kenwood_decode_report(RIG *rig, const char *report);
+
 rmode_t kenwood2rmode(unsigned char mode, const rmode_t mode_table[]);
 char rmode2kenwood(rmode_t mode, const rmode_t mode_table[]);
 
@@ -154,6 +162,8 @@ int kenwood_get_mem(RIG *rig, vfo_t vfo, int *ch);
 int kenwood_get_mem_if(RIG *rig, vfo_t vfo, int *ch);
 int kenwood_get_channel(RIG *rig, channel_t *chan);
 int kenwood_set_channel(RIG *rig, const channel_t *chan);
+int kenwood_get_channels(RIG *rig, channel_t chans[], int count);
+int kenwood_set_channels(RIG *rig, const channel_t chans[], int count);
 int kenwood_scan(RIG *rig, vfo_t vfo, scan_t scan, int ch);
 const char *kenwood_get_info(RIG *rig);
 int kenwood_get_id(RIG *rig, char *buf);
@@ -317,6 +317,7 @@ const struct rig_caps ts2000_caps =
     .get_channel = ts2000_get_channel,
     .set_channel = ts2000_set_channel,
     .set_trn =  kenwood_set_trn,
+    .decode_event =  kenwood_decode_event,
     .get_trn =  kenwood_get_trn,
     .set_powerstat =  kenwood_set_powerstat,
     .get_powerstat =  kenwood_get_powerstat,
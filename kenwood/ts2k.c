@@ -154,7 +154,7 @@ const int ts2k_ctcss_list[] =
 };
 
 #define cmd_trm(rig) ((struct ts2k_priv_caps *)(rig)->caps->priv)->cmdtrm
-#define ta_quit rs->hold_decode = 0; return retval
+#define ta_quit Unhold_Decode(rig); return retval
 
 /**
  * kenwood_transaction
@@ -193,7 +193,7 @@ ts2k_transaction(RIG *rig, const char *cmdstr, int cmd_len,
 #define MAX_RETRY_READ 5
 
     rs = &rig->state;
-    rs->hold_decode = 1;
+    Hold_Decode(rig);
 
     serial_flush(&rs->rigport);
 
@@ -222,7 +222,7 @@ ts2k_transaction(RIG *rig, const char *cmdstr, int cmd_len,
 
     if (data == NULL || datasize <= 0)
     {
-        rig->state.hold_decode = 0;
+        Unhold_Decode(rig);
         return RIG_OK;  /* don't want a reply */
     }
 
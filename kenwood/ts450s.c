@@ -259,11 +259,14 @@ const struct rig_caps ts450s_caps =
     .set_mem = kenwood_set_mem,
     .get_mem = kenwood_get_mem_if,
     .set_trn = kenwood_set_trn,
+    .decode_event = kenwood_decode_event,
     .get_trn = kenwood_get_trn,
     .set_powerstat = kenwood_set_powerstat,
     .get_powerstat = kenwood_get_powerstat,
     .reset = kenwood_reset,
     .scan = kenwood_scan,
     .get_channel = kenwood_get_channel,
+    .get_channels = kenwood_get_channels,
     .set_channel = kenwood_set_channel,
+    .set_channels = kenwood_set_channels,
 };
@@ -202,6 +202,7 @@ const struct rig_caps ts50s_caps =
     .set_mem =  kenwood_set_mem,
     .get_mem =  kenwood_get_mem,
     .set_trn =  kenwood_set_trn,
+    .decode_event =  kenwood_decode_event,
     .get_trn =  kenwood_get_trn,
     .set_powerstat =  kenwood_set_powerstat,
     .get_powerstat =  kenwood_get_powerstat,
@@ -1092,8 +1092,10 @@ const struct rig_caps ts570s_caps =
     .set_mem =  kenwood_set_mem,
     .get_mem =  kenwood_get_mem,
     .get_channel = kenwood_get_channel,
+    .get_channels = kenwood_get_channels,
     .set_channel = ts570_set_channel,
     .set_trn =  kenwood_set_trn,
+    .decode_event =  kenwood_decode_event,
     .get_trn =  kenwood_get_trn,
     .set_powerstat =  kenwood_set_powerstat,
     .get_powerstat =  kenwood_get_powerstat,
@@ -1278,8 +1280,10 @@ const struct rig_caps ts570d_caps =
     .set_mem =  kenwood_set_mem,
     .get_mem =  kenwood_get_mem,
     .get_channel = kenwood_get_channel,
+    .get_channels = kenwood_get_channels,
     .set_channel = ts570_set_channel,
     .set_trn =  kenwood_set_trn,
+    .decode_event =  kenwood_decode_event,
     .get_trn =  kenwood_get_trn,
     .set_powerstat =  kenwood_set_powerstat,
     .get_powerstat =  kenwood_get_powerstat,
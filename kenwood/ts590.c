@@ -244,12 +244,15 @@ const struct rig_caps ts590_caps =
     .get_ctcss_tone =  kenwood_get_ctcss_tone,
     .ctcss_list =  kenwood38_ctcss_list,
     .set_trn =  kenwood_set_trn,
+    .decode_event =  kenwood_decode_event,
     .get_trn =  kenwood_get_trn,
     .send_morse =  kenwood_send_morse,
     .set_mem =  kenwood_set_mem,
     .get_mem =  kenwood_get_mem,
     .set_channel =  kenwood_set_channel,
+    .set_channels = kenwood_set_channels,
     .get_channel =  kenwood_get_channel,
+    .get_channels = kenwood_get_channels,
     .vfo_ops = TS590_VFO_OPS,
     .vfo_op =  kenwood_vfo_op,
 };
@@ -413,12 +416,15 @@ const struct rig_caps ts590sg_caps =
     .get_ctcss_tone =  kenwood_get_ctcss_tone,
     .ctcss_list =  kenwood38_ctcss_list,
     .set_trn =  kenwood_set_trn,
+    .decode_event =  kenwood_decode_event,
     .get_trn =  kenwood_get_trn,
     .send_morse =  kenwood_send_morse,
     .set_mem =  kenwood_set_mem,
     .get_mem =  kenwood_get_mem,
     .set_channel =  kenwood_set_channel,
+    .set_channels = kenwood_set_channels,
     .get_channel =  kenwood_get_channel,
+    .get_channels = kenwood_get_channels,
     .vfo_ops = TS590_VFO_OPS,
     .vfo_op =  kenwood_vfo_op,
 };
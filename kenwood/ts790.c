@@ -209,8 +209,11 @@ const struct rig_caps ts790_caps =
     .set_mem =  kenwood_set_mem,
     .get_mem =  kenwood_get_mem,
     .set_channel = kenwood_set_channel,
+    .set_channels = kenwood_set_channels,
     .get_channel = kenwood_get_channel,
+    .get_channels = kenwood_get_channels,
     .set_trn =  kenwood_set_trn,
+    .decode_event =  kenwood_decode_event,
     .get_trn =  kenwood_get_trn,
     .get_info =  kenwood_get_info,
 
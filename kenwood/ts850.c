@@ -244,8 +244,10 @@ const struct rig_caps ts850_caps =
     .set_mem =  kenwood_set_mem,
     .get_mem =  kenwood_get_mem_if,
     .get_channel = kenwood_get_channel,
+    .get_channels = kenwood_get_channels,
     .set_channel = ts850_set_channel,
-    .set_trn =  kenwood_set_trn
+    .set_trn =  kenwood_set_trn,
+    .decode_event =  kenwood_decode_event
 };
 
 /*
@@ -188,7 +188,9 @@ const struct rig_caps ts940_caps =
     .set_trn =  kenwood_set_trn,
     .scan =  kenwood_scan,
     .set_channel = kenwood_set_channel,
+    .set_channels = kenwood_set_channels,
     .get_channel = kenwood_get_channel,
+    .get_channels = kenwood_get_channels,
     /* .decode_event = ic10_decode_event, */
 
 };
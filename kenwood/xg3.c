@@ -51,6 +51,9 @@
 
 struct xg3_priv_data
 {
+    /* must come first, kenwood_transaction() uses it */
+    struct kenwood_priv_data kenwood;
+
     /* current vfo already in rig_state ? */
     vfo_t curr_vfo;
     vfo_t last_vfo;
@@ -183,6 +186,10 @@ int xg3_init(RIG *rig)
         return -RIG_ENOMEM;
     }
 
+    memset(&priv->kenwood, 0, sizeof(priv->kenwood));
+    strcpy(priv->kenwood.verify_cmd, ";");
+    priv->kenwood.trn_state = -1;
+
     rig->state.priv = (void *)priv;
     rig->state.rigport.type.rig = RIG_PORT_SERIAL;
 // Tried set_trn to turn transceiver on/off but turning it on isn't enabled in hamlib for some reason
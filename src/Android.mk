@@ -24,7 +24,10 @@ LOCAL_SRC_FILES := \
         usb_port.c \
         debug.c \
         network.c \
-        cm108.c
+        cm108.c \
+        cache.c \
+        registry.c \
+        async.c
 
 
 LOCAL_MODULE := libhamlib
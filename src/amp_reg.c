@@ -41,6 +41,7 @@
 #include <hamlib/amplifier.h>
 
 #include "register.h"
+#include "registry.h"
 
 #ifndef PATH_MAX
 # define PATH_MAX       1024
@@ -83,6 +84,7 @@ static struct
     const char *be_name;
     int (*be_init)(void *);
     amp_model_t (*be_probe)(hamlib_port_t *);
+    int be_loaded;
 } amp_backend_list[AMP_BACKEND_MAX] =
 {
     { AMP_DUMMY, AMP_BACKEND_DUMMY, AMP_FUNCNAMA(dummy) },
@@ -100,38 +102,16 @@ static struct
 
 
 /*
- * This struct to keep track of known amp models.
- * It is chained, and used in a hash table, see below.
+ * The known amp models, see registry.h
  */
-struct amp_list
-{
-    const struct amp_caps *caps;
-    struct amp_list *next;
-};
-
-
-#define AMPLSTHASHSZ 16
-#define HASH_FUNC(a) ((a)%AMPLSTHASHSZ)
+static struct registry amp_registry = REGISTRY_INITIALIZER;
 
 
 /*
- * The amp_hash_table is a hash table pointing to a list of next==NULL
- *  terminated caps.
- */
-static struct amp_list *amp_hash_table[AMPLSTHASHSZ] = { NULL, };
-
-
-static int amp_lookup_backend(amp_model_t amp_model);
-
-
-/*
- * Basically, this is a hash insert function that doesn't check for dup!
+ * Adds caps to the registry, refusing a model that is already there.
  */
 int HAMLIB_API amp_register(const struct amp_caps *caps)
 {
-    int hval;
-    struct amp_list *p;
-
     if (!caps)
     {
         return -RIG_EINVAL;
@@ -139,49 +119,46 @@ int HAMLIB_API amp_register(const struct amp_caps *caps)
 
     amp_debug(RIG_DEBUG_VERBOSE, "amp_register (%d)\n", caps->amp_model);
 
-#ifndef DONT_WANT_DUP_CHECK
-
-    if (amp_get_caps(caps->amp_model) != NULL)
-    {
-        return -RIG_EINVAL;
-    }
-
-#endif
-
-    p = (struct amp_list *)malloc(sizeof(struct amp_list));
-
-    if (!p)
-    {
-        return -RIG_ENOMEM;
-    }
-
-    hval = HASH_FUNC(caps->amp_model);
-    p->caps = caps;
-    // p->handle = NULL;
-    p->next = amp_hash_table[hval];
-    amp_hash_table[hval] = p;
-
-    return RIG_OK;
+    return registry_add(&amp_registry, caps->amp_model, caps->mfg_name,
+                        caps->model_name, caps);
 }
 
 
 /*
  * Get amp capabilities.
- * i.e. amp_hash_table lookup
+ * i.e. amp_registry lookup
  */
 const struct amp_caps *HAMLIB_API amp_get_caps(amp_model_t amp_model)
 {
-    struct amp_list *p;
+    return registry_get(&amp_registry, amp_model);
+}
+
+
+/**
+ * \brief look an amplifier model up by name
+ * \param mfg_name   The manufacturer name
+ * \param model_name The model name
+ *
+ * The names are matched without regard to case. Backends that have not
+ * been loaded yet are loaded on the first miss.
+ *
+ * \return the model number, or AMP_MODEL_NONE if there is no such
+ * amplifier.
+ */
+amp_model_t HAMLIB_API amp_get_model_by_name(const char *mfg_name,
+        const char *model_name)
+{
+    const struct amp_caps *caps;
 
-    for (p = amp_hash_table[HASH_FUNC(amp_model)]; p; p = p->next)
+    caps = registry_find(&amp_registry, mfg_name, model_name);
+
+    if (!caps)
     {
-        if (p->caps->amp_model == amp_model)
-        {
-            return p->caps;
-        }
+        amp_load_all_backends();
+        caps = registry_find(&amp_registry, mfg_name, model_name);
     }
 
-    return NULL;    /* sorry, caps not registered! */
+    return caps ? caps->amp_model : AMP_MODEL_NONE;
 }
 
 
@@ -251,59 +228,32 @@ int HAMLIB_API amp_check_backend(amp_model_t amp_model)
 
 int HAMLIB_API amp_unregister(amp_model_t amp_model)
 {
-    int hval;
-    struct amp_list *p, *q;
-
-    hval = HASH_FUNC(amp_model);
-    q = NULL;
-
-    for (p = amp_hash_table[hval]; p; p = p->next)
-    {
-        if (p->caps->amp_model == amp_model)
-        {
-            if (q == NULL)
-            {
-                amp_hash_table[hval] = p->next;
-            }
-            else
-            {
-                q->next = p->next;
-            }
-
-            free(p);
-            return RIG_OK;
-        }
-
-        q = p;
-    }
-
-    return -RIG_EINVAL; /* sorry, caps not registered! */
+    return registry_remove(&amp_registry, amp_model);
 }
 
 
 /*
  * amp_list_foreach
- * executes cfunc on all the elements stored in the amp hash list
+ * executes cfunc on all the elements stored in the amp registry
  */
 int HAMLIB_API amp_list_foreach(int (*cfunc)(const struct amp_caps *,
                                 rig_ptr_t),
                                 rig_ptr_t data)
 {
-    struct amp_list *p;
-    int i;
+    const struct amp_caps *caps;
+    unsigned iter = 0;
 
     if (!cfunc)
     {
         return -RIG_EINVAL;
     }
 
-    for (i = 0; i < AMPLSTHASHSZ; i++)
+    while ((caps = registry_next(&amp_registry, &iter)))
     {
-        for (p = amp_hash_table[i]; p; p = p->next)
-            if ((*cfunc)(p->caps, data) == 0)
-            {
-                return RIG_OK;
-            }
+        if ((*cfunc)(caps, data) == 0)
+        {
+            return RIG_OK;
+        }
     }
 
     return RIG_OK;
@@ -363,6 +313,12 @@ int HAMLIB_API amp_load_backend(const char *be_name)
     {
         if (!strcmp(be_name, amp_backend_list[i].be_name))
         {
+            /* each backend registers its models only once */
+            if (amp_backend_list[i].be_loaded)
+            {
+                return RIG_OK;
+            }
+
             be_init = amp_backend_list[i].be_init;
 
             if (be_init == NULL)
@@ -372,6 +328,12 @@ int HAMLIB_API amp_load_backend(const char *be_name)
             }
 
             status = (*be_init)(NULL);
+
+            if (status == RIG_OK)
+            {
+                amp_backend_list[i].be_loaded = 1;
+            }
+
             return status;
         }
     }
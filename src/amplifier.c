@@ -637,6 +637,48 @@ int HAMLIB_API amp_get_level(AMP *amp, setting_t level, value_t *val)
     return amp->caps->get_level(amp, level, val);
 }
 
+/**
+ * \brief read several levels in one go
+ * \param amp   The amp handle
+ * \param req   The levels to read
+ * \param count The number of levels in \a req
+ *
+ *  Reads the levels of \a req, each with its own status, so that one
+ *  level which cannot be read does not fail the others.  Backends which
+ *  can fetch their telemetry in one exchange do so, see the get_levels
+ *  caps hook; the others are asked for each level in turn.
+ *
+ * \return RIG_OK if the batch could be run, in which case the outcome
+ * of each read is in its status, otherwise a negative value if an
+ * error occured (the status fields are then undefined).
+ *
+ * \sa amp_get_level()
+ */
+int HAMLIB_API amp_get_levels(AMP *amp, struct amp_level_value *req,
+                              int count)
+{
+    int i;
+
+    amp_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (CHECK_AMP_ARG(amp) || !req || count < 0)
+    {
+        return -RIG_EINVAL;
+    }
+
+    if (amp->caps->get_levels)
+    {
+        return amp->caps->get_levels(amp, req, count);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        req[i].status = amp_get_level(amp, req[i].level, &req[i].val);
+    }
+
+    return RIG_OK;
+}
+
 int HAMLIB_API amp_get_ext_level(AMP *amp, token_t level, value_t *val)
 {
     amp_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
@@ -0,0 +1,1000 @@
+/*
+ *  Hamlib Interface - asynchronous requests
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/**
+ * \addtogroup rig
+ * @{
+ */
+
+/**
+ * \file async.c
+ * \brief Asynchronous requests served by a per rig worker thread
+ *
+ * Requests are queued in submission order and run one after the other
+ * by a worker thread owning the rig, so the caller never waits for the
+ * CAT round trip. A read that is identical to one still waiting in the
+ * queue is not sent twice, both requests complete with the same answer.
+ * Consecutive reads at the head of the queue go to rig_get_multi() as a
+ * single batch, letting backends such as netrigctl pipeline them.
+ *
+ * A PTT change timed with rig_set_ptt_at_async() is run apart from the
+ * queue, as soon as it is due.  The worker keeps itself free for it
+ * ASYNC_TIMED_GUARD before, or twice the time a request has been taking
+ * if longer, and only batches the reads which fit before, so that a CAT
+ * round trip started meanwhile cannot delay the keying.
+ *
+ * Completions are delivered either by calling the callback from the
+ * worker thread, or, with RIG_ASYNC_FD, by making a file descriptor
+ * readable so that an event loop can call rig_async_dispatch().
+ *
+ * Once the worker is started, the application must not use the
+ * synchronous rig_* calls on the same rig until rig_async_stop().
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/time.h>
+
+#ifdef HAVE_PTHREAD
+#  include <pthread.h>
+#endif
+
+#include <hamlib/rig.h>
+#include "vfoctx.h"
+
+#define ASYNC_BATCH_MAX 16      /* reads handed to rig_get_multi() at once */
+#define ASYNC_TIMED_GUARD 20000 /* us left free before a timed request */
+
+#define CHECK_RIG_ARG(r) (!(r) || !(r)->caps || !(r)->state.comm_state)
+
+
+#ifdef HAVE_PTHREAD
+
+struct async_waiter
+{
+    rig_async_cb_t cb;
+    rig_ptr_t arg;
+    struct async_waiter *next;
+};
+
+struct async_req
+{
+    struct rig_multi item;
+    int set;                        /* set request, else get */
+    struct async_waiter *waiters;   /* in submission order */
+    int64_t when;                   /* time of day in us, 0 if not timed */
+    struct async_req *next;
+};
+
+struct rig_async
+{
+    RIG *rig;
+    int flags;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct async_req *head, *tail;  /* waiting to be run */
+    struct async_req *timed;        /* waiting for their date, by date */
+    struct async_req *done;         /* RIG_ASYNC_FD, waiting for dispatch */
+    struct async_req *done_tail;
+    int64_t req_us;                 /* running mean of a request, in us */
+    int quit;
+    int detached;                   /* stopped from its own thread */
+    int pipefd[2];
+};
+
+
+static int64_t async_now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+
+/* time kept free before a timed request, in us */
+static int64_t async_timed_guard(const struct rig_async *as)
+{
+    return 2 * as->req_us > ASYNC_TIMED_GUARD ? 2 * as->req_us
+           : ASYNC_TIMED_GUARD;
+}
+
+
+/* whether the first timed request is to be run now, lock held */
+static int async_timed_due(struct rig_async *as)
+{
+    return as->timed && as->timed->when - async_timed_guard(as) <= async_now();
+}
+
+
+/*
+ * How many reads may go in the next batch, lock held: those which are
+ * expected to complete before the guard of the timed request, at least
+ * one since it is not due yet.
+ */
+static int async_batch_max(const struct rig_async *as)
+{
+    int64_t room;
+
+    if (!as->timed)
+    {
+        return ASYNC_BATCH_MAX;
+    }
+
+    /* nothing measured yet, one read to learn its round trip */
+    if (as->req_us <= 0)
+    {
+        return 1;
+    }
+
+    room = (as->timed->when - async_timed_guard(as) - async_now())
+           / as->req_us;
+
+    return room < 1 ? 1 : room < ASYNC_BATCH_MAX ? (int)room : ASYNC_BATCH_MAX;
+}
+
+
+/* account n requests run in us, worker thread only */
+static void async_measure(struct rig_async *as, int n, int64_t us)
+{
+    int64_t req_us = us / n > 0 ? us / n : 1;
+
+    as->req_us = as->req_us ? (7 * as->req_us + req_us) / 8 : req_us;
+}
+
+
+static void async_complete(struct async_req *req, RIG *rig)
+{
+    struct async_waiter *w, *next;
+
+    for (w = req->waiters; w; w = next)
+    {
+        next = w->next;
+
+        if (w->cb)
+        {
+            w->cb(rig, &req->item, w->arg);
+        }
+
+        free(w);
+    }
+
+    free(req);
+}
+
+
+/* hands over finished requests, linked through next */
+static void async_finish(struct rig_async *as, struct async_req *list)
+{
+    struct async_req *req, *next;
+
+    if (!(as->flags & RIG_ASYNC_FD))
+    {
+        for (req = list; req; req = next)
+        {
+            next = req->next;
+            async_complete(req, as->rig);
+        }
+
+        return;
+    }
+
+    pthread_mutex_lock(&as->lock);
+
+    for (req = list; req; req = req->next)
+    {
+        if (as->done_tail)
+        {
+            as->done_tail->next = req;
+        }
+        else
+        {
+            as->done = req;
+        }
+
+        as->done_tail = req;
+    }
+
+    pthread_mutex_unlock(&as->lock);
+
+    if (write(as->pipefd[1], "", 1) < 0 && errno != EAGAIN)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: write failed: %s\n", __func__,
+                  strerror(errno));
+    }
+}
+
+
+static void async_free(struct rig_async *as)
+{
+    if (as->pipefd[0] >= 0)
+    {
+        close(as->pipefd[0]);
+        close(as->pipefd[1]);
+    }
+
+    pthread_mutex_destroy(&as->lock);
+    pthread_cond_destroy(&as->cond);
+    free(as);
+}
+
+
+static void async_run_set(RIG *rig, struct rig_multi *r)
+{
+    switch (r->what)
+    {
+    case RIG_MULTI_FREQ:
+        r->status = rig_set_freq(rig, r->vfo, r->val.freq);
+        break;
+
+    case RIG_MULTI_MODE:
+        r->status = rig_set_mode(rig, r->vfo, r->val.mode.mode,
+                                 r->val.mode.width);
+        break;
+
+    case RIG_MULTI_VFO:
+        r->status = rig_set_vfo(rig, r->val.vfo);
+        break;
+
+    case RIG_MULTI_PTT:
+        r->status = rig_set_ptt(rig, r->vfo, r->val.ptt);
+        break;
+
+    case RIG_MULTI_LEVEL:
+        r->status = rig_set_level(rig, r->vfo, r->level, r->val.level);
+        break;
+
+    default:
+        r->status = -RIG_EINVAL;
+    }
+}
+
+
+static void *async_main(void *arg)
+{
+    struct rig_async *as = arg;
+    RIG *rig = as->rig;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: worker started\n", __func__);
+
+    for (;;)
+    {
+        struct rig_multi batch[ASYNC_BATCH_MAX];
+        struct async_req *list, *req;
+        int n = 0, max, i, retval;
+        int64_t start;
+
+        pthread_mutex_lock(&as->lock);
+
+        while (!as->quit && !as->head && !async_timed_due(as))
+        {
+            int64_t deadline = rig_vfo_ctx_deadline(rig) * 1000;
+            int64_t due = as->timed ? as->timed->when - async_timed_guard(as)
+                          : 0;
+            int restore = 1;
+            struct timespec ts;
+
+            if (!deadline && !due)
+            {
+                pthread_cond_wait(&as->cond, &as->lock);
+                continue;
+            }
+
+            /* the timed request comes first */
+            if (due && (!deadline || due < deadline))
+            {
+                deadline = due;
+                restore = 0;
+            }
+
+            /* idle with a VFO switch to undo, see rig_restore_vfo() */
+            ts.tv_sec = deadline / 1000000;
+            ts.tv_nsec = (deadline % 1000000) * 1000;
+
+            if (pthread_cond_timedwait(&as->cond, &as->lock, &ts) == ETIMEDOUT
+                    && restore)
+            {
+                pthread_mutex_unlock(&as->lock);
+                rig_vfo_ctx_restore(rig);
+                pthread_mutex_lock(&as->lock);
+            }
+        }
+
+        if (as->quit)
+        {
+            pthread_mutex_unlock(&as->lock);
+            break;
+        }
+
+        if (async_timed_due(as))
+        {
+            list = as->timed;
+            as->timed = list->next;
+            list->next = NULL;
+            pthread_mutex_unlock(&as->lock);
+
+            list->item.status = rig_set_ptt_at(rig, list->item.vfo,
+                                               list->item.val.ptt,
+                                               list->when);
+
+            async_finish(as, list);
+            continue;
+        }
+
+        /* a set alone, or the run of gets at the head of the queue */
+        list = as->head;
+        req = list;
+
+        if (req->set)
+        {
+            n = 1;
+        }
+        else
+        {
+            max = async_batch_max(as);
+
+            while (req->next && !req->next->set && n + 1 < max)
+            {
+                req = req->next;
+                n++;
+            }
+
+            n++;
+        }
+
+        as->head = req->next;
+
+        if (!as->head)
+        {
+            as->tail = NULL;
+        }
+
+        req->next = NULL;
+        pthread_mutex_unlock(&as->lock);
+
+        start = async_now();
+
+        if (list->set)
+        {
+            async_run_set(rig, &list->item);
+        }
+        else
+        {
+            for (i = 0, req = list; req; req = req->next, i++)
+            {
+                batch[i] = req->item;
+            }
+
+            retval = rig_get_multi(rig, batch, n);
+
+            for (i = 0, req = list; req; req = req->next, i++)
+            {
+                req->item = batch[i];
+
+                if (retval != RIG_OK)
+                {
+                    req->item.status = retval;
+                }
+            }
+        }
+
+        async_measure(as, n, async_now() - start);
+        async_finish(as, list);
+    }
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: worker stopped\n", __func__);
+
+    /* rig_async_stop() was called from a callback, and left this to us */
+    if (as->detached)
+    {
+        async_free(as);
+    }
+
+    return NULL;
+}
+
+
+static int async_submit(RIG *rig, const struct rig_multi *item, int set,
+                        int64_t when, rig_async_cb_t cb, rig_ptr_t arg)
+{
+    struct rig_async *as;
+    struct async_waiter *w, **wp;
+    struct async_req *req, *same = NULL, **rp;
+
+    if (CHECK_RIG_ARG(rig) || !item)
+    {
+        return -RIG_EINVAL;
+    }
+
+    as = rig->state.async;
+
+    if (!as)
+    {
+        return -RIG_EINVAL;
+    }
+
+    w = calloc(1, sizeof(*w));
+
+    if (!w)
+    {
+        return -RIG_ENOMEM;
+    }
+
+    w->cb = cb;
+    w->arg = arg;
+
+    pthread_mutex_lock(&as->lock);
+
+    /*
+     * Coalesce with the last identical read still waiting, unless a
+     * set is queued after it: any set, e.g. of the VFO or split, may
+     * change what the read returns.
+     */
+    if (!set)
+    {
+        for (req = as->head; req; req = req->next)
+        {
+            if (req->set)
+            {
+                same = NULL;
+            }
+            else if (req->item.what == item->what
+                     && req->item.vfo == item->vfo
+                     && (item->what != RIG_MULTI_LEVEL
+                         || req->item.level == item->level))
+            {
+                same = req;
+            }
+        }
+    }
+
+    if (same)
+    {
+        wp = &same->waiters;
+
+        while (*wp)
+        {
+            wp = &(*wp)->next;
+        }
+
+        *wp = w;
+        pthread_mutex_unlock(&as->lock);
+
+        rig_debug(RIG_DEBUG_TRACE, "%s: coalesced read\n", __func__);
+        return RIG_OK;
+    }
+
+    req = calloc(1, sizeof(*req));
+
+    if (!req)
+    {
+        pthread_mutex_unlock(&as->lock);
+        free(w);
+        return -RIG_ENOMEM;
+    }
+
+    req->item = *item;
+    req->item.status = RIG_OK;
+    req->set = set;
+    req->waiters = w;
+    req->when = when;
+
+    if (when)
+    {
+        /* after those of the same date */
+        for (rp = &as->timed; *rp && (*rp)->when <= when; rp = &(*rp)->next)
+        {
+            continue;
+        }
+
+        req->next = *rp;
+        *rp = req;
+    }
+    else
+    {
+        if (as->tail)
+        {
+            as->tail->next = req;
+        }
+        else
+        {
+            as->head = req;
+        }
+
+        as->tail = req;
+    }
+
+    pthread_cond_signal(&as->cond);
+    pthread_mutex_unlock(&as->lock);
+
+    return RIG_OK;
+}
+
+#endif  /* HAVE_PTHREAD */
+
+
+/**
+ * \brief start the asynchronous request worker of a rig
+ * \param rig   The rig handle
+ * \param flags RIG_ASYNC_FD to complete through rig_async_fd() and
+ *              rig_async_dispatch(), 0 to call the callbacks from the
+ *              worker thread
+ *
+ * The rig must be open. The worker is stopped by rig_async_stop() or
+ * rig_close().
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause
+ * is set appropriately).
+ *
+ * \sa rig_async_stop(), rig_get_async(), rig_set_async()
+ */
+int HAMLIB_API rig_async_start(RIG *rig, int flags)
+{
+#ifdef HAVE_PTHREAD
+    struct rig_async *as;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (CHECK_RIG_ARG(rig) || !rig->state.comm_state)
+    {
+        return -RIG_EINVAL;
+    }
+
+    if (rig->state.async)
+    {
+        return RIG_OK;
+    }
+
+    as = calloc(1, sizeof(*as));
+
+    if (!as)
+    {
+        return -RIG_ENOMEM;
+    }
+
+    as->rig = rig;
+    as->flags = flags;
+    as->pipefd[0] = as->pipefd[1] = -1;
+    pthread_mutex_init(&as->lock, NULL);
+    pthread_cond_init(&as->cond, NULL);
+
+    if (flags & RIG_ASYNC_FD)
+    {
+        if (pipe(as->pipefd) < 0)
+        {
+            rig_debug(RIG_DEBUG_ERR, "%s: pipe failed: %s\n", __func__,
+                      strerror(errno));
+            free(as);
+            return -RIG_EIO;
+        }
+
+        fcntl(as->pipefd[0], F_SETFL, O_NONBLOCK);
+        fcntl(as->pipefd[1], F_SETFL, O_NONBLOCK);
+    }
+
+    if (pthread_create(&as->thread, NULL, async_main, as) != 0)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: pthread_create failed\n", __func__);
+
+        if (as->pipefd[0] >= 0)
+        {
+            close(as->pipefd[0]);
+            close(as->pipefd[1]);
+        }
+
+        free(as);
+        return -RIG_EINTERNAL;
+    }
+
+    rig->state.async = as;
+
+    return RIG_OK;
+#else
+    return -RIG_ENIMPL;
+#endif
+}
+
+
+/**
+ * \brief stop the asynchronous request worker of a rig
+ * \param rig   The rig handle
+ *
+ * Waits for the request being run, if any. The requests still queued
+ * complete with -RIG_EIO, and all completions not yet dispatched are
+ * delivered, from the calling thread.
+ *
+ * It may be called, e.g. through rig_close(), from a completion
+ * callback run by the worker. The worker then goes away once the
+ * callback returns, after delivering the rest of its current batch.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured.
+ *
+ * \sa rig_async_start()
+ */
+int HAMLIB_API rig_async_stop(RIG *rig)
+{
+#ifdef HAVE_PTHREAD
+    struct rig_async *as;
+    struct async_req *req, *next;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (CHECK_RIG_ARG(rig))
+    {
+        return -RIG_EINVAL;
+    }
+
+    as = rig->state.async;
+
+    if (!as)
+    {
+        return RIG_OK;
+    }
+
+    pthread_mutex_lock(&as->lock);
+    as->quit = 1;
+    pthread_cond_signal(&as->cond);
+    pthread_mutex_unlock(&as->lock);
+
+    /* a thread cannot join itself */
+    if (pthread_equal(pthread_self(), as->thread))
+    {
+        as->detached = 1;
+        pthread_detach(as->thread);
+    }
+    else
+    {
+        pthread_join(as->thread, NULL);
+    }
+
+    rig->state.async = NULL;
+
+    for (req = as->done; req; req = next)
+    {
+        next = req->next;
+        async_complete(req, rig);
+    }
+
+    for (req = as->head; req; req = next)
+    {
+        next = req->next;
+        req->item.status = -RIG_EIO;
+        async_complete(req, rig);
+    }
+
+    for (req = as->timed; req; req = next)
+    {
+        next = req->next;
+        req->item.status = -RIG_EIO;
+        async_complete(req, rig);
+    }
+
+    as->done = as->done_tail = NULL;
+    as->head = as->tail = NULL;
+    as->timed = NULL;
+
+    if (!as->detached)
+    {
+        async_free(as);
+    }
+
+    return RIG_OK;
+#else
+    return -RIG_ENIMPL;
+#endif
+}
+
+
+/**
+ * \brief file descriptor signalling completed requests
+ * \param rig   The rig handle
+ *
+ * With RIG_ASYNC_FD, the returned descriptor becomes readable when there
+ * are completions to deliver. Add it to the application's poll() or
+ * select() set and call rig_async_dispatch() when it fires.
+ *
+ * \return the file descriptor, or a negative value if the worker was
+ * not started with RIG_ASYNC_FD.
+ */
+int HAMLIB_API rig_async_fd(RIG *rig)
+{
+#ifdef HAVE_PTHREAD
+    struct rig_async *as;
+
+    if (CHECK_RIG_ARG(rig))
+    {
+        return -RIG_EINVAL;
+    }
+
+    as = rig->state.async;
+
+    if (!as || !(as->flags & RIG_ASYNC_FD))
+    {
+        return -RIG_EINVAL;
+    }
+
+    return as->pipefd[0];
+#else
+    return -RIG_ENIMPL;
+#endif
+}
+
+
+/**
+ * \brief deliver the completed requests
+ * \param rig   The rig handle
+ *
+ * Calls, from the calling thread, the callbacks of the requests
+ * completed since the previous call. Only useful with RIG_ASYNC_FD.
+ *
+ * \return the number of requests completed, or a negative value if an
+ * error occured.
+ *
+ * \sa rig_async_fd()
+ */
+int HAMLIB_API rig_async_dispatch(RIG *rig)
+{
+#ifdef HAVE_PTHREAD
+    struct rig_async *as;
+    struct async_req *req, *next;
+    char buf[64];
+    int n = 0;
+
+    if (CHECK_RIG_ARG(rig))
+    {
+        return -RIG_EINVAL;
+    }
+
+    as = rig->state.async;
+
+    if (!as || !(as->flags & RIG_ASYNC_FD))
+    {
+        return -RIG_EINVAL;
+    }
+
+    /* drain the wake ups, the done list is what matters */
+    while (read(as->pipefd[0], buf, sizeof(buf)) > 0)
+    {
+        continue;
+    }
+
+    pthread_mutex_lock(&as->lock);
+    req = as->done;
+    as->done = as->done_tail = NULL;
+    pthread_mutex_unlock(&as->lock);
+
+    for (; req; req = next)
+    {
+        next = req->next;
+        async_complete(req, rig);
+        n++;
+    }
+
+    return n;
+#else
+    return -RIG_ENIMPL;
+#endif
+}
+
+
+/**
+ * \brief queue a read
+ * \param rig   The rig handle
+ * \param req   What to read, as for rig_get_multi()
+ * \param cb    The callback receiving the result, may be NULL
+ * \param arg   Passed to \a cb
+ *
+ * \return RIG_OK if the request has been queued, otherwise
+ * a negative value if an error occured. The outcome of the read itself
+ * is in the status of the result given to \a cb.
+ *
+ * \sa rig_async_start(), rig_get_multi()
+ */
+int HAMLIB_API rig_get_async(RIG *rig, const struct rig_multi *req,
+                             rig_async_cb_t cb, rig_ptr_t arg)
+{
+#ifdef HAVE_PTHREAD
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    return async_submit(rig, req, 0, 0, cb, arg);
+#else
+    return -RIG_ENIMPL;
+#endif
+}
+
+
+/**
+ * \brief queue a write
+ * \param rig   The rig handle
+ * \param req   What to set, with the value in req->val
+ * \param cb    The callback receiving the outcome, may be NULL
+ * \param arg   Passed to \a cb
+ *
+ * \return RIG_OK if the request has been queued, otherwise
+ * a negative value if an error occured.
+ *
+ * \sa rig_async_start()
+ */
+int HAMLIB_API rig_set_async(RIG *rig, const struct rig_multi *req,
+                             rig_async_cb_t cb, rig_ptr_t arg)
+{
+#ifdef HAVE_PTHREAD
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    return async_submit(rig, req, 1, 0, cb, arg);
+#else
+    return -RIG_ENIMPL;
+#endif
+}
+
+
+/**
+ * \brief queue a frequency read, see rig_get_async()
+ */
+int HAMLIB_API rig_get_freq_async(RIG *rig, vfo_t vfo, rig_async_cb_t cb,
+                                  rig_ptr_t arg)
+{
+    struct rig_multi req;
+
+    memset(&req, 0, sizeof(req));
+    req.what = RIG_MULTI_FREQ;
+    req.vfo = vfo;
+
+    return rig_get_async(rig, &req, cb, arg);
+}
+
+
+/**
+ * \brief queue a frequency change, see rig_set_async()
+ */
+int HAMLIB_API rig_set_freq_async(RIG *rig, vfo_t vfo, freq_t freq,
+                                  rig_async_cb_t cb, rig_ptr_t arg)
+{
+    struct rig_multi req;
+
+    memset(&req, 0, sizeof(req));
+    req.what = RIG_MULTI_FREQ;
+    req.vfo = vfo;
+    req.val.freq = freq;
+
+    return rig_set_async(rig, &req, cb, arg);
+}
+
+
+/**
+ * \brief queue a mode read, see rig_get_async()
+ */
+int HAMLIB_API rig_get_mode_async(RIG *rig, vfo_t vfo, rig_async_cb_t cb,
+                                  rig_ptr_t arg)
+{
+    struct rig_multi req;
+
+    memset(&req, 0, sizeof(req));
+    req.what = RIG_MULTI_MODE;
+    req.vfo = vfo;
+
+    return rig_get_async(rig, &req, cb, arg);
+}
+
+
+/**
+ * \brief queue a mode change, see rig_set_async()
+ */
+int HAMLIB_API rig_set_mode_async(RIG *rig, vfo_t vfo, rmode_t mode,
+                                  pbwidth_t width, rig_async_cb_t cb,
+                                  rig_ptr_t arg)
+{
+    struct rig_multi req;
+
+    memset(&req, 0, sizeof(req));
+    req.what = RIG_MULTI_MODE;
+    req.vfo = vfo;
+    req.val.mode.mode = mode;
+    req.val.mode.width = width;
+
+    return rig_set_async(rig, &req, cb, arg);
+}
+
+
+/**
+ * \brief queue a PTT read, see rig_get_async()
+ */
+int HAMLIB_API rig_get_ptt_async(RIG *rig, vfo_t vfo, rig_async_cb_t cb,
+                                 rig_ptr_t arg)
+{
+    struct rig_multi req;
+
+    memset(&req, 0, sizeof(req));
+    req.what = RIG_MULTI_PTT;
+    req.vfo = vfo;
+
+    return rig_get_async(rig, &req, cb, arg);
+}
+
+
+/**
+ * \brief queue a PTT change, see rig_set_async()
+ */
+int HAMLIB_API rig_set_ptt_async(RIG *rig, vfo_t vfo, ptt_t ptt,
+                                 rig_async_cb_t cb, rig_ptr_t arg)
+{
+    struct rig_multi req;
+
+    memset(&req, 0, sizeof(req));
+    req.what = RIG_MULTI_PTT;
+    req.vfo = vfo;
+    req.val.ptt = ptt;
+
+    return rig_set_async(rig, &req, cb, arg);
+}
+
+
+/**
+ * \brief queue a PTT change at a given time
+ * \param rig   The rig handle
+ * \param vfo   The target VFO
+ * \param ptt   The PTT status to set to
+ * \param when  When to switch the PTT, a time of day in microseconds
+ *              since the Epoch, as from gettimeofday()
+ * \param cb    The callback receiving the outcome, may be NULL
+ * \param arg   Passed to \a cb
+ *
+ * The worker runs rig_set_ptt_at() for it once it is due, ahead of the
+ * requests queued meanwhile.
+ *
+ * \return RIG_OK if the request has been queued, otherwise
+ * a negative value if an error occured.
+ *
+ * \sa rig_set_ptt_at(), rig_async_start()
+ */
+int HAMLIB_API rig_set_ptt_at_async(RIG *rig, vfo_t vfo, ptt_t ptt,
+                                    int64_t when, rig_async_cb_t cb,
+                                    rig_ptr_t arg)
+{
+#ifdef HAVE_PTHREAD
+    struct rig_multi req;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    memset(&req, 0, sizeof(req));
+    req.what = RIG_MULTI_PTT;
+    req.vfo = vfo;
+    req.val.ptt = ptt;
+
+    /* 0 is not a date but "not timed" */
+    return async_submit(rig, &req, 1, when > 0 ? when : 1, cb, arg);
+#else
+    return -RIG_ENIMPL;
+#endif
+}
+
+/** @} */
@@ -0,0 +1,352 @@
+/*
+ *  Hamlib Interface - frontend cache
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/**
+ * \addtogroup rig_internal
+ * @{
+ */
+
+/**
+ * \file cache.c
+ * \brief Frontend cache of freq/mode/vfo/ptt/split
+ *
+ * Many applications poll the same few values over and over, often
+ * several of them through rigctld on a single radio.  When
+ * rig_state.cache_timeout is set, the values read from the rig are kept
+ * here per VFO and served again until they are older than the timeout,
+ * or until a rig_set_* call invalidates them.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <hamlib/rig.h>
+#include "cache.h"
+
+
+static int64_t cache_now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+
+/* is a value dated "t" still usable? */
+static int cache_valid(RIG *rig, int64_t t)
+{
+    struct rig_cache *cache = &rig->state.cache;
+
+    if (rig->state.cache_timeout <= 0)
+    {
+        return 0;
+    }
+
+    if (t != 0 && cache_now() - t < rig->state.cache_timeout)
+    {
+        cache->hits++;
+        return 1;
+    }
+
+    cache->misses++;
+    return 0;
+}
+
+
+/* entry of vfo, NULL if none */
+static struct rig_cache_vfo *cache_find(RIG *rig, vfo_t vfo)
+{
+    struct rig_cache *cache = &rig->state.cache;
+    int i;
+
+    for (i = 0; i < RIG_CACHE_VFO_SLOTS; i++)
+    {
+        if (cache->vfo[i].vfo == vfo)
+        {
+            return &cache->vfo[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+/* entry of vfo, allocated or recycled as needed, NULL if caching is off */
+static struct rig_cache_vfo *cache_slot(RIG *rig, vfo_t vfo)
+{
+    struct rig_cache *cache = &rig->state.cache;
+    struct rig_cache_vfo *entry;
+
+    if (rig->state.cache_timeout <= 0 || vfo == RIG_VFO_NONE)
+    {
+        return NULL;
+    }
+
+    entry = cache_find(rig, vfo);
+
+    if (entry)
+    {
+        return entry;
+    }
+
+    entry = cache_find(rig, RIG_VFO_NONE);
+
+    if (!entry)
+    {
+        entry = &cache->vfo[cache->next_slot];
+        cache->next_slot = (cache->next_slot + 1) % RIG_CACHE_VFO_SLOTS;
+    }
+
+    memset(entry, 0, sizeof(*entry));
+    entry->vfo = vfo;
+
+    return entry;
+}
+
+
+int rig_cache_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
+{
+    struct rig_cache_vfo *entry = cache_find(rig, vfo);
+
+    if (!cache_valid(rig, entry ? entry->time_freq : 0))
+    {
+        return -RIG_ENAVAIL;
+    }
+
+    *freq = entry->freq;
+
+    return RIG_OK;
+}
+
+
+void rig_cache_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
+{
+    struct rig_cache_vfo *entry = cache_slot(rig, vfo);
+
+    if (entry)
+    {
+        entry->freq = freq;
+        entry->time_freq = cache_now();
+    }
+}
+
+
+int rig_cache_get_mode(RIG *rig, vfo_t vfo, rmode_t *mode, pbwidth_t *width)
+{
+    struct rig_cache_vfo *entry = cache_find(rig, vfo);
+
+    if (!cache_valid(rig, entry ? entry->time_mode : 0))
+    {
+        return -RIG_ENAVAIL;
+    }
+
+    *mode = entry->mode;
+    *width = entry->width;
+
+    return RIG_OK;
+}
+
+
+void rig_cache_set_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
+{
+    struct rig_cache_vfo *entry = cache_slot(rig, vfo);
+
+    if (entry)
+    {
+        entry->mode = mode;
+        entry->width = width;
+        entry->time_mode = cache_now();
+    }
+}
+
+
+int rig_cache_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
+{
+    struct rig_cache_vfo *entry = cache_find(rig, vfo);
+
+    if (!cache_valid(rig, entry ? entry->time_ptt : 0))
+    {
+        return -RIG_ENAVAIL;
+    }
+
+    *ptt = entry->ptt;
+
+    return RIG_OK;
+}
+
+
+void rig_cache_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
+{
+    struct rig_cache_vfo *entry = cache_slot(rig, vfo);
+
+    if (entry)
+    {
+        entry->ptt = ptt;
+        entry->time_ptt = cache_now();
+    }
+}
+
+
+int rig_cache_get_split(RIG *rig, vfo_t vfo, split_t *split, vfo_t *tx_vfo)
+{
+    struct rig_cache_vfo *entry = cache_find(rig, vfo);
+
+    if (!cache_valid(rig, entry ? entry->time_split : 0))
+    {
+        return -RIG_ENAVAIL;
+    }
+
+    *split = entry->split;
+    *tx_vfo = entry->tx_vfo;
+
+    return RIG_OK;
+}
+
+
+void rig_cache_set_split(RIG *rig, vfo_t vfo, split_t split, vfo_t tx_vfo)
+{
+    struct rig_cache_vfo *entry = cache_slot(rig, vfo);
+
+    if (entry)
+    {
+        entry->split = split;
+        entry->tx_vfo = tx_vfo;
+        entry->time_split = cache_now();
+    }
+}
+
+
+int rig_cache_get_vfo(RIG *rig, vfo_t *vfo)
+{
+    struct rig_cache *cache = &rig->state.cache;
+
+    if (!cache_valid(rig, cache->time_vfo))
+    {
+        return -RIG_ENAVAIL;
+    }
+
+    *vfo = cache->curr_vfo;
+
+    return RIG_OK;
+}
+
+
+void rig_cache_set_vfo(RIG *rig, vfo_t vfo)
+{
+    struct rig_cache *cache = &rig->state.cache;
+
+    if (rig->state.cache_timeout > 0)
+    {
+        cache->curr_vfo = vfo;
+        cache->time_vfo = cache_now();
+    }
+}
+
+
+/**
+ * \brief Invalidate cached values
+ * \param rig   The rig handle
+ * \param what  Mask of RIG_CACHE_FREQ, RIG_CACHE_MODE, etc.
+ *
+ * To be called before any operation that may change the cached values.
+ * The values of all the VFOs are invalidated: on most rigs, changing
+ * RIG_VFO_A also changes what RIG_VFO_CURR or RIG_VFO_MAIN read back.
+ */
+void rig_cache_invalidate(RIG *rig, int what)
+{
+    struct rig_cache *cache = &rig->state.cache;
+    int i;
+
+    for (i = 0; i < RIG_CACHE_VFO_SLOTS; i++)
+    {
+        if (what & RIG_CACHE_FREQ)
+        {
+            cache->vfo[i].time_freq = 0;
+        }
+
+        if (what & RIG_CACHE_MODE)
+        {
+            cache->vfo[i].time_mode = 0;
+        }
+
+        if (what & RIG_CACHE_PTT)
+        {
+            cache->vfo[i].time_ptt = 0;
+        }
+
+        if (what & RIG_CACHE_SPLIT)
+        {
+            cache->vfo[i].time_split = 0;
+        }
+    }
+
+    if (what & RIG_CACHE_VFO)
+    {
+        cache->time_vfo = 0;
+    }
+}
+
+/** @} */
+
+
+/**
+ * \addtogroup rig
+ * @{
+ */
+
+/**
+ * \brief get the frontend cache statistics
+ * \param rig       The rig handle
+ * \param hits      The location where to store the number of cache hits
+ * \param misses    The location where to store the number of cache misses
+ *
+ *  Retrieves how many rig_get_freq(), rig_get_mode(), rig_get_vfo(),
+ *  rig_get_ptt() and rig_get_split_vfo() calls have been answered from
+ *  the frontend cache, and how many had to query the rig.  Nothing is
+ *  counted while the "cache_timeout" configuration parameter is 0.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ */
+int HAMLIB_API rig_get_cache_stats(RIG *rig,
+                                   unsigned long *hits,
+                                   unsigned long *misses)
+{
+    if (!rig || !rig->caps || !hits || !misses)
+    {
+        return -RIG_EINVAL;
+    }
+
+    *hits = rig->state.cache.hits;
+    *misses = rig->state.cache.misses;
+
+    return RIG_OK;
+}
+
+/** @} */
@@ -0,0 +1,68 @@
+/*
+ *  Hamlib Interface - frontend cache header
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef _CACHE_H
+#define _CACHE_H 1
+
+#include <hamlib/rig.h>
+
+/* what to invalidate, see rig_cache_invalidate() */
+#define RIG_CACHE_FREQ  (1<<0)
+#define RIG_CACHE_MODE  (1<<1)
+#define RIG_CACHE_PTT   (1<<2)
+#define RIG_CACHE_SPLIT (1<<3)
+#define RIG_CACHE_VFO   (1<<4)
+#define RIG_CACHE_ALL   (RIG_CACHE_FREQ|RIG_CACHE_MODE|RIG_CACHE_PTT|RIG_CACHE_SPLIT|RIG_CACHE_VFO)
+
+/*
+ * The rig_cache_get_*() return RIG_OK when the value was served from the
+ * cache, -RIG_ENAVAIL when it has to be read from the rig.
+ */
+extern int rig_cache_get_freq(RIG *rig, vfo_t vfo, freq_t *freq);
+extern void rig_cache_set_freq(RIG *rig, vfo_t vfo, freq_t freq);
+
+extern int rig_cache_get_mode(RIG *rig,
+                              vfo_t vfo,
+                              rmode_t *mode,
+                              pbwidth_t *width);
+extern void rig_cache_set_mode(RIG *rig,
+                               vfo_t vfo,
+                               rmode_t mode,
+                               pbwidth_t width);
+
+extern int rig_cache_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt);
+extern void rig_cache_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt);
+
+extern int rig_cache_get_split(RIG *rig,
+                               vfo_t vfo,
+                               split_t *split,
+                               vfo_t *tx_vfo);
+extern void rig_cache_set_split(RIG *rig,
+                                vfo_t vfo,
+                                split_t split,
+                                vfo_t tx_vfo);
+
+extern int rig_cache_get_vfo(RIG *rig, vfo_t *vfo);
+extern void rig_cache_set_vfo(RIG *rig, vfo_t vfo);
+
+extern void rig_cache_invalidate(RIG *rig, int what);
+
+#endif /* _CACHE_H */
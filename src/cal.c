@@ -34,10 +34,16 @@
 #  include "config.h"
 #endif
 
+#include <stdlib.h>
+#include <string.h>
+
 #include <hamlib/rig.h>
 #include "cal.h"
 
-/* add rig_set_cal(cal_table), rig_get_calstat(rawmin,rawmax,cal_table), */
+/* add rig_get_calstat(rawmin,rawmax,cal_table), */
+
+/* largest span of raw values compiled into a lookup array */
+#define CAL_LUT_MAX 4096
 
 
 /**
@@ -170,4 +176,342 @@ float HAMLIB_API rig_raw2val_float(int rawval, const cal_table_float_t *cal)
     return cal->table[i].val - interpolation;
 }
 
+
+static void cal_to_float(cal_table_float_t *dst, const cal_table_t *src)
+{
+    int i;
+
+    dst->size = src->size;
+
+    for (i = 0; i < src->size; i++)
+    {
+        dst->table[i].raw = src->table[i].raw;
+        dst->table[i].val = src->table[i].val;
+    }
+}
+
+
+/*
+ * Fill the lookup array from the table.  Tables whose raw values are not
+ * sorted, or span more than CAL_LUT_MAX, are left to rig_raw2val_float()
+ */
+static int cal_lut_compile(struct cal_lut *lut)
+{
+    const cal_table_float_t *cal = &lut->cal;
+    int raw_min, raw_max;
+    float *val;
+    int i;
+
+    free(lut->val);
+    lut->val = NULL;
+    lut->size = 0;
+
+    /* an empty table is the identity */
+    if (cal->size == 0)
+    {
+        return RIG_OK;
+    }
+
+    for (i = 1; i < cal->size; i++)
+    {
+        if (cal->table[i].raw < cal->table[i - 1].raw)
+        {
+            rig_debug(RIG_DEBUG_TRACE, "%s: raw values not sorted\n",
+                      __func__);
+            return RIG_OK;
+        }
+    }
+
+    raw_min = cal->table[0].raw;
+    raw_max = cal->table[cal->size - 1].raw;
+
+    if (raw_max - raw_min >= CAL_LUT_MAX)
+    {
+        rig_debug(RIG_DEBUG_TRACE, "%s: %d..%d not compiled\n", __func__,
+                  raw_min, raw_max);
+        return RIG_OK;
+    }
+
+    val = malloc((raw_max - raw_min + 1) * sizeof(float));
+
+    if (!val)
+    {
+        return -RIG_ENOMEM;
+    }
+
+    for (i = 0; i <= raw_max - raw_min; i++)
+    {
+        val[i] = rig_raw2val_float(raw_min + i, cal);
+    }
+
+    lut->raw_min = raw_min;
+    lut->size = raw_max - raw_min + 1;
+    lut->val = val;
+
+    return RIG_OK;
+}
+
+
+/* fast path of rig_raw2val_meter(), same results as rig_raw2val_float() */
+static float cal_lut_lookup(const struct cal_lut *lut, int rawval)
+{
+    int i;
+
+    if (!lut->val)
+    {
+        return rig_raw2val_float(rawval, &lut->cal);
+    }
+
+    i = rawval - lut->raw_min;
+
+    if (i < 0)
+    {
+        return lut->cal.table[0].val;
+    }
+
+    if (i >= lut->size)
+    {
+        return lut->cal.table[lut->cal.size - 1].val;
+    }
+
+    return lut->val[i];
+}
+
+
+/*
+ * Load the meter tables of the caps, before the backend init gets
+ * a chance to override them with rig_set_cal()
+ */
+void rig_cal_init(RIG *rig)
+{
+    const struct rig_caps *caps = rig->caps;
+    struct cal_lut *lut = rig->state.cal_lut;
+
+    memset(lut, 0, sizeof(rig->state.cal_lut));
+
+    cal_to_float(&lut[RIG_CAL_STR].cal, &rig->state.str_cal);
+    lut[RIG_CAL_SWR].cal = caps->swr_cal;
+    lut[RIG_CAL_ALC].cal = caps->alc_cal;
+    lut[RIG_CAL_RFPOWER_METER].cal = caps->rfpower_meter_cal;
+    lut[RIG_CAL_COMP_METER].cal = caps->comp_meter_cal;
+    lut[RIG_CAL_VD_METER].cal = caps->vd_meter_cal;
+    lut[RIG_CAL_ID_METER].cal = caps->id_meter_cal;
+}
+
+
+/*
+ * Compile the meter tables, called by rig_open().  rig_state.str_cal is
+ * taken again as backends may have changed it directly.
+ */
+int rig_cal_compile(RIG *rig)
+{
+    struct cal_lut *lut = rig->state.cal_lut;
+    int meter;
+    int retval;
+
+    cal_to_float(&lut[RIG_CAL_STR].cal, &rig->state.str_cal);
+
+    for (meter = 0; meter < RIG_CAL_NB; meter++)
+    {
+        retval = cal_lut_compile(&lut[meter]);
+
+        if (retval != RIG_OK)
+        {
+            return retval;
+        }
+    }
+
+    return RIG_OK;
+}
+
+
+void rig_cal_free(RIG *rig)
+{
+    int meter;
+
+    for (meter = 0; meter < RIG_CAL_NB; meter++)
+    {
+        free(rig->state.cal_lut[meter].val);
+        rig->state.cal_lut[meter].val = NULL;
+        rig->state.cal_lut[meter].size = 0;
+    }
+}
+
+/** @} */
+
+
+/**
+ * \addtogroup rig
+ * @{
+ */
+
+/**
+ * \brief set the calibration table of a meter
+ * \param rig   The rig handle
+ * \param meter The meter
+ * \param cal   The calibration table
+ *
+ *  Replaces the table of \a meter, taken from the caps by rig_init().
+ *  For RIG_CAL_STR, rig_state.str_cal is updated too.  The table is
+ *  compiled at once if the rig is already opened, otherwise by
+ *  rig_open().
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_set_cal_float(), rig_raw2val_meter()
+ */
+int HAMLIB_API rig_set_cal(RIG *rig, rig_cal_t meter, const cal_table_t *cal)
+{
+    struct cal_lut *lut;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (!rig || !rig->caps || !cal || meter < 0 || meter >= RIG_CAL_NB
+            || cal->size < 0 || cal->size > MAX_CAL_LENGTH)
+    {
+        return -RIG_EINVAL;
+    }
+
+    lut = &rig->state.cal_lut[meter];
+
+    if (meter == RIG_CAL_STR)
+    {
+        rig->state.str_cal = *cal;
+    }
+
+    cal_to_float(&lut->cal, cal);
+
+    return rig->state.comm_state ? cal_lut_compile(lut) : RIG_OK;
+}
+
+
+/**
+ * \brief set the calibration table of a meter, float values
+ * \param rig   The rig handle
+ * \param meter The meter, but RIG_CAL_STR
+ * \param cal   The calibration table
+ *
+ *  As rig_set_cal(), for the meters whose values are not integers.
+ *  The S-meter table is rig_state.str_cal, use rig_set_cal() for it.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_set_cal(), rig_raw2val_meter()
+ */
+int HAMLIB_API rig_set_cal_float(RIG *rig,
+                                 rig_cal_t meter,
+                                 const cal_table_float_t *cal)
+{
+    struct cal_lut *lut;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (!rig || !rig->caps || !cal || meter <= RIG_CAL_STR
+            || meter >= RIG_CAL_NB || cal->size < 0
+            || cal->size > MAX_CAL_LENGTH)
+    {
+        return -RIG_EINVAL;
+    }
+
+    lut = &rig->state.cal_lut[meter];
+    lut->cal = *cal;
+
+    return rig->state.comm_state ? cal_lut_compile(lut) : RIG_OK;
+}
+
+
+/**
+ * \brief convert a raw meter reading to its calibrated value
+ * \param rig       The rig handle
+ * \param meter     The meter
+ * \param rawval    The raw value
+ *
+ *  Gives the same result as rig_raw2val_float() with the table of
+ *  \a meter, from the lookup array compiled by rig_open().  An
+ *  unknown meter, or a meter without table, returns \a rawval.
+ *
+ * \return the calibrated value
+ *
+ * \sa rig_raw2val_batch(), rig_set_cal()
+ */
+float HAMLIB_API rig_raw2val_meter(RIG *rig, rig_cal_t meter, int rawval)
+{
+    if (!rig || meter < 0 || meter >= RIG_CAL_NB)
+    {
+        return rawval;
+    }
+
+    return cal_lut_lookup(&rig->state.cal_lut[meter], rawval);
+}
+
+
+/**
+ * \brief convert raw meter readings to calibrated values
+ * \param rig       The rig handle
+ * \param meter     The meter
+ * \param rawval    The raw values
+ * \param val       The location where to store the \a count values
+ * \param count     Number of values to convert
+ *
+ *  Converts an array of samples at once, as rig_raw2val_meter() would
+ *  one by one.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_raw2val_meter()
+ */
+int HAMLIB_API rig_raw2val_batch(RIG *rig,
+                                 rig_cal_t meter,
+                                 const int *rawval,
+                                 float *val,
+                                 int count)
+{
+    const struct cal_lut *lut;
+    int i;
+
+    if (!rig || !rig->caps || meter < 0 || meter >= RIG_CAL_NB || count < 0
+            || (count && (!rawval || !val)))
+    {
+        return -RIG_EINVAL;
+    }
+
+    lut = &rig->state.cal_lut[meter];
+
+    if (!lut->val)
+    {
+        for (i = 0; i < count; i++)
+        {
+            val[i] = rig_raw2val_float(rawval[i], &lut->cal);
+        }
+
+        return RIG_OK;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        int j = rawval[i] - lut->raw_min;
+
+        if (j < 0)
+        {
+            val[i] = lut->cal.table[0].val;
+        }
+        else if (j >= lut->size)
+        {
+            val[i] = lut->cal.table[lut->cal.size - 1].val;
+        }
+        else
+        {
+            val[i] = lut->val[j];
+        }
+    }
+
+    return RIG_OK;
+}
+
 /** @} */
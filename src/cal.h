@@ -27,4 +27,8 @@
 extern HAMLIB_EXPORT(float) rig_raw2val(int rawval, const cal_table_t *cal);
 extern HAMLIB_EXPORT(float) rig_raw2val_float(int rawval, const cal_table_float_t *cal);
 
+extern void rig_cal_init(RIG *rig);
+extern int rig_cal_compile(RIG *rig);
+extern void rig_cal_free(RIG *rig);
+
 #endif /* _CAL_H */
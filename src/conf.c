@@ -42,6 +42,8 @@
 
 #include <hamlib/rig.h>
 #include "token.h"
+#include "cache.h"
+#include "stats.h"
 
 
 /*
@@ -118,6 +120,26 @@ static const struct confparams frontend_cfg_params[] =
         "Frequency to add to the VFO frequency for use with a transverter",
         "0", RIG_CONF_NUMERIC, { .n = {0.0, 1e9, .1}}
     },
+    {
+        TOK_CACHE_TIMEOUT, "cache_timeout", "Cache timeout",
+        "Validity in ms of the cached freq/mode/vfo/ptt/split values, 0 to disable",
+        "0", RIG_CONF_NUMERIC, { .n = { 0, 60000, 1 } }
+    },
+    {
+        TOK_STATS, "stats", "Statistics",
+        "Collect per operation statistics, see rig_get_stats()",
+        "0", RIG_CONF_CHECKBUTTON,
+    },
+    {
+        TOK_VFO_RESTORE_DELAY, "vfo_restore_delay", "VFO restore delay",
+        "Delay in ms before selecting back the current VFO after an operation on another VFO, 0 for at once",
+        "0", RIG_CONF_NUMERIC, { .n = { 0, 60000, 1 } }
+    },
+    {
+        TOK_PTT_HOLD, "ptt_hold", "Hold PTT port",
+        "Keep a PTT serial port other than the rig port open between transmissions",
+        "0", RIG_CONF_CHECKBUTTON,
+    },
 
     { RIG_CONF_END, NULL, }
 };
@@ -520,6 +542,41 @@ static int frontend_set_conf(RIG *rig, token_t token, const char *val)
         rs->lo_freq = atof(val);
         break;
 
+    case TOK_CACHE_TIMEOUT:
+        if (1 != sscanf(val, "%d", &val_i))
+        {
+            return -RIG_EINVAL;//value format error
+        }
+
+        rs->cache_timeout = val_i;
+        break;
+
+    case TOK_STATS:
+        if (1 != sscanf(val, "%d", &val_i))
+        {
+            return -RIG_EINVAL;//value format error
+        }
+
+        return rig_set_stats(rig, val_i);
+
+    case TOK_VFO_RESTORE_DELAY:
+        if (1 != sscanf(val, "%d", &val_i))
+        {
+            return -RIG_EINVAL;//value format error
+        }
+
+        rs->vfo_restore_delay = val_i;
+        break;
+
+    case TOK_PTT_HOLD:
+        if (1 != sscanf(val, "%d", &val_i))
+        {
+            return -RIG_EINVAL;//value format error
+        }
+
+        rs->ptt_hold = val_i ? 1 : 0;
+        break;
+
 
     default:
         return -RIG_EINVAL;
@@ -718,6 +775,22 @@ static int frontend_get_conf(RIG *rig, token_t token, char *val)
         sprintf(val, "%d", rs->poll_interval);
         break;
 
+    case TOK_CACHE_TIMEOUT:
+        sprintf(val, "%d", rs->cache_timeout);
+        break;
+
+    case TOK_STATS:
+        sprintf(val, "%d", rig_stats_enabled(rig));
+        break;
+
+    case TOK_VFO_RESTORE_DELAY:
+        sprintf(val, "%d", rs->vfo_restore_delay);
+        break;
+
+    case TOK_PTT_HOLD:
+        sprintf(val, "%d", rs->ptt_hold);
+        break;
+
     case TOK_PTT_TYPE:
         switch (rs->pttport.type.ptt)
         {
@@ -1009,6 +1082,9 @@ int HAMLIB_API rig_set_conf(RIG *rig, token_t token, const char *val)
         rig_debug(RIG_DEBUG_VERBOSE, "%s: %s='%s'\n", __func__, cfp->name, val);
     }
 
+    /* e.g. lo_freq or vfo_comp change what rig_get_freq() returns */
+    rig_cache_invalidate(rig, RIG_CACHE_ALL);
+
     if (IS_TOKEN_FRONTEND(token))
     {
         return frontend_set_conf(rig, token, val);
@@ -52,20 +52,47 @@
 #include "misc.h"
 
 #define DUMP_HEX_WIDTH 16
+#define DEBUG_RING_LINE 160     /* longer messages are truncated */
 
 
-static int rig_debug_level = RIG_DEBUG_TRACE;
+/* exported so that the rig_debug() macro can test it inline */
+int rig_debug_level = RIG_DEBUG_TRACE;
 static int rig_debug_time_stamp = 0;
 static FILE *rig_debug_stream;
 static vprintf_cb_t rig_vprintf_cb;
 static rig_ptr_t rig_vprintf_arg;
 
+/*
+ * In memory trace. Writers take an index with an atomic increment of
+ * the head, so several threads can log at once without a lock, and
+ * format the message on their own stack. Once the ring wrapped, two
+ * writers may get the same slot: the slot is then claimed by swapping
+ * its sequence number for DEBUG_RING_BUSY, and the loser, or an older
+ * message, is dropped rather than mixed with the other. The sequence
+ * number is only set once the text is complete, letting the dump skip
+ * slots that are being rewritten.
+ */
+#define DEBUG_RING_BUSY ((unsigned long) -1)
+
+struct debug_ring_entry
+{
+    unsigned long seq;      /* index + 1 once written */
+    char text[DEBUG_RING_LINE];
+};
+
+static struct debug_ring_entry *debug_ring;
+static unsigned long debug_ring_size;
+static unsigned long debug_ring_head;   /* next index to write */
+static unsigned long debug_ring_tail;   /* first index not yet dumped */
+static enum rig_debug_level_e debug_ring_dump_level;
+
 
 /**
  * \param ptr Pointer to memory area
  * \param size Number of chars to words to dump
  * \brief Do a hex dump of the unsigned char array.
  */
+#undef dump_hex
 void dump_hex(const unsigned char ptr[], size_t size)
 {
     /* example
@@ -127,7 +154,7 @@ void HAMLIB_API rig_set_debug(enum rig_debug_level_e debug_level)
  */
 int HAMLIB_API rig_need_debug(enum rig_debug_level_e debug_level)
 {
-    return (debug_level <= rig_debug_level);
+    return RIG_DEBUG_ENABLED(debug_level);
 }
 
 /**
@@ -155,6 +182,176 @@ char *date_strget(char *buf, int buflen)
     return buf;
 }
 
+static void debug_ring_add(const char *fmt, va_list ap)
+{
+    char text[DEBUG_RING_LINE];
+    struct debug_ring_entry *e;
+    unsigned long idx, seq;
+    size_t len = 0;
+
+    if (rig_debug_time_stamp)
+    {
+        char buf[256];
+        int n = snprintf(text, sizeof(text), "%s: ",
+                         date_strget(buf, sizeof(buf)));
+
+        len = n < 0 ? 0 : (size_t) n;
+
+        if (len >= sizeof(text))
+        {
+            len = sizeof(text) - 1;
+        }
+    }
+
+    vsnprintf(text + len, sizeof(text) - len, fmt, ap);
+
+    idx = __sync_fetch_and_add(&debug_ring_head, 1);
+    e = &debug_ring[idx % debug_ring_size];
+
+    do
+    {
+        seq = e->seq;
+
+        if (seq == DEBUG_RING_BUSY || seq > idx)
+        {
+            /* another writer has the slot, or a newer message is in */
+            return;
+        }
+    }
+    while (!__sync_bool_compare_and_swap(&e->seq, seq, DEBUG_RING_BUSY));
+
+    memcpy(e->text, text, sizeof(text));
+
+    __sync_synchronize();
+    e->seq = idx + 1;
+}
+
+
+/**
+ * \brief write out the in memory trace
+ * \param stream The stream to write to, NULL for the debug stream
+ *
+ * Writes the messages recorded since the previous dump, oldest first.
+ * Messages overwritten in the meantime are lost, their number is
+ * reported instead.
+ *
+ * \return the number of messages written, or -RIG_EINVAL if the ring
+ * is not enabled.
+ *
+ * \sa rig_set_debug_ring()
+ */
+int HAMLIB_API rig_debug_ring_dump(FILE *stream)
+{
+    unsigned long head, i;
+    int n = 0;
+
+    if (!debug_ring)
+    {
+        return -RIG_EINVAL;
+    }
+
+    if (!stream)
+    {
+        stream = rig_debug_stream ? rig_debug_stream : stderr;
+    }
+
+    /* claim what is there, so concurrent dumps do not repeat it */
+    do
+    {
+        i = debug_ring_tail;
+        head = debug_ring_head;
+    }
+    while (!__sync_bool_compare_and_swap(&debug_ring_tail, i, head));
+
+    if (head - i > debug_ring_size)
+    {
+        fprintf(stream, "[%lu trace messages lost]\n",
+                head - debug_ring_size - i);
+        i = head - debug_ring_size;
+    }
+
+    for (; i < head; i++)
+    {
+        struct debug_ring_entry *e = &debug_ring[i % debug_ring_size];
+        char text[DEBUG_RING_LINE];
+
+        if (e->seq != i + 1)
+        {
+            continue;   /* being written, or already recycled */
+        }
+
+        memcpy(text, e->text, sizeof(text));
+        __sync_synchronize();
+
+        if (e->seq != i + 1)
+        {
+            continue;
+        }
+
+        text[sizeof(text) - 1] = '\0';
+        fputs(text, stream);
+        n++;
+    }
+
+    fflush(stream);
+
+    return n;
+}
+
+
+/**
+ * \brief keep debug messages in memory
+ * \param size       The number of messages to keep, 0 to go back to
+ *                   the debug stream
+ * \param dump_level Messages at this level or more severe write out
+ *                   the trace, e.g. RIG_DEBUG_ERR
+ *
+ * With the ring enabled, debug messages up to the rig_set_debug() level
+ * are formatted into a circular buffer instead of being written and
+ * flushed to the debug stream one by one. The buffer is written out
+ * when a message at \a dump_level or below comes in, or on demand with
+ * rig_debug_ring_dump(). This makes it cheap to run with
+ * RIG_DEBUG_TRACE enabled and still get the context of an error.
+ * A callback set with rig_set_debug_callback() still gets every
+ * message.
+ *
+ * Call it before any other thread uses Hamlib.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured.
+ *
+ * \sa rig_debug_ring_dump()
+ */
+int HAMLIB_API rig_set_debug_ring(int size, enum rig_debug_level_e dump_level)
+{
+    struct debug_ring_entry *ring = NULL;
+
+    if (size < 0)
+    {
+        return -RIG_EINVAL;
+    }
+
+    if (size > 0)
+    {
+        ring = calloc(size, sizeof(struct debug_ring_entry));
+
+        if (!ring)
+        {
+            return -RIG_ENOMEM;
+        }
+    }
+
+    free(debug_ring);
+    debug_ring = ring;
+    debug_ring_size = size;
+    debug_ring_head = 0;
+    debug_ring_tail = 0;
+    debug_ring_dump_level = dump_level;
+
+    return RIG_OK;
+}
+
+
 /**
  * \param debug_level
  * \param fmt
@@ -171,6 +368,17 @@ void HAMLIB_API rig_debug(enum rig_debug_level_e debug_level,
         return;
     }
 
+    if (debug_ring)
+    {
+        va_start(ap, fmt);
+        debug_ring_add(fmt, ap);
+        va_end(ap);
+
+        if (debug_level <= debug_ring_dump_level)
+        {
+            rig_debug_ring_dump(NULL);
+        }
+    }
 
     va_start(ap, fmt);
 
@@ -178,7 +386,7 @@ void HAMLIB_API rig_debug(enum rig_debug_level_e debug_level,
     {
         rig_vprintf_cb(debug_level, rig_vprintf_arg, fmt, ap);
     }
-    else
+    else if (!debug_ring)
     {
         if (!rig_debug_stream)
         {
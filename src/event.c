@@ -55,9 +55,19 @@
 #include <signal.h>
 #include <errno.h>
 
+#ifdef HAVE_PTHREAD
+#  include <pthread.h>
+#endif
+
+#if defined(HAVE_PTHREAD) && defined(HAVE_SYS_EPOLL_H)
+#  define HAVE_EVENT_LOOP 1
+#  include <sys/epoll.h>
+#endif
+
 
 #include <hamlib/rig.h>
 #include "event.h"
+#include "misc.h"
 
 #if defined(WIN32) && !defined(HAVE_TERMIOS_H)
 #  include "win32termios.h"
@@ -68,6 +78,8 @@
 
 #define CHECK_RIG_ARG(r) (!(r) || !(r)->caps || !(r)->state.comm_state)
 
+#define TRN_MAX_DECODE  16      /* decode_event calls per SIGIO and rig */
+
 
 #ifdef HAVE_SIGACTION
 static struct sigaction hamlib_trn_oldact, hamlib_trn_poll_oldact;
@@ -86,6 +98,311 @@ static void sa_sigalrmhandler(int signum);
 extern int foreach_opened_rig(int (*cfunc)(RIG *, rig_ptr_t), rig_ptr_t data);
 
 
+/*
+ * The decode lock serializes the backend transactions with the event
+ * decoder, which runs on its own thread. It is recursive, since the
+ * callbacks fired by the decoder may well issue transactions.
+ * hold_decode counts the holders, for the signal driven paths which
+ * cannot take a mutex: while a SIGIO or SIGALRM handler decodes or
+ * polls a rig, the transactions it runs on its thread only count.
+ */
+#ifdef HAVE_PTHREAD
+struct decode_lock
+{
+    pthread_mutex_t mutex;
+    volatile sig_atomic_t in_signal;    /* a handler runs the backend */
+    pthread_t signal_thread;            /* on this thread */
+};
+#endif
+
+
+void rig_decode_lock_init(RIG *rig)
+{
+#ifdef HAVE_PTHREAD
+    struct decode_lock *l = calloc(1, sizeof(*l));
+    pthread_mutexattr_t attr;
+
+    if (!l)
+    {
+        return;
+    }
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&l->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    rig->state.decode_lock = (rig_ptr_t) l;
+#endif
+}
+
+
+void rig_decode_lock_free(RIG *rig)
+{
+#ifdef HAVE_PTHREAD
+    struct decode_lock *l = (struct decode_lock *) rig->state.decode_lock;
+
+    if (l)
+    {
+        pthread_mutex_destroy(&l->mutex);
+        free(l);
+        rig->state.decode_lock = NULL;
+    }
+
+#endif
+}
+
+
+/*
+ * The decode lock to take, or NULL when there is none or when a signal
+ * handler of this thread runs the backend.
+ */
+#ifdef HAVE_PTHREAD
+static pthread_mutex_t *decode_mutex(RIG *rig)
+{
+    struct decode_lock *l = (struct decode_lock *) rig->state.decode_lock;
+
+    if (!l || (l->in_signal && pthread_equal(l->signal_thread, pthread_self())))
+    {
+        return NULL;
+    }
+
+    return &l->mutex;
+}
+#endif
+
+
+/* mark the backend calls of a signal handler, hold_decode taken */
+static void trn_signal_enter(RIG *rig)
+{
+#ifdef HAVE_PTHREAD
+    struct decode_lock *l = (struct decode_lock *) rig->state.decode_lock;
+
+    if (l)
+    {
+        l->signal_thread = pthread_self();
+        l->in_signal = 1;
+    }
+
+#endif
+}
+
+
+static void trn_signal_leave(RIG *rig)
+{
+#ifdef HAVE_PTHREAD
+    struct decode_lock *l = (struct decode_lock *) rig->state.decode_lock;
+
+    if (l)
+    {
+        l->in_signal = 0;
+    }
+
+#endif
+}
+
+
+/*
+ * Hold the decoder for the length of a transaction,
+ * waiting for the event thread to be done with the port.
+ * The count goes first, so that a signal handler coming in while
+ * the mutex is taken leaves this rig alone.
+ */
+void HAMLIB_API rig_hold_decode(RIG *rig)
+{
+#ifdef HAVE_PTHREAD
+    pthread_mutex_t *m;
+#endif
+
+    rig->state.hold_decode++;
+#ifdef HAVE_PTHREAD
+    m = decode_mutex(rig);
+
+    if (m)
+    {
+        pthread_mutex_lock(m);
+    }
+
+#endif
+}
+
+
+/*
+ * SIGIO only comes for bytes reaching the fd. When a transaction read
+ * ahead some frames into the port buffer, signal them ourselves once
+ * the decoder is no longer held.
+ */
+static void trn_kick(RIG *rig)
+{
+#if defined(HAVE_SIGACTION) && defined(HAVE_SIGINFO_T) && defined(O_ASYNC)
+    int flags;
+
+    if (rig->state.transceive != RIG_TRN_RIG
+            || rig->state.rigport.rx.count == 0
+            || rig->state.rigport.fd < 0)
+    {
+        return;
+    }
+
+    /* signal driven, see add_trn_rig(), rather than the event loop */
+    flags = fcntl(rig->state.rigport.fd, F_GETFL);
+
+    if (flags >= 0 && (flags & O_ASYNC))
+    {
+        raise(SIGIO);
+    }
+
+#endif
+}
+
+
+void HAMLIB_API rig_unhold_decode(RIG *rig)
+{
+#ifdef HAVE_PTHREAD
+    pthread_mutex_t *m = decode_mutex(rig);
+
+    if (m)
+    {
+        pthread_mutex_unlock(m);
+    }
+
+#endif
+    rig->state.hold_decode--;
+
+    if (rig->state.hold_decode == 0)
+    {
+        trn_kick(rig);
+    }
+}
+
+
+/*
+ * Same as rig_hold_decode(), but give up rather than wait.
+ * Returns 1 if the decoder is now held, 0 otherwise.
+ */
+int HAMLIB_API rig_try_hold_decode(RIG *rig)
+{
+#ifdef HAVE_PTHREAD
+    pthread_mutex_t *m = decode_mutex(rig);
+
+    if (m)
+    {
+        if (pthread_mutex_trylock(m))
+        {
+            return 0;
+        }
+
+        rig->state.hold_decode++;
+        return 1;
+    }
+
+#endif
+
+    if (rig->state.hold_decode)
+    {
+        return 0;
+    }
+
+    rig->state.hold_decode++;
+    return 1;
+}
+
+
+/*
+ * poll_rig_state
+ * Query vfo/freq/mode/ptt from the backend and fire the callbacks
+ * for whatever changed since the last call.
+ * Caller is responsible for holding the decoder.
+ *
+ * assumes rig!=NULL
+ */
+static void poll_rig_state(RIG *rig)
+{
+    struct rig_state *rs = &rig->state;
+    int retval;
+
+    if (rig->caps->get_vfo && rig->callbacks.vfo_event)
+    {
+        vfo_t vfo = RIG_VFO_CURR;
+
+        retval = rig->caps->get_vfo(rig, &vfo);
+
+        if (retval == RIG_OK)
+        {
+            if (vfo != rs->current_vfo)
+            {
+                rig->callbacks.vfo_event(rig, vfo, rig->callbacks.vfo_arg);
+            }
+
+            rs->current_vfo = vfo;
+        }
+    }
+
+    if (rig->caps->get_freq && rig->callbacks.freq_event)
+    {
+        freq_t freq;
+
+        retval = rig->caps->get_freq(rig, RIG_VFO_CURR, &freq);
+
+        if (retval == RIG_OK)
+        {
+            if (freq != rs->current_freq)
+            {
+                rig->callbacks.freq_event(rig,
+                                          RIG_VFO_CURR,
+                                          freq,
+                                          rig->callbacks.freq_arg);
+            }
+
+            rs->current_freq = freq;
+        }
+    }
+
+    if (rig->caps->get_mode && rig->callbacks.mode_event)
+    {
+        rmode_t rmode;
+        pbwidth_t width;
+
+        retval = rig->caps->get_mode(rig, RIG_VFO_CURR, &rmode, &width);
+
+        if (retval == RIG_OK)
+        {
+            if (rmode != rs->current_mode || width != rs->current_width)
+            {
+                rig->callbacks.mode_event(rig,
+                                          RIG_VFO_CURR,
+                                          rmode,
+                                          width,
+                                          rig->callbacks.mode_arg);
+            }
+
+            rs->current_mode = rmode;
+            rs->current_width = width;
+        }
+    }
+
+    if (rig->caps->get_ptt && rig->callbacks.ptt_event)
+    {
+        ptt_t ptt;
+
+        retval = rig->caps->get_ptt(rig, RIG_VFO_CURR, &ptt);
+
+        if (retval == RIG_OK)
+        {
+            if ((ptt != RIG_PTT_OFF) != (rs->transmit != 0))
+            {
+                rig->callbacks.ptt_event(rig,
+                                         RIG_VFO_CURR,
+                                         ptt,
+                                         rig->callbacks.ptt_arg);
+            }
+
+            rs->transmit = ptt != RIG_PTT_OFF;
+        }
+    }
+}
+
+
 /*
  * add_trn_rig
  * not exported in Hamlib API.
@@ -339,172 +656,657 @@ static int search_rig_and_decode(RIG *rig, rig_ptr_t data)
         return -1;
     }
 
-#endif
+#endif
+
+    /*
+     * Do not disturb, the backend is currently receiving data
+     */
+    if (rig->state.hold_decode)
+    {
+        return -1;
+    }
+
+    if (rig->caps->decode_event)
+    {
+        int i = 0;
+
+        rig->state.hold_decode++;
+        trn_signal_enter(rig);
+
+        /*
+         * SIGIO only tells about the fd, not about the frames already
+         * read ahead into the port buffer, by a transaction or by this
+         * decode: those would otherwise wait for the next byte.
+         */
+        do
+        {
+            rig->caps->decode_event(rig);
+        }
+        while (++i < TRN_MAX_DECODE && rig->state.rigport.rx.count > 0);
+
+        trn_signal_leave(rig);
+        rig->state.hold_decode--;
+    }
+
+    return 1;   /* process each opened rig */
+}
+
+
+/*
+ * This is used by sa_sigio, the SIGALRM handler
+ * to poll each RIG in RIG_TRN_POLL mode.
+ *
+ * assumes rig!=NULL
+ */
+static int search_rig_and_poll(RIG *rig, rig_ptr_t data)
+{
+    if (rig->state.transceive != RIG_TRN_POLL)
+    {
+        return -1;
+    }
+
+    /*
+     * Do not disturb, the backend is currently receiving data
+     */
+    if (rig->state.hold_decode)
+    {
+        return -1;
+    }
+
+    rig->state.hold_decode++;
+    trn_signal_enter(rig);
+
+    poll_rig_state(rig);
+
+    trn_signal_leave(rig);
+    rig->state.hold_decode--;
+
+    return 1;   /* process each opened rig */
+}
+
+
+/*
+ * This is the SIGIO handler
+ *
+ * lookup in the list of open rigs,
+ * check the rig is not holding SIGIO,
+ * then call rig->caps->decode_event()  (this is done by search_rig)
+ */
+#ifdef HAVE_SIGINFO_T
+static void sa_sigioaction(int signum, siginfo_t *si, rig_ptr_t data)
+{
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: activity detected\n", __func__);
+
+    foreach_opened_rig(search_rig_and_decode, si);
+}
+
+#else
+
+static void sa_sigiohandler(int signum)
+{
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: activity detected\n", __func__);
+
+    foreach_opened_rig(search_rig_and_decode, NULL);
+}
+
+#endif
+
+
+/*
+ * This is the SIGALRM handler
+ *
+ * lookup in the list of open rigs,
+ * check the rig is not holding SIGALRM,
+ * then call get_freq and check for changes  (this is done by search_rig)
+ */
+#ifdef HAVE_SIGINFO_T
+static void sa_sigalrmaction(int signum, siginfo_t *si, rig_ptr_t data)
+{
+    rig_debug(RIG_DEBUG_TRACE, "%s entered\n", __func__);
+
+    foreach_opened_rig(search_rig_and_poll, si);
+}
+
+#else
+
+static void sa_sigalrmhandler(int signum)
+{
+    rig_debug(RIG_DEBUG_TRACE, "%s entered\n", __func__);
+
+    foreach_opened_rig(search_rig_and_poll, NULL);
+}
+
+#endif /* !HAVE_SIGINFO_T */
+
+#endif /* HAVE_SIGINFO */
+
+#ifdef HAVE_EVENT_LOOP
+
+/*
+ * Event loop thread.
+ *
+ * Instead of SIGIO/SIGALRM, one thread watches the port of every rig
+ * in RIG_TRN_RIG mode with epoll, and keeps a poll deadline per rig in
+ * RIG_TRN_POLL mode, so each rig gets its own poll_interval.
+ * Callbacks are called from that thread, with the decoder of the rig
+ * held but not evl_mutex, so a slow rig does not stall the others.
+ * Entries are only freed by that thread, which may thus keep using
+ * one while evl_mutex is released.
+ */
+
+#define EVL_MAX_EVENTS  16
+#define EVL_MAX_DECODE  16      /* decode_event calls per wakeup and rig */
+#define EVL_RETRY_MS    10      /* retry delay when the decoder is held */
+
+struct evl_rig
+{
+    RIG *rig;               /* NULL once removed, freed by the thread */
+    int trn;                /* RIG_TRN_RIG or RIG_TRN_POLL */
+    int fd;                 /* fd registered with epoll, or -1 */
+    int pending;            /* RIG_TRN_RIG: data left, decoder was held */
+    int64_t next_poll;      /* RIG_TRN_POLL: next poll time in ms */
+    struct evl_rig *next;
+};
+
+static pthread_once_t evl_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t evl_mutex;
+static pthread_t evl_thread;
+static int evl_running;
+static int evl_epfd = -1;
+static int evl_pipe[2] = { -1, -1 };
+static struct evl_rig *evl_list;
+
+
+static void evl_init_mutex(void)
+{
+    pthread_mutex_init(&evl_mutex, NULL);
+}
+
+
+static int64_t evl_now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+
+static void evl_wakeup(void)
+{
+    char c = 0;
+
+    if (write(evl_pipe[1], &c, 1) < 0 && errno != EAGAIN)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: write: %s\n", __func__, strerror(errno));
+    }
+}
+
+
+/*
+ * Data is waiting when either the port buffer or the fd has some.
+ */
+static int evl_readable(RIG *rig)
+{
+    hamlib_port_t *p = &rig->state.rigport;
+    fd_set rfds;
+    struct timeval tv;
+
+    if (p->rx.count > 0)
+    {
+        return 1;
+    }
+
+    FD_ZERO(&rfds);
+    FD_SET(p->fd, &rfds);
+    tv.tv_sec = 0;
+    tv.tv_usec = 0;
+
+    return select(p->fd + 1, &rfds, NULL, NULL, &tv) > 0;
+}
+
+
+/*
+ * The decoder may be held by an application thread in the middle of
+ * a transaction. Do not wait for it, the frames will still be there
+ * on the next pass.
+ */
+static int evl_hold(RIG *rig)
+{
+    return rig_try_hold_decode(rig);
+}
+
+
+/* evl_mutex held, released while decoding */
+static void evl_decode(struct evl_rig *e)
+{
+    RIG *rig = e->rig;
+    int i;
+
+    if (!rig->caps->decode_event)
+    {
+        return;
+    }
+
+    /* held, evl_remove_rig() waits for us before returning */
+    if (!evl_hold(rig))
+    {
+        e->pending = 1;
+        return;
+    }
+
+    e->pending = 0;
+    pthread_mutex_unlock(&evl_mutex);
+
+    /*
+     * epoll is edge triggered, and the port buffer may still hold
+     * complete frames after the first decode, so drain it here.
+     */
+    for (i = 0; i < EVL_MAX_DECODE && evl_readable(rig); i++)
+    {
+        int removed;
+
+        rig->caps->decode_event(rig);
+
+        pthread_mutex_lock(&evl_mutex);
+        removed = !e->rig;
+        pthread_mutex_unlock(&evl_mutex);
+
+        if (removed)
+        {
+            /* transceive turned off by a callback */
+            break;
+        }
+    }
+
+    rig_unhold_decode(rig);
+    pthread_mutex_lock(&evl_mutex);
+}
+
+
+/* evl_mutex held, released while polling */
+static void evl_poll(struct evl_rig *e, int64_t now)
+{
+    RIG *rig = e->rig;
+    int interval = rig->state.poll_interval > 0 ?
+                   rig->state.poll_interval : 1;
+
+    if (now < e->next_poll)
+    {
+        return;
+    }
+
+    e->next_poll = now + interval;
+
+    if (!evl_hold(rig))
+    {
+        return;
+    }
+
+    pthread_mutex_unlock(&evl_mutex);
+
+    poll_rig_state(rig);
+
+    rig_unhold_decode(rig);
+    pthread_mutex_lock(&evl_mutex);
+}
+
+
+/* free entries removed since the last pass, evl_mutex held */
+static void evl_sweep(void)
+{
+    struct evl_rig **pp = &evl_list;
+
+    while (*pp)
+    {
+        struct evl_rig *e = *pp;
+
+        if (e->rig)
+        {
+            pp = &e->next;
+            continue;
+        }
+
+        *pp = e->next;
+        free(e);
+    }
+}
+
+
+/* ms to sleep until the next deadline, -1 for none, evl_mutex held */
+static int evl_timeout(int64_t now)
+{
+    struct evl_rig *e;
+    int64_t deadline = -1;
+
+    for (e = evl_list; e; e = e->next)
+    {
+        int64_t t;
+
+        if (e->trn == RIG_TRN_POLL)
+        {
+            t = e->next_poll;
+        }
+        else if (e->pending)
+        {
+            t = now + EVL_RETRY_MS;
+        }
+        else
+        {
+            continue;
+        }
+
+        if (deadline < 0 || t < deadline)
+        {
+            deadline = t;
+        }
+    }
+
+    if (deadline < 0)
+    {
+        return -1;
+    }
+
+    return deadline > now ? (int)(deadline - now) : 0;
+}
+
+
+static void *evl_main(void *arg)
+{
+    struct epoll_event events[EVL_MAX_EVENTS];
+    struct evl_rig *e;
+    int64_t now;
+    int timeout;
+    int n, i;
+
+    (void) arg;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: event loop started\n", __func__);
+
+    pthread_mutex_lock(&evl_mutex);
+
+    while (evl_running)
+    {
+        evl_sweep();
+        timeout = evl_timeout(evl_now());
+
+        pthread_mutex_unlock(&evl_mutex);
+        n = epoll_wait(evl_epfd, events, EVL_MAX_EVENTS, timeout);
+        pthread_mutex_lock(&evl_mutex);
+
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            rig_debug(RIG_DEBUG_ERR, "%s: epoll_wait: %s\n",
+                      __func__,
+                      strerror(errno));
+            break;
+        }
+
+        for (i = 0; i < n && evl_running; i++)
+        {
+            if (events[i].data.fd == evl_pipe[0])
+            {
+                char buf[64];
+
+                while (read(evl_pipe[0], buf, sizeof(buf)) > 0)
+                {
+                    ;
+                }
+
+                continue;
+            }
+
+            for (e = evl_list; e; e = e->next)
+            {
+                if (e->rig && e->fd == events[i].data.fd)
+                {
+                    evl_decode(e);
+                    break;
+                }
+            }
+        }
+
+        now = evl_now();
 
-    /*
-     * Do not disturb, the backend is currently receiving data
-     */
-    if (rig->state.hold_decode)
-    {
-        return -1;
-    }
+        for (e = evl_list; e && evl_running; e = e->next)
+        {
+            if (!e->rig)
+            {
+                continue;
+            }
 
-    if (rig->caps->decode_event)
-    {
-        rig->caps->decode_event(rig);
+            if (e->trn == RIG_TRN_POLL)
+            {
+                evl_poll(e, now);
+            }
+            else if (e->pending && evl_readable(e->rig))
+            {
+                evl_decode(e);
+            }
+            else
+            {
+                e->pending = 0;
+            }
+        }
     }
 
-    return 1;   /* process each opened rig */
+    pthread_mutex_unlock(&evl_mutex);
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: event loop stopped\n", __func__);
+
+    return NULL;
 }
 
 
 /*
- * This is used by sa_sigio, the SIGALRM handler
- * to poll each RIG in RIG_TRN_POLL mode.
- *
- * assumes rig!=NULL
+ * evl_add_rig
+ * Hand a rig over to the event loop thread.
+ * Returns 0 when the loop is not running, 1 on success,
+ * or a negative RIG error code.
  */
-static int search_rig_and_poll(RIG *rig, rig_ptr_t data)
+static int evl_add_rig(RIG *rig, int trn)
 {
-    struct rig_state *rs = &rig->state;
-    int retval;
+    struct evl_rig *e;
+    int fd = rig->state.rigport.fd;
 
-    if (rig->state.transceive != RIG_TRN_POLL)
+    pthread_once(&evl_once, evl_init_mutex);
+    pthread_mutex_lock(&evl_mutex);
+
+    if (!evl_running)
     {
-        return -1;
+        pthread_mutex_unlock(&evl_mutex);
+        return 0;
     }
 
-    /*
-     * Do not disturb, the backend is currently receiving data
-     */
-    if (rig->state.hold_decode)
+    if (trn == RIG_TRN_RIG && fd < 0)
     {
-        return -1;
+        pthread_mutex_unlock(&evl_mutex);
+        return -RIG_EINVAL;
     }
 
-    rig->state.hold_decode = 2;
+    e = calloc(1, sizeof(struct evl_rig));
 
-    if (rig->caps->get_vfo && rig->callbacks.vfo_event)
+    if (!e)
     {
-        vfo_t vfo = RIG_VFO_CURR;
+        pthread_mutex_unlock(&evl_mutex);
+        return -RIG_ENOMEM;
+    }
 
-        retval = rig->caps->get_vfo(rig, &vfo);
+    e->rig = rig;
+    e->trn = trn;
+    e->fd = -1;
+    e->next_poll = evl_now() + rig->state.poll_interval;
 
-        if (retval == RIG_OK)
-        {
-            if (vfo != rs->current_vfo)
-            {
-                rig->callbacks.vfo_event(rig, vfo, rig->callbacks.vfo_arg);
-            }
+    if (trn == RIG_TRN_RIG)
+    {
+        struct epoll_event ev;
 
-            rs->current_vfo = vfo;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.fd = fd;
+
+        if (epoll_ctl(evl_epfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+        {
+            rig_debug(RIG_DEBUG_ERR, "%s: epoll_ctl: %s\n",
+                      __func__,
+                      strerror(errno));
+            free(e);
+            pthread_mutex_unlock(&evl_mutex);
+            return -RIG_EIO;
         }
+
+        e->fd = fd;
+        /* something may have arrived before the fd was watched */
+        e->pending = 1;
     }
 
-    if (rig->caps->get_freq && rig->callbacks.freq_event)
-    {
-        freq_t freq;
+    e->next = evl_list;
+    evl_list = e;
 
-        retval = rig->caps->get_freq(rig, RIG_VFO_CURR, &freq);
+    evl_wakeup();
+    pthread_mutex_unlock(&evl_mutex);
 
-        if (retval == RIG_OK)
+    return 1;
+}
+
+
+/*
+ * evl_remove_rig
+ * Take a rig back from the event loop thread.
+ * Returns 1 when the rig was handled by the loop, 0 otherwise.
+ * Once this returns, no callback is running for this rig,
+ * unless called from such a callback.
+ */
+static int evl_remove_rig(RIG *rig)
+{
+    struct evl_rig *e;
+    int found = 0;
+
+    pthread_once(&evl_once, evl_init_mutex);
+    pthread_mutex_lock(&evl_mutex);
+
+    for (e = evl_list; e; e = e->next)
+    {
+        if (e->rig != rig)
         {
-            if (freq != rs->current_freq)
-            {
-                rig->callbacks.freq_event(rig,
-                                          RIG_VFO_CURR,
-                                          freq,
-                                          rig->callbacks.freq_arg);
-            }
+            continue;
+        }
 
-            rs->current_freq = freq;
+        if (e->fd >= 0)
+        {
+            epoll_ctl(evl_epfd, EPOLL_CTL_DEL, e->fd, NULL);
         }
+
+        e->rig = NULL;
+        found = 1;
     }
 
-    if (rig->caps->get_mode && rig->callbacks.mode_event)
+    if (found)
     {
-        rmode_t rmode;
-        pbwidth_t width;
+        evl_wakeup();
+    }
 
-        retval = rig->caps->get_mode(rig, RIG_VFO_CURR, &rmode, &width);
+    pthread_mutex_unlock(&evl_mutex);
 
-        if (retval == RIG_OK)
-        {
-            if (rmode != rs->current_mode || width != rs->current_width)
-            {
-                rig->callbacks.mode_event(rig,
-                                          RIG_VFO_CURR,
-                                          rmode,
-                                          width,
-                                          rig->callbacks.mode_arg);
-            }
+    if (found)
+    {
+        /* wait for a decode or poll still running on the loop thread */
+        rig_hold_decode(rig);
+        rig_unhold_decode(rig);
+    }
 
-            rs->current_mode = rmode;
-            rs->current_width = width;
-        }
+    return found;
+}
+
+
+/* whether the loop handles rig */
+static int evl_has_rig(RIG *rig)
+{
+    struct evl_rig *e;
+    int found = 0;
+
+    pthread_once(&evl_once, evl_init_mutex);
+    pthread_mutex_lock(&evl_mutex);
+
+    for (e = evl_list; e && !found; e = e->next)
+    {
+        found = e->rig == rig;
     }
 
-    rig->state.hold_decode = 0;
+    pthread_mutex_unlock(&evl_mutex);
 
-    return 1;   /* process each opened rig */
+    return found;
 }
 
 
-/*
- * This is the SIGIO handler
- *
- * lookup in the list of open rigs,
- * check the rig is not holding SIGIO,
- * then call rig->caps->decode_event()  (this is done by search_rig)
- */
-#ifdef HAVE_SIGINFO_T
-static void sa_sigioaction(int signum, siginfo_t *si, rig_ptr_t data)
+/* move a rig already in transceive mode from signals to the loop */
+static int evl_adopt_rig(RIG *rig, rig_ptr_t data)
 {
-    rig_debug(RIG_DEBUG_VERBOSE, "%s: activity detected\n", __func__);
+    int trn = rig->state.transceive;
 
-    foreach_opened_rig(search_rig_and_decode, si);
+    (void) data;
+
+    if (trn != RIG_TRN_OFF)
+    {
+        rig_set_trn(rig, RIG_TRN_OFF);
+        rig_set_trn(rig, trn);
+    }
+
+    return 1;   /* process each opened rig */
 }
 
 #else
 
-static void sa_sigiohandler(int signum)
+static int evl_add_rig(RIG *rig, int trn)
 {
-    rig_debug(RIG_DEBUG_VERBOSE, "%s: activity detected\n", __func__);
+    return 0;
+}
 
-    foreach_opened_rig(search_rig_and_decode, NULL);
+static int evl_remove_rig(RIG *rig)
+{
+    return 0;
 }
 
-#endif
+static int evl_has_rig(RIG *rig)
+{
+    return 0;
+}
+
+#endif /* HAVE_EVENT_LOOP */
 
 
 /*
- * This is the SIGALRM handler
- *
- * lookup in the list of open rigs,
- * check the rig is not holding SIGALRM,
- * then call get_freq and check for changes  (this is done by search_rig)
+ * Whether the backend of rig runs from a signal handler of this thread,
+ * where no mutex may be taken.
  */
-#ifdef HAVE_SIGINFO_T
-static void sa_sigalrmaction(int signum, siginfo_t *si, rig_ptr_t data)
+int HAMLIB_API rig_decode_in_signal(RIG *rig)
 {
-    rig_debug(RIG_DEBUG_TRACE, "%s entered\n", __func__);
+#ifdef HAVE_PTHREAD
+    struct decode_lock *l = (struct decode_lock *) rig->state.decode_lock;
 
-    foreach_opened_rig(search_rig_and_poll, si);
+    return l && l->in_signal && pthread_equal(l->signal_thread, pthread_self());
+#else
+    return 0;
+#endif
 }
 
-#else
 
-static void sa_sigalrmhandler(int signum)
+/*
+ * Whether the transceive mode of rig is driven by SIGIO or SIGALRM
+ * rather than the event loop, so its backend may run from a handler.
+ * Not for use from such a handler.
+ */
+int HAMLIB_API rig_trn_by_signal(RIG *rig)
 {
-    rig_debug(RIG_DEBUG_TRACE, "%s entered\n", __func__);
-
-    foreach_opened_rig(search_rig_and_poll, NULL);
+    return rig->state.transceive != RIG_TRN_OFF && !evl_has_rig(rig);
 }
 
-#endif /* !HAVE_SIGINFO_T */
-
-#endif /* HAVE_SIGINFO */
-
 #endif  /* !DOC_HIDDEN */
 
 
@@ -747,7 +1549,16 @@ int HAMLIB_API rig_set_trn(RIG *rig, int trn)
             return -RIG_ENAVAIL;
         }
 
-        retcode = add_trn_rig(rig);
+        retcode = evl_add_rig(rig, RIG_TRN_RIG);
+
+        if (retcode == 0)
+        {
+            retcode = add_trn_rig(rig);
+        }
+        else if (retcode > 0)
+        {
+            retcode = RIG_OK;
+        }
 
         /* some protocols (e.g. CI-V's) offer no way
          * to turn on/off the transceive mode */
@@ -759,6 +1570,14 @@ int HAMLIB_API rig_set_trn(RIG *rig, int trn)
         break;
 
     case RIG_TRN_POLL:
+        retcode = evl_add_rig(rig, RIG_TRN_POLL);
+
+        if (retcode != 0)
+        {
+            retcode = retcode > 0 ? RIG_OK : retcode;
+            break;
+        }
+
 #ifdef HAVE_SETITIMER
 
         add_trn_poll_rig(rig);
@@ -786,7 +1605,15 @@ int HAMLIB_API rig_set_trn(RIG *rig, int trn)
         break;
 
     case RIG_TRN_OFF:
-        if (rig->state.transceive == RIG_TRN_POLL)
+        if (evl_remove_rig(rig))
+        {
+            if (rig->state.transceive == RIG_TRN_RIG
+                    && caps->set_trn && caps->transceive == RIG_TRN_RIG)
+            {
+                retcode = caps->set_trn(rig, RIG_TRN_OFF);
+            }
+        }
+        else if (rig->state.transceive == RIG_TRN_POLL)
         {
 #ifdef HAVE_SETITIMER
 
@@ -868,4 +1695,168 @@ int HAMLIB_API rig_get_trn(RIG *rig, int *trn)
     return RIG_OK;
 }
 
+
+/**
+ * \brief start the transceive event loop thread
+ *
+ *  Hands transceive handling of all rigs over to a dedicated thread,
+ *  instead of the SIGIO and SIGALRM handlers.
+ *  The thread watches the port of every rig in RIG_TRN_RIG mode,
+ *  and polls every rig in RIG_TRN_POLL mode at its own poll_interval.
+ *  Rigs already in transceive mode are moved over to the thread,
+ *  and later calls to rig_set_trn() are served by it until
+ *  rig_event_loop_stop() is called.
+ *
+ *  Event callbacks are then called from the event loop thread,
+ *  one at a time. They may call rig_set_trn() and the rig API,
+ *  but must not call rig_cleanup() or rig_event_loop_stop().
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_event_loop_stop(), rig_set_trn()
+ */
+int HAMLIB_API rig_event_loop_start(void)
+{
+#ifdef HAVE_EVENT_LOOP
+    struct epoll_event ev;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    pthread_once(&evl_once, evl_init_mutex);
+    pthread_mutex_lock(&evl_mutex);
+
+    if (evl_running)
+    {
+        pthread_mutex_unlock(&evl_mutex);
+        return RIG_OK;
+    }
+
+    evl_epfd = epoll_create(EVL_MAX_EVENTS);
+
+    if (evl_epfd < 0)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: epoll_create: %s\n",
+                  __func__,
+                  strerror(errno));
+        pthread_mutex_unlock(&evl_mutex);
+        return -RIG_EINTERNAL;
+    }
+
+    if (pipe(evl_pipe) < 0)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: pipe: %s\n", __func__, strerror(errno));
+        close(evl_epfd);
+        evl_epfd = -1;
+        pthread_mutex_unlock(&evl_mutex);
+        return -RIG_EINTERNAL;
+    }
+
+    fcntl(evl_pipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(evl_pipe[1], F_SETFL, O_NONBLOCK);
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = evl_pipe[0];
+    epoll_ctl(evl_epfd, EPOLL_CTL_ADD, evl_pipe[0], &ev);
+
+    evl_running = 1;
+
+    if (pthread_create(&evl_thread, NULL, evl_main, NULL) != 0)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: pthread_create failed\n", __func__);
+        evl_running = 0;
+        close(evl_pipe[0]);
+        close(evl_pipe[1]);
+        close(evl_epfd);
+        evl_epfd = -1;
+        pthread_mutex_unlock(&evl_mutex);
+        return -RIG_EINTERNAL;
+    }
+
+    pthread_mutex_unlock(&evl_mutex);
+
+    foreach_opened_rig(evl_adopt_rig, NULL);
+
+    return RIG_OK;
+#else
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    return -RIG_ENIMPL;
+#endif
+}
+
+
+/**
+ * \brief stop the transceive event loop thread
+ *
+ *  Stops the thread started by rig_event_loop_start() and waits for it.
+ *  Rigs still in transceive mode go back to signal driven handling.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_event_loop_start()
+ */
+int HAMLIB_API rig_event_loop_stop(void)
+{
+#ifdef HAVE_EVENT_LOOP
+    struct evl_rig *list, *e;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    pthread_once(&evl_once, evl_init_mutex);
+    pthread_mutex_lock(&evl_mutex);
+
+    if (!evl_running)
+    {
+        pthread_mutex_unlock(&evl_mutex);
+        return RIG_OK;
+    }
+
+    if (pthread_equal(pthread_self(), evl_thread))
+    {
+        pthread_mutex_unlock(&evl_mutex);
+        return -RIG_EINVAL;
+    }
+
+    evl_running = 0;
+    evl_wakeup();
+    pthread_mutex_unlock(&evl_mutex);
+
+    pthread_join(evl_thread, NULL);
+
+    pthread_mutex_lock(&evl_mutex);
+    list = evl_list;
+    evl_list = NULL;
+    close(evl_pipe[0]);
+    close(evl_pipe[1]);
+    close(evl_epfd);
+    evl_epfd = -1;
+    pthread_mutex_unlock(&evl_mutex);
+
+    while (list)
+    {
+        e = list;
+        list = e->next;
+
+        if (e->rig)
+        {
+            e->rig->state.transceive = RIG_TRN_OFF;
+            rig_set_trn(e->rig, e->trn);
+        }
+
+        free(e);
+    }
+
+    return RIG_OK;
+#else
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    return -RIG_ENIMPL;
+#endif
+}
+
 /** @} */
@@ -28,5 +28,8 @@
 int add_trn_rig(RIG *rig);
 int remove_trn_rig(RIG *rig);
 
+void rig_decode_lock_init(RIG *rig);
+void rig_decode_lock_free(RIG *rig);
+
 #endif /* _EVENT_H */
 
@@ -67,6 +67,7 @@ int HAMLIB_API port_open(hamlib_port_t *p)
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
     p->fd = -1;
+    port_rxbuf_flush(p);
 
     switch (p->type.rig)
     {
@@ -230,6 +231,8 @@ int HAMLIB_API port_close(hamlib_port_t *p, rig_port_t port_type)
         p->fd = -1;
     }
 
+    port_rxbuf_flush(p);
+
     return ret;
 }
 
@@ -397,6 +400,148 @@ static ssize_t port_read(hamlib_port_t *p, void *buf, size_t count)
 
 #endif
 
+
+/**
+ * \brief Discard any data held in the port receive buffer
+ * \param p rig port descriptor
+ *
+ * Only the user space buffer is cleared, serial_flush() and
+ * network_flush() take care of the driver side.
+ */
+void HAMLIB_API port_rxbuf_flush(hamlib_port_t *p)
+{
+    if (p->rx.count > 0)
+    {
+        rig_debug(RIG_DEBUG_TRACE,
+                  "%s(): discarding %d buffered bytes\n",
+                  __func__,
+                  p->rx.count);
+    }
+
+    p->rx.head = 0;
+    p->rx.count = 0;
+}
+
+
+/*
+ * Drain whatever the driver has ready into the receive ring buffer,
+ * with a single read.  Only to be called once port_select() reported
+ * the fd as readable.
+ *
+ * Returns the number of bytes added, 0 on end of file, <0 on error.
+ */
+static ssize_t port_rxbuf_fill(hamlib_port_t *p)
+{
+    int tail;
+    size_t room;
+    ssize_t ret;
+
+    if (p->rx.count == 0)
+    {
+        /* restart at the beginning to get the largest contiguous room */
+        p->rx.head = 0;
+    }
+
+    tail = (p->rx.head + p->rx.count) % PORTRXBUFSIZ;
+
+    if (tail >= p->rx.head)
+    {
+        room = PORTRXBUFSIZ - tail;
+    }
+    else
+    {
+        room = p->rx.head - tail;
+    }
+
+#if defined(WIN32) && !defined(HAVE_TERMIOS_H)
+
+    /*
+     * win32_serial_read() waits for the whole request to complete,
+     * so stick to one character at a time there.
+     */
+    if (p->type.rig == RIG_PORT_SERIAL && !is_uh_radio_fd(p->fd))
+    {
+        room = 1;
+    }
+
+#endif
+
+    p->io_count.read_calls++;
+    ret = port_read(p, p->rx.buf + tail, room);
+
+    if (ret > 0)
+    {
+        p->rx.count += ret;
+        p->io_count.rx_bytes += ret;
+    }
+
+    return ret;
+}
+
+
+/*
+ * Move up to count buffered bytes into rxbuffer.
+ * Returns the number of bytes copied.
+ */
+static int port_rxbuf_get(hamlib_port_t *p, char *rxbuffer, size_t count)
+{
+    size_t n, chunk;
+
+    n = count < (size_t)p->rx.count ? count : (size_t)p->rx.count;
+
+    /* at most two pieces when wrapping around the end of the ring */
+    chunk = PORTRXBUFSIZ - p->rx.head;
+
+    if (chunk > n)
+    {
+        chunk = n;
+    }
+
+    memcpy(rxbuffer, p->rx.buf + p->rx.head, chunk);
+    memcpy(rxbuffer + chunk, p->rx.buf, n - chunk);
+
+    p->rx.head = (p->rx.head + n) % PORTRXBUFSIZ;
+    p->rx.count -= n;
+
+    return (int)n;
+}
+
+
+/*
+ * Move buffered bytes into rxbuffer until one of the stopset characters
+ * has been copied or rxmax bytes were copied.
+ * Returns the number of bytes copied, *stop is set if a stopset
+ * character terminated the copy.
+ */
+static int port_rxbuf_get_string(hamlib_port_t *p,
+                                 char *rxbuffer,
+                                 size_t rxmax,
+                                 const char *stopset,
+                                 int stopset_len,
+                                 int *stop)
+{
+    size_t n = 0;
+
+    *stop = 0;
+
+    while (n < rxmax && p->rx.count > 0)
+    {
+        char c = p->rx.buf[p->rx.head];
+
+        rxbuffer[n++] = c;
+        p->rx.head = (p->rx.head + 1) % PORTRXBUFSIZ;
+        p->rx.count--;
+
+        if (stopset && memchr(stopset, c, stopset_len))
+        {
+            *stop = 1;
+            break;
+        }
+    }
+
+    return (int)n;
+}
+
 /**
  * \brief Write a block of characters to an fd.
  * \param p rig port descriptor
@@ -462,6 +607,7 @@ int HAMLIB_API write_block(hamlib_port_t *p, const char *txbuffer, size_t count)
     {
         for (i = 0; i < count; i++)
         {
+            p->io_count.write_calls++;
             ret = port_write(p, txbuffer + i, 1);
 
             if (ret != 1)
@@ -481,6 +627,7 @@ int HAMLIB_API write_block(hamlib_port_t *p, const char *txbuffer, size_t count)
     }
     else
     {
+        p->io_count.write_calls++;
         ret = port_write(p, txbuffer, count);
 
         if (ret != count)
@@ -496,6 +643,8 @@ int HAMLIB_API write_block(hamlib_port_t *p, const char *txbuffer, size_t count)
         }
     }
 
+    p->io_count.tx_bytes += count;
+
     if (p->post_write_delay > 0)
     {
 #ifdef WANT_NON_ACTIVE_POST_WRITE_DELAY
@@ -535,7 +684,9 @@ int HAMLIB_API write_block(hamlib_port_t *p, const char *txbuffer, size_t count)
  *
  * Blocks on read until timeout hits.
  *
- * It then reads "num" bytes into rxbuffer.
+ * It then reads "num" bytes into rxbuffer.  Whatever the driver has
+ * ready is drained into the port receive buffer in a single read, bytes
+ * beyond "num" are kept there for the next read_block() or read_string().
  *
  * Actually, this function has nothing specific to serial comm,
  * it could work very well also with any file handle, like a socket.
@@ -561,12 +712,22 @@ int HAMLIB_API read_block(hamlib_port_t *p, char *rxbuffer, size_t count)
 
     while (count > 0)
     {
+        /* serve from what an earlier read already brought in */
+        if (p->rx.count > 0)
+        {
+            rd_count = port_rxbuf_get(p, rxbuffer + total_count, count);
+            total_count += rd_count;
+            count -= rd_count;
+            continue;
+        }
+
         tv = tv_timeout;    /* select may have updated it */
 
         FD_ZERO(&rfds);
         FD_SET(p->fd, &rfds);
         efds = rfds;
 
+        p->io_count.select_calls++;
         retval = port_select(p, p->fd + 1, &rfds, NULL, &efds, &tv);
 
         if (retval == 0)
@@ -583,6 +744,7 @@ int HAMLIB_API read_block(hamlib_port_t *p, char *rxbuffer, size_t count)
                       (int)elapsed_time.tv_usec,
                       total_count);
 
+            p->io_count.timeouts++;
             return -RIG_ETIMEOUT;
         }
 
@@ -609,10 +771,11 @@ int HAMLIB_API read_block(hamlib_port_t *p, char *rxbuffer, size_t count)
         }
 
         /*
-         * grab bytes from the rig
+         * grab all available bytes from the rig, anything beyond
+         * count is kept in the receive buffer for the next call.
          * The file descriptor must have been set up non blocking.
          */
-        rd_count = port_read(p, rxbuffer + total_count, count);
+        rd_count = port_rxbuf_fill(p);
 
         if (rd_count < 0)
         {
@@ -623,9 +786,6 @@ int HAMLIB_API read_block(hamlib_port_t *p, char *rxbuffer, size_t count)
 
             return -RIG_EIO;
         }
-
-        total_count += rd_count;
-        count -= rd_count;
     }
 
     rig_debug(RIG_DEBUG_TRACE, "%s(): RX %d bytes\n", __func__, total_count);
@@ -654,6 +814,8 @@ int HAMLIB_API read_block(hamlib_port_t *p, char *rxbuffer, size_t count)
  * It then reads characters until one of the characters in
  * "stopset" is found, or until "rxmax-1" characters was copied
  * into rxbuffer.  String termination character is added at the end.
+ * The stopset is searched in the port receive buffer, so a reply costs
+ * one read per chunk delivered by the driver rather than one per character.
  *
  * Actually, this function has nothing specific to serial comm,
  * it could work very well also with any file handle, like a socket.
@@ -670,6 +832,7 @@ int HAMLIB_API read_string(hamlib_port_t *p,
     struct timeval tv, tv_timeout, start_time, end_time, elapsed_time;
     int rd_count, total_count = 0;
     int retval;
+    int stop;
 
     rig_debug(RIG_DEBUG_TRACE, "%s called\n", __func__);
 
@@ -696,12 +859,31 @@ int HAMLIB_API read_string(hamlib_port_t *p,
 
     while (total_count < rxmax - 1)
     {
+        /* scan what an earlier read already brought in */
+        if (p->rx.count > 0)
+        {
+            total_count += port_rxbuf_get_string(p,
+                                                 &rxbuffer[total_count],
+                                                 rxmax - 1 - total_count,
+                                                 stopset,
+                                                 stopset_len,
+                                                 &stop);
+
+            if (stop)
+            {
+                break;
+            }
+
+            continue;
+        }
+
         tv = tv_timeout;    /* select may have updated it */
 
         FD_ZERO(&rfds);
         FD_SET(p->fd, &rfds);
         efds = rfds;
 
+        p->io_count.select_calls++;
         retval = port_select(p, p->fd + 1, &rfds, NULL, &efds, &tv);
 
         if (retval == 0)
@@ -720,6 +902,7 @@ int HAMLIB_API read_string(hamlib_port_t *p,
                           (int)elapsed_time.tv_usec,
                           total_count);
 
+                p->io_count.timeouts++;
                 return -RIG_ETIMEOUT;
             }
 
@@ -749,10 +932,11 @@ int HAMLIB_API read_string(hamlib_port_t *p,
         }
 
         /*
-             * read 1 character from the rig, (check if in stop set)
+         * grab all available bytes from the rig, the stop set is
+         * looked for in the receive buffer on the next pass.
          * The file descriptor must have been set up non blocking.
          */
-        rd_count = port_read(p, &rxbuffer[total_count], 1);
+        rd_count = port_rxbuf_fill(p);
 
         /* if we get 0 bytes or an error something is wrong */
         if (rd_count <= 0)
@@ -765,13 +949,6 @@ int HAMLIB_API read_string(hamlib_port_t *p,
 
             return -RIG_EIO;
         }
-
-        ++total_count;
-
-        if (stopset && memchr(stopset, rxbuffer[total_count - 1], stopset_len))
-        {
-            break;
-        }
     }
 
     /*
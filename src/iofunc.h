@@ -38,6 +38,8 @@ extern HAMLIB_EXPORT(int) write_block(hamlib_port_t *p,
                                       const char *txbuffer,
                                       size_t count);
 
+extern HAMLIB_EXPORT(void) port_rxbuf_flush(hamlib_port_t *p);
+
 extern HAMLIB_EXPORT(int) read_string(hamlib_port_t *p,
                                       char *rxbuffer,
                                       size_t rxmax,
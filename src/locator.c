@@ -461,6 +461,101 @@ int HAMLIB_API locator2longlat(double *longitude,
 /* end dph */
 
 
+/**
+ * \brief Convert an array of Maidenhead grid locators to Longitude/Latitude
+ * \param longitude Array for the calculated Longitudes
+ * \param latitude  Array for the calculated Latitudes
+ * \param status    Array for the result of each conversion, may be NULL
+ * \param locator   Array of Maidenhead grid locators
+ * \param count     Number of locators
+ *
+ *  Same as locator2longlat() for \a count locators at once, without the
+ *  per call overhead. A locator which fails to convert gets -RIG_EINVAL
+ *  in \a status, if given, and NAN as longitude and latitude.
+ *
+ * \retval -RIG_EINVAL if an array is NULL or any locator is malformed.
+ * \retval RIG_OK if all the conversions went OK.
+ *
+ * \sa locator2longlat(), qrb_batch()
+ */
+int HAMLIB_API locator2longlat_batch(double *longitude,
+                                     double *latitude,
+                                     int *status,
+                                     const char *const *locator,
+                                     int count)
+{
+    /* divisions of each pair, as locator2longlat() computes them */
+    static const double divisions[MAX_LOCATOR_PAIRS] =
+    {
+        18.0, 180.0, 4320.0, 43200.0, 1036800.0, 10368000.0
+    };
+    int i, retval = RIG_OK;
+
+    rot_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (!longitude || !latitude || !locator || count < 0)
+    {
+        return -RIG_EINVAL;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        const char *loc = locator[i];
+        int paircount = loc ? strlen(loc) / 2 : 0;
+        int x_or_y, pair, bad = 0;
+        double xy[2];
+
+        if (paircount > MAX_LOCATOR_PAIRS)
+        {
+            paircount = MAX_LOCATOR_PAIRS;
+        }
+
+        for (x_or_y = 0;  x_or_y < 2;  ++x_or_y)
+        {
+            double ordinate = -90.0;
+
+            for (pair = 0;  pair < paircount;  ++pair)
+            {
+                int c = loc[pair * 2 + x_or_y];
+                int locvalue;
+
+                /* both cases of a letter fold to lower case, anything
+                   else ends up out of range */
+                locvalue = (loc_char_range[pair] == 10) ? c - '0' :
+                           (c | 0x20) - 'a';
+
+                bad |= (locvalue < 0) | (locvalue >= loc_char_range[pair]);
+
+                ordinate += locvalue * 180.0 / divisions[pair];
+            }
+
+            xy[x_or_y] = ordinate + (paircount ?
+                                     90.0 / divisions[paircount - 1] : 0.0);
+        }
+
+        if (bad || paircount < MIN_LOCATOR_PAIRS)
+        {
+            longitude[i] = NAN;
+            latitude[i] = NAN;
+            retval = -RIG_EINVAL;
+        }
+        else
+        {
+            longitude[i] = xy[0] * 2.0;
+            latitude[i] = xy[1];
+        }
+
+        if (status)
+        {
+            status[i] = (bad || paircount < MIN_LOCATOR_PAIRS) ?
+                        -RIG_EINVAL : RIG_OK;
+        }
+    }
+
+    return retval;
+}
+
+
 /**
  * \brief Convert longitude/latitude to Maidenhead grid locator
  * \param longitude     Longitude, decimal degrees
@@ -663,6 +758,148 @@ int HAMLIB_API qrb(double lon1,
 }
 
 
+/**
+ * \brief Calculate the distance and bearing from one point to many.
+ * \param lon1      The local Longitude, decimal degrees
+ * \param lat1      The local Latitude, decimal degrees
+ * \param lon2      Array of remote Longitudes, decimal degrees
+ * \param lat2      Array of remote Latitudes, decimal degrees
+ * \param distance  Array for the distances, km
+ * \param azimuth   Array for the bearings, decimal degrees
+ * \param status    Array for the result of each calculation, may be NULL
+ * \param count     Number of remote points
+ *
+ *  Same as qrb() from \a lon1, \a lat1 to each of \a count points at
+ *  once, with the same results. The trigonometry of the local point is
+ *  only done once, and there is no per call overhead, which makes it
+ *  the one to use for cluster spots and other large sets of points.
+ *  A remote point out of range gets -RIG_EINVAL in \a status, if given,
+ *  and NAN as distance and azimuth.
+ *
+ * \retval -RIG_EINVAL if an array is NULL, the local point is out of
+ *  range or any remote point is.
+ * \retval RIG_OK if all the calculations are successful.
+ *
+ * \sa qrb(), locator2longlat_batch()
+ */
+int HAMLIB_API qrb_batch(double lon1,
+                         double lat1,
+                         const double *lon2,
+                         const double *lat2,
+                         double *distance,
+                         double *azimuth,
+                         int *status,
+                         int count)
+{
+    double sin_lat1, cos_lat1;
+    int i, retval = RIG_OK;
+
+    rot_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (!lon2 || !lat2 || !distance || !azimuth || count < 0)
+    {
+        return -RIG_EINVAL;
+    }
+
+    if (lat1 > 90.0 || lat1 < -90.0 || lon1 > 180.0 || lon1 < -180.0)
+    {
+        return -RIG_EINVAL;
+    }
+
+    /* Prevent ACOS() Domain Error */
+    if (lat1 == 90.0)
+    {
+        lat1 = 89.999999999;
+    }
+    else if (lat1 == -90.0)
+    {
+        lat1 = -89.999999999;
+    }
+
+    lat1 /= RADIAN;
+    lon1 /= RADIAN;
+    sin_lat1 = sin(lat1);
+    cos_lat1 = cos(lat1);
+
+    /*
+     * One pass for the bulk of the math, free of branches so that the
+     * compiler may vectorize it, then one for the special cases.
+     */
+    for (i = 0; i < count; i++)
+    {
+        double lat = lat2[i];
+        double delta_long, sin_lat2, cos_lat2, cos_delta, tmp;
+
+        lat = lat == 90.0 ? 89.999999999 : lat;
+        lat = lat == -90.0 ? -89.999999999 : lat;
+        lat /= RADIAN;
+
+        delta_long = lon2[i] / RADIAN - lon1;
+        sin_lat2 = sin(lat);
+        cos_lat2 = cos(lat);
+        cos_delta = cos(delta_long);
+
+        tmp = sin_lat1 * sin_lat2 + cos_lat1 * cos_lat2 * cos_delta;
+
+        distance[i] = tmp;
+        azimuth[i] = RADIAN * atan2(sin(delta_long) * cos_lat2,
+                                    cos_lat1 * sin_lat2
+                                    - sin_lat1 * cos_lat2 * cos_delta);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        double tmp = distance[i];
+        double az = azimuth[i];
+        int bad = lat2[i] > 90.0 || lat2[i] < -90.0
+                  || lon2[i] > 180.0 || lon2[i] < -180.0;
+
+        if (bad)
+        {
+            distance[i] = NAN;
+            azimuth[i] = NAN;
+            retval = -RIG_EINVAL;
+        }
+        else if (tmp > .999999999999999)
+        {
+            /* Station points coincide, use an Omni! */
+            distance[i] = 0.0;
+            azimuth[i] = 0.0;
+        }
+        else if (tmp < -.999999)
+        {
+            /* points are antipodal, see qrb() */
+            distance[i] = 180.0 * ARC_IN_KM;
+            azimuth[i] = 0.0;
+        }
+        else
+        {
+            distance[i] = ARC_IN_KM * RADIAN * acos(tmp);
+
+            az = fmod(360.0 + az, 360.0);
+
+            if (az < 0.0)
+            {
+                az += 360.0;
+            }
+            else if (az >= 360.0)
+            {
+                az -= 360.0;
+            }
+
+            azimuth[i] = floor(az + 0.5);
+        }
+
+        if (status)
+        {
+            status[i] = bad ? -RIG_EINVAL : RIG_OK;
+        }
+    }
+
+    return retval;
+}
+
+
 /**
  * \brief Calculate the long path distance between two points.
  * \param distance  The shortpath distance
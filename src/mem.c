@@ -45,11 +45,23 @@
 #include <fcntl.h>
 
 #include <hamlib/rig.h>
+#include "cache.h"
+#include "stats.h"
+#include "vfoctx.h"
 
 #ifndef DOC_HIDDEN
 
 #define CHECK_RIG_ARG(r) (!(r) || !(r)->caps || !(r)->state.comm_state)
 
+/*
+ * API functions accounted in the statistics are wrappers around these,
+ * see stats.h
+ */
+static int do_rig_set_mem(RIG *rig, vfo_t vfo, int ch);
+static int do_rig_get_mem(RIG *rig, vfo_t vfo, int *ch);
+static int do_rig_set_channel(RIG *rig, const channel_t *chan);
+static int do_rig_get_channel(RIG *rig, channel_t *chan);
+
 #endif /* !DOC_HIDDEN */
 
 
@@ -70,10 +82,20 @@
  * \sa rig_get_mem()
  */
 int HAMLIB_API rig_set_mem(RIG *rig, vfo_t vfo, int ch)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_MEM,
+                         do_rig_set_mem(rig, vfo, ch));
+}
+
+
+static int do_rig_set_mem(RIG *rig, vfo_t vfo, int ch)
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -82,6 +104,15 @@ int HAMLIB_API rig_set_mem(RIG *rig, vfo_t vfo, int ch)
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_ALL);
+
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_mem == NULL)
@@ -101,8 +132,7 @@ int HAMLIB_API rig_set_mem(RIG *rig, vfo_t vfo, int ch)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -110,7 +140,7 @@ int HAMLIB_API rig_set_mem(RIG *rig, vfo_t vfo, int ch)
     }
 
     retcode = caps->set_mem(rig, vfo, ch);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
 
     return retcode;
 }
@@ -133,10 +163,20 @@ int HAMLIB_API rig_set_mem(RIG *rig, vfo_t vfo, int ch)
  * \sa rig_set_mem()
  */
 int HAMLIB_API rig_get_mem(RIG *rig, vfo_t vfo, int *ch)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_MEM,
+                         do_rig_get_mem(rig, vfo, ch));
+}
+
+
+static int do_rig_get_mem(RIG *rig, vfo_t vfo, int *ch)
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -145,6 +185,13 @@ int HAMLIB_API rig_get_mem(RIG *rig, vfo_t vfo, int *ch)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_mem == NULL)
@@ -164,8 +211,7 @@ int HAMLIB_API rig_get_mem(RIG *rig, vfo_t vfo, int *ch)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -173,7 +219,7 @@ int HAMLIB_API rig_get_mem(RIG *rig, vfo_t vfo, int *ch)
     }
 
     retcode = caps->get_mem(rig, vfo, ch);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
 
     return retcode;
 }
@@ -199,7 +245,6 @@ int HAMLIB_API rig_set_bank(RIG *rig, vfo_t vfo, int bank)
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -208,6 +253,15 @@ int HAMLIB_API rig_set_bank(RIG *rig, vfo_t vfo, int bank)
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_ALL);
+
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_bank == NULL)
@@ -227,8 +281,7 @@ int HAMLIB_API rig_set_bank(RIG *rig, vfo_t vfo, int bank)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -236,7 +289,7 @@ int HAMLIB_API rig_set_bank(RIG *rig, vfo_t vfo, int bank)
     }
 
     retcode = caps->set_bank(rig, vfo, bank);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
 
     return retcode;
 }
@@ -352,6 +405,113 @@ static int rig_mem_caps_empty(const channel_cap_t *mem_cap)
 }
 
 
+/*
+ * reads freq, vfo, mode and levels of chan in a single rig_get_multi()
+ * batch, for backends which can pipeline it
+ */
+static int generic_save_multi(RIG *rig, channel_t *chan,
+                              const channel_cap_t *mem_cap)
+{
+    struct rig_multi req[3 + RIG_SETTING_MAX];
+    int idx[RIG_SETTING_MAX];
+    int i, n = 0, nlevels = 0;
+    int retval;
+
+    memset(req, 0, sizeof(req));
+
+    if (mem_cap->freq)
+    {
+        req[n].what = RIG_MULTI_FREQ;
+        req[n++].vfo = RIG_VFO_CURR;
+    }
+
+    if (mem_cap->vfo)
+    {
+        req[n++].what = RIG_MULTI_VFO;
+    }
+
+    if (mem_cap->mode || mem_cap->width)
+    {
+        req[n].what = RIG_MULTI_MODE;
+        req[n++].vfo = RIG_VFO_CURR;
+    }
+
+    for (i = 0; i < RIG_SETTING_MAX; i++)
+    {
+        setting_t setting = rig_idx2setting(i);
+
+        if ((setting & mem_cap->levels) && RIG_LEVEL_SET(setting))
+        {
+            idx[nlevels++] = i;
+            req[n].what = RIG_MULTI_LEVEL;
+            req[n].vfo = RIG_VFO_CURR;
+            req[n++].level = setting;
+        }
+    }
+
+    retval = rig_get_multi(rig, req, n);
+
+    if (retval != RIG_OK)
+    {
+        return retval;
+    }
+
+    for (i = 0, nlevels = 0; i < n; i++)
+    {
+        switch (req[i].what)
+        {
+        case RIG_MULTI_FREQ:
+
+            /* empty channel ? */
+            if (req[i].status == -RIG_ENAVAIL
+                    || (req[i].status == RIG_OK
+                        && req[i].val.freq == RIG_FREQ_NONE))
+            {
+                return -RIG_ENAVAIL;
+            }
+
+            if (req[i].status == RIG_OK)
+            {
+                chan->freq = req[i].val.freq;
+            }
+
+            break;
+
+        case RIG_MULTI_VFO:
+            if (req[i].status == RIG_OK)
+            {
+                chan->vfo = req[i].val.vfo;
+            }
+
+            break;
+
+        case RIG_MULTI_MODE:
+            if (req[i].status == RIG_OK)
+            {
+                chan->mode = req[i].val.mode.mode;
+                chan->width = req[i].val.mode.width;
+            }
+
+            break;
+
+        case RIG_MULTI_LEVEL:
+            if (req[i].status == RIG_OK)
+            {
+                chan->levels[idx[nlevels]] = req[i].val.level;
+            }
+
+            nlevels++;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return RIG_OK;
+}
+
+
 /*
  * stores current VFO state into chan by emulating rig_get_channel
  */
@@ -386,25 +546,48 @@ static int generic_save_channel(RIG *rig, channel_t *chan)
         mem_cap = &mem_cap_all;
     }
 
-    if (mem_cap->freq)
+    if (rig->caps->get_multi)
     {
-        retval = rig_get_freq(rig, RIG_VFO_CURR, &chan->freq);
+        /* one round trip for the bulk of the reads */
+        retval = generic_save_multi(rig, chan, mem_cap);
 
-        /* empty channel ? */
-        if (retval == -RIG_ENAVAIL || chan->freq == RIG_FREQ_NONE)
+        if (retval != RIG_OK)
         {
-            return -RIG_ENAVAIL;
+            return retval;
         }
     }
-
-    if (mem_cap->vfo)
+    else
     {
-        rig_get_vfo(rig, &chan->vfo);
-    }
+        if (mem_cap->freq)
+        {
+            retval = rig_get_freq(rig, RIG_VFO_CURR, &chan->freq);
 
-    if (mem_cap->mode || mem_cap->width)
-    {
-        rig_get_mode(rig, RIG_VFO_CURR, &chan->mode, &chan->width);
+            /* empty channel ? */
+            if (retval == -RIG_ENAVAIL || chan->freq == RIG_FREQ_NONE)
+            {
+                return -RIG_ENAVAIL;
+            }
+        }
+
+        if (mem_cap->vfo)
+        {
+            rig_get_vfo(rig, &chan->vfo);
+        }
+
+        if (mem_cap->mode || mem_cap->width)
+        {
+            rig_get_mode(rig, RIG_VFO_CURR, &chan->mode, &chan->width);
+        }
+
+        for (i = 0; i < RIG_SETTING_MAX; i++)
+        {
+            setting = rig_idx2setting(i);
+
+            if ((setting & mem_cap->levels) && RIG_LEVEL_SET(setting))
+            {
+                rig_get_level(rig, RIG_VFO_CURR, setting, &chan->levels[i]);
+            }
+        }
     }
 
     chan->split = RIG_SPLIT_OFF;
@@ -463,16 +646,6 @@ static int generic_save_channel(RIG *rig, channel_t *chan)
         rig_get_xit(rig, RIG_VFO_CURR, &chan->xit);
     }
 
-    for (i = 0; i < RIG_SETTING_MAX; i++)
-    {
-        setting = rig_idx2setting(i);
-
-        if ((setting & mem_cap->levels) && RIG_LEVEL_SET(setting))
-        {
-            rig_get_level(rig, RIG_VFO_CURR, setting, &chan->levels[i]);
-        }
-    }
-
     for (i = 0; i < RIG_SETTING_MAX; i++)
     {
         int fstatus;
@@ -681,6 +854,17 @@ static int generic_restore_channel(RIG *rig, const channel_t *chan)
  * \sa rig_get_channel()
  */
 int HAMLIB_API rig_set_channel(RIG *rig, const channel_t *chan)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_CHANNEL,
+                         do_rig_set_channel(rig, chan));
+}
+
+
+static int do_rig_set_channel(RIG *rig, const channel_t *chan)
 {
     struct rig_caps *rc;
     int curr_chan_num, get_mem_status = RIG_OK;
@@ -699,10 +883,19 @@ int HAMLIB_API rig_set_channel(RIG *rig, const channel_t *chan)
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_ALL);
+
     /*
      * TODO: check validity of chan->channel_num
      */
 
+    retcode = rig_vfo_ctx_restore(rig);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     rc = rig->caps;
 
     if (rc->set_channel)
@@ -833,6 +1026,17 @@ int HAMLIB_API rig_set_channel(RIG *rig, const channel_t *chan)
  * \sa rig_set_channel()
  */
 int HAMLIB_API rig_get_channel(RIG *rig, channel_t *chan)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_CHANNEL,
+                         do_rig_get_channel(rig, chan));
+}
+
+
+static int do_rig_get_channel(RIG *rig, channel_t *chan)
 {
     struct rig_caps *rc;
     int curr_chan_num, get_mem_status = RIG_OK;
@@ -855,6 +1059,13 @@ int HAMLIB_API rig_get_channel(RIG *rig, channel_t *chan)
      * TODO: check validity of chan->channel_num
      */
 
+    retcode = rig_vfo_ctx_restore(rig);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     rc = rig->caps;
 
     if (rc->get_channel)
@@ -948,11 +1159,124 @@ int HAMLIB_API rig_get_channel(RIG *rig, channel_t *chan)
 
 
 #ifndef DOC_HIDDEN
+
+/* channels handed to the get_channels/set_channels hooks at once */
+#define CHAN_BLOCK_SIZE 32
+
+
+static void chan_progress(RIG *rig, int done, int total)
+{
+    if (rig->callbacks.chan_progress)
+    {
+        rig->callbacks.chan_progress(rig, done, total,
+                                     rig->callbacks.chan_progress_arg);
+    }
+}
+
+
+/*
+ * copies a channel read by block into the application's struct,
+ * leaving its ext_levels alone
+ */
+static void chan_copy_plain(channel_t *dest, const channel_t *src)
+{
+    struct ext_list *saved_ext_levels = dest->ext_levels;
+
+    memcpy(dest, src, sizeof(channel_t));
+    dest->ext_levels = saved_ext_levels;
+}
+
+
+static int get_chan_all_blocks(RIG *rig, chan_cb_t chan_cb, rig_ptr_t arg)
+{
+    int i, j, k, n, retval;
+    chan_t *chan_list = rig->state.chan_list;
+    channel_t *chan;
+    channel_t *block;
+    int total = rig_mem_count(rig);
+    int done = 0;
+
+    block = calloc(CHAN_BLOCK_SIZE, sizeof(channel_t));
+
+    if (!block)
+    {
+        return -RIG_ENOMEM;
+    }
+
+    for (i = 0; !RIG_IS_CHAN_END(chan_list[i]) && i < CHANLSTSIZ; i++)
+    {
+        chan = NULL;
+        retval = chan_cb(rig, &chan, chan_list[i].startc, chan_list, arg);
+
+        if (retval != RIG_OK || chan == NULL)
+        {
+            free(block);
+            return retval != RIG_OK ? retval : -RIG_ENOMEM;
+        }
+
+        for (j = chan_list[i].startc; j <= chan_list[i].endc; j += n)
+        {
+            n = chan_list[i].endc - j + 1;
+
+            if (n > CHAN_BLOCK_SIZE)
+            {
+                n = CHAN_BLOCK_SIZE;
+            }
+
+            memset(block, 0, n * sizeof(channel_t));
+
+            for (k = 0; k < n; k++)
+            {
+                block[k].vfo = RIG_VFO_MEM;
+                block[k].channel_num = j + k;
+            }
+
+            retval = rig->caps->get_channels(rig, block, n);
+
+            if (retval != RIG_OK)
+            {
+                free(block);
+                return retval;
+            }
+
+            for (k = 0; k < n; k++)
+            {
+                int chan_next = j + k < chan_list[i].endc ? j + k + 1 : j + k;
+
+                /* empty channel */
+                if (block[k].freq == RIG_FREQ_NONE)
+                {
+                    continue;
+                }
+
+                chan_copy_plain(chan, &block[k]);
+                chan_cb(rig, &chan, chan_next, chan_list, arg);
+            }
+
+            done += n;
+            chan_progress(rig, done, total);
+        }
+    }
+
+    free(block);
+
+    return RIG_OK;
+}
+
+
 int get_chan_all_cb_generic(RIG *rig, chan_cb_t chan_cb, rig_ptr_t arg)
 {
     int i, j, retval;
     chan_t *chan_list = rig->state.chan_list;
     channel_t *chan;
+    int total, done = 0;
+
+    if (rig->caps->get_channels)
+    {
+        return get_chan_all_blocks(rig, chan_cb, arg);
+    }
+
+    total = rig_mem_count(rig);
 
     for (i = 0; !RIG_IS_CHAN_END(chan_list[i]) && i < CHANLSTSIZ; i++)
     {
@@ -982,6 +1306,8 @@ int get_chan_all_cb_generic(RIG *rig, chan_cb_t chan_cb, rig_ptr_t arg)
             chan->vfo = RIG_VFO_MEM;
             chan->channel_num = j;
 
+            chan_progress(rig, ++done, total);
+
             /*
              * TODO: if doesn't have rc->get_channel, special generic
              */
@@ -1014,12 +1340,26 @@ int get_chan_all_cb_generic(RIG *rig, chan_cb_t chan_cb, rig_ptr_t arg)
 
 int set_chan_all_cb_generic(RIG *rig, chan_cb_t chan_cb, rig_ptr_t arg)
 {
-    int i, j, retval;
+    int i, j, n, retval;
     chan_t *chan_list = rig->state.chan_list;
     channel_t *chan;
+    channel_t *block = NULL;
+    int total = rig_mem_count(rig);
+    int done = 0;
+
+    if (rig->caps->set_channels)
+    {
+        block = malloc(CHAN_BLOCK_SIZE * sizeof(channel_t));
+
+        if (!block)
+        {
+            return -RIG_ENOMEM;
+        }
+    }
 
     for (i = 0; !RIG_IS_CHAN_END(chan_list[i]) && i < CHANLSTSIZ; i++)
     {
+        n = 0;
 
         for (j = chan_list[i].startc; j <= chan_list[i].endc; j++)
         {
@@ -1027,15 +1367,41 @@ int set_chan_all_cb_generic(RIG *rig, chan_cb_t chan_cb, rig_ptr_t arg)
             chan_cb(rig, &chan, j, chan_list, arg);
             chan->vfo = RIG_VFO_MEM;
 
-            retval = rig_set_channel(rig, chan);
+            if (!block)
+            {
+                retval = rig_set_channel(rig, chan);
 
-            if (retval != RIG_OK)
+                if (retval != RIG_OK)
+                {
+                    return retval;
+                }
+
+                chan_progress(rig, ++done, total);
+                continue;
+            }
+
+            /* shares ext_levels with the application, only read */
+            block[n++] = *chan;
+
+            if (n == CHAN_BLOCK_SIZE || j == chan_list[i].endc)
             {
-                return retval;
+                retval = rig_set_channels(rig, block, n);
+
+                if (retval != RIG_OK)
+                {
+                    free(block);
+                    return retval;
+                }
+
+                done += n;
+                n = 0;
+                chan_progress(rig, done, total);
             }
         }
     }
 
+    free(block);
+
     return RIG_OK;
 }
 
@@ -1096,6 +1462,8 @@ int HAMLIB_API rig_set_chan_all_cb(RIG *rig, chan_cb_t chan_cb, rig_ptr_t arg)
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_ALL);
+
     rc = rig->caps;
 
     if (rc->set_chan_all_cb)
@@ -1183,6 +1551,8 @@ int HAMLIB_API rig_set_chan_all(RIG *rig, const channel_t chans[])
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_ALL);
+
     rc = rig->caps;
     map_arg.chans = (channel_t *) chans;
 
@@ -1244,6 +1614,141 @@ int HAMLIB_API rig_get_chan_all(RIG *rig, channel_t chans[])
 }
 
 
+/**
+ * \brief set a block of channels
+ * \param rig   The rig handle
+ * \param chans The channels to write
+ * \param count Number of channels in \a chans
+ *
+ *  Writes \a count channels in as few exchanges with the rig as the
+ *  backend allows. Backends without block writes get one
+ *  rig_set_channel() per channel. The ext_levels of \a chans are not
+ *  written by block capable backends.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_get_channels(), rig_set_channel()
+ */
+int HAMLIB_API rig_set_channels(RIG *rig, const channel_t chans[], int count)
+{
+    int i, retval;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (CHECK_RIG_ARG(rig) || !chans || count < 0)
+    {
+        return -RIG_EINVAL;
+    }
+
+    rig_cache_invalidate(rig, RIG_CACHE_ALL);
+
+    if (rig->caps->set_channels)
+    {
+        return rig->caps->set_channels(rig, chans, count);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        retval = rig_set_channel(rig, &chans[i]);
+
+        if (retval != RIG_OK)
+        {
+            return retval;
+        }
+    }
+
+    return RIG_OK;
+}
+
+
+/**
+ * \brief get a block of channels
+ * \param rig   The rig handle
+ * \param chans The channels to read, with vfo and channel_num set
+ * \param count Number of channels in \a chans
+ *
+ *  Reads \a count channels in as few exchanges with the rig as the
+ *  backend allows. Backends without block reads get one
+ *  rig_get_channel() per channel. Empty channels are returned with
+ *  their freq set to RIG_FREQ_NONE.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_set_channels(), rig_get_channel()
+ */
+int HAMLIB_API rig_get_channels(RIG *rig, channel_t chans[], int count)
+{
+    int i, retval;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (CHECK_RIG_ARG(rig) || !chans || count < 0)
+    {
+        return -RIG_EINVAL;
+    }
+
+    if (rig->caps->get_channels)
+    {
+        return rig->caps->get_channels(rig, chans, count);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        retval = rig_get_channel(rig, &chans[i]);
+
+        if (retval == -RIG_ENAVAIL)
+        {
+            chans[i].freq = RIG_FREQ_NONE;
+            continue;
+        }
+
+        if (retval != RIG_OK)
+        {
+            return retval;
+        }
+    }
+
+    return RIG_OK;
+}
+
+
+/**
+ * \brief set the callback for channel transfer progress
+ * \param rig   The rig handle
+ * \param cb    The callback to install, NULL to remove it
+ * \param arg   An argument passed back to the callback
+ *
+ *  Installs a callback called with the number of channels transferred so
+ *  far and the total count while rig_get_chan_all() and friends run.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_get_chan_all_cb(), rig_set_chan_all_cb()
+ */
+int HAMLIB_API rig_set_chan_progress_callback(RIG *rig,
+        chan_progress_cb_t cb,
+        rig_ptr_t arg)
+{
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (CHECK_RIG_ARG(rig))
+    {
+        return -RIG_EINVAL;
+    }
+
+    rig->callbacks.chan_progress = cb;
+    rig->callbacks.chan_progress_arg = arg;
+
+    return RIG_OK;
+}
+
+
 int HAMLIB_API rig_copy_channel(RIG *rig,
                                 channel_t *dest,
                                 const channel_t *src)
@@ -1326,6 +1831,8 @@ int HAMLIB_API rig_set_mem_all_cb(RIG *rig,
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_ALL);
+
     rc = rig->caps;
 
     if (rc->set_mem_all_cb)
@@ -1459,6 +1966,8 @@ int HAMLIB_API rig_set_mem_all(RIG *rig,
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_ALL);
+
     rc = rig->caps;
     mem_all_arg.chans = (channel_t *) chans;
     mem_all_arg.cfgps = cfgps;
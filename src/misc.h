@@ -26,13 +26,12 @@
 
 
 /*
- * Carefull!! These macros are NOT reentrant!
- * ie. they may not be executed atomically,
- * thus not ensure mutual exclusion.
- * Fix it when making Hamlib reentrant!  --SF
+ * Hold the event decoder for the length of a transaction.
+ * Calls nest, and every Hold_Decode() needs its Unhold_Decode().
+ * See rig_hold_decode() in event.c.
  */
-#define Hold_Decode(rig) {(rig)->state.hold_decode = 1;}
-#define Unhold_Decode(rig) {(rig)->state.hold_decode = 0;}
+#define Hold_Decode(rig) rig_hold_decode(rig)
+#define Unhold_Decode(rig) rig_unhold_decode(rig)
 
 __BEGIN_DECLS
 
@@ -42,6 +41,15 @@ __BEGIN_DECLS
 
 void dump_hex(const unsigned char ptr[], size_t size);
 
+/* skip the call altogether when tracing is off */
+#define dump_hex(ptr, size) \
+    do { \
+        if (RIG_DEBUG_ENABLED(RIG_DEBUG_TRACE)) \
+        { \
+            dump_hex(ptr, size); \
+        } \
+    } while (0)
+
 /*
  * BCD conversion routines.
  *
@@ -81,6 +89,21 @@ extern int no_restore_ai;
 /* check if it's any of CR or LF */
 #define isreturn(c) ((c) == 10 || (c) == 13)
 
+/*
+ * Set of two letter CAT commands (Kenwood, Yaesu newcat), one bit per
+ * command, so checking a command is a shift and a mask instead of a
+ * search. Commands must be two upper case letters, anything else is
+ * never in the set.
+ */
+#define CAT_CMD_SET_SIZE ((26 * 26 + 7) / 8)
+#define cat_cmd_ok(cmd) ((cmd)[0] >= 'A' && (cmd)[0] <= 'Z' \
+                         && (cmd)[1] >= 'A' && (cmd)[1] <= 'Z')
+#define cat_cmd_index(cmd) (((cmd)[0] - 'A') * 26 + ((cmd)[1] - 'A'))
+#define cat_cmd_set(set, cmd) \
+    ((set)[cat_cmd_index(cmd) >> 3] |= 1 << (cat_cmd_index(cmd) & 7))
+#define cat_cmd_isset(set, cmd) (cat_cmd_ok(cmd) \
+    && ((set)[cat_cmd_index(cmd) >> 3] & (1 << (cat_cmd_index(cmd) & 7))))
+
 
 /* needs config.h included beforehand in .c file */
 #ifdef HAVE_INTTYPES_H
@@ -96,6 +119,12 @@ extern HAMLIB_EXPORT(int) rig_check_cache_timeout(const struct timeval *tv,
 
 extern HAMLIB_EXPORT(void) rig_force_cache_timeout(struct timeval *tv);
 
+extern HAMLIB_EXPORT(void) rig_hold_decode(RIG *rig);
+extern HAMLIB_EXPORT(void) rig_unhold_decode(RIG *rig);
+extern HAMLIB_EXPORT(int) rig_try_hold_decode(RIG *rig);
+extern HAMLIB_EXPORT(int) rig_decode_in_signal(RIG *rig);
+extern HAMLIB_EXPORT(int) rig_trn_by_signal(RIG *rig);
+
 extern HAMLIB_EXPORT(setting_t) rig_idx2setting(int i);
 
 #ifdef PRId64
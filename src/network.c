@@ -70,14 +70,13 @@
 #include <hamlib/rig.h>
 #include "network.h"
 #include "misc.h"
+#include "iofunc.h"
 
 
 #ifdef __MINGW32__
 static int wsstarted;
 #endif
 
-#define NET_BUFFER_SIZE 64
-
 static void handle_error(enum rig_debug_level_e lvl, const char *msg)
 {
     int e;
@@ -268,6 +267,7 @@ int network_open(hamlib_port_t *rp, int default_port)
     }
 
     rp->fd = fd;
+    port_rxbuf_flush(rp);
 
     return RIG_OK;
 }
@@ -287,13 +287,15 @@ void network_flush(hamlib_port_t *rp)
     uint len = 0;
 #endif
 
-    char buffer[NET_BUFFER_SIZE] = { 0 };
-
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
+    /* first what has already been read ahead by read_string/read_block */
+    port_rxbuf_flush(rp);
+
     for (;;)
     {
         len = 0;
+        rp->io_count.flush_calls++;
 #ifdef __MINGW32__
         ret = ioctlsocket(rp->fd, FIONREAD, &len);
 #else
@@ -309,11 +311,15 @@ void network_flush(hamlib_port_t *rp)
         if (len > 0)
         {
             int len_read = 0;
+            /* The receive buffer is empty now, use it as scratch space */
+            char *buffer = (char *) rp->rx.buf;
+
             rig_debug(RIG_DEBUG_WARN,
-                      "%s: network data clear d: ret=%d, len=%d, '%s'\n",
+                      "%s: network data clear d: ret=%d, len=%d\n",
                       __func__,
-                      ret, (int)len, buffer);
-            len_read = recv(rp->fd, buffer, len < NET_BUFFER_SIZE ? len : NET_BUFFER_SIZE,
+                      ret, (int)len);
+            rp->io_count.flush_calls++;
+            len_read = recv(rp->fd, buffer, len < PORTRXBUFSIZ - 1 ? len : PORTRXBUFSIZ - 1,
                             0);
 
             if (len_read < 0)   // -1 indicates error occurred
@@ -322,6 +328,7 @@ void network_flush(hamlib_port_t *rp)
                 break;
             }
 
+            buffer[len_read] = '\0';
             rig_debug(RIG_DEBUG_WARN,
                       "%s: network data cleared: ret=%d, len_read=%d/0x%x, '%s'\n",
                       __func__,
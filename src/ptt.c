@@ -0,0 +1,280 @@
+/*
+ *  Hamlib Interface - PTT keying
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/**
+ * \addtogroup rig
+ * @{
+ */
+
+/**
+ * \file ptt.c
+ * \brief PTT keying and timed PTT
+ *
+ * How the PTT is switched is worked out once by rig_open(), which tells
+ * a PTT line on the rig port from one on a port of its own.  With the
+ * "ptt_hold" configuration parameter set, the latter is kept open
+ * instead of being opened at each key down, which otherwise costs the
+ * open and setup of a tty before the line moves.
+ *
+ * rig_set_ptt_at() keys at a given time of day, for the modes where a
+ * transmission must start on a time slot.  Its statistics, see
+ * rig_get_stats(), time the keying from that date: their mean is the
+ * key latency and their deviation the jitter.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include <hamlib/rig.h>
+#include "serial.h"
+#include "parallel.h"
+#include "cm108.h"
+#include "gpio.h"
+#include "stats.h"
+#include "vfoctx.h"
+#include "ptt.h"
+
+#define CHECK_RIG_ARG(r) (!(r) || !(r)->caps || !(r)->state.comm_state)
+
+
+static int64_t ptt_now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+
+void rig_ptt_wait(int64_t when)
+{
+#ifdef HAVE_CLOCK_NANOSLEEP
+    struct timespec ts;
+
+    ts.tv_sec = when / 1000000;
+    ts.tv_nsec = (when % 1000000) * 1000;
+
+    while (clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    {
+        continue;
+    }
+
+#else
+    int64_t left;
+
+    while ((left = when - ptt_now()) > 0)
+    {
+        usleep(left > 1000000 ? 1000000 : left);
+    }
+
+#endif
+}
+
+
+/* PTT on a line of a serial port, the other line kept low */
+static int ptt_serial_key(struct rig_state *rs, ptt_t ptt,
+                          int (*set_line)(hamlib_port_t *, int),
+                          int (*set_other)(hamlib_port_t *, int))
+{
+    int retcode;
+
+    /* when the PTT port is not the control port and is not held, we want
+       to free the port when PTT is reset and seize the port when PTT is
+       set, this allows limited sharing of the PTT port between
+       applications so long as there is no contention */
+    if (!rs->ptt_shared && rs->pttport.fd < 0 && RIG_PTT_OFF != ptt)
+    {
+        rs->pttport.fd = ser_open(&rs->pttport);
+
+        if (rs->pttport.fd < 0)
+        {
+            rig_debug(RIG_DEBUG_ERR,
+                      "%s: cannot open PTT device \"%s\"\n",
+                      __func__,
+                      rs->pttport.pathname);
+            return -RIG_EIO;
+        }
+
+        /* Needed on Linux because the serial port driver sets RTS/DTR
+           high on open - set both since we offer no control of
+           the non-PTT line and low is better than high */
+        retcode = set_other(&rs->pttport, 0);
+
+        if (RIG_OK != retcode)
+        {
+            return retcode;
+        }
+    }
+
+    retcode = set_line(&rs->pttport, ptt != RIG_PTT_OFF);
+
+    if (!rs->ptt_shared && !rs->ptt_hold && ptt == RIG_PTT_OFF)
+    {
+        /* free the port */
+        ser_close(&rs->pttport);
+    }
+
+    return retcode;
+}
+
+
+int rig_ptt_key(RIG *rig, vfo_t vfo, ptt_t ptt)
+{
+    const struct rig_caps *caps = rig->caps;
+    struct rig_state *rs = &rig->state;
+    int retcode = RIG_OK;
+    int rc2;
+    vfo_t curr_vfo;
+
+    switch (rs->pttport.type.ptt)
+    {
+    case RIG_PTT_RIG:
+        if (ptt == RIG_PTT_ON_MIC || ptt == RIG_PTT_ON_DATA)
+        {
+            ptt = RIG_PTT_ON;
+        }
+
+    /* fall through */
+    case RIG_PTT_RIG_MICDATA:
+        if (caps->set_ptt == NULL)
+        {
+            return -RIG_ENIMPL;
+        }
+
+        if ((caps->targetable_vfo & RIG_TARGETABLE_PURE)
+                || vfo == RIG_VFO_CURR
+                || vfo == rs->current_vfo)
+        {
+
+            retcode = caps->set_ptt(rig, vfo, ptt);
+        }
+        else
+        {
+            if (!caps->set_vfo)
+            {
+                return -RIG_ENTARGET;
+            }
+
+            curr_vfo = rs->current_vfo;
+            retcode = caps->set_vfo(rig, vfo);
+
+            if (retcode == RIG_OK)
+            {
+                retcode = caps->set_ptt(rig, vfo, ptt);
+                /* try and revert even if we had an error above */
+                rc2 = caps->set_vfo(rig, curr_vfo);
+
+                /* return the first error code */
+                if (RIG_OK == retcode)
+                {
+                    retcode = rc2;
+                }
+            }
+        }
+
+        break;
+
+    case RIG_PTT_SERIAL_DTR:
+        retcode = ptt_serial_key(rs, ptt, ser_set_dtr, ser_set_rts);
+        break;
+
+    case RIG_PTT_SERIAL_RTS:
+        retcode = ptt_serial_key(rs, ptt, ser_set_rts, ser_set_dtr);
+        break;
+
+    case RIG_PTT_PARALLEL:
+        retcode = par_ptt_set(&rs->pttport, ptt);
+        break;
+
+    case RIG_PTT_CM108:
+        retcode = cm108_ptt_set(&rs->pttport, ptt);
+        break;
+
+    case RIG_PTT_GPIO:
+    case RIG_PTT_GPION:
+        retcode = gpio_ptt_set(&rs->pttport, ptt);
+        break;
+
+    default:
+        return -RIG_EINVAL;
+    }
+
+    return retcode;
+}
+
+
+/**
+ * \brief set PTT on/off at a given time
+ * \param rig   The rig handle
+ * \param vfo   The target VFO
+ * \param ptt   The PTT status to set to
+ * \param when  When to switch the PTT, a time of day in microseconds
+ *              since the Epoch, as from gettimeofday()
+ *
+ *  Waits until \a when, and does rig_set_ptt().  A pending VFO switch
+ *  back, see rig_restore_vfo(), is done before waiting so that only the
+ *  PTT command is left to send at that time.  If \a when is already past,
+ *  the PTT is switched at once.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_set_ptt(), rig_set_ptt_at_async()
+ */
+int HAMLIB_API rig_set_ptt_at(RIG *rig, vfo_t vfo, ptt_t ptt, int64_t when)
+{
+    struct rig_stats_call call;
+    int retcode;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (CHECK_RIG_ARG(rig))
+    {
+        return -RIG_EINVAL;
+    }
+
+    retcode = rig_vfo_ctx_restore(rig);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
+    if (when > ptt_now())
+    {
+        rig_ptt_wait(when);
+    }
+
+    rig_stats_begin_at(rig, &call, when);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_PTT_AT,
+                         rig_set_ptt(rig, vfo, ptt));
+}
+
+/** @} */
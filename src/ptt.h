@@ -0,0 +1,33 @@
+/*
+ *  Hamlib Interface - PTT keying header
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef _PTT_H
+#define _PTT_H 1
+
+#include <hamlib/rig.h>
+
+/* switch the PTT the way set up by rig_open(), see rig_state.ptt_shared */
+extern int rig_ptt_key(RIG *rig, vfo_t vfo, ptt_t ptt);
+
+/* sleep until when, a time of day in us */
+extern void rig_ptt_wait(int64_t when);
+
+#endif /* _PTT_H */
@@ -38,6 +38,7 @@
 #include <sys/types.h>
 
 #include <register.h>
+#include "registry.h"
 
 #include <hamlib/rig.h>
 
@@ -108,76 +109,55 @@ static struct
     const char *be_name;
     int (* be_init_all)(void *handle);
     rig_model_t (* be_probe_all)(hamlib_port_t *, rig_probe_func_t, rig_ptr_t);
+    int be_loaded;
 } rig_backend_list[RIG_BACKEND_MAX] =
 {
-    { RIG_DUMMY, RIG_BACKEND_DUMMY, RIG_FUNCNAMA(dummy) },
-    { RIG_YAESU, RIG_BACKEND_YAESU, RIG_FUNCNAM(yaesu) },
-    { RIG_KENWOOD, RIG_BACKEND_KENWOOD, RIG_FUNCNAM(kenwood) },
-    { RIG_ICOM, RIG_BACKEND_ICOM, RIG_FUNCNAM(icom) },
-    { RIG_ICMARINE, RIG_BACKEND_ICMARINE, RIG_FUNCNAMA(icmarine) },
-    { RIG_PCR, RIG_BACKEND_PCR, RIG_FUNCNAMA(pcr) },
-    { RIG_AOR, RIG_BACKEND_AOR, RIG_FUNCNAMA(aor) },
-    { RIG_JRC, RIG_BACKEND_JRC, RIG_FUNCNAMA(jrc) },
-    { RIG_UNIDEN, RIG_BACKEND_UNIDEN, RIG_FUNCNAM(uniden) },
-    { RIG_DRAKE, RIG_BACKEND_DRAKE, RIG_FUNCNAM(drake) },
-    { RIG_LOWE, RIG_BACKEND_LOWE, RIG_FUNCNAM(lowe) },
-    { RIG_RACAL, RIG_BACKEND_RACAL, RIG_FUNCNAMA(racal) },
-    { RIG_WJ, RIG_BACKEND_WJ, RIG_FUNCNAMA(wj) },
-    { RIG_SKANTI, RIG_BACKEND_SKANTI, RIG_FUNCNAMA(skanti) },
+    { RIG_DUMMY, RIG_BACKEND_DUMMY, RIG_FUNCNAMA(dummy), NULL, 0 },
+    { RIG_YAESU, RIG_BACKEND_YAESU, RIG_FUNCNAM(yaesu), 0 },
+    { RIG_KENWOOD, RIG_BACKEND_KENWOOD, RIG_FUNCNAM(kenwood), 0 },
+    { RIG_ICOM, RIG_BACKEND_ICOM, RIG_FUNCNAM(icom), 0 },
+    { RIG_ICMARINE, RIG_BACKEND_ICMARINE, RIG_FUNCNAMA(icmarine), NULL, 0 },
+    { RIG_PCR, RIG_BACKEND_PCR, RIG_FUNCNAMA(pcr), NULL, 0 },
+    { RIG_AOR, RIG_BACKEND_AOR, RIG_FUNCNAMA(aor), NULL, 0 },
+    { RIG_JRC, RIG_BACKEND_JRC, RIG_FUNCNAMA(jrc), NULL, 0 },
+    { RIG_UNIDEN, RIG_BACKEND_UNIDEN, RIG_FUNCNAM(uniden), 0 },
+    { RIG_DRAKE, RIG_BACKEND_DRAKE, RIG_FUNCNAM(drake), 0 },
+    { RIG_LOWE, RIG_BACKEND_LOWE, RIG_FUNCNAM(lowe), 0 },
+    { RIG_RACAL, RIG_BACKEND_RACAL, RIG_FUNCNAMA(racal), NULL, 0 },
+    { RIG_WJ, RIG_BACKEND_WJ, RIG_FUNCNAMA(wj), NULL, 0 },
+    { RIG_SKANTI, RIG_BACKEND_SKANTI, RIG_FUNCNAMA(skanti), NULL, 0 },
 #ifdef HAVE_WINRADIO
-    { RIG_WINRADIO, RIG_BACKEND_WINRADIO, RIG_FUNCNAMA(winradio) },
+    { RIG_WINRADIO, RIG_BACKEND_WINRADIO, RIG_FUNCNAMA(winradio), NULL, 0 },
 #endif /* HAVE_WINRADIO */
-    { RIG_TENTEC, RIG_BACKEND_TENTEC, RIG_FUNCNAMA(tentec) },
-    { RIG_ALINCO, RIG_BACKEND_ALINCO, RIG_FUNCNAMA(alinco) },
-    { RIG_KACHINA, RIG_BACKEND_KACHINA, RIG_FUNCNAMA(kachina) },
-    { RIG_TAPR, RIG_BACKEND_TAPR, RIG_FUNCNAMA(tapr) },
-    { RIG_FLEXRADIO, RIG_BACKEND_FLEXRADIO, RIG_FUNCNAMA(flexradio) },
-    { RIG_RFT, RIG_BACKEND_RFT, RIG_FUNCNAMA(rft) },
-    { RIG_KIT, RIG_BACKEND_KIT, RIG_FUNCNAMA(kit) },
-    { RIG_TUNER, RIG_BACKEND_TUNER, RIG_FUNCNAMA(tuner) },
-    { RIG_RS, RIG_BACKEND_RS, RIG_FUNCNAMA(rs) },
-    { RIG_PRM80, RIG_BACKEND_PRM80, RIG_FUNCNAMA(prm80) },
-    { RIG_ADAT, RIG_BACKEND_ADAT, RIG_FUNCNAM(adat) },
-    { RIG_DORJI, RIG_BACKEND_DORJI, RIG_FUNCNAMA(dorji) },
-    { RIG_BARRETT, RIG_BACKEND_BARRETT, RIG_FUNCNAMA(barrett) },
-    { RIG_ELAD, RIG_BACKEND_ELAD, RIG_FUNCNAMA(elad) },
+    { RIG_TENTEC, RIG_BACKEND_TENTEC, RIG_FUNCNAMA(tentec), NULL, 0 },
+    { RIG_ALINCO, RIG_BACKEND_ALINCO, RIG_FUNCNAMA(alinco), NULL, 0 },
+    { RIG_KACHINA, RIG_BACKEND_KACHINA, RIG_FUNCNAMA(kachina), NULL, 0 },
+    { RIG_TAPR, RIG_BACKEND_TAPR, RIG_FUNCNAMA(tapr), NULL, 0 },
+    { RIG_FLEXRADIO, RIG_BACKEND_FLEXRADIO, RIG_FUNCNAMA(flexradio), NULL, 0 },
+    { RIG_RFT, RIG_BACKEND_RFT, RIG_FUNCNAMA(rft), NULL, 0 },
+    { RIG_KIT, RIG_BACKEND_KIT, RIG_FUNCNAMA(kit), NULL, 0 },
+    { RIG_TUNER, RIG_BACKEND_TUNER, RIG_FUNCNAMA(tuner), NULL, 0 },
+    { RIG_RS, RIG_BACKEND_RS, RIG_FUNCNAMA(rs), NULL, 0 },
+    { RIG_PRM80, RIG_BACKEND_PRM80, RIG_FUNCNAMA(prm80), NULL, 0 },
+    { RIG_ADAT, RIG_BACKEND_ADAT, RIG_FUNCNAM(adat), 0 },
+    { RIG_DORJI, RIG_BACKEND_DORJI, RIG_FUNCNAMA(dorji), NULL, 0 },
+    { RIG_BARRETT, RIG_BACKEND_BARRETT, RIG_FUNCNAMA(barrett), NULL, 0 },
+    { RIG_ELAD, RIG_BACKEND_ELAD, RIG_FUNCNAMA(elad), NULL, 0 },
     { 0, NULL }, /* end */
 };
 
 
 /*
- * This struct to keep track of known rig models.
- * It is chained, and used in a hash table, see below.
+ * The known rig models, see registry.h
  */
-struct rig_list
-{
-    const struct rig_caps *caps;
-    struct rig_list *next;
-};
-
-
-#define RIGLSTHASHSZ 16
-#define HASH_FUNC(a) ((a)%RIGLSTHASHSZ)
-
-
-/*
- * The rig_hash_table is a hash table pointing to a list of next==NULL
- *  terminated caps.
- */
-static struct rig_list *rig_hash_table[RIGLSTHASHSZ] = { NULL, };
-
-
-static int rig_lookup_backend(rig_model_t rig_model);
+static struct registry rig_registry = REGISTRY_INITIALIZER;
 
 
 /*
- * Basically, this is a hash insert function that doesn't check for dup!
+ * Adds caps to the registry, refusing a model that is already there.
  */
 int HAMLIB_API rig_register(const struct rig_caps *caps)
 {
-    int hval;
-    struct rig_list *p;
-
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
     if (!caps)
@@ -190,49 +170,45 @@ int HAMLIB_API rig_register(const struct rig_caps *caps)
               __func__,
               caps->rig_model);
 
-#ifndef DONT_WANT_DUP_CHECK
-
-    if (rig_get_caps(caps->rig_model) != NULL)
-    {
-        return -RIG_EINVAL;
-    }
-
-#endif
-
-    p = (struct rig_list *)malloc(sizeof(struct rig_list));
-
-    if (!p)
-    {
-        return -RIG_ENOMEM;
-    }
-
-    hval = HASH_FUNC(caps->rig_model);
-    p->caps = caps;
-    // p->handle = NULL;
-    p->next = rig_hash_table[hval];
-    rig_hash_table[hval] = p;
-
-    return RIG_OK;
+    return registry_add(&rig_registry, caps->rig_model, caps->mfg_name,
+                        caps->model_name, caps);
 }
 
 /*
  * Get rig capabilities.
- * ie. rig_hash_table lookup
+ * ie. rig_registry lookup
  */
 
 const struct rig_caps *HAMLIB_API rig_get_caps(rig_model_t rig_model)
 {
-    struct rig_list *p;
+    return registry_get(&rig_registry, rig_model);
+}
+
+
+/**
+ * \brief look a rig model up by name
+ * \param mfg_name   The manufacturer name, e.g. "Icom"
+ * \param model_name The model name, e.g. "IC-7300"
+ *
+ * The names are matched without regard to case. Backends that have not
+ * been loaded yet are loaded on the first miss.
+ *
+ * \return the model number, or RIG_MODEL_NONE if there is no such rig.
+ */
+rig_model_t HAMLIB_API rig_get_model_by_name(const char *mfg_name,
+        const char *model_name)
+{
+    const struct rig_caps *caps;
+
+    caps = registry_find(&rig_registry, mfg_name, model_name);
 
-    for (p = rig_hash_table[HASH_FUNC(rig_model)]; p; p = p->next)
+    if (!caps)
     {
-        if (p->caps->rig_model == rig_model)
-        {
-            return p->caps;
-        }
+        rig_load_all_backends();
+        caps = registry_find(&rig_registry, mfg_name, model_name);
     }
 
-    return NULL;    /* sorry, caps not registered! */
+    return caps ? caps->rig_model : RIG_MODEL_NONE;
 }
 
 /*
@@ -299,63 +275,31 @@ int HAMLIB_API rig_check_backend(rig_model_t rig_model)
 
 int HAMLIB_API rig_unregister(rig_model_t rig_model)
 {
-    int hval;
-    struct rig_list *p, *q;
-
-    hval = HASH_FUNC(rig_model);
-    q = NULL;
-
-    for (p = rig_hash_table[hval]; p; p = p->next)
-    {
-        if (p->caps->rig_model == rig_model)
-        {
-            if (q == NULL)
-            {
-                rig_hash_table[hval] = p->next;
-            }
-            else
-            {
-                q->next = p->next;
-            }
-
-            free(p);
-            return RIG_OK;
-        }
-
-        q = p;
-    }
-
-    return -RIG_EINVAL; /* sorry, caps not registered! */
+    return registry_remove(&rig_registry, rig_model);
 }
 
 /*
  * rig_list_foreach
- * executes cfunc on all the elements stored in the rig hash list
+ * executes cfunc on all the elements stored in the rig registry
  */
 int HAMLIB_API rig_list_foreach(int (*cfunc)(const struct rig_caps *,
                                 rig_ptr_t),
                                 rig_ptr_t data)
 {
-    struct rig_list *p;
-    int i;
+    const struct rig_caps *caps;
+    unsigned iter = 0;
 
     if (!cfunc)
     {
         return -RIG_EINVAL;
     }
 
-    for (i = 0; i < RIGLSTHASHSZ; i++)
+    /* removing the current entry during the call is fine */
+    while ((caps = registry_next(&rig_registry, &iter)))
     {
-        struct rig_list *next = NULL;
-
-        for (p = rig_hash_table[i]; p; p = next)
+        if ((*cfunc)(caps, data) == 0)
         {
-            next = p->next;       /* read before call in case it is unregistered */
-
-            if ((*cfunc)(p->caps, data) == 0)
-            {
-                return RIG_OK;
-            }
+            return RIG_OK;
         }
     }
 
@@ -451,16 +395,29 @@ int HAMLIB_API rig_load_backend(const char *be_name)
     {
         if (!strcmp(be_name, rig_backend_list[i].be_name))
         {
-            be_init = rig_backend_list[i].be_init_all ;
+            int retval;
 
-            if (be_init)
+            /* each backend registers its models only once */
+            if (rig_backend_list[i].be_loaded)
             {
-                return (*be_init)(NULL);
+                return RIG_OK;
             }
-            else
+
+            be_init = rig_backend_list[i].be_init_all ;
+
+            if (!be_init)
             {
                 return -RIG_EINVAL;
             }
+
+            retval = (*be_init)(NULL);
+
+            if (retval == RIG_OK)
+            {
+                rig_backend_list[i].be_loaded = 1;
+            }
+
+            return retval;
         }
     }
 
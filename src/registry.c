@@ -0,0 +1,305 @@
+/*
+ *  Hamlib Interface - model registry hash tables
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+#include <hamlib/rig.h>
+#include "registry.h"
+
+#define REGISTRY_MIN_SIZE 64
+
+/* marks a removed slot, so that probe sequences are not cut short */
+static const char registry_deleted;
+#define DELETED ((const void *)&registry_deleted)
+
+
+static unsigned model_hash(int model)
+{
+    unsigned h = (unsigned)model * 0x9e3779b1U;
+
+    return h ^ (h >> 16);
+}
+
+
+/* FNV-1a, not case sensitive */
+static unsigned name_hash(const char *mfg_name, const char *model_name)
+{
+    unsigned h = 2166136261U;
+    const char *p;
+
+    for (p = mfg_name; *p; p++)
+    {
+        h = (h ^ (unsigned char)tolower((unsigned char)*p)) * 16777619U;
+    }
+
+    h = (h ^ '/') * 16777619U;
+
+    for (p = model_name; *p; p++)
+    {
+        h = (h ^ (unsigned char)tolower((unsigned char)*p)) * 16777619U;
+    }
+
+    return h;
+}
+
+
+static int name_match(const struct registry_slot *s, const char *mfg_name,
+                      const char *model_name)
+{
+    return s->mfg_name && s->model_name
+           && !strcasecmp(s->mfg_name, mfg_name)
+           && !strcasecmp(s->model_name, model_name);
+}
+
+
+/* slot holding model, or the free slot ending its probe sequence */
+static unsigned lookup_slot(const struct registry *r, int model)
+{
+    unsigned mask = r->size - 1;
+    unsigned i = model_hash(model) & mask;
+
+    while (r->slot[i].caps
+            && (r->slot[i].caps == DELETED || r->slot[i].model != model))
+    {
+        i = (i + 1) & mask;
+    }
+
+    return i;
+}
+
+
+static void index_name(struct registry *r, unsigned idx)
+{
+    const struct registry_slot *s = &r->slot[idx];
+    unsigned mask = r->size - 1;
+    unsigned i;
+
+    if (!s->mfg_name || !s->model_name)
+    {
+        return;
+    }
+
+    i = name_hash(s->mfg_name, s->model_name) & mask;
+
+    while (r->by_name[i] > 0)
+    {
+        i = (i + 1) & mask;
+    }
+
+    r->by_name[i] = idx + 1;
+}
+
+
+static int registry_grow(struct registry *r)
+{
+    struct registry old = *r;
+    unsigned size = REGISTRY_MIN_SIZE;
+    unsigned i;
+
+    while (size < (r->count + 1) * 4)
+    {
+        size *= 2;
+    }
+
+    r->slot = calloc(size, sizeof(struct registry_slot));
+    r->by_name = calloc(size, sizeof(int));
+
+    if (!r->slot || !r->by_name)
+    {
+        free(r->slot);
+        free(r->by_name);
+        *r = old;
+        return -RIG_ENOMEM;
+    }
+
+    r->size = size;
+    r->used = r->count;
+
+    for (i = 0; i < old.size; i++)
+    {
+        if (old.slot[i].caps && old.slot[i].caps != DELETED)
+        {
+            unsigned idx = lookup_slot(r, old.slot[i].model);
+
+            r->slot[idx] = old.slot[i];
+            index_name(r, idx);
+        }
+    }
+
+    free(old.slot);
+    free(old.by_name);
+
+    return RIG_OK;
+}
+
+
+/*
+ * Adds caps under model. Returns -RIG_EINVAL if the model is already
+ * registered.
+ */
+int registry_add(struct registry *r, int model, const char *mfg_name,
+                 const char *model_name, const void *caps)
+{
+    unsigned idx;
+
+    if (!caps)
+    {
+        return -RIG_EINVAL;
+    }
+
+    if ((r->used + 1) * 2 > r->size)
+    {
+        int retval = registry_grow(r);
+
+        if (retval != RIG_OK)
+        {
+            return retval;
+        }
+    }
+
+    idx = lookup_slot(r, model);
+
+    if (r->slot[idx].caps)
+    {
+        return -RIG_EINVAL;
+    }
+
+    r->slot[idx].model = model;
+    r->slot[idx].mfg_name = mfg_name;
+    r->slot[idx].model_name = model_name;
+    r->slot[idx].caps = caps;
+    r->used++;
+    r->count++;
+
+    index_name(r, idx);
+
+    return RIG_OK;
+}
+
+
+int registry_remove(struct registry *r, int model)
+{
+    struct registry_slot *s;
+    unsigned idx, i, mask;
+
+    if (!r->size)
+    {
+        return -RIG_EINVAL;
+    }
+
+    idx = lookup_slot(r, model);
+    s = &r->slot[idx];
+
+    if (!s->caps)
+    {
+        return -RIG_EINVAL;
+    }
+
+    if (s->mfg_name && s->model_name)
+    {
+        mask = r->size - 1;
+
+        for (i = name_hash(s->mfg_name, s->model_name) & mask;
+                r->by_name[i];
+                i = (i + 1) & mask)
+        {
+            if (r->by_name[i] == (int) idx + 1)
+            {
+                r->by_name[i] = -1;
+                break;
+            }
+        }
+    }
+
+    s->caps = DELETED;
+    r->count--;
+
+    return RIG_OK;
+}
+
+
+const void *registry_get(const struct registry *r, int model)
+{
+    if (!r->size)
+    {
+        return NULL;
+    }
+
+    return r->slot[lookup_slot(r, model)].caps;
+}
+
+
+/*
+ * Looks a model up by manufacturer and model name, ignoring case.
+ */
+const void *registry_find(const struct registry *r, const char *mfg_name,
+                          const char *model_name)
+{
+    unsigned mask, i;
+
+    if (!r->size || !mfg_name || !model_name)
+    {
+        return NULL;
+    }
+
+    mask = r->size - 1;
+
+    for (i = name_hash(mfg_name, model_name) & mask;
+            r->by_name[i];
+            i = (i + 1) & mask)
+    {
+        if (r->by_name[i] > 0
+                && name_match(&r->slot[r->by_name[i] - 1],
+                              mfg_name, model_name))
+        {
+            return r->slot[r->by_name[i] - 1].caps;
+        }
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Iterates over the registered caps, *iter starting at 0.
+ * Returns NULL at the end.
+ */
+const void *registry_next(const struct registry *r, unsigned *iter)
+{
+    while (*iter < r->size)
+    {
+        const void *caps = r->slot[(*iter)++].caps;
+
+        if (caps && caps != DELETED)
+        {
+            return caps;
+        }
+    }
+
+    return NULL;
+}
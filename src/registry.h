@@ -0,0 +1,65 @@
+/*
+ *  Hamlib Interface - model registry hash tables
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef _REGISTRY_H
+#define _REGISTRY_H 1
+
+#include <hamlib/rig.h>
+
+/*
+ * Caps registered by the rig, rotator and amplifier backends, indexed
+ * by model number and by manufacturer plus model name. Both indexes
+ * are open addressed with linear probing and grow to stay at most half
+ * full, so lookups do not depend on the number of models.
+ */
+struct registry_slot
+{
+    int model;
+    const char *mfg_name;
+    const char *model_name;
+    const void *caps;           /* NULL when free */
+};
+
+struct registry
+{
+    struct registry_slot *slot; /* by model number */
+    int *by_name;               /* slot index + 1, by names */
+    unsigned size;              /* power of 2 */
+    unsigned used;              /* live and deleted slots */
+    unsigned count;             /* live slots */
+};
+
+#define REGISTRY_INITIALIZER { NULL, NULL, 0, 0, 0 }
+
+__BEGIN_DECLS
+
+extern int registry_add(struct registry *r, int model, const char *mfg_name,
+                        const char *model_name, const void *caps);
+extern int registry_remove(struct registry *r, int model);
+extern const void *registry_get(const struct registry *r, int model);
+extern const void *registry_find(const struct registry *r,
+                                 const char *mfg_name,
+                                 const char *model_name);
+extern const void *registry_next(const struct registry *r, unsigned *iter);
+
+__END_DECLS
+
+#endif /* _REGISTRY_H */
@@ -60,6 +60,9 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 
+#ifdef HAVE_PTHREAD
+#  include <pthread.h>
+#endif
 
 #include <hamlib/rig.h>
 #include "serial.h"
@@ -69,6 +72,11 @@
 #include "event.h"
 #include "cm108.h"
 #include "gpio.h"
+#include "cache.h"
+#include "cal.h"
+#include "stats.h"
+#include "vfoctx.h"
+#include "ptt.h"
 
 /**
  * \brief Hamlib release number
@@ -152,6 +160,16 @@ struct opened_rig_l
 };
 static struct opened_rig_l *opened_rig_list = { NULL };
 
+#ifdef HAVE_PTHREAD
+/* serializes add/remove, rigs may be opened from several threads */
+static pthread_mutex_t opened_rig_lock = PTHREAD_MUTEX_INITIALIZER;
+#  define OPENED_RIG_LOCK()   pthread_mutex_lock(&opened_rig_lock)
+#  define OPENED_RIG_UNLOCK() pthread_mutex_unlock(&opened_rig_lock)
+#else
+#  define OPENED_RIG_LOCK()
+#  define OPENED_RIG_UNLOCK()
+#endif
+
 
 /*
  * Careful, the order must be the same as their RIG_E* counterpart!
@@ -199,8 +217,10 @@ static int add_opened_rig(RIG *rig)
     }
 
     p->rig = rig;
+    OPENED_RIG_LOCK();
     p->next = opened_rig_list;
     opened_rig_list = p;
+    OPENED_RIG_UNLOCK();
 
     return RIG_OK;
 }
@@ -211,6 +231,8 @@ static int remove_opened_rig(RIG *rig)
     struct opened_rig_l *p, *q;
     q = NULL;
 
+    OPENED_RIG_LOCK();
+
     for (p = opened_rig_list; p; p = p->next)
     {
         if (p->rig == rig)
@@ -224,6 +246,7 @@ static int remove_opened_rig(RIG *rig)
                 q->next = p->next;
             }
 
+            OPENED_RIG_UNLOCK();
             free(p);
             return RIG_OK;
         }
@@ -231,6 +254,8 @@ static int remove_opened_rig(RIG *rig)
         q = p;
     }
 
+    OPENED_RIG_UNLOCK();
+
     return -RIG_EINVAL; /* Not found in list ! */
 }
 
@@ -268,6 +293,52 @@ int foreach_opened_rig(int (*cfunc)(RIG *, rig_ptr_t), rig_ptr_t data)
     return RIG_OK;
 }
 
+/*
+ * API functions accounted in the statistics are wrappers around these,
+ * see stats.h
+ */
+static int do_rig_set_freq(RIG *rig, vfo_t vfo, freq_t freq);
+static int do_rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq);
+static int do_rig_set_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width);
+static int do_rig_get_mode(RIG *rig,
+                           vfo_t vfo,
+                           rmode_t *mode,
+                           pbwidth_t *width);
+static int do_rig_set_vfo(RIG *rig, vfo_t vfo);
+static int do_rig_get_vfo(RIG *rig, vfo_t *vfo);
+static int do_rig_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt);
+static int do_rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt);
+static int do_rig_get_dcd(RIG *rig, vfo_t vfo, dcd_t *dcd);
+static int do_rig_set_split_freq(RIG *rig, vfo_t vfo, freq_t tx_freq);
+static int do_rig_get_split_freq(RIG *rig, vfo_t vfo, freq_t *tx_freq);
+static int do_rig_set_split_mode(RIG *rig,
+                                 vfo_t vfo,
+                                 rmode_t tx_mode,
+                                 pbwidth_t tx_width);
+static int do_rig_get_split_mode(RIG *rig, vfo_t vfo, rmode_t *tx_mode,
+                                 pbwidth_t *tx_width);
+static int do_rig_set_split_vfo(RIG *rig,
+                                vfo_t vfo,
+                                split_t split,
+                                vfo_t tx_vfo);
+static int do_rig_get_split_vfo(RIG *rig,
+                                vfo_t vfo,
+                                split_t *split,
+                                vfo_t *tx_vfo);
+static int do_rig_set_rit(RIG *rig, vfo_t vfo, shortfreq_t rit);
+static int do_rig_get_rit(RIG *rig, vfo_t vfo, shortfreq_t *rit);
+static int do_rig_set_xit(RIG *rig, vfo_t vfo, shortfreq_t xit);
+static int do_rig_get_xit(RIG *rig, vfo_t vfo, shortfreq_t *xit);
+static int do_rig_set_ts(RIG *rig, vfo_t vfo, shortfreq_t ts);
+static int do_rig_get_ts(RIG *rig, vfo_t vfo, shortfreq_t *ts);
+static int do_rig_set_ant(RIG *rig, vfo_t vfo, ant_t ant);
+static int do_rig_get_ant(RIG *rig, vfo_t vfo, ant_t *ant);
+static int do_rig_set_powerstat(RIG *rig, powerstat_t status);
+static int do_rig_get_powerstat(RIG *rig, powerstat_t *status);
+static int do_rig_vfo_op(RIG *rig, vfo_t vfo, vfo_op_t op);
+static int do_rig_scan(RIG *rig, vfo_t vfo, scan_t scan, int ch);
+static int do_rig_send_morse(RIG *rig, vfo_t vfo, const char *msg);
+
 #endif /* !DOC_HIDDEN */
 
 
@@ -403,6 +474,7 @@ RIG *HAMLIB_API rig_init(rig_model_t rig_model)
     rs->vfo_comp = 0.0; /* override it with preferences */
     rs->current_vfo = RIG_VFO_CURR; /* we don't know yet! */
     rs->tx_vfo = RIG_VFO_CURR;  /* we don't know yet! */
+    rs->restore_vfo = RIG_VFO_NONE;
     rs->transceive = RIG_TRN_OFF;
     rs->poll_interval = 500;
     /* should it be a parameter to rig_init ? --SF */
@@ -451,6 +523,7 @@ RIG *HAMLIB_API rig_init(rig_model_t rig_model)
            sizeof(struct filter_list)*FLTLSTSIZ);
     memcpy(&rs->str_cal, &caps->str_cal,
            sizeof(cal_table_t));
+    rig_cal_init(rig);
 
     memcpy(rs->chan_list, caps->chan_list, sizeof(chan_t)*CHANLSTSIZ);
 
@@ -478,6 +551,8 @@ RIG *HAMLIB_API rig_init(rig_model_t rig_model)
 
     rs->rigport.fd = rs->pttport.fd = rs->dcdport.fd = -1;
 
+    rig_decode_lock_init(rig);
+
     /*
      * let the backend a chance to setup his private data
      * This must be done only once defaults are setup,
@@ -493,6 +568,7 @@ RIG *HAMLIB_API rig_init(rig_model_t rig_model)
                       "%s: backend_init failed!\n",
                       __func__);
             /* cleanup and exit */
+            rig_decode_lock_free(rig);
             free(rig);
             return NULL;
         }
@@ -541,6 +617,9 @@ int HAMLIB_API rig_open(RIG *rig)
 
     rs->rigport.fd = -1;
 
+    /* the rig may have been changed while we were away */
+    rig_cache_invalidate(rig, RIG_CACHE_ALL);
+
     if (rs->rigport.type.rig == RIG_PORT_SERIAL)
     {
         if (rs->rigport.parm.serial.rts_state != RIG_SIGNAL_UNSET
@@ -601,7 +680,9 @@ int HAMLIB_API rig_open(RIG *rig)
             strcpy(rs->pttport.pathname, rs->rigport.pathname);
         }
 
-        if (!strcmp(rs->pttport.pathname, rs->rigport.pathname))
+        rs->ptt_shared = !strcmp(rs->pttport.pathname, rs->rigport.pathname);
+
+        if (rs->ptt_shared)
         {
             rs->pttport.fd = rs->rigport.fd;
 
@@ -648,7 +729,11 @@ int HAMLIB_API rig_open(RIG *rig)
                 }
             }
 
-            ser_close(&rs->pttport);
+            /* else seized again at each transmission */
+            if (!rs->ptt_hold || RIG_OK != status)
+            {
+                ser_close(&rs->pttport);
+            }
         }
 
         break;
@@ -842,6 +927,15 @@ int HAMLIB_API rig_open(RIG *rig)
         }
     }
 
+    /* after the backend, which may have adjusted the calibrations */
+    status = rig_cal_compile(rig);
+
+    if (status != RIG_OK)
+    {
+        rig_close(rig);
+        return status;
+    }
+
     /*
      * trigger state->current_vfo first retrieval
      */
@@ -904,6 +998,14 @@ int HAMLIB_API rig_close(RIG *rig)
         return -RIG_EINVAL;
     }
 
+    if (rs->async)
+    {
+        rig_async_stop(rig);
+    }
+
+    /* leave the rig on the VFO it was found on, or last set to */
+    rig_vfo_ctx_restore(rig);
+
     if (rs->transceive != RIG_TRN_OFF)
     {
         rig_set_trn(rig, RIG_TRN_OFF);
@@ -1062,6 +1164,9 @@ int HAMLIB_API rig_cleanup(RIG *rig)
         rig->caps->rig_cleanup(rig);
     }
 
+    rig_stats_free(rig);
+    rig_cal_free(rig);
+    rig_decode_lock_free(rig);
     free(rig);
 
     return RIG_OK;
@@ -1083,10 +1188,20 @@ int HAMLIB_API rig_cleanup(RIG *rig)
  * \sa rig_get_freq()
  */
 int HAMLIB_API rig_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_FREQ,
+                         do_rig_set_freq(rig, vfo, freq));
+}
+
+
+static int do_rig_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -1095,6 +1210,15 @@ int HAMLIB_API rig_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_FREQ);
+
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (rig->state.lo_freq != 0.0)
@@ -1125,8 +1249,7 @@ int HAMLIB_API rig_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
             return -RIG_ENTARGET;
         }
 
-        curr_vfo = rig->state.current_vfo;
-        retcode = caps->set_vfo(rig, vfo);
+        retcode = rig_vfo_ctx_select(rig, vfo);
 
         if (retcode != RIG_OK)
         {
@@ -1135,7 +1258,7 @@ int HAMLIB_API rig_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
 
         retcode = caps->set_freq(rig, vfo, freq);
         /* try and revert even if we had an error above */
-        rc2 = caps->set_vfo(rig, curr_vfo);
+        rc2 = rig_vfo_ctx_release(rig);
 
         if (RIG_OK == retcode)
         {
@@ -1172,10 +1295,20 @@ int HAMLIB_API rig_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
  * \sa rig_set_freq()
  */
 int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_FREQ,
+                         do_rig_get_freq(rig, vfo, freq));
+}
+
+
+static int do_rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -1184,6 +1317,18 @@ int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
         return -RIG_EINVAL;
     }
 
+    if (rig_cache_get_freq(rig, vfo, freq) == RIG_OK)
+    {
+        return RIG_OK;
+    }
+
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_freq == NULL)
@@ -1203,8 +1348,7 @@ int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
             return -RIG_ENAVAIL;
         }
 
-        curr_vfo = rig->state.current_vfo;
-        retcode = caps->set_vfo(rig, vfo);
+        retcode = rig_vfo_ctx_select(rig, vfo);
 
         if (retcode != RIG_OK)
         {
@@ -1213,7 +1357,7 @@ int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
 
         retcode = caps->get_freq(rig, vfo, freq);
         /* try and revert even if we had an error above */
-        rc2 = caps->set_vfo(rig, curr_vfo);
+        rc2 = rig_vfo_ctx_release(rig);
 
         if (RIG_OK == retcode)
         {
@@ -1239,6 +1383,11 @@ int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
         *freq += rig->state.lo_freq;
     }
 
+    if (retcode == RIG_OK)
+    {
+        rig_cache_set_freq(rig, vfo, *freq);
+    }
+
     return retcode;
 }
 
@@ -1263,10 +1412,20 @@ int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
  * \sa rig_get_mode()
  */
 int HAMLIB_API rig_set_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_MODE,
+                         do_rig_set_mode(rig, vfo, mode, width));
+}
+
+
+static int do_rig_set_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -1275,6 +1434,15 @@ int HAMLIB_API rig_set_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_MODE);
+
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_mode == NULL)
@@ -1296,8 +1464,7 @@ int HAMLIB_API rig_set_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
             return -RIG_ENTARGET;
         }
 
-        curr_vfo = rig->state.current_vfo;
-        retcode = caps->set_vfo(rig, vfo);
+        retcode = rig_vfo_ctx_select(rig, vfo);
 
         if (retcode != RIG_OK)
         {
@@ -1306,7 +1473,7 @@ int HAMLIB_API rig_set_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
 
         retcode = caps->set_mode(rig, vfo, mode, width);
         /* try and revert even if we had an error above */
-        rc2 = caps->set_vfo(rig, curr_vfo);
+        rc2 = rig_vfo_ctx_release(rig);
 
         /* return the first error code */
         if (RIG_OK == retcode)
@@ -1349,10 +1516,23 @@ int HAMLIB_API rig_get_mode(RIG *rig,
                             vfo_t vfo,
                             rmode_t *mode,
                             pbwidth_t *width)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_MODE,
+                         do_rig_get_mode(rig, vfo, mode, width));
+}
+
+
+static int do_rig_get_mode(RIG *rig,
+                           vfo_t vfo,
+                           rmode_t *mode,
+                           pbwidth_t *width)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -1361,6 +1541,18 @@ int HAMLIB_API rig_get_mode(RIG *rig,
         return -RIG_EINVAL;
     }
 
+    if (rig_cache_get_mode(rig, vfo, mode, width) == RIG_OK)
+    {
+        return RIG_OK;
+    }
+
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_mode == NULL)
@@ -1382,8 +1574,7 @@ int HAMLIB_API rig_get_mode(RIG *rig,
             return -RIG_ENTARGET;
         }
 
-        curr_vfo = rig->state.current_vfo;
-        retcode = caps->set_vfo(rig, vfo);
+        retcode = rig_vfo_ctx_select(rig, vfo);
 
         if (retcode != RIG_OK)
         {
@@ -1392,7 +1583,7 @@ int HAMLIB_API rig_get_mode(RIG *rig,
 
         retcode = caps->get_mode(rig, vfo, mode, width);
         /* try and revert even if we had an error above */
-        rc2 = caps->set_vfo(rig, curr_vfo);
+        rc2 = rig_vfo_ctx_release(rig);
 
         if (RIG_OK == retcode)
         {
@@ -1413,6 +1604,11 @@ int HAMLIB_API rig_get_mode(RIG *rig,
         *width = rig_passband_normal(rig, *mode);
     }
 
+    if (retcode == RIG_OK)
+    {
+        rig_cache_set_mode(rig, vfo, *mode, *width);
+    }
+
     return retcode;
 }
 
@@ -1575,6 +1771,17 @@ pbwidth_t HAMLIB_API rig_passband_wide(RIG *rig, rmode_t mode)
  * \sa rig_get_vfo()
  */
 int HAMLIB_API rig_set_vfo(RIG *rig, vfo_t vfo)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_VFO,
+                         do_rig_set_vfo(rig, vfo));
+}
+
+
+static int do_rig_set_vfo(RIG *rig, vfo_t vfo)
 {
     const struct rig_caps *caps;
     int retcode;
@@ -1586,6 +1793,8 @@ int HAMLIB_API rig_set_vfo(RIG *rig, vfo_t vfo)
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_ALL);
+
     caps = rig->caps;
 
     if (caps->set_vfo == NULL)
@@ -1593,6 +1802,17 @@ int HAMLIB_API rig_set_vfo(RIG *rig, vfo_t vfo)
         return -RIG_ENAVAIL;
     }
 
+    /* a VFO left by a deferred switch is adopted rather than restored */
+    if (rig->state.restore_vfo != RIG_VFO_NONE)
+    {
+        rig->state.restore_vfo = RIG_VFO_NONE;
+
+        if (vfo == rig->state.current_vfo)
+        {
+            return RIG_OK;
+        }
+    }
+
     retcode = caps->set_vfo(rig, vfo);
 
     if (retcode == RIG_OK)
@@ -1620,6 +1840,17 @@ int HAMLIB_API rig_set_vfo(RIG *rig, vfo_t vfo)
  * \sa rig_set_vfo()
  */
 int HAMLIB_API rig_get_vfo(RIG *rig, vfo_t *vfo)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_VFO,
+                         do_rig_get_vfo(rig, vfo));
+}
+
+
+static int do_rig_get_vfo(RIG *rig, vfo_t *vfo)
 {
     const struct rig_caps *caps;
     int retcode;
@@ -1631,6 +1862,18 @@ int HAMLIB_API rig_get_vfo(RIG *rig, vfo_t *vfo)
         return -RIG_EINVAL;
     }
 
+    /* the rig is only temporarily on another VFO */
+    if (rig->state.restore_vfo != RIG_VFO_NONE)
+    {
+        *vfo = rig->state.restore_vfo;
+        return RIG_OK;
+    }
+
+    if (rig_cache_get_vfo(rig, vfo) == RIG_OK)
+    {
+        return RIG_OK;
+    }
+
     caps = rig->caps;
 
     if (caps->get_vfo == NULL)
@@ -1643,6 +1886,7 @@ int HAMLIB_API rig_get_vfo(RIG *rig, vfo_t *vfo)
     if (retcode == RIG_OK)
     {
         rig->state.current_vfo = *vfo;
+        rig_cache_set_vfo(rig, *vfo);
     }
 
     return retcode;
@@ -1665,11 +1909,19 @@ int HAMLIB_API rig_get_vfo(RIG *rig, vfo_t *vfo)
  */
 int HAMLIB_API rig_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
 {
-    const struct rig_caps *caps;
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_PTT,
+                         do_rig_set_ptt(rig, vfo, ptt));
+}
+
+
+static int do_rig_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
+{
     struct rig_state *rs = &rig->state;
-    int retcode = RIG_OK;
-    int rc2;
-    vfo_t curr_vfo;
+    int retcode;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -1678,163 +1930,17 @@ int HAMLIB_API rig_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
         return -RIG_EINVAL;
     }
 
-    caps = rig->caps;
-
-    switch (rig->state.pttport.type.ptt)
-    {
-    case RIG_PTT_RIG:
-        if (ptt == RIG_PTT_ON_MIC || ptt == RIG_PTT_ON_DATA)
-        {
-            ptt = RIG_PTT_ON;
-        }
-
-    /* fall through */
-    case RIG_PTT_RIG_MICDATA:
-        if (caps->set_ptt == NULL)
-        {
-            return -RIG_ENIMPL;
-        }
-
-        if ((caps->targetable_vfo & RIG_TARGETABLE_PURE)
-                || vfo == RIG_VFO_CURR
-                || vfo == rig->state.current_vfo)
-        {
-
-            retcode = caps->set_ptt(rig, vfo, ptt);
-        }
-        else
-        {
-            if (!caps->set_vfo)
-            {
-                return -RIG_ENTARGET;
-            }
-
-            curr_vfo = rig->state.current_vfo;
-            retcode = caps->set_vfo(rig, vfo);
-
-            if (retcode == RIG_OK)
-            {
-                retcode = caps->set_ptt(rig, vfo, ptt);
-                /* try and revert even if we had an error above */
-                rc2 = caps->set_vfo(rig, curr_vfo);
-
-                /* return the first error code */
-                if (RIG_OK == retcode)
-                {
-                    retcode = rc2;
-                }
-            }
-        }
-
-        break;
-
-    case RIG_PTT_SERIAL_DTR:
-
-        /* when the PTT port is not the control port we want to free the
-           port when PTT is reset and seize the port when PTT is set,
-           this allows limited sharing of the PTT port between
-           applications so long as there is no contention */
-        if (strcmp(rs->pttport.pathname, rs->rigport.pathname)
-                && rs->pttport.fd < 0
-                && RIG_PTT_OFF != ptt)
-        {
-
-            rs->pttport.fd = ser_open(&rs->pttport);
-
-            if (rs->pttport.fd < 0)
-            {
-                rig_debug(RIG_DEBUG_ERR,
-                          "%s: cannot open PTT device \"%s\"\n",
-                          __func__,
-                          rs->pttport.pathname);
-                return -RIG_EIO;
-            }
-
-            /* Needed on Linux because the serial port driver sets RTS/DTR
-               high on open - set both since we offer no control of
-               the non-PTT line and low is better than high */
-            retcode = ser_set_rts(&rs->pttport, 0);
-
-            if (RIG_OK != retcode)
-            {
-                return retcode;
-            }
-        }
-
-        retcode = ser_set_dtr(&rig->state.pttport, ptt != RIG_PTT_OFF);
-
-        if (strcmp(rs->pttport.pathname, rs->rigport.pathname)
-                && ptt == RIG_PTT_OFF)
-        {
-
-            /* free the port */
-            ser_close(&rs->pttport);
-        }
-
-        break;
-
-    case RIG_PTT_SERIAL_RTS:
-
-        /* when the PTT port is not the control port we want to free the
-           port when PTT is reset and seize the port when PTT is set,
-           this allows limited sharing of the PTT port between
-           applications so long as there is no contention */
-        if (strcmp(rs->pttport.pathname, rs->rigport.pathname)
-                && rs->pttport.fd < 0
-                && RIG_PTT_OFF != ptt)
-        {
-
-            rs->pttport.fd = ser_open(&rs->pttport);
-
-            if (rs->pttport.fd < 0)
-            {
-                rig_debug(RIG_DEBUG_ERR,
-                          "%s: cannot open PTT device \"%s\"\n",
-                          __func__,
-                          rs->pttport.pathname);
-                return -RIG_EIO;
-            }
-
-            /* Needed on Linux because the serial port driver sets RTS/DTR
-               high on open - set both since we offer no control of the
-               non-PTT line and low is better than high */
-            retcode = ser_set_dtr(&rs->pttport, 0);
-
-            if (RIG_OK != retcode)
-            {
-                return retcode;
-            }
-        }
-
-        retcode = ser_set_rts(&rig->state.pttport, ptt != RIG_PTT_OFF);
-
-        if (strcmp(rs->pttport.pathname, rs->rigport.pathname)
-                && ptt == RIG_PTT_OFF)
-        {
-
-            /* free the port */
-            ser_close(&rs->pttport);
-        }
-
-        break;
-
-    case RIG_PTT_PARALLEL:
-        retcode = par_ptt_set(&rig->state.pttport, ptt);
-        break;
+    rig_cache_invalidate(rig, RIG_CACHE_PTT);
 
-    case RIG_PTT_CM108:
-        retcode = cm108_ptt_set(&rig->state.pttport, ptt);
-        break;
-
-    case RIG_PTT_GPIO:
-    case RIG_PTT_GPION:
-        retcode = gpio_ptt_set(&rig->state.pttport, ptt);
-        break;
+    retcode = rig_vfo_ctx_restore(rig);
 
-    default:
-        return -RIG_EINVAL;
+    if (retcode != RIG_OK)
+    {
+        return retcode;
     }
 
+    retcode = rig_ptt_key(rig, vfo, ptt);
+
     if (RIG_OK == retcode)
     {
         rs->transmit = ptt != RIG_PTT_OFF;
@@ -1859,6 +1965,17 @@ int HAMLIB_API rig_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
  * \sa rig_set_ptt()
  */
 int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_PTT,
+                         do_rig_get_ptt(rig, vfo, ptt));
+}
+
+
+static int do_rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 {
     const struct rig_caps *caps;
     struct rig_state *rs = &rig->state;
@@ -1873,9 +1990,16 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
         return -RIG_EINVAL;
     }
 
-    caps = rig->caps;
+    retcode = rig_vfo_ctx_restore(rig);
 
-    switch (rig->state.pttport.type.ptt)
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
+    caps = rig->caps;
+
+    switch (rig->state.pttport.type.ptt)
     {
     case RIG_PTT_RIG:
     case RIG_PTT_RIG_MICDATA:
@@ -1885,12 +2009,23 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
             return RIG_OK;
         }
 
+        if (rig_cache_get_ptt(rig, vfo, ptt) == RIG_OK)
+        {
+            return RIG_OK;
+        }
+
         if ((caps->targetable_vfo & RIG_TARGETABLE_PURE)
                 || vfo == RIG_VFO_CURR
                 || vfo == rig->state.current_vfo)
         {
+            retcode = caps->get_ptt(rig, vfo, ptt);
 
-            return caps->get_ptt(rig, vfo, ptt);
+            if (retcode == RIG_OK)
+            {
+                rig_cache_set_ptt(rig, vfo, *ptt);
+            }
+
+            return retcode;
         }
 
         if (!caps->set_vfo)
@@ -1912,6 +2047,7 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 
         if (RIG_OK == retcode)
         {
+            rig_cache_set_ptt(rig, vfo, *ptt);
             /* return the first error code */
             retcode = rc2;
         }
@@ -1924,8 +2060,7 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
             return caps->get_ptt(rig, vfo, ptt);
         }
 
-        if (strcmp(rs->pttport.pathname, rs->rigport.pathname)
-                && rs->pttport.fd < 0)
+        if (!rs->ptt_shared && rs->pttport.fd < 0)
         {
 
             /* port is closed so assume PTT off */
@@ -1945,8 +2080,7 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
             return caps->get_ptt(rig, vfo, ptt);
         }
 
-        if (strcmp(rs->pttport.pathname, rs->rigport.pathname)
-                && rs->pttport.fd < 0)
+        if (!rs->ptt_shared && rs->pttport.fd < 0)
         {
 
             /* port is closed so assume PTT off */
@@ -2010,6 +2144,17 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
  *
  */
 int HAMLIB_API rig_get_dcd(RIG *rig, vfo_t vfo, dcd_t *dcd)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_DCD,
+                         do_rig_get_dcd(rig, vfo, dcd));
+}
+
+
+static int do_rig_get_dcd(RIG *rig, vfo_t vfo, dcd_t *dcd)
 {
     const struct rig_caps *caps;
     int retcode, rc2, status;
@@ -2022,6 +2167,13 @@ int HAMLIB_API rig_get_dcd(RIG *rig, vfo_t vfo, dcd_t *dcd)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_restore(rig);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     switch (rig->state.dcdport.type.dcd)
@@ -2118,7 +2270,6 @@ int HAMLIB_API rig_set_rptr_shift(RIG *rig, vfo_t vfo, rptr_shift_t rptr_shift)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -2127,6 +2278,13 @@ int HAMLIB_API rig_set_rptr_shift(RIG *rig, vfo_t vfo, rptr_shift_t rptr_shift)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_rptr_shift == NULL)
@@ -2146,8 +2304,7 @@ int HAMLIB_API rig_set_rptr_shift(RIG *rig, vfo_t vfo, rptr_shift_t rptr_shift)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -2156,7 +2313,7 @@ int HAMLIB_API rig_set_rptr_shift(RIG *rig, vfo_t vfo, rptr_shift_t rptr_shift)
 
     retcode = caps->set_rptr_shift(rig, vfo, rptr_shift);
     /* try and revert even if we had an error above */
-    rc2 = caps->set_vfo(rig, curr_vfo);
+    rc2 = rig_vfo_ctx_release(rig);
 
     if (RIG_OK == retcode)
     {
@@ -2186,7 +2343,6 @@ int HAMLIB_API rig_get_rptr_shift(RIG *rig, vfo_t vfo, rptr_shift_t *rptr_shift)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -2195,6 +2351,13 @@ int HAMLIB_API rig_get_rptr_shift(RIG *rig, vfo_t vfo, rptr_shift_t *rptr_shift)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_rptr_shift == NULL)
@@ -2214,8 +2377,7 @@ int HAMLIB_API rig_get_rptr_shift(RIG *rig, vfo_t vfo, rptr_shift_t *rptr_shift)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -2224,7 +2386,7 @@ int HAMLIB_API rig_get_rptr_shift(RIG *rig, vfo_t vfo, rptr_shift_t *rptr_shift)
 
     retcode = caps->get_rptr_shift(rig, vfo, rptr_shift);
     /* try and revert even if we had an error above */
-    rc2 = caps->set_vfo(rig, curr_vfo);
+    rc2 = rig_vfo_ctx_release(rig);
 
     if (RIG_OK == retcode)
     {
@@ -2254,7 +2416,6 @@ int HAMLIB_API rig_set_rptr_offs(RIG *rig, vfo_t vfo, shortfreq_t rptr_offs)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -2263,6 +2424,13 @@ int HAMLIB_API rig_set_rptr_offs(RIG *rig, vfo_t vfo, shortfreq_t rptr_offs)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_rptr_offs == NULL)
@@ -2282,8 +2450,7 @@ int HAMLIB_API rig_set_rptr_offs(RIG *rig, vfo_t vfo, shortfreq_t rptr_offs)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -2292,7 +2459,7 @@ int HAMLIB_API rig_set_rptr_offs(RIG *rig, vfo_t vfo, shortfreq_t rptr_offs)
 
     retcode = caps->set_rptr_offs(rig, vfo, rptr_offs);
     /* try and revert even if we had an error above */
-    rc2 = caps->set_vfo(rig, curr_vfo);
+    rc2 = rig_vfo_ctx_release(rig);
 
     if (RIG_OK == retcode)
     {
@@ -2322,7 +2489,6 @@ int HAMLIB_API rig_get_rptr_offs(RIG *rig, vfo_t vfo, shortfreq_t *rptr_offs)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -2331,6 +2497,13 @@ int HAMLIB_API rig_get_rptr_offs(RIG *rig, vfo_t vfo, shortfreq_t *rptr_offs)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_rptr_offs == NULL)
@@ -2350,8 +2523,7 @@ int HAMLIB_API rig_get_rptr_offs(RIG *rig, vfo_t vfo, shortfreq_t *rptr_offs)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -2360,7 +2532,7 @@ int HAMLIB_API rig_get_rptr_offs(RIG *rig, vfo_t vfo, shortfreq_t *rptr_offs)
 
     retcode = caps->get_rptr_offs(rig, vfo, rptr_offs);
     /* try and revert even if we had an error above */
-    rc2 = caps->set_vfo(rig, curr_vfo);
+    rc2 = rig_vfo_ctx_release(rig);
 
     if (RIG_OK == retcode)
     {
@@ -2387,10 +2559,21 @@ int HAMLIB_API rig_get_rptr_offs(RIG *rig, vfo_t vfo, shortfreq_t *rptr_offs)
  * \sa rig_get_split_freq(), rig_set_split_vfo()
  */
 int HAMLIB_API rig_set_split_freq(RIG *rig, vfo_t vfo, freq_t tx_freq)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_SPLIT_FREQ,
+                         do_rig_set_split_freq(rig, vfo, tx_freq));
+}
+
+
+static int do_rig_set_split_freq(RIG *rig, vfo_t vfo, freq_t tx_freq)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo, tx_vfo;
+    vfo_t tx_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -2399,6 +2582,15 @@ int HAMLIB_API rig_set_split_freq(RIG *rig, vfo_t vfo, freq_t tx_freq)
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_FREQ);
+
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_split_freq
@@ -2411,8 +2603,6 @@ int HAMLIB_API rig_set_split_freq(RIG *rig, vfo_t vfo, freq_t tx_freq)
     }
 
     /* Assisted mode */
-    curr_vfo = rig->state.current_vfo;
-
     /* Use previously setup TxVFO */
     if (vfo == RIG_VFO_CURR || vfo == RIG_VFO_TX)
     {
@@ -2431,7 +2621,7 @@ int HAMLIB_API rig_set_split_freq(RIG *rig, vfo_t vfo, freq_t tx_freq)
 
     if (caps->set_vfo)
     {
-        retcode = caps->set_vfo(rig, tx_vfo);
+        retcode = rig_vfo_ctx_select(rig, tx_vfo);
     }
     else if (rig_has_vfo_op(rig, RIG_OP_TOGGLE) && caps->vfo_op)
     {
@@ -2459,7 +2649,7 @@ int HAMLIB_API rig_set_split_freq(RIG *rig, vfo_t vfo, freq_t tx_freq)
     /* try and revert even if we had an error above */
     if (caps->set_vfo)
     {
-        rc2 = caps->set_vfo(rig, curr_vfo);
+        rc2 = rig_vfo_ctx_release(rig);
     }
     else
     {
@@ -2491,10 +2681,21 @@ int HAMLIB_API rig_set_split_freq(RIG *rig, vfo_t vfo, freq_t tx_freq)
  * \sa rig_set_split_freq()
  */
 int HAMLIB_API rig_get_split_freq(RIG *rig, vfo_t vfo, freq_t *tx_freq)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_SPLIT_FREQ,
+                         do_rig_get_split_freq(rig, vfo, tx_freq));
+}
+
+
+static int do_rig_get_split_freq(RIG *rig, vfo_t vfo, freq_t *tx_freq)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo, tx_vfo;
+    vfo_t tx_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -2503,6 +2704,13 @@ int HAMLIB_API rig_get_split_freq(RIG *rig, vfo_t vfo, freq_t *tx_freq)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_split_freq
@@ -2515,8 +2723,6 @@ int HAMLIB_API rig_get_split_freq(RIG *rig, vfo_t vfo, freq_t *tx_freq)
     }
 
     /* Assisted mode */
-    curr_vfo = rig->state.current_vfo;
-
     /* Use previously setup TxVFO */
     if (vfo == RIG_VFO_CURR || vfo == RIG_VFO_TX)
     {
@@ -2535,7 +2741,7 @@ int HAMLIB_API rig_get_split_freq(RIG *rig, vfo_t vfo, freq_t *tx_freq)
 
     if (caps->set_vfo)
     {
-        retcode = caps->set_vfo(rig, tx_vfo);
+        retcode = rig_vfo_ctx_select(rig, tx_vfo);
     }
     else if (rig_has_vfo_op(rig, RIG_OP_TOGGLE) && caps->vfo_op)
     {
@@ -2563,7 +2769,7 @@ int HAMLIB_API rig_get_split_freq(RIG *rig, vfo_t vfo, freq_t *tx_freq)
     /* try and revert even if we had an error above */
     if (caps->set_vfo)
     {
-        rc2 = caps->set_vfo(rig, curr_vfo);
+        rc2 = rig_vfo_ctx_release(rig);
     }
     else
     {
@@ -2602,10 +2808,24 @@ int HAMLIB_API rig_set_split_mode(RIG *rig,
                                   vfo_t vfo,
                                   rmode_t tx_mode,
                                   pbwidth_t tx_width)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_SPLIT_MODE,
+                         do_rig_set_split_mode(rig, vfo, tx_mode, tx_width));
+}
+
+
+static int do_rig_set_split_mode(RIG *rig,
+                                 vfo_t vfo,
+                                 rmode_t tx_mode,
+                                 pbwidth_t tx_width)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo, tx_vfo;
+    vfo_t tx_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -2614,6 +2834,15 @@ int HAMLIB_API rig_set_split_mode(RIG *rig,
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_MODE);
+
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_split_mode
@@ -2626,8 +2855,6 @@ int HAMLIB_API rig_set_split_mode(RIG *rig,
     }
 
     /* Assisted mode */
-    curr_vfo = rig->state.current_vfo;
-
     /* Use previously setup TxVFO */
     if (vfo == RIG_VFO_CURR || vfo == RIG_VFO_TX)
     {
@@ -2646,7 +2873,7 @@ int HAMLIB_API rig_set_split_mode(RIG *rig,
 
     if (caps->set_vfo)
     {
-        retcode = caps->set_vfo(rig, tx_vfo);
+        retcode = rig_vfo_ctx_select(rig, tx_vfo);
     }
     else if (rig_has_vfo_op(rig, RIG_OP_TOGGLE) && caps->vfo_op)
     {
@@ -2674,7 +2901,7 @@ int HAMLIB_API rig_set_split_mode(RIG *rig,
     /* try and revert even if we had an error above */
     if (caps->set_vfo)
     {
-        rc2 = caps->set_vfo(rig, curr_vfo);
+        rc2 = rig_vfo_ctx_release(rig);
     }
     else
     {
@@ -2712,10 +2939,22 @@ int HAMLIB_API rig_set_split_mode(RIG *rig,
  */
 int HAMLIB_API rig_get_split_mode(RIG *rig, vfo_t vfo, rmode_t *tx_mode,
                                   pbwidth_t *tx_width)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_SPLIT_MODE,
+                         do_rig_get_split_mode(rig, vfo, tx_mode, tx_width));
+}
+
+
+static int do_rig_get_split_mode(RIG *rig, vfo_t vfo, rmode_t *tx_mode,
+                                 pbwidth_t *tx_width)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo, tx_vfo;
+    vfo_t tx_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -2724,6 +2963,13 @@ int HAMLIB_API rig_get_split_mode(RIG *rig, vfo_t vfo, rmode_t *tx_mode,
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_split_mode
@@ -2736,8 +2982,6 @@ int HAMLIB_API rig_get_split_mode(RIG *rig, vfo_t vfo, rmode_t *tx_mode,
     }
 
     /* Assisted mode */
-    curr_vfo = rig->state.current_vfo;
-
     /* Use previously setup TxVFO */
     if (vfo == RIG_VFO_CURR || vfo == RIG_VFO_TX)
     {
@@ -2756,7 +3000,7 @@ int HAMLIB_API rig_get_split_mode(RIG *rig, vfo_t vfo, rmode_t *tx_mode,
 
     if (caps->set_vfo)
     {
-        retcode = caps->set_vfo(rig, tx_vfo);
+        retcode = rig_vfo_ctx_select(rig, tx_vfo);
     }
     else if (rig_has_vfo_op(rig, RIG_OP_TOGGLE) && caps->vfo_op)
     {
@@ -2784,7 +3028,7 @@ int HAMLIB_API rig_get_split_mode(RIG *rig, vfo_t vfo, rmode_t *tx_mode,
     /* try and revert even if we had an error above */
     if (caps->set_vfo)
     {
-        rc2 = caps->set_vfo(rig, curr_vfo);
+        rc2 = rig_vfo_ctx_release(rig);
     }
     else
     {
@@ -2846,6 +3090,15 @@ int HAMLIB_API rig_set_split_freq_mode(RIG *rig,
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_FREQ | RIG_CACHE_MODE);
+
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_split_freq_mode)
@@ -2905,6 +3158,13 @@ int HAMLIB_API rig_get_split_freq_mode(RIG *rig,
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_split_freq_mode)
@@ -2942,6 +3202,20 @@ int HAMLIB_API rig_set_split_vfo(RIG *rig,
                                  vfo_t vfo,
                                  split_t split,
                                  vfo_t tx_vfo)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_SPLIT_VFO,
+                         do_rig_set_split_vfo(rig, vfo, split, tx_vfo));
+}
+
+
+static int do_rig_set_split_vfo(RIG *rig,
+                                vfo_t vfo,
+                                split_t split,
+                                vfo_t tx_vfo)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
@@ -2954,6 +3228,15 @@ int HAMLIB_API rig_set_split_vfo(RIG *rig,
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_SPLIT | RIG_CACHE_VFO);
+
+    retcode = rig_vfo_ctx_restore(rig);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_split_vfo == NULL)
@@ -3027,10 +3310,23 @@ int HAMLIB_API rig_get_split_vfo(RIG *rig,
                                  vfo_t vfo,
                                  split_t *split,
                                  vfo_t *tx_vfo)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_SPLIT_VFO,
+                         do_rig_get_split_vfo(rig, vfo, split, tx_vfo));
+}
+
+
+static int do_rig_get_split_vfo(RIG *rig,
+                                vfo_t vfo,
+                                split_t *split,
+                                vfo_t *tx_vfo)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -3039,6 +3335,13 @@ int HAMLIB_API rig_get_split_vfo(RIG *rig,
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_split_vfo == NULL)
@@ -3046,6 +3349,11 @@ int HAMLIB_API rig_get_split_vfo(RIG *rig,
         return -RIG_ENAVAIL;
     }
 
+    if (rig_cache_get_split(rig, vfo, split, tx_vfo) == RIG_OK)
+    {
+        return RIG_OK;
+    }
+
     /* overidden by backend at will */
     *tx_vfo = rig->state.tx_vfo;
 
@@ -3053,7 +3361,14 @@ int HAMLIB_API rig_get_split_vfo(RIG *rig,
             || vfo == RIG_VFO_CURR
             || vfo == rig->state.current_vfo)
     {
-        return caps->get_split_vfo(rig, vfo, split, tx_vfo);
+        retcode = caps->get_split_vfo(rig, vfo, split, tx_vfo);
+
+        if (retcode == RIG_OK)
+        {
+            rig_cache_set_split(rig, vfo, *split, *tx_vfo);
+        }
+
+        return retcode;
     }
 
     if (!caps->set_vfo)
@@ -3061,8 +3376,7 @@ int HAMLIB_API rig_get_split_vfo(RIG *rig,
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -3071,10 +3385,11 @@ int HAMLIB_API rig_get_split_vfo(RIG *rig,
 
     retcode = caps->get_split_vfo(rig, vfo, split, tx_vfo);
     /* try and revert even if we had an error above */
-    rc2 = caps->set_vfo(rig, curr_vfo);
+    rc2 = rig_vfo_ctx_release(rig);
 
     if (RIG_OK == retcode)
     {
+        rig_cache_set_split(rig, vfo, *split, *tx_vfo);
         /* return the first error code */
         retcode = rc2;
     }
@@ -3098,10 +3413,20 @@ int HAMLIB_API rig_get_split_vfo(RIG *rig,
  * \sa rig_get_rit()
  */
 int HAMLIB_API rig_set_rit(RIG *rig, vfo_t vfo, shortfreq_t rit)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_RIT,
+                         do_rig_set_rit(rig, vfo, rit));
+}
+
+
+static int do_rig_set_rit(RIG *rig, vfo_t vfo, shortfreq_t rit)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -3110,6 +3435,13 @@ int HAMLIB_API rig_set_rit(RIG *rig, vfo_t vfo, shortfreq_t rit)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_rit == NULL)
@@ -3129,8 +3461,7 @@ int HAMLIB_API rig_set_rit(RIG *rig, vfo_t vfo, shortfreq_t rit)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -3139,7 +3470,7 @@ int HAMLIB_API rig_set_rit(RIG *rig, vfo_t vfo, shortfreq_t rit)
 
     retcode = caps->set_rit(rig, vfo, rit);
     /* try and revert even if we had an error above */
-    rc2 = caps->set_vfo(rig, curr_vfo);
+    rc2 = rig_vfo_ctx_release(rig);
 
     if (RIG_OK == retcode)
     {
@@ -3166,10 +3497,20 @@ int HAMLIB_API rig_set_rit(RIG *rig, vfo_t vfo, shortfreq_t rit)
  * \sa rig_set_rit()
  */
 int HAMLIB_API rig_get_rit(RIG *rig, vfo_t vfo, shortfreq_t *rit)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_RIT,
+                         do_rig_get_rit(rig, vfo, rit));
+}
+
+
+static int do_rig_get_rit(RIG *rig, vfo_t vfo, shortfreq_t *rit)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -3178,6 +3519,13 @@ int HAMLIB_API rig_get_rit(RIG *rig, vfo_t vfo, shortfreq_t *rit)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_rit == NULL)
@@ -3197,8 +3545,7 @@ int HAMLIB_API rig_get_rit(RIG *rig, vfo_t vfo, shortfreq_t *rit)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -3207,7 +3554,7 @@ int HAMLIB_API rig_get_rit(RIG *rig, vfo_t vfo, shortfreq_t *rit)
 
     retcode = caps->get_rit(rig, vfo, rit);
     /* try and revert even if we had an error above */
-    rc2 = caps->set_vfo(rig, curr_vfo);
+    rc2 = rig_vfo_ctx_release(rig);
 
     if (RIG_OK == retcode)
     {
@@ -3234,10 +3581,20 @@ int HAMLIB_API rig_get_rit(RIG *rig, vfo_t vfo, shortfreq_t *rit)
  * \sa rig_get_xit()
  */
 int HAMLIB_API rig_set_xit(RIG *rig, vfo_t vfo, shortfreq_t xit)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_XIT,
+                         do_rig_set_xit(rig, vfo, xit));
+}
+
+
+static int do_rig_set_xit(RIG *rig, vfo_t vfo, shortfreq_t xit)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -3246,6 +3603,13 @@ int HAMLIB_API rig_set_xit(RIG *rig, vfo_t vfo, shortfreq_t xit)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_xit == NULL)
@@ -3265,8 +3629,7 @@ int HAMLIB_API rig_set_xit(RIG *rig, vfo_t vfo, shortfreq_t xit)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -3275,7 +3638,7 @@ int HAMLIB_API rig_set_xit(RIG *rig, vfo_t vfo, shortfreq_t xit)
 
     retcode = caps->set_xit(rig, vfo, xit);
     /* try and revert even if we had an error above */
-    rc2 = caps->set_vfo(rig, curr_vfo);
+    rc2 = rig_vfo_ctx_release(rig);
 
     if (RIG_OK == retcode)
     {
@@ -3302,10 +3665,20 @@ int HAMLIB_API rig_set_xit(RIG *rig, vfo_t vfo, shortfreq_t xit)
  * \sa rig_set_xit()
  */
 int HAMLIB_API rig_get_xit(RIG *rig, vfo_t vfo, shortfreq_t *xit)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_XIT,
+                         do_rig_get_xit(rig, vfo, xit));
+}
+
+
+static int do_rig_get_xit(RIG *rig, vfo_t vfo, shortfreq_t *xit)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -3314,6 +3687,13 @@ int HAMLIB_API rig_get_xit(RIG *rig, vfo_t vfo, shortfreq_t *xit)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_xit == NULL)
@@ -3333,8 +3713,7 @@ int HAMLIB_API rig_get_xit(RIG *rig, vfo_t vfo, shortfreq_t *xit)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -3343,7 +3722,7 @@ int HAMLIB_API rig_get_xit(RIG *rig, vfo_t vfo, shortfreq_t *xit)
 
     retcode = caps->get_xit(rig, vfo, xit);
     /* try and revert even if we had an error above */
-    rc2 = caps->set_vfo(rig, curr_vfo);
+    rc2 = rig_vfo_ctx_release(rig);
 
     if (RIG_OK == retcode)
     {
@@ -3370,10 +3749,20 @@ int HAMLIB_API rig_get_xit(RIG *rig, vfo_t vfo, shortfreq_t *xit)
  * \sa rig_get_ts()
  */
 int HAMLIB_API rig_set_ts(RIG *rig, vfo_t vfo, shortfreq_t ts)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_TS,
+                         do_rig_set_ts(rig, vfo, ts));
+}
+
+
+static int do_rig_set_ts(RIG *rig, vfo_t vfo, shortfreq_t ts)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -3382,6 +3771,13 @@ int HAMLIB_API rig_set_ts(RIG *rig, vfo_t vfo, shortfreq_t ts)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_ts == NULL)
@@ -3401,8 +3797,7 @@ int HAMLIB_API rig_set_ts(RIG *rig, vfo_t vfo, shortfreq_t ts)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -3411,7 +3806,7 @@ int HAMLIB_API rig_set_ts(RIG *rig, vfo_t vfo, shortfreq_t ts)
 
     retcode = caps->set_ts(rig, vfo, ts);
     /* try and revert even if we had an error above */
-    rc2 = caps->set_vfo(rig, curr_vfo);
+    rc2 = rig_vfo_ctx_release(rig);
 
     if (RIG_OK == retcode)
     {
@@ -3438,10 +3833,20 @@ int HAMLIB_API rig_set_ts(RIG *rig, vfo_t vfo, shortfreq_t ts)
  * \sa rig_set_ts()
  */
 int HAMLIB_API rig_get_ts(RIG *rig, vfo_t vfo, shortfreq_t *ts)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_TS,
+                         do_rig_get_ts(rig, vfo, ts));
+}
+
+
+static int do_rig_get_ts(RIG *rig, vfo_t vfo, shortfreq_t *ts)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -3450,6 +3855,13 @@ int HAMLIB_API rig_get_ts(RIG *rig, vfo_t vfo, shortfreq_t *ts)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_ts == NULL)
@@ -3469,8 +3881,7 @@ int HAMLIB_API rig_get_ts(RIG *rig, vfo_t vfo, shortfreq_t *ts)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -3479,7 +3890,7 @@ int HAMLIB_API rig_get_ts(RIG *rig, vfo_t vfo, shortfreq_t *ts)
 
     retcode = caps->get_ts(rig, vfo, ts);
     /* try and revert even if we had an error above */
-    rc2 = caps->set_vfo(rig, curr_vfo);
+    rc2 = rig_vfo_ctx_release(rig);
 
     if (RIG_OK == retcode)
     {
@@ -3510,10 +3921,20 @@ int HAMLIB_API rig_get_ts(RIG *rig, vfo_t vfo, shortfreq_t *ts)
  * \sa rig_get_ant()
  */
 int HAMLIB_API rig_set_ant(RIG *rig, vfo_t vfo, ant_t ant)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_ANT,
+                         do_rig_set_ant(rig, vfo, ant));
+}
+
+
+static int do_rig_set_ant(RIG *rig, vfo_t vfo, ant_t ant)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -3522,6 +3943,13 @@ int HAMLIB_API rig_set_ant(RIG *rig, vfo_t vfo, ant_t ant)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_ant == NULL)
@@ -3541,8 +3969,7 @@ int HAMLIB_API rig_set_ant(RIG *rig, vfo_t vfo, ant_t ant)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -3551,7 +3978,7 @@ int HAMLIB_API rig_set_ant(RIG *rig, vfo_t vfo, ant_t ant)
 
     retcode = caps->set_ant(rig, vfo, ant);
     /* try and revert even if we had an error above */
-    rc2 = caps->set_vfo(rig, curr_vfo);
+    rc2 = rig_vfo_ctx_release(rig);
 
     if (RIG_OK == retcode)
     {
@@ -3578,10 +4005,20 @@ int HAMLIB_API rig_set_ant(RIG *rig, vfo_t vfo, ant_t ant)
  * \sa rig_set_ant()
  */
 int HAMLIB_API rig_get_ant(RIG *rig, vfo_t vfo, ant_t *ant)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_ANT,
+                         do_rig_get_ant(rig, vfo, ant));
+}
+
+
+static int do_rig_get_ant(RIG *rig, vfo_t vfo, ant_t *ant)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -3590,6 +4027,13 @@ int HAMLIB_API rig_get_ant(RIG *rig, vfo_t vfo, ant_t *ant)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_ant == NULL)
@@ -3609,8 +4053,7 @@ int HAMLIB_API rig_get_ant(RIG *rig, vfo_t vfo, ant_t *ant)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -3619,7 +4062,7 @@ int HAMLIB_API rig_get_ant(RIG *rig, vfo_t vfo, ant_t *ant)
 
     retcode = caps->get_ant(rig, vfo, ant);
     /* try and revert even if we had an error above */
-    rc2 = caps->set_vfo(rig, curr_vfo);
+    rc2 = rig_vfo_ctx_release(rig);
 
     if (RIG_OK == retcode)
     {
@@ -3807,6 +4250,17 @@ shortfreq_t HAMLIB_API rig_get_resolution(RIG *rig, rmode_t mode)
  * \sa rig_get_powerstat()
  */
 int HAMLIB_API rig_set_powerstat(RIG *rig, powerstat_t status)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_POWERSTAT,
+                         do_rig_set_powerstat(rig, status));
+}
+
+
+static int do_rig_set_powerstat(RIG *rig, powerstat_t status)
 {
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -3815,11 +4269,16 @@ int HAMLIB_API rig_set_powerstat(RIG *rig, powerstat_t status)
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_ALL);
+
     if (rig->caps->set_powerstat == NULL)
     {
         return -RIG_ENAVAIL;
     }
 
+    /* best effort, power up on the VFO the application knows about */
+    rig_vfo_ctx_restore(rig);
+
     return rig->caps->set_powerstat(rig, status);
 }
 
@@ -3839,6 +4298,17 @@ int HAMLIB_API rig_set_powerstat(RIG *rig, powerstat_t status)
  * \sa rig_set_powerstat()
  */
 int HAMLIB_API rig_get_powerstat(RIG *rig, powerstat_t *status)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_POWERSTAT,
+                         do_rig_get_powerstat(rig, status));
+}
+
+
+static int do_rig_get_powerstat(RIG *rig, powerstat_t *status)
 {
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -3879,11 +4349,16 @@ int HAMLIB_API rig_reset(RIG *rig, reset_t reset)
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_ALL);
+
     if (rig->caps->reset == NULL)
     {
         return -RIG_ENAVAIL;
     }
 
+    /* whatever VFO was left, the reset decides which one is current */
+    rig->state.restore_vfo = RIG_VFO_NONE;
+
     return rig->caps->reset(rig, reset);
 }
 
@@ -3999,6 +4474,17 @@ vfo_op_t HAMLIB_API rig_has_vfo_op(RIG *rig, vfo_op_t op)
  * \sa rig_has_vfo_op()
  */
 int HAMLIB_API rig_vfo_op(RIG *rig, vfo_t vfo, vfo_op_t op)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_VFO_OP,
+                         do_rig_vfo_op(rig, vfo, op));
+}
+
+
+static int do_rig_vfo_op(RIG *rig, vfo_t vfo, vfo_op_t op)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
@@ -4011,6 +4497,15 @@ int HAMLIB_API rig_vfo_op(RIG *rig, vfo_t vfo, vfo_op_t op)
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_ALL);
+
+    retcode = rig_vfo_ctx_restore(rig);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->vfo_op == NULL || !rig_has_vfo_op(rig, op))
@@ -4098,6 +4593,17 @@ scan_t HAMLIB_API rig_has_scan(RIG *rig, scan_t scan)
  * \sa rig_has_scan()
  */
 int HAMLIB_API rig_scan(RIG *rig, vfo_t vfo, scan_t scan, int ch)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SCAN,
+                         do_rig_scan(rig, vfo, scan, ch));
+}
+
+
+static int do_rig_scan(RIG *rig, vfo_t vfo, scan_t scan, int ch)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
@@ -4110,6 +4616,15 @@ int HAMLIB_API rig_scan(RIG *rig, vfo_t vfo, scan_t scan, int ch)
         return -RIG_EINVAL;
     }
 
+    rig_cache_invalidate(rig, RIG_CACHE_ALL);
+
+    retcode = rig_vfo_ctx_restore(rig);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->scan == NULL
@@ -4179,6 +4694,13 @@ int HAMLIB_API rig_send_dtmf(RIG *rig, vfo_t vfo, const char *digits)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_restore(rig);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->send_dtmf == NULL)
@@ -4248,6 +4770,13 @@ int HAMLIB_API rig_recv_dtmf(RIG *rig, vfo_t vfo, char *digits, int *length)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_restore(rig);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->recv_dtmf == NULL)
@@ -4304,6 +4833,17 @@ int HAMLIB_API rig_recv_dtmf(RIG *rig, vfo_t vfo, char *digits, int *length)
  *
  */
 int HAMLIB_API rig_send_morse(RIG *rig, vfo_t vfo, const char *msg)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SEND_MORSE,
+                         do_rig_send_morse(rig, vfo, msg));
+}
+
+
+static int do_rig_send_morse(RIG *rig, vfo_t vfo, const char *msg)
 {
     const struct rig_caps *caps;
     int retcode, rc2;
@@ -4316,6 +4856,13 @@ int HAMLIB_API rig_send_morse(RIG *rig, vfo_t vfo, const char *msg)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_restore(rig);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->send_morse == NULL)
@@ -4425,6 +4972,304 @@ const char *HAMLIB_API rig_get_info(RIG *rig)
 }
 
 
+/*
+ * Serve a rig_get_multi() entry from the frontend cache.
+ * Returns 1 if done, 0 if it has to be read.
+ */
+static int multi_cached(RIG *rig, struct rig_multi *r)
+{
+    switch (r->what)
+    {
+    case RIG_MULTI_FREQ:
+        return rig_cache_get_freq(rig, r->vfo, &r->val.freq) == RIG_OK;
+
+    case RIG_MULTI_MODE:
+        return rig_cache_get_mode(rig, r->vfo, &r->val.mode.mode,
+                                  &r->val.mode.width) == RIG_OK;
+
+    case RIG_MULTI_VFO:
+        return rig_cache_get_vfo(rig, &r->val.vfo) == RIG_OK;
+
+    case RIG_MULTI_PTT:
+        return rig_cache_get_ptt(rig, r->vfo, &r->val.ptt) == RIG_OK;
+
+    default:
+        return 0;
+    }
+}
+
+
+/*
+ * Whether caps->get_multi() may read the entry: it must not need a VFO
+ * switch nor any of the frontend emulations of rig_get_*().
+ */
+static int multi_direct(RIG *rig, const struct rig_multi *r)
+{
+    const struct rig_caps *caps = rig->caps;
+    int curr = r->vfo == RIG_VFO_CURR || r->vfo == rig->state.current_vfo;
+
+    switch (r->what)
+    {
+    case RIG_MULTI_FREQ:
+        return caps->get_freq
+               && (curr || (caps->targetable_vfo & RIG_TARGETABLE_FREQ));
+
+    case RIG_MULTI_MODE:
+        return caps->get_mode
+               && (curr || (caps->targetable_vfo & RIG_TARGETABLE_MODE));
+
+    case RIG_MULTI_VFO:
+        return caps->get_vfo != NULL;
+
+    case RIG_MULTI_PTT:
+        return caps->get_ptt
+               && (rig->state.pttport.type.ptt == RIG_PTT_RIG
+                   || rig->state.pttport.type.ptt == RIG_PTT_RIG_MICDATA)
+               && (curr || (caps->targetable_vfo & RIG_TARGETABLE_PURE));
+
+    case RIG_MULTI_LEVEL:
+        /* not the calibrated S-meter emulation */
+        if (r->level == RIG_LEVEL_STRENGTH
+                && (caps->has_get_level & RIG_LEVEL_STRENGTH) == 0
+                && rig->state.str_cal.size)
+        {
+            return 0;
+        }
+
+        return caps->get_level
+               && rig_has_get_level(rig, r->level)
+               && (curr || (caps->targetable_vfo & RIG_TARGETABLE_PURE));
+
+    default:
+        return 0;
+    }
+}
+
+
+/* the bookkeeping rig_get_*() do after the backend call */
+static void multi_finish(RIG *rig, struct rig_multi *r)
+{
+    struct rig_state *rs = &rig->state;
+    int curr = r->vfo == RIG_VFO_CURR || r->vfo == rs->current_vfo;
+
+    if (r->status != RIG_OK)
+    {
+        return;
+    }
+
+    switch (r->what)
+    {
+    case RIG_MULTI_FREQ:
+        if (rs->vfo_comp != 0.0)
+        {
+            r->val.freq = (freq_t)(r->val.freq / (1.0 + (double)rs->vfo_comp));
+        }
+
+        if (curr)
+        {
+            rs->current_freq = r->val.freq;
+        }
+
+        if (rs->lo_freq != 0.0)
+        {
+            r->val.freq += rs->lo_freq;
+        }
+
+        rig_cache_set_freq(rig, r->vfo, r->val.freq);
+        break;
+
+    case RIG_MULTI_MODE:
+        if (curr)
+        {
+            rs->current_mode = r->val.mode.mode;
+            rs->current_width = r->val.mode.width;
+        }
+
+        if (r->val.mode.width == RIG_PASSBAND_NORMAL
+                && r->val.mode.mode != RIG_MODE_NONE)
+        {
+            r->val.mode.width = rig_passband_normal(rig, r->val.mode.mode);
+        }
+
+        rig_cache_set_mode(rig, r->vfo, r->val.mode.mode, r->val.mode.width);
+        break;
+
+    case RIG_MULTI_VFO:
+        rs->current_vfo = r->val.vfo;
+        rig_cache_set_vfo(rig, r->val.vfo);
+        break;
+
+    case RIG_MULTI_PTT:
+        rig_cache_set_ptt(rig, r->vfo, r->val.ptt);
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+/*
+ * Hand the entries caps->get_multi() can read as is to the backend,
+ * in one call, and flag them in done[]. The rest is left to the
+ * rig_get_*() calls, after the batch since they may switch VFO.
+ */
+static int multi_batch(RIG *rig, struct rig_multi *req, int count,
+                       int *done)
+{
+    struct rig_multi *batch;
+    int *idx;
+    int i, n = 0;
+    int retcode = RIG_OK;
+
+    batch = malloc(count * sizeof(struct rig_multi));
+    idx = malloc(count * sizeof(int));
+
+    if (!batch || !idx)
+    {
+        free(batch);
+        free(idx);
+        return -RIG_ENOMEM;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (multi_cached(rig, &req[i]))
+        {
+            req[i].status = RIG_OK;
+            done[i] = 1;
+        }
+        else if (multi_direct(rig, &req[i]))
+        {
+            batch[n] = req[i];
+            idx[n++] = i;
+        }
+    }
+
+    if (n > 0)
+    {
+        retcode = rig->caps->get_multi(rig, batch, n);
+    }
+
+    for (i = 0; retcode == RIG_OK && i < n; i++)
+    {
+        multi_finish(rig, &batch[i]);
+        req[idx[i]] = batch[i];
+        done[idx[i]] = 1;
+    }
+
+    free(batch);
+    free(idx);
+
+    return retcode;
+}
+
+
+/**
+ * \brief read several values from the radio in one go
+ * \param rig   The rig handle
+ * \param req   The array of reads to do
+ * \param count The number of entries in \a req
+ *
+ * Reads frequency, mode, VFO, PTT and level values as described by
+ * \a req. Backends that can batch requests, like netrigctl which
+ * pipelines them to rigctld, get at once the reads that need neither
+ * a VFO switch nor a frontend emulation; the others are done one after
+ * the other through the usual rig_get_* calls. Either way the values
+ * come back as rig_get_*() would return them, and go through the
+ * frontend cache.
+ *
+ * The status of each read is stored in req[i].status, a failed read
+ * does not stop the next ones.
+ *
+ * \return RIG_OK if the batch could be run, in which case the outcome
+ * of each read is in its status, otherwise a negative value if an
+ * error occured (the status fields are then undefined).
+ *
+ * \sa rig_get_freq(), rig_get_mode(), rig_get_vfo(), rig_get_ptt(),
+ * rig_get_level()
+ */
+int HAMLIB_API rig_get_multi(RIG *rig, struct rig_multi *req, int count)
+{
+    int i;
+    int *done = NULL;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (CHECK_RIG_ARG(rig) || !req || count < 0)
+    {
+        return -RIG_EINVAL;
+    }
+
+    if (rig->caps->get_multi && count > 0)
+    {
+        int retcode = rig_vfo_ctx_restore(rig);
+
+        if (retcode != RIG_OK)
+        {
+            return retcode;
+        }
+
+        done = calloc(count, sizeof(int));
+
+        if (!done)
+        {
+            return -RIG_ENOMEM;
+        }
+
+        retcode = multi_batch(rig, req, count, done);
+
+        if (retcode != RIG_OK)
+        {
+            free(done);
+            return retcode;
+        }
+    }
+
+    /* what the backend could not read as is */
+    for (i = 0; i < count; i++)
+    {
+        struct rig_multi *r = &req[i];
+
+        if (done && done[i])
+        {
+            continue;
+        }
+
+        switch (r->what)
+        {
+        case RIG_MULTI_FREQ:
+            r->status = rig_get_freq(rig, r->vfo, &r->val.freq);
+            break;
+
+        case RIG_MULTI_MODE:
+            r->status = rig_get_mode(rig, r->vfo, &r->val.mode.mode,
+                                     &r->val.mode.width);
+            break;
+
+        case RIG_MULTI_VFO:
+            r->status = rig_get_vfo(rig, &r->val.vfo);
+            break;
+
+        case RIG_MULTI_PTT:
+            r->status = rig_get_ptt(rig, r->vfo, &r->val.ptt);
+            break;
+
+        case RIG_MULTI_LEVEL:
+            r->status = rig_get_level(rig, r->vfo, r->level, &r->val.level);
+            break;
+
+        default:
+            r->status = -RIG_EINVAL;
+        }
+    }
+
+    free(done);
+
+    return RIG_OK;
+}
+
+
 const char *HAMLIB_API rig_license()
 {
     return hamlib_license;
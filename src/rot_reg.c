@@ -41,6 +41,7 @@
 #include <hamlib/rotator.h>
 
 #include "register.h"
+#include "registry.h"
 
 #ifndef PATH_MAX
 # define PATH_MAX       1024
@@ -100,6 +101,7 @@ static struct
     const char *be_name;
     int (*be_init)(void *);
     rot_model_t (*be_probe)(hamlib_port_t *);
+    int be_loaded;
 } rot_backend_list[ROT_BACKEND_MAX] =
 {
     { ROT_DUMMY, ROT_BACKEND_DUMMY, ROT_FUNCNAMA(dummy) },
@@ -134,38 +136,16 @@ static struct
 
 
 /*
- * This struct to keep track of known rot models.
- * It is chained, and used in a hash table, see below.
+ * The known rot models, see registry.h
  */
-struct rot_list
-{
-    const struct rot_caps *caps;
-    struct rot_list *next;
-};
-
-
-#define ROTLSTHASHSZ 16
-#define HASH_FUNC(a) ((a)%ROTLSTHASHSZ)
+static struct registry rot_registry = REGISTRY_INITIALIZER;
 
 
 /*
- * The rot_hash_table is a hash table pointing to a list of next==NULL
- *  terminated caps.
- */
-static struct rot_list *rot_hash_table[ROTLSTHASHSZ] = { NULL, };
-
-
-static int rot_lookup_backend(rot_model_t rot_model);
-
-
-/*
- * Basically, this is a hash insert function that doesn't check for dup!
+ * Adds caps to the registry, refusing a model that is already there.
  */
 int HAMLIB_API rot_register(const struct rot_caps *caps)
 {
-    int hval;
-    struct rot_list *p;
-
     if (!caps)
     {
         return -RIG_EINVAL;
@@ -173,49 +153,45 @@ int HAMLIB_API rot_register(const struct rot_caps *caps)
 
     rot_debug(RIG_DEBUG_VERBOSE, "rot_register (%d)\n", caps->rot_model);
 
-#ifndef DONT_WANT_DUP_CHECK
-
-    if (rot_get_caps(caps->rot_model) != NULL)
-    {
-        return -RIG_EINVAL;
-    }
-
-#endif
-
-    p = (struct rot_list *)malloc(sizeof(struct rot_list));
-
-    if (!p)
-    {
-        return -RIG_ENOMEM;
-    }
-
-    hval = HASH_FUNC(caps->rot_model);
-    p->caps = caps;
-    // p->handle = NULL;
-    p->next = rot_hash_table[hval];
-    rot_hash_table[hval] = p;
-
-    return RIG_OK;
+    return registry_add(&rot_registry, caps->rot_model, caps->mfg_name,
+                        caps->model_name, caps);
 }
 
 
 /*
  * Get rot capabilities.
- * i.e. rot_hash_table lookup
+ * i.e. rot_registry lookup
  */
 const struct rot_caps *HAMLIB_API rot_get_caps(rot_model_t rot_model)
 {
-    struct rot_list *p;
+    return registry_get(&rot_registry, rot_model);
+}
+
+
+/**
+ * \brief look a rotator model up by name
+ * \param mfg_name   The manufacturer name
+ * \param model_name The model name
+ *
+ * The names are matched without regard to case. Backends that have not
+ * been loaded yet are loaded on the first miss.
+ *
+ * \return the model number, or ROT_MODEL_NONE if there is no such rotator.
+ */
+rot_model_t HAMLIB_API rot_get_model_by_name(const char *mfg_name,
+        const char *model_name)
+{
+    const struct rot_caps *caps;
 
-    for (p = rot_hash_table[HASH_FUNC(rot_model)]; p; p = p->next)
+    caps = registry_find(&rot_registry, mfg_name, model_name);
+
+    if (!caps)
     {
-        if (p->caps->rot_model == rot_model)
-        {
-            return p->caps;
-        }
+        rot_load_all_backends();
+        caps = registry_find(&rot_registry, mfg_name, model_name);
     }
 
-    return NULL;    /* sorry, caps not registered! */
+    return caps ? caps->rot_model : ROT_MODEL_NONE;
 }
 
 
@@ -285,59 +261,32 @@ int HAMLIB_API rot_check_backend(rot_model_t rot_model)
 
 int HAMLIB_API rot_unregister(rot_model_t rot_model)
 {
-    int hval;
-    struct rot_list *p, *q;
-
-    hval = HASH_FUNC(rot_model);
-    q = NULL;
-
-    for (p = rot_hash_table[hval]; p; p = p->next)
-    {
-        if (p->caps->rot_model == rot_model)
-        {
-            if (q == NULL)
-            {
-                rot_hash_table[hval] = p->next;
-            }
-            else
-            {
-                q->next = p->next;
-            }
-
-            free(p);
-            return RIG_OK;
-        }
-
-        q = p;
-    }
-
-    return -RIG_EINVAL; /* sorry, caps not registered! */
+    return registry_remove(&rot_registry, rot_model);
 }
 
 
 /*
  * rot_list_foreach
- * executes cfunc on all the elements stored in the rot hash list
+ * executes cfunc on all the elements stored in the rot registry
  */
 int HAMLIB_API rot_list_foreach(int (*cfunc)(const struct rot_caps *,
                                 rig_ptr_t),
                                 rig_ptr_t data)
 {
-    struct rot_list *p;
-    int i;
+    const struct rot_caps *caps;
+    unsigned iter = 0;
 
     if (!cfunc)
     {
         return -RIG_EINVAL;
     }
 
-    for (i = 0; i < ROTLSTHASHSZ; i++)
+    while ((caps = registry_next(&rot_registry, &iter)))
     {
-        for (p = rot_hash_table[i]; p; p = p->next)
-            if ((*cfunc)(p->caps, data) == 0)
-            {
-                return RIG_OK;
-            }
+        if ((*cfunc)(caps, data) == 0)
+        {
+            return RIG_OK;
+        }
     }
 
     return RIG_OK;
@@ -397,6 +346,12 @@ int HAMLIB_API rot_load_backend(const char *be_name)
     {
         if (!strcmp(be_name, rot_backend_list[i].be_name))
         {
+            /* each backend registers its models only once */
+            if (rot_backend_list[i].be_loaded)
+            {
+                return RIG_OK;
+            }
+
             be_init = rot_backend_list[i].be_init;
 
             if (be_init == NULL)
@@ -406,6 +361,12 @@ int HAMLIB_API rot_load_backend(const char *be_name)
             }
 
             status = (*be_init)(NULL);
+
+            if (status == RIG_OK)
+            {
+                rot_backend_list[i].be_loaded = 1;
+            }
+
             return status;
         }
     }
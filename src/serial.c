@@ -78,6 +78,7 @@
 #include <hamlib/rig.h>
 #include "serial.h"
 #include "misc.h"
+#include "iofunc.h"
 
 #ifdef HAVE_SYS_IOCCOM_H
 #  include <sys/ioccom.h>
@@ -573,18 +574,22 @@ int HAMLIB_API serial_flush(hamlib_port_t *p)
 {
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
+    /* first what has already been read ahead by read_string/read_block */
+    port_rxbuf_flush(p);
+
     if (p->fd == uh_ptt_fd || p->fd == uh_radio_fd)
     {
-        char buf[32];
         /*
          * Catch microHam case:
          * if fd corresponds to a microHam device drain the line
          * (which is a socket) by reading until it is empty.
+         * The receive buffer is empty now, use it as scratch space.
          */
         int n;
 
-        while ((n = read(p->fd, buf, 32)) > 0)
+        while ((n = read(p->fd, p->rx.buf, PORTRXBUFSIZ)) > 0)
         {
+            p->io_count.flush_calls++;
             rig_debug(RIG_DEBUG_VERBOSE, "%s: flushed %d bytes\n", __func__, n);
             /* do nothing */
         }
@@ -593,6 +598,7 @@ int HAMLIB_API serial_flush(hamlib_port_t *p)
     }
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s: tcflush\n", __func__);
+    p->io_count.flush_calls++;
     tcflush(p->fd, TCIFLUSH);
     return RIG_OK;
 }
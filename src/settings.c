@@ -48,12 +48,25 @@
 #include <hamlib/rig.h>
 #include <hamlib/amplifier.h>
 #include "cal.h"
+#include "stats.h"
+#include "vfoctx.h"
 
 
 #ifndef DOC_HIDDEN
 
 #  define CHECK_RIG_ARG(r) (!(r) || !(r)->caps || !(r)->state.comm_state)
 
+/*
+ * API functions accounted in the statistics are wrappers around these,
+ * see stats.h
+ */
+static int do_rig_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val);
+static int do_rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val);
+static int do_rig_set_func(RIG *rig, vfo_t vfo, setting_t func, int status);
+static int do_rig_get_func(RIG *rig, vfo_t vfo, setting_t func, int *status);
+static int do_rig_set_parm(RIG *rig, setting_t parm, value_t val);
+static int do_rig_get_parm(RIG *rig, setting_t parm, value_t *val);
+
 #endif /* !DOC_HIDDEN */
 
 
@@ -75,10 +88,20 @@
  * \sa rig_has_set_level(), rig_get_level()
  */
 int HAMLIB_API rig_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_LEVEL,
+                         do_rig_set_level(rig, vfo, level, val));
+}
+
+
+static int do_rig_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val)
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -87,6 +110,13 @@ int HAMLIB_API rig_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_level == NULL || !rig_has_set_level(rig, level))
@@ -106,8 +136,7 @@ int HAMLIB_API rig_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -115,7 +144,7 @@ int HAMLIB_API rig_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val)
     }
 
     retcode = caps->set_level(rig, vfo, level, val);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
     return retcode;
 }
 
@@ -145,10 +174,20 @@ int HAMLIB_API rig_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val)
  * \sa rig_has_get_level(), rig_set_level()
  */
 int HAMLIB_API rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_LEVEL,
+                         do_rig_get_level(rig, vfo, level, val));
+}
+
+
+static int do_rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -157,6 +196,13 @@ int HAMLIB_API rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_level == NULL || !rig_has_get_level(rig, level))
@@ -182,7 +228,7 @@ int HAMLIB_API rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
             return retcode;
         }
 
-        val->i = (int)rig_raw2val(rawstr.i, &rig->state.str_cal);
+        val->i = (int)rig_raw2val_meter(rig, RIG_CAL_STR, rawstr.i);
         return RIG_OK;
     }
 
@@ -200,8 +246,7 @@ int HAMLIB_API rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -209,7 +254,7 @@ int HAMLIB_API rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
     }
 
     retcode = caps->get_level(rig, vfo, level, val);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
     return retcode;
 }
 
@@ -231,6 +276,17 @@ int HAMLIB_API rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
  * \sa rig_has_set_parm(), rig_get_parm()
  */
 int HAMLIB_API rig_set_parm(RIG *rig, setting_t parm, value_t val)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_PARM,
+                         do_rig_set_parm(rig, parm, val));
+}
+
+
+static int do_rig_set_parm(RIG *rig, setting_t parm, value_t val)
 {
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -265,6 +321,17 @@ int HAMLIB_API rig_set_parm(RIG *rig, setting_t parm, value_t val)
  * \sa rig_has_get_parm(), rig_set_parm()
  */
 int HAMLIB_API rig_get_parm(RIG *rig, setting_t parm, value_t *val)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_PARM,
+                         do_rig_get_parm(rig, parm, val));
+}
+
+
+static int do_rig_get_parm(RIG *rig, setting_t parm, value_t *val)
 {
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -504,10 +571,20 @@ setting_t HAMLIB_API rig_has_set_func(RIG *rig, setting_t func)
  * \sa rig_get_func()
  */
 int HAMLIB_API rig_set_func(RIG *rig, vfo_t vfo, setting_t func, int status)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_SET_FUNC,
+                         do_rig_set_func(rig, vfo, func, status));
+}
+
+
+static int do_rig_set_func(RIG *rig, vfo_t vfo, setting_t func, int status)
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -516,6 +593,13 @@ int HAMLIB_API rig_set_func(RIG *rig, vfo_t vfo, setting_t func, int status)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_func == NULL || !rig_has_set_func(rig, func))
@@ -536,8 +620,7 @@ int HAMLIB_API rig_set_func(RIG *rig, vfo_t vfo, setting_t func, int status)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -545,7 +628,7 @@ int HAMLIB_API rig_set_func(RIG *rig, vfo_t vfo, setting_t func, int status)
     }
 
     retcode = caps->set_func(rig, vfo, func, status);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
 
     return retcode;
 }
@@ -571,10 +654,20 @@ int HAMLIB_API rig_set_func(RIG *rig, vfo_t vfo, setting_t func, int status)
  * \sa rig_set_func()
  */
 int HAMLIB_API rig_get_func(RIG *rig, vfo_t vfo, setting_t func, int *status)
+{
+    struct rig_stats_call call;
+
+    rig_stats_begin(rig, &call);
+
+    return rig_stats_end(rig, &call, RIG_STATS_GET_FUNC,
+                         do_rig_get_func(rig, vfo, func, status));
+}
+
+
+static int do_rig_get_func(RIG *rig, vfo_t vfo, setting_t func, int *status)
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -583,6 +676,13 @@ int HAMLIB_API rig_get_func(RIG *rig, vfo_t vfo, setting_t func, int *status)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_func == NULL || !rig_has_get_func(rig, func))
@@ -603,8 +703,7 @@ int HAMLIB_API rig_get_func(RIG *rig, vfo_t vfo, setting_t func, int *status)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -612,7 +711,7 @@ int HAMLIB_API rig_get_func(RIG *rig, vfo_t vfo, setting_t func, int *status)
     }
 
     retcode = caps->get_func(rig, vfo, func, status);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
 
     return retcode;
 }
@@ -640,7 +739,6 @@ int HAMLIB_API rig_set_ext_level(RIG *rig,
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -649,6 +747,13 @@ int HAMLIB_API rig_set_ext_level(RIG *rig,
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_ext_level == NULL)
@@ -669,8 +774,7 @@ int HAMLIB_API rig_set_ext_level(RIG *rig,
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -678,7 +782,7 @@ int HAMLIB_API rig_set_ext_level(RIG *rig,
     }
 
     retcode = caps->set_ext_level(rig, vfo, token, val);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
 
     return retcode;
 }
@@ -706,7 +810,6 @@ int HAMLIB_API rig_get_ext_level(RIG *rig,
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -715,6 +818,13 @@ int HAMLIB_API rig_get_ext_level(RIG *rig,
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_ext_level == NULL)
@@ -735,8 +845,7 @@ int HAMLIB_API rig_get_ext_level(RIG *rig,
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -744,7 +853,7 @@ int HAMLIB_API rig_get_ext_level(RIG *rig,
     }
 
     retcode = caps->get_ext_level(rig, vfo, token, val);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
 
     return retcode;
 }
@@ -0,0 +1,463 @@
+/*
+ *  Hamlib Interface - operation statistics
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/**
+ * \addtogroup rig
+ * @{
+ */
+
+/**
+ * \file stats.c
+ * \brief Per operation statistics
+ *
+ * When enabled with rig_set_stats() or the "stats" configuration
+ * parameter, every accounted API call records its latency in a log2
+ * histogram, along with the bytes, timeouts and retries seen on the rig
+ * port meanwhile.  This tells a slow serial link from a backend busy
+ * retrying or verifying its commands.  The latency also goes to the
+ * histogram of the port which served the call, the PTT or DCD port when
+ * those are not handled through the rig.
+ *
+ * Only the outermost call is accounted: the rig_set_ptt() done by
+ * rig_set_ptt_at(), or the rig_set_vfo() done by a backend on its way,
+ * are part of the caller's time.
+ *
+ * Once allocated, the statistics are kept until rig_cleanup(), even when
+ * disabled, so that a call in progress in another thread never finds
+ * them freed under its feet.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <hamlib/rig.h>
+#include "stats.h"
+
+
+enum stats_port_e
+{
+    STATS_RIGPORT,
+    STATS_PTTPORT,
+    STATS_DCDPORT,
+    STATS_NB_PORTS
+};
+
+/* what rig_state.stats points to */
+struct rig_stats_priv
+{
+    int enabled;
+    int depth;                  /* accounted calls in progress */
+    struct rig_op_stats op[RIG_STATS_NB_OPS];
+    unsigned long port_hist[STATS_NB_PORTS][RIG_STATS_HIST_SIZE];
+};
+
+
+static const char *const stats_op_names[RIG_STATS_NB_OPS] =
+{
+    [RIG_STATS_SET_FREQ] = "set_freq",
+    [RIG_STATS_GET_FREQ] = "get_freq",
+    [RIG_STATS_SET_MODE] = "set_mode",
+    [RIG_STATS_GET_MODE] = "get_mode",
+    [RIG_STATS_SET_VFO] = "set_vfo",
+    [RIG_STATS_GET_VFO] = "get_vfo",
+    [RIG_STATS_SET_PTT] = "set_ptt",
+    [RIG_STATS_GET_PTT] = "get_ptt",
+    [RIG_STATS_GET_DCD] = "get_dcd",
+    [RIG_STATS_SET_SPLIT_FREQ] = "set_split_freq",
+    [RIG_STATS_GET_SPLIT_FREQ] = "get_split_freq",
+    [RIG_STATS_SET_SPLIT_MODE] = "set_split_mode",
+    [RIG_STATS_GET_SPLIT_MODE] = "get_split_mode",
+    [RIG_STATS_SET_SPLIT_VFO] = "set_split_vfo",
+    [RIG_STATS_GET_SPLIT_VFO] = "get_split_vfo",
+    [RIG_STATS_SET_RIT] = "set_rit",
+    [RIG_STATS_GET_RIT] = "get_rit",
+    [RIG_STATS_SET_XIT] = "set_xit",
+    [RIG_STATS_GET_XIT] = "get_xit",
+    [RIG_STATS_SET_TS] = "set_ts",
+    [RIG_STATS_GET_TS] = "get_ts",
+    [RIG_STATS_SET_ANT] = "set_ant",
+    [RIG_STATS_GET_ANT] = "get_ant",
+    [RIG_STATS_SET_LEVEL] = "set_level",
+    [RIG_STATS_GET_LEVEL] = "get_level",
+    [RIG_STATS_SET_FUNC] = "set_func",
+    [RIG_STATS_GET_FUNC] = "get_func",
+    [RIG_STATS_SET_PARM] = "set_parm",
+    [RIG_STATS_GET_PARM] = "get_parm",
+    [RIG_STATS_SET_MEM] = "set_mem",
+    [RIG_STATS_GET_MEM] = "get_mem",
+    [RIG_STATS_SET_CHANNEL] = "set_channel",
+    [RIG_STATS_GET_CHANNEL] = "get_channel",
+    [RIG_STATS_VFO_OP] = "vfo_op",
+    [RIG_STATS_SCAN] = "scan",
+    [RIG_STATS_SET_POWERSTAT] = "set_powerstat",
+    [RIG_STATS_GET_POWERSTAT] = "get_powerstat",
+    [RIG_STATS_SEND_MORSE] = "send_morse",
+    [RIG_STATS_SET_PTT_AT] = "set_ptt_at",
+};
+
+
+static int64_t stats_now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+
+static int stats_bucket(int64_t us)
+{
+    int i = 0;
+
+    while (us > 0 && i < RIG_STATS_HIST_SIZE - 1)
+    {
+        us >>= 1;
+        i++;
+    }
+
+    return i;
+}
+
+
+/* the port which served op */
+static enum stats_port_e stats_port(const RIG *rig, enum rig_stats_op_e op)
+{
+    const struct rig_state *rs = &rig->state;
+
+    switch (op)
+    {
+    case RIG_STATS_SET_PTT:
+    case RIG_STATS_GET_PTT:
+    case RIG_STATS_SET_PTT_AT:
+        if (rs->pttport.type.ptt != RIG_PTT_NONE
+                && rs->pttport.type.ptt != RIG_PTT_RIG
+                && rs->pttport.type.ptt != RIG_PTT_RIG_MICDATA)
+        {
+            return STATS_PTTPORT;
+        }
+
+        break;
+
+    case RIG_STATS_GET_DCD:
+        if (rs->dcdport.type.dcd != RIG_DCD_NONE
+                && rs->dcdport.type.dcd != RIG_DCD_RIG)
+        {
+            return STATS_DCDPORT;
+        }
+
+        break;
+
+    default:
+        break;
+    }
+
+    return STATS_RIGPORT;
+}
+
+
+static void port_stats(struct rig_port_stats *ps, const hamlib_port_t *p,
+                       const unsigned long *hist)
+{
+    memcpy(ps->hist, hist, sizeof(ps->hist));
+    ps->tx_bytes = p->io_count.tx_bytes;
+    ps->rx_bytes = p->io_count.rx_bytes;
+    ps->timeouts = p->io_count.timeouts;
+    ps->retries = p->io_count.retries;
+    ps->syscalls = p->io_count.select_calls + p->io_count.read_calls
+                   + p->io_count.write_calls + p->io_count.flush_calls;
+}
+
+
+void rig_stats_begin(RIG *rig, struct rig_stats_call *call)
+{
+    struct rig_stats_priv *priv = rig ? rig->state.stats : NULL;
+    const hamlib_port_t *rp;
+
+    call->active = priv && priv->enabled;
+
+    if (!call->active)
+    {
+        return;
+    }
+
+    call->outer = priv->depth++ == 0;
+
+    if (!call->outer)
+    {
+        return;
+    }
+
+    rp = &rig->state.rigport;
+    call->tx_bytes = rp->io_count.tx_bytes;
+    call->rx_bytes = rp->io_count.rx_bytes;
+    call->timeouts = rp->io_count.timeouts;
+    call->retries = rp->io_count.retries;
+    call->start = stats_now();
+}
+
+
+void rig_stats_begin_at(RIG *rig, struct rig_stats_call *call, int64_t start)
+{
+    rig_stats_begin(rig, call);
+    call->start = start;
+}
+
+
+int rig_stats_end(RIG *rig,
+                  const struct rig_stats_call *call,
+                  enum rig_stats_op_e op,
+                  int retcode)
+{
+    struct rig_stats_priv *priv;
+    struct rig_op_stats *os;
+    const hamlib_port_t *rp;
+    int64_t us;
+    int bucket;
+
+    if (!call->active)
+    {
+        return retcode;
+    }
+
+    priv = rig->state.stats;
+    priv->depth--;
+
+    /* nested in an accounted call, or disabled meanwhile */
+    if (!call->outer || !priv->enabled)
+    {
+        return retcode;
+    }
+
+    us = stats_now() - call->start;
+
+    rp = &rig->state.rigport;
+    os = &priv->op[op];
+
+    os->count++;
+
+    if (retcode != RIG_OK)
+    {
+        os->errors++;
+    }
+
+    os->tx_bytes += rp->io_count.tx_bytes - call->tx_bytes;
+    os->rx_bytes += rp->io_count.rx_bytes - call->rx_bytes;
+    os->timeouts += rp->io_count.timeouts - call->timeouts;
+    os->retries += rp->io_count.retries - call->retries;
+
+    os->total_us += us;
+    os->total_sq_us += (double)us * us;
+
+    if (us > os->max_us)
+    {
+        os->max_us = us;
+    }
+
+    bucket = stats_bucket(us);
+    os->hist[bucket]++;
+    priv->port_hist[stats_port(rig, op)][bucket]++;
+
+    return retcode;
+}
+
+
+void rig_stats_free(RIG *rig)
+{
+    free(rig->state.stats);
+    rig->state.stats = NULL;
+}
+
+
+int rig_stats_enabled(const RIG *rig)
+{
+    const struct rig_stats_priv *priv = rig->state.stats;
+
+    return priv && priv->enabled;
+}
+
+
+static void stats_clear(struct rig_stats_priv *priv)
+{
+    memset(priv->op, 0, sizeof(priv->op));
+    memset(priv->port_hist, 0, sizeof(priv->port_hist));
+}
+
+
+/**
+ * \brief enable or disable the operation statistics
+ * \param rig       The rig handle
+ * \param enable    1 to collect statistics, 0 to stop and discard them
+ *
+ *  The statistics are disabled by default and then cost a pointer test
+ *  per API call.  Enabling them when already enabled keeps what has been
+ *  collected so far.  Disabling them clears the counters, but keeps their
+ *  memory until rig_cleanup(), so this may be called while another thread
+ *  is in an API call.
+ *
+ * \return RIG_OK if the operation has been sucessful, otherwise
+ * a negative value if an error occured (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_get_stats(), rig_reset_stats()
+ */
+int HAMLIB_API rig_set_stats(RIG *rig, int enable)
+{
+    struct rig_stats_priv *priv;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (!rig || !rig->caps)
+    {
+        return -RIG_EINVAL;
+    }
+
+    priv = rig->state.stats;
+
+    if (!enable)
+    {
+        if (priv)
+        {
+            priv->enabled = 0;
+            stats_clear(priv);
+        }
+
+        return RIG_OK;
+    }
+
+    if (!priv)
+    {
+        priv = calloc(1, sizeof(struct rig_stats_priv));
+
+        if (!priv)
+        {
+            return -RIG_ENOMEM;
+        }
+
+        rig->state.stats = priv;
+    }
+
+    priv->enabled = 1;
+
+    return RIG_OK;
+}
+
+
+/**
+ * \brief get the operation statistics
+ * \param rig       The rig handle
+ * \param stats     The location where to store the statistics
+ *
+ *  Retrieves the per operation statistics collected since they were
+ *  enabled or reset, and the current counters of the rig, PTT and DCD
+ *  ports.  The port counters are kept whether the statistics are enabled
+ *  or not, and are not cleared by rig_reset_stats(); the port latency
+ *  histograms are.
+ *
+ * \return RIG_OK if the operation has been sucessful, -RIG_ENAVAIL if
+ * the statistics are not enabled, otherwise a negative value if an error
+ * occured (in which case, cause is set appropriately).
+ *
+ * \sa rig_set_stats(), rig_reset_stats(), rig_strstatsop()
+ */
+int HAMLIB_API rig_get_stats(RIG *rig, struct rig_stats *stats)
+{
+    const struct rig_stats_priv *priv;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (!rig || !rig->caps || !stats)
+    {
+        return -RIG_EINVAL;
+    }
+
+    if (!rig_stats_enabled(rig))
+    {
+        return -RIG_ENAVAIL;
+    }
+
+    priv = rig->state.stats;
+    memcpy(stats->op, priv->op, sizeof(stats->op));
+
+    port_stats(&stats->rigport, &rig->state.rigport,
+               priv->port_hist[STATS_RIGPORT]);
+    port_stats(&stats->pttport, &rig->state.pttport,
+               priv->port_hist[STATS_PTTPORT]);
+    port_stats(&stats->dcdport, &rig->state.dcdport,
+               priv->port_hist[STATS_DCDPORT]);
+
+    return RIG_OK;
+}
+
+
+/**
+ * \brief clear the operation statistics
+ * \param rig       The rig handle
+ *
+ * \return RIG_OK if the operation has been sucessful, -RIG_ENAVAIL if
+ * the statistics are not enabled, otherwise a negative value if an error
+ * occured (in which case, cause is set appropriately).
+ *
+ * \sa rig_set_stats(), rig_get_stats()
+ */
+int HAMLIB_API rig_reset_stats(RIG *rig)
+{
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (!rig || !rig->caps)
+    {
+        return -RIG_EINVAL;
+    }
+
+    if (!rig_stats_enabled(rig))
+    {
+        return -RIG_ENAVAIL;
+    }
+
+    stats_clear(rig->state.stats);
+
+    return RIG_OK;
+}
+
+
+/**
+ * \brief name of an accounted operation
+ * \param op    The operation
+ *
+ * \return the name of the API call, without the "rig_" prefix, or ""
+ * for an unknown operation.
+ */
+const char *HAMLIB_API rig_strstatsop(enum rig_stats_op_e op)
+{
+    if (op < 0 || op >= RIG_STATS_NB_OPS)
+    {
+        return "";
+    }
+
+    return stats_op_names[op];
+}
+
+/** @} */
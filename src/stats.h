@@ -0,0 +1,60 @@
+/*
+ *  Hamlib Interface - operation statistics header
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef _STATS_H
+#define _STATS_H 1
+
+#include <hamlib/rig.h>
+
+/* what rig_stats_end() needs from the start of a call */
+struct rig_stats_call {
+    int active;                 /* counted in the nesting depth */
+    int outer;                  /* not nested in another accounted call */
+    int64_t start;              /* us */
+    unsigned long tx_bytes;
+    unsigned long rx_bytes;
+    unsigned long timeouts;
+    unsigned long retries;
+};
+
+/*
+ * API functions are accounted as
+ *
+ *      rig_stats_begin(rig, &call);
+ *      return rig_stats_end(rig, &call, op, do_the_work(...));
+ *
+ * Both only test rig_state.stats while the statistics are disabled.
+ * Calls nested in an accounted call are not accounted on their own.
+ */
+extern void rig_stats_begin(RIG *rig, struct rig_stats_call *call);
+/* the same, timing the call from start, a time of day in us */
+extern void rig_stats_begin_at(RIG *rig, struct rig_stats_call *call,
+                               int64_t start);
+extern int rig_stats_end(RIG *rig,
+                         const struct rig_stats_call *call,
+                         enum rig_stats_op_e op,
+                         int retcode);
+
+/* only from rig_cleanup(), nothing else frees the statistics */
+extern void rig_stats_free(RIG *rig);
+extern int rig_stats_enabled(const RIG *rig);
+
+#endif /* _STATS_H */
@@ -98,6 +98,14 @@
 #define TOK_POLL_INTERVAL   TOKEN_FRONTEND(111)
 /** \brief rig: lo frequency of any transverters */
 #define TOK_LO_FREQ         TOKEN_FRONTEND(112)
+/** \brief rig: validity of the frontend cache in ms */
+#define TOK_CACHE_TIMEOUT   TOKEN_FRONTEND(113)
+/** \brief rig: operation statistics on/off */
+#define TOK_STATS           TOKEN_FRONTEND(114)
+/** \brief rig: delay in ms before selecting back a VFO */
+#define TOK_VFO_RESTORE_DELAY TOKEN_FRONTEND(115)
+/** \brief rig: keep a separate PTT serial port open */
+#define TOK_PTT_HOLD        TOKEN_FRONTEND(116)
 /** \brief rig: International Telecommunications Union region no. */
 #define TOK_ITU_REGION  TOKEN_FRONTEND(120)
 /*
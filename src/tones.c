@@ -38,6 +38,7 @@
 
 #include <hamlib/rig.h>
 #include "tones.h"
+#include "vfoctx.h"
 
 #if !defined(_WIN32) && !defined(__CYGWIN__)
 
@@ -101,7 +102,6 @@ int HAMLIB_API rig_set_ctcss_tone(RIG *rig, vfo_t vfo, tone_t tone)
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -110,6 +110,13 @@ int HAMLIB_API rig_set_ctcss_tone(RIG *rig, vfo_t vfo, tone_t tone)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_ctcss_tone == NULL)
@@ -130,8 +137,7 @@ int HAMLIB_API rig_set_ctcss_tone(RIG *rig, vfo_t vfo, tone_t tone)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -139,7 +145,7 @@ int HAMLIB_API rig_set_ctcss_tone(RIG *rig, vfo_t vfo, tone_t tone)
     }
 
     retcode = caps->set_ctcss_tone(rig, vfo, tone);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
 
     return retcode;
 }
@@ -168,7 +174,6 @@ int HAMLIB_API rig_get_ctcss_tone(RIG *rig, vfo_t vfo, tone_t *tone)
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -177,6 +182,13 @@ int HAMLIB_API rig_get_ctcss_tone(RIG *rig, vfo_t vfo, tone_t *tone)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_ctcss_tone == NULL)
@@ -197,8 +209,7 @@ int HAMLIB_API rig_get_ctcss_tone(RIG *rig, vfo_t vfo, tone_t *tone)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -206,7 +217,7 @@ int HAMLIB_API rig_get_ctcss_tone(RIG *rig, vfo_t vfo, tone_t *tone)
     }
 
     retcode = caps->get_ctcss_tone(rig, vfo, tone);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
 
     return retcode;
 }
@@ -231,7 +242,6 @@ int HAMLIB_API rig_set_dcs_code(RIG *rig, vfo_t vfo, tone_t code)
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -240,6 +250,13 @@ int HAMLIB_API rig_set_dcs_code(RIG *rig, vfo_t vfo, tone_t code)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_dcs_code == NULL)
@@ -260,8 +277,7 @@ int HAMLIB_API rig_set_dcs_code(RIG *rig, vfo_t vfo, tone_t code)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -269,7 +285,7 @@ int HAMLIB_API rig_set_dcs_code(RIG *rig, vfo_t vfo, tone_t code)
     }
 
     retcode = caps->set_dcs_code(rig, vfo, code);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
 
     return retcode;
 }
@@ -293,7 +309,6 @@ int HAMLIB_API rig_get_dcs_code(RIG *rig, vfo_t vfo, tone_t *code)
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -302,6 +317,13 @@ int HAMLIB_API rig_get_dcs_code(RIG *rig, vfo_t vfo, tone_t *code)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_dcs_code == NULL)
@@ -322,8 +344,7 @@ int HAMLIB_API rig_get_dcs_code(RIG *rig, vfo_t vfo, tone_t *code)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -331,7 +352,7 @@ int HAMLIB_API rig_get_dcs_code(RIG *rig, vfo_t vfo, tone_t *code)
     }
 
     retcode = caps->get_dcs_code(rig, vfo, code);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
 
     return retcode;
 }
@@ -363,7 +384,6 @@ int HAMLIB_API rig_set_ctcss_sql(RIG *rig, vfo_t vfo, tone_t tone)
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -372,6 +392,13 @@ int HAMLIB_API rig_set_ctcss_sql(RIG *rig, vfo_t vfo, tone_t tone)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_ctcss_sql == NULL)
@@ -392,8 +419,7 @@ int HAMLIB_API rig_set_ctcss_sql(RIG *rig, vfo_t vfo, tone_t tone)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -401,7 +427,7 @@ int HAMLIB_API rig_set_ctcss_sql(RIG *rig, vfo_t vfo, tone_t tone)
     }
 
     retcode = caps->set_ctcss_sql(rig, vfo, tone);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
 
     return retcode;
 }
@@ -430,7 +456,6 @@ int HAMLIB_API rig_get_ctcss_sql(RIG *rig, vfo_t vfo, tone_t *tone)
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -439,6 +464,13 @@ int HAMLIB_API rig_get_ctcss_sql(RIG *rig, vfo_t vfo, tone_t *tone)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_ctcss_sql == NULL)
@@ -459,8 +491,7 @@ int HAMLIB_API rig_get_ctcss_sql(RIG *rig, vfo_t vfo, tone_t *tone)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -468,7 +499,7 @@ int HAMLIB_API rig_get_ctcss_sql(RIG *rig, vfo_t vfo, tone_t *tone)
     }
 
     retcode = caps->get_ctcss_sql(rig, vfo, tone);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
 
     return retcode;
 }
@@ -492,7 +523,6 @@ int HAMLIB_API rig_set_dcs_sql(RIG *rig, vfo_t vfo, tone_t code)
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -501,6 +531,13 @@ int HAMLIB_API rig_set_dcs_sql(RIG *rig, vfo_t vfo, tone_t code)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->set_dcs_sql == NULL)
@@ -521,8 +558,7 @@ int HAMLIB_API rig_set_dcs_sql(RIG *rig, vfo_t vfo, tone_t code)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -530,7 +566,7 @@ int HAMLIB_API rig_set_dcs_sql(RIG *rig, vfo_t vfo, tone_t code)
     }
 
     retcode = caps->set_dcs_sql(rig, vfo, code);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
 
     return retcode;
 }
@@ -554,7 +590,6 @@ int HAMLIB_API rig_get_dcs_sql(RIG *rig, vfo_t vfo, tone_t *code)
 {
     const struct rig_caps *caps;
     int retcode;
-    vfo_t curr_vfo;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
@@ -563,6 +598,13 @@ int HAMLIB_API rig_get_dcs_sql(RIG *rig, vfo_t vfo, tone_t *code)
         return -RIG_EINVAL;
     }
 
+    retcode = rig_vfo_ctx_enter(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
     caps = rig->caps;
 
     if (caps->get_dcs_sql == NULL)
@@ -583,8 +625,7 @@ int HAMLIB_API rig_get_dcs_sql(RIG *rig, vfo_t vfo, tone_t *code)
         return -RIG_ENTARGET;
     }
 
-    curr_vfo = rig->state.current_vfo;
-    retcode = caps->set_vfo(rig, vfo);
+    retcode = rig_vfo_ctx_select(rig, vfo);
 
     if (retcode != RIG_OK)
     {
@@ -592,7 +633,7 @@ int HAMLIB_API rig_get_dcs_sql(RIG *rig, vfo_t vfo, tone_t *code)
     }
 
     retcode = caps->get_dcs_sql(rig, vfo, code);
-    caps->set_vfo(rig, curr_vfo);
+    rig_vfo_ctx_release(rig);
 
     return retcode;
 }
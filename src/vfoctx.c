@@ -0,0 +1,217 @@
+/*
+ *  Hamlib Interface - VFO switching of non targetable rigs
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/**
+ * \addtogroup rig
+ * @{
+ */
+
+/**
+ * \file vfoctx.c
+ * \brief VFO switching of non targetable rigs
+ *
+ * When the backend cannot target a VFO for an operation, the frontend
+ * selects that VFO, does the operation and selects the previous VFO back,
+ * three transactions instead of one.
+ *
+ * With the "vfo_restore_delay" configuration parameter set, the previous
+ * VFO is only selected back once no operation on the other VFO came for
+ * that many milliseconds, or as soon as an operation needs the previous
+ * VFO.  Reading the frequency and mode of VFO B then costs two VFO
+ * switches instead of four, and the rig display flickers once.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <sys/time.h>
+
+#include <hamlib/rig.h>
+#include "vfoctx.h"
+
+
+static int64_t vfo_ctx_now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+
+int rig_vfo_ctx_restore(RIG *rig)
+{
+    struct rig_state *rs = &rig->state;
+    vfo_t vfo = rs->restore_vfo;
+    int retcode;
+
+    if (vfo == RIG_VFO_NONE)
+    {
+        return RIG_OK;
+    }
+
+    rig_debug(RIG_DEBUG_TRACE, "%s: back to %s\n", __func__, rig_strvfo(vfo));
+
+    rs->restore_vfo = RIG_VFO_NONE;
+    rs->restore_time = 0;
+
+    retcode = rig->caps->set_vfo(rig, vfo);
+
+    if (retcode == RIG_OK)
+    {
+        rs->current_vfo = vfo;
+    }
+
+    return retcode;
+}
+
+
+int rig_vfo_ctx_enter(RIG *rig, vfo_t vfo)
+{
+    const struct rig_state *rs = &rig->state;
+
+    if (rs->restore_vfo == RIG_VFO_NONE)
+    {
+        return RIG_OK;
+    }
+
+    if (vfo == RIG_VFO_CURR
+            || (rs->restore_time != 0 && vfo_ctx_now() >= rs->restore_time))
+    {
+        return rig_vfo_ctx_restore(rig);
+    }
+
+    return RIG_OK;
+}
+
+
+int rig_vfo_ctx_select(RIG *rig, vfo_t vfo)
+{
+    struct rig_state *rs = &rig->state;
+    int fresh = 0;
+    int retcode;
+
+    if (rs->restore_vfo == RIG_VFO_NONE)
+    {
+        rs->restore_vfo = rs->current_vfo != RIG_VFO_NONE
+                          ? rs->current_vfo : RIG_VFO_CURR;
+        fresh = 1;
+    }
+    else if (vfo == rs->restore_vfo)
+    {
+        return rig_vfo_ctx_restore(rig);
+    }
+
+    /* held until rig_vfo_ctx_release() */
+    rs->restore_time = 0;
+
+    retcode = rig->caps->set_vfo(rig, vfo);
+
+    if (retcode != RIG_OK)
+    {
+        if (fresh)
+        {
+            rs->restore_vfo = RIG_VFO_NONE;
+        }
+        else
+        {
+            /* unknown VFO now, restore on next operation */
+            rs->restore_time = vfo_ctx_now();
+        }
+
+        return retcode;
+    }
+
+    if (rs->vfo_restore_delay > 0)
+    {
+        rs->current_vfo = vfo;
+    }
+
+    return RIG_OK;
+}
+
+
+int rig_vfo_ctx_release(RIG *rig)
+{
+    struct rig_state *rs = &rig->state;
+
+    if (rs->restore_vfo == RIG_VFO_NONE)
+    {
+        return RIG_OK;
+    }
+
+    if (rs->vfo_restore_delay <= 0)
+    {
+        return rig_vfo_ctx_restore(rig);
+    }
+
+    rs->restore_time = vfo_ctx_now() + rs->vfo_restore_delay;
+
+    return RIG_OK;
+}
+
+
+int64_t rig_vfo_ctx_deadline(RIG *rig)
+{
+    const struct rig_state *rs = &rig->state;
+
+    if (rs->restore_vfo == RIG_VFO_NONE)
+    {
+        return 0;
+    }
+
+    return rs->restore_time;
+}
+
+
+/**
+ * \brief select back the VFO left by a deferred switch
+ * \param rig   The rig handle
+ *
+ *  When the "vfo_restore_delay" configuration parameter is set, an
+ *  operation on a VFO other than the current one may leave the rig on
+ *  that VFO.  The previous VFO is selected back by the next operation on
+ *  RIG_VFO_CURR, or by the first operation after the delay.  An
+ *  application going idle calls rig_restore_vfo() to have the rig show its
+ *  VFO again without waiting for that operation.  The async worker started
+ *  by rig_async_start() does it by itself.
+ *
+ * \return RIG_OK if the operation has been sucessful or there was nothing
+ * to restore, otherwise a negative value if an error occured (in which
+ * case, cause is set appropriately).
+ *
+ * \sa rig_set_vfo()
+ */
+int HAMLIB_API rig_restore_vfo(RIG *rig)
+{
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (!rig || !rig->caps || !rig->state.comm_state)
+    {
+        return -RIG_EINVAL;
+    }
+
+    return rig_vfo_ctx_restore(rig);
+}
+
+/** @} */
@@ -0,0 +1,57 @@
+/*
+ *  Hamlib Interface - VFO switching of non targetable rigs header
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef _VFOCTX_H
+#define _VFOCTX_H 1
+
+#include <hamlib/rig.h>
+
+/*
+ * An operation on a VFO the backend cannot target is done as
+ *
+ *      retcode = rig_vfo_ctx_enter(rig, vfo);
+ *      ...
+ *      if (vfo == RIG_VFO_CURR || vfo == rig->state.current_vfo)
+ *          do it;
+ *      else
+ *      {
+ *          retcode = rig_vfo_ctx_select(rig, vfo);
+ *          do it;
+ *          rc2 = rig_vfo_ctx_release(rig);
+ *      }
+ *
+ * With rig_state.vfo_restore_delay at 0, rig_vfo_ctx_release() selects
+ * the previous VFO back at once.  Otherwise the rig is left on the
+ * selected VFO, rig_state.current_vfo follows it, and the previous VFO is
+ * only selected back by the first operation on RIG_VFO_CURR, or once the
+ * delay has expired.
+ */
+extern int rig_vfo_ctx_enter(RIG *rig, vfo_t vfo);
+extern int rig_vfo_ctx_select(RIG *rig, vfo_t vfo);
+extern int rig_vfo_ctx_release(RIG *rig);
+
+/* select the previous VFO back now, if still pending */
+extern int rig_vfo_ctx_restore(RIG *rig);
+
+/* time of day in ms when the pending restore is due, 0 if none */
+extern int64_t rig_vfo_ctx_deadline(RIG *rig);
+
+#endif /* _VFOCTX_H */
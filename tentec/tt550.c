@@ -123,6 +123,8 @@ tt550_transaction(RIG *rig, const char *cmd, int cmd_len, char *data,
 
     retval = read_string(&rs->rigport, data, *data_len, NULL, 0);
 
+    Unhold_Decode(rig);
+
     if (retval == -RIG_ETIMEOUT)
     {
         retval = 0;
@@ -135,8 +137,6 @@ tt550_transaction(RIG *rig, const char *cmd, int cmd_len, char *data,
 
     *data_len = retval;
 
-    Unhold_Decode(rig);
-
     return RIG_OK;
 }
 
@@ -178,6 +178,8 @@ declare_proto_amp(reset);
 declare_proto_amp(get_level);
 declare_proto_amp(set_powerstat);
 declare_proto_amp(get_powerstat);
+declare_proto_amp(get_levels);
+declare_proto_amp(watch_levels);
 //declare_proto_amp(dump_caps);
 
 /*
@@ -197,6 +199,8 @@ struct test_table test_list[] =
     { 'R', "reset",         ACTION(reset),          ARG_IN, "Reset" },
     { 0x87, "set_powerstat",    ACTION(set_powerstat),  ARG_IN, "Power Status" },
     { 0x88, "get_powerstat",    ACTION(get_powerstat),  ARG_OUT, "Power Status" },
+    { 0x89, "get_levels",   ACTION(get_levels),     ARG_IN1 | ARG_OUT2, "Levels", "Level Values" },
+    { 0x8a, "watch_levels", ACTION(watch_levels),   ARG_IN, "Interval(ms)", "Levels" },
     { 0x00, "", NULL },
 };
 
@@ -1888,6 +1892,206 @@ declare_proto_amp(get_powerstat)
     return status;
 }
 
+/*
+ * Comma separated level names, or ALL for every level the amplifier
+ * can read
+ */
+static int parse_levels(AMP *amp, const char *s, setting_t *levels)
+{
+    char buf[MAXARGSZ + 1];
+    char *tok, *saveptr = NULL;
+
+    if (!strcmp(s, "ALL"))
+    {
+        *levels = amp->state.has_get_level;
+        return *levels ? RIG_OK : -RIG_ENAVAIL;
+    }
+
+    *levels = AMP_LEVEL_NONE;
+    snprintf(buf, sizeof(buf), "%s", s);
+
+    for (tok = strtok_r(buf, ",", &saveptr); tok;
+            tok = strtok_r(NULL, ",", &saveptr))
+    {
+        setting_t level = amp_parse_level(tok);
+
+        if (level == AMP_LEVEL_NONE || !amp_has_get_level(amp, level))
+        {
+            return -RIG_EINVAL;
+        }
+
+        *levels |= level;
+    }
+
+    return *levels ? RIG_OK : -RIG_EINVAL;
+}
+
+
+/* one read per level of levels, in the order of the level bits */
+static int levels_req(setting_t levels, struct amp_level_value *req)
+{
+    int i, n = 0;
+
+    for (i = 0; i < RIG_SETTING_MAX; i++)
+    {
+        if (levels & rig_idx2setting(i))
+        {
+            req[n].level = rig_idx2setting(i);
+            req[n].status = RIG_OK;
+            n++;
+        }
+    }
+
+    return n;
+}
+
+
+/*
+ * One line per level, its value or the RPRT code if it could not be
+ * read, after the level name when names is set.
+ */
+void ampctl_print_levels(FILE *fout, const struct amp_level_value *req,
+                         int count, int names)
+{
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        const struct amp_level_value *r = &req[i];
+
+        if (names)
+        {
+            fprintf(fout, "%s: ", amp_strlevel(r->level));
+        }
+
+        if (r->status != RIG_OK)
+        {
+            fprintf(fout, NETAMPCTL_RET "%d\n", r->status);
+        }
+        else if (AMP_LEVEL_IS_FLOAT(r->level))
+        {
+            fprintf(fout, "%f\n", r->val.f);
+        }
+        else if (AMP_LEVEL_IS_STRING(r->level))
+        {
+            fprintf(fout, "%s\n", r->val.s);
+        }
+        else
+        {
+            fprintf(fout, "%d\n", r->val.i);
+        }
+    }
+}
+
+
+/*
+ * Read levels into req, the error of the batch in each status if it
+ * could not be run. Returns the number of reads.
+ */
+int ampctl_read_levels(AMP *amp, setting_t levels,
+                        struct amp_level_value *req)
+{
+    int n = levels_req(levels, req);
+    int retcode = amp_get_levels(amp, req, n);
+    int i;
+
+    if (retcode != RIG_OK)
+    {
+        for (i = 0; i < n; i++)
+        {
+            req[i].status = retcode;
+        }
+    }
+
+    return n;
+}
+
+
+/* '0x89' */
+declare_proto_amp(get_levels)
+{
+    struct amp_level_value req[RIG_SETTING_MAX];
+    setting_t levels;
+    int status;
+    int n;
+
+    if (!strcmp(arg1, "?"))
+    {
+        char s[SPRINTF_MAX_SIZE];
+        sprintf_level_amp(s, amp->state.has_get_level);
+        fprintf(fout, "%s\n", s);
+        return RIG_OK;
+    }
+
+    status = parse_levels(amp, arg1, &levels);
+
+    if (status != RIG_OK)
+    {
+        return status;
+    }
+
+    n = levels_req(levels, req);
+    status = amp_get_levels(amp, req, n);
+
+    if (status != RIG_OK)
+    {
+        return status;
+    }
+
+    ampctl_print_levels(fout, req, n,
+                        (interactive && prompt)
+                        || (interactive && !prompt && ext_resp));
+
+    return RIG_OK;
+}
+
+
+/*
+ * Set by ampctld, which is the only one able to push data to a client
+ */
+int (*ampctl_watch_hook)(AMP *amp, setting_t levels, int interval);
+
+/* ms, faster would only keep the amplifier busy answering */
+#define WATCH_INTERVAL_MIN 100
+
+/* '0x8a' */
+declare_proto_amp(watch_levels)
+{
+    setting_t levels = AMP_LEVEL_NONE;
+    int interval;
+    int status;
+
+    if (!ampctl_watch_hook)
+    {
+        return -RIG_ENAVAIL;
+    }
+
+    CHKSCN1ARG(sscanf(arg1, "%d", &interval));
+
+    if (interval < 0)
+    {
+        return -RIG_EINVAL;
+    }
+
+    if (interval > 0)
+    {
+        if (interval < WATCH_INTERVAL_MIN)
+        {
+            interval = WATCH_INTERVAL_MIN;
+        }
+
+        status = parse_levels(amp, arg2, &levels);
+
+        if (status != RIG_OK)
+        {
+            return status;
+        }
+    }
+
+    return ampctl_watch_hook(amp, levels, interval);
+}
+
+
 /*
  * Special debugging purpose send command display reply until there's a
  * timeout.
@@ -47,4 +47,12 @@ int set_conf(AMP *my_amp, char *conf_parms);
 
 int ampctl_parse(AMP *my_amp, FILE *fin, FILE *fout, char *argv[], int argc);
 
+void ampctl_print_levels(FILE *fout, const struct amp_level_value *req,
+                         int count, int names);
+int ampctl_read_levels(AMP *amp, setting_t levels,
+                        struct amp_level_value *req);
+
+/* subscribes the client of the running command, 0 interval to stop */
+extern int (*ampctl_watch_hook)(AMP *amp, setting_t levels, int interval);
+
 #endif  /* AMPCTL_PARSE_H */
@@ -35,6 +35,7 @@
 #include <getopt.h>
 #include <errno.h>
 #include <signal.h>
+#include <sys/time.h>
 
 #include <sys/types.h>          /* See NOTES */
 
@@ -65,6 +66,7 @@
 #include "misc.h"
 
 #include "ampctl_parse.h"
+#include "netserver.h"
 
 struct handle_data
 {
@@ -114,6 +116,206 @@ char send_cmd_term = '\r';      /* send_cmd termination char */
 #define MAXCONFLEN 128
 
 
+#ifdef HAVE_NETSERVER
+/* runs until killed, as always */
+static int quit_never(void)
+{
+    return 0;
+}
+
+
+/*
+ * Clients streaming levels, see watch_levels. Only used with the
+ * device lock held, from the netserver ops.
+ */
+struct level_watch
+{
+    struct netserver_client *client;
+    setting_t levels;
+    int interval;               /* ms */
+    int64_t next;               /* ms */
+    struct level_watch *next_watch;
+};
+
+static struct level_watch *watches;
+static struct netserver_client *parse_client;   /* running a command */
+
+
+static int64_t watch_now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+
+static struct level_watch **find_watch(struct netserver_client *client)
+{
+    struct level_watch **pp;
+
+    for (pp = &watches; *pp; pp = &(*pp)->next_watch)
+    {
+        if ((*pp)->client == client)
+        {
+            break;
+        }
+    }
+
+    return pp;
+}
+
+
+static int watch_levels(AMP *amp, setting_t levels, int interval)
+{
+    struct level_watch **pp = find_watch(parse_client);
+    struct level_watch *w = *pp;
+
+    (void) amp;
+
+    if (!interval)
+    {
+        if (w)
+        {
+            *pp = w->next_watch;
+            free(w);
+        }
+
+        return RIG_OK;
+    }
+
+    if (!w)
+    {
+        w = calloc(1, sizeof(struct level_watch));
+
+        if (!w)
+        {
+            return -RIG_ENOMEM;
+        }
+
+        w->client = parse_client;
+        *pp = w;
+    }
+
+    w->levels = levels;
+    w->interval = interval;
+    w->next = watch_now();
+    netserver_wake_tick(parse_client);
+
+    return RIG_OK;
+}
+
+
+/*
+ * Read the levels due to any watcher with one amp_get_levels(), and
+ * send each watcher its own.
+ */
+static int watch_tick(void *dev, void *data)
+{
+    struct amp_level_value req[RIG_SETTING_MAX];
+    struct level_watch *w;
+    setting_t levels = AMP_LEVEL_NONE;
+    int64_t now = watch_now();
+    int64_t wait = 1000;
+    int n, i;
+
+    (void) data;
+
+    for (w = watches; w; w = w->next_watch)
+    {
+        if (w->next <= now)
+        {
+            levels |= w->levels;
+        }
+    }
+
+    n = levels ? ampctl_read_levels(dev, levels, req) : 0;
+
+    for (w = watches; w; w = w->next_watch)
+    {
+        if (w->next <= now)
+        {
+            struct amp_level_value wreq[RIG_SETTING_MAX];
+            char *buf = NULL;
+            size_t len = 0;
+            FILE *fout;
+            int wn = 0;
+
+            for (i = 0; i < n; i++)
+            {
+                if (w->levels & req[i].level)
+                {
+                    wreq[wn++] = req[i];
+                }
+            }
+
+            fout = open_memstream(&buf, &len);
+
+            if (fout)
+            {
+                fprintf(fout, "watch_levels:\n");
+                ampctl_print_levels(fout, wreq, wn, 1);
+                fprintf(fout, NETAMPCTL_RET "0\n");
+                fclose(fout);
+                netserver_send(w->client, buf, len);
+                free(buf);
+            }
+
+            /* no catching up after a slow read */
+            w->next += w->interval;
+
+            if (w->next <= now)
+            {
+                w->next = now + w->interval;
+            }
+        }
+
+        if (w->next - now < wait)
+        {
+            wait = w->next - now;
+        }
+    }
+
+    return (int)wait;
+}
+
+
+static void client_close(struct netserver_client *client)
+{
+    struct level_watch **pp = find_watch(client);
+    struct level_watch *w = *pp;
+
+    if (w)
+    {
+        *pp = w->next_watch;
+        free(w);
+    }
+}
+
+
+static int client_parse(struct netserver_client *client, FILE *fin,
+                        FILE *fout)
+{
+    int retcode;
+
+    parse_client = client;
+    retcode = ampctl_parse(client->dev, fin, fout, NULL, 0);
+    parse_client = NULL;
+
+    return !(retcode == 0 || retcode == 2);
+}
+
+
+static const struct netserver_ops client_ops =
+{
+    .parse = client_parse,
+    .close = client_close,
+    .tick = watch_tick,
+};
+#endif  /* HAVE_NETSERVER */
+
+
 static void handle_error(enum rig_debug_level_e lvl, const char *msg)
 {
     int e;
@@ -168,14 +370,15 @@ int main(int argc, char *argv[])
     int sock_listen;
     int reuseaddr = 1;
     int sockopt;
+#ifndef HAVE_NETSERVER
     char host[NI_MAXHOST];
     char serv[NI_MAXSERV];
-
 #ifdef HAVE_PTHREAD
     pthread_t thread;
     pthread_attr_t attr;
 #endif
     struct handle_data *arg;
+#endif
 
     while (1)
     {
@@ -518,6 +721,12 @@ int main(int argc, char *argv[])
 #endif
 #endif
 
+#ifdef HAVE_NETSERVER
+    ampctl_watch_hook = watch_levels;
+    netserver_listen(sock_listen, &client_ops, my_amp, NULL);
+    netserver_run(NETSERVER_WORKERS, quit_never);
+#else
+
     /*
      * main loop accepting connections
      */
@@ -581,6 +790,8 @@ int main(int argc, char *argv[])
     }
     while (retcode == 0);
 
+#endif  /* !HAVE_NETSERVER */
+
     amp_close(my_amp); /* close port */
     amp_cleanup(my_amp); /* if you care about memory */
 
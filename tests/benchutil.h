@@ -0,0 +1,34 @@
+/*
+ *  Hamlib test tools - timing helpers shared by the benchmarks
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _BENCHUTIL_H
+#define _BENCHUTIL_H 1
+
+/* wall clock, in seconds */
+extern double bench_now(void);
+
+/* qsort() comparison of doubles, ascending */
+extern int bench_cmp_double(const void *a, const void *b);
+
+/* p in percent, of count sorted samples, 0 when there are none */
+extern double bench_percentile(const double *samples, int count, int p);
+
+#endif /* _BENCHUTIL_H */
@@ -44,9 +44,13 @@
  */
 
 extern int all;
+extern int write_channels(RIG *rig, channel_t chans[], int count);
 
 char csv_sep = ','; /* CSV separator */
 
+/* channels written to the rig at once by csv_load */
+#define CSV_LOAD_BLOCK 32
+
 /*
  * Prototypes
  */
@@ -121,7 +125,8 @@ int csv_load(RIG *rig, const char *infilename)
     char *value_list[ 64 ];
     char keys[ 256 ];
     char line[ 256 ];
-    channel_t chan;
+    channel_t chans[ CSV_LOAD_BLOCK ];
+    int nchans = 0;
 
     f = fopen(infilename, "r");
 
@@ -172,20 +177,36 @@ int csv_load(RIG *rig, const char *infilename)
         }
 
         /* Parse a line, write channel data into chan */
-        set_channel_data(rig, &chan, key_list, value_list);
+        set_channel_data(rig, &chans[nchans++], key_list, value_list);
+
+        if (nchans < CSV_LOAD_BLOCK)
+        {
+            continue;
+        }
 
-        /* Write a rig memory */
-        status = rig_set_channel(rig, &chan);
+        /* Write a block of rig memories */
+        status = write_channels(rig, chans, nchans);
+        nchans = 0;
 
         if (status != RIG_OK)
         {
-            fprintf(stderr, "rig_get_channel: error = %s \n", rigerror(status));
+            fprintf(stderr, "write_channels: error = %s \n", rigerror(status));
             fclose(f);
             return status;
         }
 
     }
 
+    if (nchans > 0)
+    {
+        status = write_channels(rig, chans, nchans);
+
+        if (status != RIG_OK)
+        {
+            fprintf(stderr, "write_channels: error = %s \n", rigerror(status));
+        }
+    }
+
     fclose(f);
     return status;
 }
@@ -38,6 +38,8 @@
 static int set_chan(RIG *rig, channel_t *chan, xmlNodePtr node);
 #endif
 
+extern int write_channels(RIG *rig, channel_t chans[], int count);
+
 
 int xml_load(RIG *my_rig, const char *infilename)
 {
@@ -99,11 +101,11 @@ int xml_load(RIG *my_rig, const char *infilename)
 
         set_chan(my_rig, &chan, node);
 
-        status = rig_set_channel(my_rig, &chan);
+        status = write_channels(my_rig, &chan, 1);
 
         if (status != RIG_OK)
         {
-            printf("rig_get_channel: error = %s \n", rigerror(status));
+            printf("write_channels: error = %s \n", rigerror(status));
             return status;
         }
     }
@@ -0,0 +1,520 @@
+/*
+ * memsync.c - Copyright (c) 2020 by the Hamlib Group
+ *
+ * This program exercises the backup and restore of a radio
+ * using Hamlib. Differential restore primitives
+ *
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <hamlib/rig.h>
+
+
+/*
+ * "rigmem sync" loads a file like "rigmem load", but only writes the
+ * channels whose content hash differs from the one cached for the rig,
+ * and clears the cached channels the file does not have any more.
+ * Without a cache, the hashes are first taken from the rig memory.
+ *
+ * The cache only knows what rigmem wrote. Channels edited on the rig
+ * itself are seen once the cache file is removed.
+ */
+
+#define SYNC_BLOCK 32   /* channels read or written at once */
+
+struct sync_slot
+{
+    uint64_t hash;
+    char used;          /* channel holds data */
+    char seen;          /* channel is in the file */
+};
+
+static struct sync_slot *slots;
+static int nslots;      /* highest channel number + 1 */
+static char cache_path[1024];
+static int nwritten;
+
+extern int all;
+
+int sync_begin(RIG *rig, const char *path);
+int sync_end(RIG *rig, int clear);
+int write_channels(RIG *rig, channel_t chans[], int count);
+
+
+#define FNV_PRIME 1099511628211ULL
+
+static uint64_t hash_bytes(uint64_t h, const void *p, size_t len)
+{
+    const unsigned char *c = p;
+
+    while (len--)
+    {
+        h = (h ^ *c++) * FNV_PRIME;
+    }
+
+    return h;
+}
+
+#define HASH(h, field) ((h) = hash_bytes((h), &(field), sizeof(field)))
+
+
+/*
+ * Hashes the fields of chan which the rig stores, as a dump of the
+ * channel would have them. vfo and ext_levels are left out.
+ */
+static uint64_t chan_hash(RIG *rig, const channel_t *chan)
+{
+    static const channel_cap_t mem_cap_all =
+    {
+        .bank_num = 1, .ant = 1, .freq = 1, .mode = 1, .width = 1,
+        .tx_freq = 1, .tx_mode = 1, .tx_width = 1, .split = 1, .tx_vfo = 1,
+        .rptr_shift = 1, .rptr_offs = 1, .tuning_step = 1, .rit = 1,
+        .xit = 1, .funcs = (setting_t) - 1, .levels = (setting_t) - 1,
+        .ctcss_tone = 1, .ctcss_sql = 1, .dcs_code = 1, .dcs_sql = 1,
+        .scan_group = 1, .flags = 1, .channel_desc = 1,
+    };
+    const channel_cap_t *mem_caps = &mem_cap_all;
+    const chan_t *chan_list;
+    uint64_t h = 14695981039346656037ULL;
+    int i;
+
+    chan_list = rig_lookup_mem_caps(rig, chan->channel_num);
+
+    if (chan_list && !all)
+    {
+        mem_caps = &chan_list->mem_caps;
+    }
+
+    HASH(h, chan->channel_num);
+
+    if (mem_caps->bank_num) { HASH(h, chan->bank_num); }
+
+    if (mem_caps->ant) { HASH(h, chan->ant); }
+
+    if (mem_caps->freq) { HASH(h, chan->freq); }
+
+    if (mem_caps->mode) { HASH(h, chan->mode); }
+
+    if (mem_caps->width) { HASH(h, chan->width); }
+
+    if (mem_caps->tx_freq) { HASH(h, chan->tx_freq); }
+
+    if (mem_caps->tx_mode) { HASH(h, chan->tx_mode); }
+
+    if (mem_caps->tx_width) { HASH(h, chan->tx_width); }
+
+    if (mem_caps->split) { HASH(h, chan->split); }
+
+    if (mem_caps->tx_vfo) { HASH(h, chan->tx_vfo); }
+
+    if (mem_caps->rptr_shift) { HASH(h, chan->rptr_shift); }
+
+    if (mem_caps->rptr_offs) { HASH(h, chan->rptr_offs); }
+
+    if (mem_caps->tuning_step) { HASH(h, chan->tuning_step); }
+
+    if (mem_caps->rit) { HASH(h, chan->rit); }
+
+    if (mem_caps->xit) { HASH(h, chan->xit); }
+
+    if (mem_caps->funcs)
+    {
+        setting_t funcs = chan->funcs & mem_caps->funcs;
+
+        HASH(h, funcs);
+    }
+
+    for (i = 0; i < RIG_SETTING_MAX; i++)
+    {
+        setting_t level = rig_idx2setting(i);
+
+        if (!(mem_caps->levels & level))
+        {
+            continue;
+        }
+
+        if (RIG_LEVEL_IS_FLOAT(level))
+        {
+            HASH(h, chan->levels[i].f);
+        }
+        else
+        {
+            HASH(h, chan->levels[i].i);
+        }
+    }
+
+    if (mem_caps->ctcss_tone) { HASH(h, chan->ctcss_tone); }
+
+    if (mem_caps->ctcss_sql) { HASH(h, chan->ctcss_sql); }
+
+    if (mem_caps->dcs_code) { HASH(h, chan->dcs_code); }
+
+    if (mem_caps->dcs_sql) { HASH(h, chan->dcs_sql); }
+
+    if (mem_caps->scan_group) { HASH(h, chan->scan_group); }
+
+    if (mem_caps->flags) { HASH(h, chan->flags); }
+
+    if (mem_caps->channel_desc)
+    {
+        h = hash_bytes(h, chan->channel_desc,
+                       strnlen(chan->channel_desc, MAXCHANDESC));
+    }
+
+    return h;
+}
+
+
+/*
+ * Default cache file, in $RIGMEM_SYNC_DIR or $HOME, named after the
+ * model and what the rig tells about itself, or its port when it does not.
+ */
+static void default_cache_path(RIG *rig, char *path, size_t len)
+{
+    const char *dir = getenv("RIGMEM_SYNC_DIR");
+    const char *id = rig_get_info(rig);
+    uint64_t h = 14695981039346656037ULL;
+
+    if (!dir)
+    {
+        dir = getenv("HOME");
+    }
+
+    if (!dir)
+    {
+        dir = ".";
+    }
+
+    if (!id || !*id)
+    {
+        id = rig->state.rigport.pathname;
+    }
+
+    h = hash_bytes(h, id, strlen(id));
+
+    snprintf(path, len, "%s/.rigmem-%d-%08" PRIx32 ".sync", dir,
+             rig->caps->rig_model, (uint32_t)(h ^ (h >> 32)));
+}
+
+
+static int read_cache(const char *path)
+{
+    FILE *f;
+    char line[80];
+    int n = 0;
+
+    f = fopen(path, "r");
+
+    if (!f)
+    {
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), f))
+    {
+        int num;
+        uint64_t hash;
+
+        if (line[0] == '#'
+                || sscanf(line, "%d %" SCNx64, &num, &hash) != 2
+                || num < 0 || num >= nslots)
+        {
+            continue;
+        }
+
+        slots[num].hash = hash;
+        slots[num].used = 1;
+        n++;
+    }
+
+    fclose(f);
+
+    return n;
+}
+
+
+static int write_cache(RIG *rig, const char *path)
+{
+    FILE *f;
+    int i;
+
+    f = fopen(path, "w");
+
+    if (!f)
+    {
+        return -1;
+    }
+
+    fprintf(f, "# rigmem sync cache, %s %s\n", rig->caps->mfg_name,
+            rig->caps->model_name);
+
+    for (i = 0; i < nslots; i++)
+    {
+        if (slots[i].used)
+        {
+            fprintf(f, "%d %016" PRIx64 "\n", i, slots[i].hash);
+        }
+    }
+
+    return fclose(f);
+}
+
+
+/*
+ * Hashes what the rig memory holds, for a first sync.
+ */
+static int read_rig(RIG *rig)
+{
+    const chan_t *chan_list = rig->state.chan_list;
+    channel_t block[SYNC_BLOCK];
+    int i, j, k, n, ret;
+
+    for (i = 0; i < CHANLSTSIZ && !RIG_IS_CHAN_END(chan_list[i]); i++)
+    {
+        for (j = chan_list[i].startc; j <= chan_list[i].endc; j += n)
+        {
+            n = chan_list[i].endc - j + 1;
+
+            if (n > SYNC_BLOCK)
+            {
+                n = SYNC_BLOCK;
+            }
+
+            memset(block, 0, sizeof(block));
+
+            for (k = 0; k < n; k++)
+            {
+                block[k].vfo = RIG_VFO_MEM;
+                block[k].channel_num = j + k;
+            }
+
+            ret = rig_get_channels(rig, block, n);
+
+            for (k = 0; k < n; k++)
+            {
+                if (ret == RIG_OK && block[k].freq != RIG_FREQ_NONE
+                        && j + k < nslots)
+                {
+                    slots[j + k].hash = chan_hash(rig, &block[k]);
+                    slots[j + k].used = 1;
+                }
+
+                free(block[k].ext_levels);
+            }
+
+            if (ret != RIG_OK)
+            {
+                return ret;
+            }
+        }
+    }
+
+    return RIG_OK;
+}
+
+
+/*
+ * Starts a sync, with the hashes cached in path, or in the default
+ * cache file of the rig when path is NULL.
+ */
+int sync_begin(RIG *rig, const char *path)
+{
+    const chan_t *chan_list = rig->state.chan_list;
+    int i, ret;
+
+    nslots = 0;
+    nwritten = 0;
+
+    for (i = 0; i < CHANLSTSIZ && !RIG_IS_CHAN_END(chan_list[i]); i++)
+    {
+        if (chan_list[i].endc >= nslots)
+        {
+            nslots = chan_list[i].endc + 1;
+        }
+    }
+
+    slots = calloc(nslots ? nslots : 1, sizeof(struct sync_slot));
+
+    if (!slots)
+    {
+        return -RIG_ENOMEM;
+    }
+
+    if (path)
+    {
+        snprintf(cache_path, sizeof(cache_path), "%s", path);
+    }
+    else
+    {
+        default_cache_path(rig, cache_path, sizeof(cache_path));
+    }
+
+    if (read_cache(cache_path) >= 0)
+    {
+        rig_debug(RIG_DEBUG_VERBOSE, "%s: using %s\n", __func__, cache_path);
+        return RIG_OK;
+    }
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: no %s, reading the rig\n", __func__,
+              cache_path);
+
+    ret = read_rig(rig);
+
+    if (ret != RIG_OK)
+    {
+        /* write everything, as rigmem load does */
+        fprintf(stderr, "Cannot read the rig memory (%s), "
+                "every channel will be written\n", rigerror(ret));
+        memset(slots, 0, nslots * sizeof(struct sync_slot));
+    }
+
+    return RIG_OK;
+}
+
+
+/*
+ * Writes the channels of chans which differ from the cache.
+ */
+static int sync_channels(RIG *rig, channel_t chans[], int count)
+{
+    channel_t *changed[SYNC_BLOCK];
+    channel_t block[SYNC_BLOCK];
+    int i, k, n = 0, ret;
+
+    for (i = 0; i < count; i++)
+    {
+        channel_t *chan = &chans[i];
+        int num = chan->channel_num;
+        uint64_t hash = chan_hash(rig, chan);
+
+        if (num >= 0 && num < nslots)
+        {
+            slots[num].seen = 1;
+
+            if (slots[num].used && slots[num].hash == hash)
+            {
+                continue;
+            }
+        }
+
+        changed[n] = chan;
+        block[n++] = *chan;
+    }
+
+    if (!n)
+    {
+        return RIG_OK;
+    }
+
+    ret = rig_set_channels(rig, block, n);
+
+    if (ret != RIG_OK)
+    {
+        return ret;
+    }
+
+    for (k = 0; k < n; k++)
+    {
+        int num = changed[k]->channel_num;
+
+        if (num >= 0 && num < nslots)
+        {
+            slots[num].hash = chan_hash(rig, changed[k]);
+            slots[num].used = 1;
+        }
+    }
+
+    nwritten += n;
+
+    return RIG_OK;
+}
+
+
+/*
+ * Writes the channels read from a file by the loaders, only those which
+ * changed during a sync.
+ */
+int write_channels(RIG *rig, channel_t chans[], int count)
+{
+    if (slots)
+    {
+        return sync_channels(rig, chans, count);
+    }
+
+    return rig_set_channels(rig, chans, count);
+}
+
+
+/*
+ * Clears the channels the file no longer has when clear is set, that is
+ * when the whole file was loaded, and saves the cache.
+ */
+int sync_end(RIG *rig, int clear)
+{
+    channel_t chan;
+    int i, ret = RIG_OK, ncleared = 0;
+
+    memset(&chan, 0, sizeof(chan));
+    chan.freq = RIG_FREQ_NONE;
+    chan.tx_freq = RIG_FREQ_NONE;
+    chan.mode = RIG_MODE_NONE;
+    chan.tx_mode = RIG_MODE_NONE;
+    chan.vfo = RIG_VFO_MEM;
+
+    for (i = 0; clear && i < nslots; i++)
+    {
+        if (!slots[i].used || slots[i].seen)
+        {
+            continue;
+        }
+
+        chan.channel_num = i;
+        ret = rig_set_channel(rig, &chan);
+
+        if (ret != RIG_OK)
+        {
+            break;
+        }
+
+        slots[i].used = 0;
+        ncleared++;
+    }
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: %d channels written, %d cleared\n",
+              __func__, nwritten, ncleared);
+
+    /* keep what was done even when a clear failed */
+    if (write_cache(rig, cache_path) != 0)
+    {
+        fprintf(stderr, "Cannot write %s\n", cache_path);
+    }
+
+    free(slots);
+    slots = NULL;
+
+    return ret;
+}
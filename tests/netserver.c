@@ -0,0 +1,1054 @@
+/*
+ *  Hamlib Interface - event driven server core for the ctld daemons
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "netserver.h"
+
+#ifdef HAVE_NETSERVER
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/time.h>
+#include <netdb.h>
+
+#define NETSERVER_MAX_EVENTS    32
+#define NETSERVER_MAX_INPUT     65536   /* hang up on longer lines */
+#define NETSERVER_READ_SIZE     4096
+#define NETSERVER_MAX_OUTPUT    65536   /* drop pushes beyond this */
+#define NETSERVER_TICK_MAX      1000    /* ms */
+
+/*
+ * Every object registered with epoll starts with its kind,
+ * so the event loop knows what woke it up.
+ */
+enum netserver_kind
+{
+    NS_WAKEUP,
+    NS_LISTENER,
+    NS_CONN
+};
+
+struct netserver_listener
+{
+    enum netserver_kind kind;
+    int sock;
+    const struct netserver_ops *ops;
+    void *dev;
+    void *data;
+    pthread_mutex_t lock;       /* serializes access to dev */
+    pthread_cond_t tick_cond;   /* wakes the tick thread, with lock */
+    pthread_t tick_thread;
+    int tick_started;
+    int tick_wake;              /* run ops->tick() now */
+    int tick_stop;
+
+    /* connections waiting for the device, ns_mutex held */
+    struct netserver_conn *work_head, *work_tail;
+    int queued;                 /* on the ready queue */
+    int running;                /* a worker has the device */
+
+    struct netserver_listener *next;    /* all listeners */
+    struct netserver_listener *qnext;   /* ready queue */
+};
+
+struct netserver_conn
+{
+    enum netserver_kind kind;
+    struct netserver_client client;     /* what the daemon sees */
+    struct netserver_listener *lsn;
+    int fd;
+    char host[NI_MAXHOST];
+    char serv[NI_MAXSERV];
+
+    char *in;                   /* received, not yet parsed */
+    size_t in_len, in_size;
+    char *out;                  /* answers, not yet sent */
+    size_t out_len, out_size;
+    unsigned events;            /* epoll events armed, 0 if none */
+
+    int opened;                 /* ops->open() was called */
+    int closed;                 /* ops->close() was called */
+    int eof;                    /* nothing more to read */
+    int error;                  /* socket error, nothing can be sent */
+    int hangup;                 /* parse asked to close */
+    int busy;                   /* owned by a worker */
+
+    struct netserver_conn *next;        /* all connections */
+    struct netserver_conn *qnext;       /* device or done queue */
+};
+
+static struct netserver_listener *listeners;
+static struct netserver_conn *conns;
+
+/*
+ * protects the connection buffers, flags, and the queues.
+ * The workers pick devices, not connections, from the ready queue,
+ * so a slow device never has them all waiting on its lock while
+ * the clients of the others have work.
+ */
+static pthread_mutex_t ns_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ns_cond = PTHREAD_COND_INITIALIZER;
+static struct netserver_listener *ready_head, *ready_tail;
+static struct netserver_conn *done_head;
+static int ns_running;
+static int ns_pushed;           /* netserver_send() queued output */
+
+static int ns_epfd = -1;
+static int ns_pipe[2] = { -1, -1 };
+static enum netserver_kind ns_wakeup_kind = NS_WAKEUP;
+
+
+static int set_nonblock(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+
+    if (flags < 0)
+    {
+        return -1;
+    }
+
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+
+static void ns_wakeup(void)
+{
+    char c = 0;
+
+    if (write(ns_pipe[1], &c, 1) < 0 && errno != EAGAIN)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: write: %s\n", __func__, strerror(errno));
+    }
+}
+
+
+static int buf_append(char **buf, size_t *len, size_t *size,
+                      const char *data, size_t n)
+{
+    if (*len + n > *size)
+    {
+        size_t nsize = *size ? *size : NETSERVER_READ_SIZE;
+        char *p;
+
+        while (nsize < *len + n)
+        {
+            nsize *= 2;
+        }
+
+        p = realloc(*buf, nsize);
+
+        if (!p)
+        {
+            return -1;
+        }
+
+        *buf = p;
+        *size = nsize;
+    }
+
+    memcpy(*buf + *len, data, n);
+    *len += n;
+
+    return 0;
+}
+
+
+/* length of the complete lines in the input buffer, ns_mutex held */
+static size_t complete_lines(const struct netserver_conn *c)
+{
+    size_t n = c->in_len;
+
+    while (n > 0 && c->in[n - 1] != '\n' && c->in[n - 1] != '\r')
+    {
+        n--;
+    }
+
+    return n;
+}
+
+
+/* queue the device for a worker, unless it has one, ns_mutex held */
+static void lsn_ready(struct netserver_listener *lsn)
+{
+    if (lsn->queued || lsn->running || !lsn->work_head)
+    {
+        return;
+    }
+
+    lsn->queued = 1;
+    lsn->qnext = NULL;
+
+    if (ready_tail)
+    {
+        ready_tail->qnext = lsn;
+    }
+    else
+    {
+        ready_head = lsn;
+    }
+
+    ready_tail = lsn;
+    pthread_cond_signal(&ns_cond);
+}
+
+
+/* queue the connection on its device if it has work, ns_mutex held */
+static void schedule(struct netserver_conn *c)
+{
+    struct netserver_listener *lsn = c->lsn;
+
+    if (c->busy || c->closed)
+    {
+        return;
+    }
+
+    if (c->opened && !c->eof && !c->hangup && !complete_lines(c))
+    {
+        return;
+    }
+
+    c->busy = 1;
+    c->qnext = NULL;
+
+    if (lsn->work_tail)
+    {
+        lsn->work_tail->qnext = c;
+    }
+    else
+    {
+        lsn->work_head = c;
+    }
+
+    lsn->work_tail = c;
+    lsn_ready(lsn);
+}
+
+
+/*
+ * Feed the complete lines of a client to the daemon's parser.
+ * Runs in a worker, with the connection marked busy.
+ */
+static void process_conn(struct netserver_conn *c)
+{
+    struct netserver_listener *lsn = c->lsn;
+    char *buf = NULL;
+    size_t len;
+    char *obuf = NULL;
+    size_t olen = 0;
+    size_t consumed = 0;
+    int eof, hangup;
+    FILE *fin = NULL, *fout;
+
+    pthread_mutex_lock(&ns_mutex);
+    eof = c->eof;
+    hangup = c->hangup;
+    len = eof ? c->in_len : complete_lines(c);
+
+    if (len > 0)
+    {
+        buf = malloc(len);
+
+        if (buf)
+        {
+            memcpy(buf, c->in, len);
+        }
+        else
+        {
+            len = 0;
+        }
+    }
+
+    pthread_mutex_unlock(&ns_mutex);
+
+    fout = open_memstream(&obuf, &olen);
+
+    if (len > 0 && !lsn->ops->parse_buf)
+    {
+        fin = fmemopen(buf, len, "r");
+    }
+
+    pthread_mutex_lock(&lsn->lock);
+
+    if (!c->opened)
+    {
+        if (lsn->ops->open)
+        {
+            lsn->ops->open(&c->client);
+        }
+
+        c->opened = 1;
+    }
+
+    while ((fin || (buf && lsn->ops->parse_buf)) && fout && !hangup)
+    {
+        int retcode;
+        size_t used = 0;
+
+        /* blank lines between commands */
+        while (consumed < len && strchr(" \t\r\n", buf[consumed]))
+        {
+            consumed++;
+        }
+
+        if (consumed == len)
+        {
+            break;
+        }
+
+        if (lsn->ops->parse_buf)
+        {
+            retcode = lsn->ops->parse_buf(&c->client, buf + consumed,
+                                          len - consumed, &used, fout);
+        }
+        else
+        {
+            fseek(fin, consumed, SEEK_SET);
+            clearerr(fin);
+
+            retcode = lsn->ops->parse(&c->client, fin, fout);
+
+            if (!feof(fin))
+            {
+                used = ftell(fin) - consumed;
+            }
+        }
+
+        if (used == 0)
+        {
+            /* command not complete yet, unless the peer is gone */
+            if (eof)
+            {
+                consumed = len;
+            }
+
+            break;
+        }
+
+        consumed += used;
+
+        if (retcode != 0)
+        {
+            hangup = 1;
+        }
+    }
+
+    if (fout)
+    {
+        fflush(fout);
+    }
+
+    if ((eof || hangup || !fout) && !c->closed)
+    {
+        if (lsn->ops->close)
+        {
+            lsn->ops->close(&c->client);
+        }
+
+        c->closed = 1;
+    }
+
+    if (fin)
+    {
+        fclose(fin);
+    }
+
+    if (fout)
+    {
+        fclose(fout);
+    }
+
+    /* queue the answers before anything ops->tick() pushes next */
+    pthread_mutex_lock(&ns_mutex);
+    pthread_mutex_unlock(&lsn->lock);
+
+    if (c->closed)
+    {
+        c->in_len = 0;
+    }
+    else if (consumed > 0)
+    {
+        memmove(c->in, c->in + consumed, c->in_len - consumed);
+        c->in_len -= consumed;
+    }
+
+    if (olen > 0 && buf_append(&c->out, &c->out_len, &c->out_size,
+                               obuf, olen) < 0)
+    {
+        c->eof = c->error = 1;
+    }
+
+    c->hangup |= hangup;
+    c->qnext = done_head;
+    done_head = c;
+    ns_wakeup();
+
+    pthread_mutex_unlock(&ns_mutex);
+
+    free(obuf);
+    free(buf);
+}
+
+
+static void *worker(void *arg)
+{
+    (void) arg;
+
+    pthread_mutex_lock(&ns_mutex);
+
+    while (ns_running)
+    {
+        struct netserver_listener *lsn = ready_head;
+        struct netserver_conn *c;
+
+        if (!lsn)
+        {
+            pthread_cond_wait(&ns_cond, &ns_mutex);
+            continue;
+        }
+
+        ready_head = lsn->qnext;
+
+        if (!ready_head)
+        {
+            ready_tail = NULL;
+        }
+
+        /* one connection per turn, the other devices go in between */
+        c = lsn->work_head;
+        lsn->work_head = c->qnext;
+
+        if (!lsn->work_head)
+        {
+            lsn->work_tail = NULL;
+        }
+
+        lsn->queued = 0;
+        lsn->running = 1;
+
+        pthread_mutex_unlock(&ns_mutex);
+        process_conn(c);
+        pthread_mutex_lock(&ns_mutex);
+
+        lsn->running = 0;
+        lsn_ready(lsn);
+    }
+
+    pthread_mutex_unlock(&ns_mutex);
+
+    return NULL;
+}
+
+
+/*
+ * Only watch for what we still expect, as level triggered epoll
+ * would keep reporting a closed socket as readable.
+ */
+static void update_events(struct netserver_conn *c)
+{
+    struct epoll_event ev;
+    unsigned events = 0;
+
+    if (!c->eof)
+    {
+        events |= EPOLLIN;
+    }
+
+    if (c->out_len > 0 && !c->error)
+    {
+        events |= EPOLLOUT;
+    }
+
+    if (events == c->events)
+    {
+        return;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.ptr = c;
+
+    if (!events)
+    {
+        epoll_ctl(ns_epfd, EPOLL_CTL_DEL, c->fd, NULL);
+    }
+    else
+    {
+        epoll_ctl(ns_epfd, c->events ? EPOLL_CTL_MOD : EPOLL_CTL_ADD,
+                  c->fd, &ev);
+    }
+
+    c->events = events;
+}
+
+
+/* send what we can of the answers, ns_mutex held */
+static void flush_out(struct netserver_conn *c)
+{
+    while (c->out_len > 0 && !c->error)
+    {
+        ssize_t n = send(c->fd, c->out, c->out_len, MSG_NOSIGNAL);
+
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                c->eof = c->error = 1;
+            }
+
+            break;
+        }
+
+        memmove(c->out, c->out + n, c->out_len - n);
+        c->out_len -= n;
+    }
+
+    if (c->error)
+    {
+        c->out_len = 0;
+    }
+
+    update_events(c);
+}
+
+
+static void read_in(struct netserver_conn *c)
+{
+    char buf[NETSERVER_READ_SIZE];
+
+    while (!c->eof)
+    {
+        ssize_t n = recv(c->fd, buf, sizeof(buf), 0);
+
+        if (n == 0)
+        {
+            c->eof = 1;
+        }
+        else if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                c->eof = c->error = 1;
+            }
+
+            break;
+        }
+        else if (c->in_len + n > NETSERVER_MAX_INPUT
+                 || buf_append(&c->in, &c->in_len, &c->in_size, buf, n) < 0)
+        {
+            rig_debug(RIG_DEBUG_WARN, "%s: input overflow from %s:%s\n",
+                      __func__, c->host, c->serv);
+            c->eof = c->error = 1;
+        }
+    }
+}
+
+
+static void accept_conns(struct netserver_listener *lsn)
+{
+    while (1)
+    {
+        struct sockaddr_storage cli_addr;
+        socklen_t clilen = sizeof(cli_addr);
+        struct netserver_conn *c;
+        struct epoll_event ev;
+        int retcode;
+        int fd;
+
+        fd = accept(lsn->sock, (struct sockaddr *)&cli_addr, &clilen);
+
+        if (fd < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                rig_debug(RIG_DEBUG_ERR, "%s: accept: %s\n",
+                          __func__, strerror(errno));
+            }
+
+            return;
+        }
+
+        c = calloc(1, sizeof(struct netserver_conn));
+
+        if (!c || set_nonblock(fd) < 0)
+        {
+            rig_debug(RIG_DEBUG_ERR, "%s: cannot set up connection\n",
+                      __func__);
+            free(c);
+            close(fd);
+            continue;
+        }
+
+        c->kind = NS_CONN;
+        c->client.dev = lsn->dev;
+        c->client.data = lsn->data;
+        c->lsn = lsn;
+        c->fd = fd;
+
+        if ((retcode = getnameinfo((struct sockaddr const *)&cli_addr,
+                                   clilen,
+                                   c->host,
+                                   sizeof(c->host),
+                                   c->serv,
+                                   sizeof(c->serv),
+                                   NI_NOFQDN))
+                < 0)
+        {
+            rig_debug(RIG_DEBUG_WARN, "Peer lookup error: %s",
+                      gai_strerror(retcode));
+        }
+
+        rig_debug(RIG_DEBUG_VERBOSE, "Connection opened from %s:%s\n",
+                  c->host, c->serv);
+
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.ptr = c;
+        c->events = EPOLLIN;
+
+        if (epoll_ctl(ns_epfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+        {
+            rig_debug(RIG_DEBUG_ERR, "%s: epoll_ctl: %s\n",
+                      __func__, strerror(errno));
+            free(c);
+            close(fd);
+            continue;
+        }
+
+        pthread_mutex_lock(&ns_mutex);
+        c->next = conns;
+        conns = c;
+        schedule(c);        /* let the daemon open the device */
+        pthread_mutex_unlock(&ns_mutex);
+    }
+}
+
+
+static void free_conn(struct netserver_conn *c)
+{
+    rig_debug(RIG_DEBUG_VERBOSE, "Connection closed from %s:%s\n",
+              c->host, c->serv);
+
+    if (c->events)
+    {
+        epoll_ctl(ns_epfd, EPOLL_CTL_DEL, c->fd, NULL);
+    }
+
+    close(c->fd);
+    free(c->in);
+    free(c->out);
+    free(c);
+}
+
+
+/* drop connections that are done with, ns_mutex held */
+static void reap_conns(void)
+{
+    struct netserver_conn **pp = &conns;
+
+    while (*pp)
+    {
+        struct netserver_conn *c = *pp;
+
+        if (c->busy || !c->closed || c->out_len > 0)
+        {
+            pp = &c->next;
+            continue;
+        }
+
+        *pp = c->next;
+        free_conn(c);
+    }
+}
+
+
+static void *tick_loop(void *arg)
+{
+    struct netserver_listener *lsn = arg;
+
+    pthread_mutex_lock(&lsn->lock);
+
+    while (!lsn->tick_stop)
+    {
+        struct timeval tv;
+        struct timespec ts;
+        long ms;
+
+        lsn->tick_wake = 0;
+        ms = lsn->ops->tick(lsn->dev, lsn->data);
+
+        if (ms <= 0 || ms > NETSERVER_TICK_MAX)
+        {
+            ms = NETSERVER_TICK_MAX;
+        }
+
+        gettimeofday(&tv, NULL);
+        ts.tv_sec = tv.tv_sec + ms / 1000;
+        ts.tv_nsec = tv.tv_usec * 1000L + (ms % 1000) * 1000000L;
+
+        if (ts.tv_nsec >= 1000000000L)
+        {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+
+        while (!lsn->tick_stop && !lsn->tick_wake
+                && pthread_cond_timedwait(&lsn->tick_cond, &lsn->lock,
+                                          &ts) != ETIMEDOUT)
+        {
+            ;
+        }
+    }
+
+    pthread_mutex_unlock(&lsn->lock);
+
+    return NULL;
+}
+
+
+static struct netserver_conn *client_conn(struct netserver_client *client)
+{
+    return (struct netserver_conn *)((char *)client
+                                     - offsetof(struct netserver_conn, client));
+}
+
+
+/*
+ * Queue data for a client outside of the answers to its commands.
+ * To be called from the ops, with the device lock held, so the client
+ * cannot go away meanwhile; the data is not mixed with an answer.
+ */
+int netserver_send(struct netserver_client *client, const char *buf,
+                   size_t len)
+{
+    struct netserver_conn *c = client_conn(client);
+    int retcode = RIG_OK;
+
+    pthread_mutex_lock(&ns_mutex);
+
+    if (c->closed || c->error)
+    {
+        retcode = -RIG_EIO;
+    }
+    else if (c->out_len + len > NETSERVER_MAX_OUTPUT)
+    {
+        /* not reading, it will get the next ones */
+        rig_debug(RIG_DEBUG_WARN, "%s: output overflow to %s:%s\n",
+                  __func__, c->host, c->serv);
+        retcode = -RIG_EIO;
+    }
+    else if (buf_append(&c->out, &c->out_len, &c->out_size, buf, len) < 0)
+    {
+        c->eof = c->error = 1;
+        retcode = -RIG_ENOMEM;
+    }
+    else
+    {
+        ns_pushed = 1;
+    }
+
+    ns_wakeup();
+    pthread_mutex_unlock(&ns_mutex);
+
+    return retcode;
+}
+
+
+/*
+ * Have ops->tick() run as soon as the device is free, e.g. when a
+ * command changed what it pushes. Called from the ops.
+ */
+void netserver_wake_tick(struct netserver_client *client)
+{
+    struct netserver_listener *lsn = client_conn(client)->lsn;
+
+    lsn->tick_wake = 1;
+    pthread_cond_signal(&lsn->tick_cond);
+}
+
+
+/*
+ * Register a listening socket. Clients accepted on it are served
+ * with ops, and share one lock around dev.
+ */
+int netserver_listen(int sock, const struct netserver_ops *ops,
+                     void *dev, void *data)
+{
+    struct netserver_listener *lsn;
+
+    if (!ops || (!ops->parse && !ops->parse_buf))
+    {
+        return -RIG_EINVAL;
+    }
+
+    lsn = calloc(1, sizeof(struct netserver_listener));
+
+    if (!lsn)
+    {
+        return -RIG_ENOMEM;
+    }
+
+    if (set_nonblock(sock) < 0)
+    {
+        free(lsn);
+        return -RIG_EIO;
+    }
+
+    lsn->kind = NS_LISTENER;
+    lsn->sock = sock;
+    lsn->ops = ops;
+    lsn->dev = dev;
+    lsn->data = data;
+    pthread_mutex_init(&lsn->lock, NULL);
+    pthread_cond_init(&lsn->tick_cond, NULL);
+    lsn->next = listeners;
+    listeners = lsn;
+
+    return RIG_OK;
+}
+
+
+/*
+ * Serve the registered listeners until quit() returns non zero,
+ * checked at least once a second. Clients still connected then are
+ * closed through their ops->close().
+ */
+int netserver_run(int nworkers, int (*quit)(void))
+{
+    struct epoll_event events[NETSERVER_MAX_EVENTS];
+    struct epoll_event ev;
+    struct netserver_listener *lsn;
+    struct netserver_conn *c;
+    pthread_t *workers;
+    int nstarted = 0;
+    int i, n;
+
+    if (nworkers < 1)
+    {
+        nworkers = NETSERVER_WORKERS;
+    }
+
+    workers = calloc(nworkers, sizeof(pthread_t));
+
+    if (!workers)
+    {
+        return -RIG_ENOMEM;
+    }
+
+    ns_epfd = epoll_create(NETSERVER_MAX_EVENTS);
+
+    if (ns_epfd < 0 || pipe(ns_pipe) < 0)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: %s\n", __func__, strerror(errno));
+        free(workers);
+        return -RIG_EINTERNAL;
+    }
+
+    set_nonblock(ns_pipe[0]);
+    set_nonblock(ns_pipe[1]);
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = &ns_wakeup_kind;
+    epoll_ctl(ns_epfd, EPOLL_CTL_ADD, ns_pipe[0], &ev);
+
+    for (lsn = listeners; lsn; lsn = lsn->next)
+    {
+        ev.data.ptr = lsn;
+        epoll_ctl(ns_epfd, EPOLL_CTL_ADD, lsn->sock, &ev);
+    }
+
+    ns_running = 1;
+
+    for (i = 0; i < nworkers; i++)
+    {
+        if (pthread_create(&workers[i], NULL, worker, NULL) != 0)
+        {
+            rig_debug(RIG_DEBUG_ERR, "%s: pthread_create failed\n", __func__);
+            break;
+        }
+
+        nstarted++;
+    }
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: serving with %d workers\n", __func__,
+              nstarted);
+
+    for (lsn = listeners; lsn && nstarted > 0; lsn = lsn->next)
+    {
+        if (lsn->ops->tick
+                && pthread_create(&lsn->tick_thread, NULL, tick_loop, lsn) == 0)
+        {
+            lsn->tick_started = 1;
+        }
+    }
+
+    while (nstarted > 0 && !quit())
+    {
+        n = epoll_wait(ns_epfd, events, NETSERVER_MAX_EVENTS, 1000);
+
+        if (n < 0 && errno != EINTR)
+        {
+            rig_debug(RIG_DEBUG_ERR, "%s: epoll_wait: %s\n", __func__,
+                      strerror(errno));
+            break;
+        }
+
+        for (i = 0; i < n; i++)
+        {
+            enum netserver_kind *kind = events[i].data.ptr;
+
+            if (*kind == NS_WAKEUP)
+            {
+                char buf[64];
+
+                while (read(ns_pipe[0], buf, sizeof(buf)) > 0)
+                {
+                    ;
+                }
+            }
+            else if (*kind == NS_LISTENER)
+            {
+                accept_conns((struct netserver_listener *)kind);
+            }
+            else
+            {
+                c = (struct netserver_conn *)kind;
+
+                pthread_mutex_lock(&ns_mutex);
+
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                {
+                    read_in(c);
+                }
+
+                flush_out(c);
+                schedule(c);
+                pthread_mutex_unlock(&ns_mutex);
+            }
+        }
+
+        /* connections handed back by the workers */
+        pthread_mutex_lock(&ns_mutex);
+
+        if (ns_pushed)
+        {
+            ns_pushed = 0;
+
+            for (c = conns; c; c = c->next)
+            {
+                if (c->out_len > 0)
+                {
+                    flush_out(c);
+                }
+            }
+        }
+
+        while (done_head)
+        {
+            c = done_head;
+            done_head = c->qnext;
+            c->busy = 0;
+            flush_out(c);
+            schedule(c);
+        }
+
+        reap_conns();
+        pthread_mutex_unlock(&ns_mutex);
+    }
+
+    /* let the workers finish their current command */
+    pthread_mutex_lock(&ns_mutex);
+    ns_running = 0;
+    pthread_cond_broadcast(&ns_cond);
+    pthread_mutex_unlock(&ns_mutex);
+
+    for (i = 0; i < nstarted; i++)
+    {
+        pthread_join(workers[i], NULL);
+    }
+
+    for (lsn = listeners; lsn; lsn = lsn->next)
+    {
+        if (lsn->tick_started)
+        {
+            pthread_mutex_lock(&lsn->lock);
+            lsn->tick_stop = 1;
+            pthread_cond_signal(&lsn->tick_cond);
+            pthread_mutex_unlock(&lsn->lock);
+            pthread_join(lsn->tick_thread, NULL);
+            lsn->tick_started = 0;
+        }
+    }
+
+    free(workers);
+
+    while (conns)
+    {
+        c = conns;
+        conns = c->next;
+
+        if (c->opened && !c->closed && c->lsn->ops->close)
+        {
+            c->lsn->ops->close(&c->client);
+        }
+
+        free_conn(c);
+    }
+
+    ready_head = ready_tail = NULL;
+    done_head = NULL;
+
+    for (lsn = listeners; lsn; lsn = lsn->next)
+    {
+        lsn->work_head = lsn->work_tail = NULL;
+        lsn->queued = lsn->running = 0;
+    }
+
+    close(ns_pipe[0]);
+    close(ns_pipe[1]);
+    close(ns_epfd);
+    ns_epfd = -1;
+
+    return RIG_OK;
+}
+
+#endif  /* HAVE_NETSERVER */
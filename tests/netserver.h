@@ -0,0 +1,87 @@
+/*
+ *  Hamlib Interface - event driven server core for the ctld daemons header
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef _NETSERVER_H
+#define _NETSERVER_H 1
+
+#include <stdio.h>
+#include <hamlib/rig.h>
+
+/*
+ * One thread multiplexes all the client sockets with epoll, and a
+ * bounded pool of workers runs the commands. Where this is not
+ * available, the daemons keep their thread per client loop.
+ */
+#if defined(HAVE_PTHREAD) && defined(HAVE_SYS_EPOLL_H) \
+    && defined(HAVE_FMEMOPEN) && defined(HAVE_OPEN_MEMSTREAM)
+#  define HAVE_NETSERVER 1
+#endif
+
+#define NETSERVER_WORKERS   4       /* default worker pool size */
+
+__BEGIN_DECLS
+
+/*
+ * What the daemon sees of a client connection
+ */
+struct netserver_client
+{
+    void *dev;      /* device handle given to netserver_listen() */
+    void *data;     /* listener data given to netserver_listen() */
+    void *priv;     /* per connection, owned by the daemon */
+};
+
+/*
+ * Daemon hooks. All of them are called from a worker thread with the
+ * device lock of the listener held, so at most one runs per device.
+ */
+struct netserver_ops
+{
+    /* a client connected */
+    void (*open)(struct netserver_client *client);
+    /* parse and run one command, return 0 to go on, else to hang up */
+    int (*parse)(struct netserver_client *client, FILE *fin, FILE *fout);
+    /* the client is gone */
+    void (*close)(struct netserver_client *client);
+    /*
+     * optional, preferred to parse: the same on the received bytes,
+     * *used left 0 if the command is not complete yet
+     */
+    int (*parse_buf)(struct netserver_client *client, const char *buf,
+                     size_t len, size_t *used, FILE *fout);
+    /*
+     * optional, run from a thread of its own, for the daemon to push
+     * data to its clients with netserver_send(). Returns in how many ms
+     * to run it again, at most a second.
+     */
+    int (*tick)(void *dev, void *data);
+};
+
+int netserver_listen(int sock, const struct netserver_ops *ops,
+                     void *dev, void *data);
+int netserver_send(struct netserver_client *client, const char *buf,
+                   size_t len);
+void netserver_wake_tick(struct netserver_client *client);
+int netserver_run(int nworkers, int (*quit)(void));
+
+__END_DECLS
+
+#endif  /* _NETSERVER_H */
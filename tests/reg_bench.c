@@ -0,0 +1,149 @@
+/*
+ * Hamlib reg_bench program
+ *
+ * Measures the startup cost of the model registries: opening a single
+ * model from cold, loading every backend as "rigctl -l" does, and
+ * looking models up once they are registered.
+ *
+ * Usage: reg_bench [lookup rounds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <hamlib/rig.h>
+#include <hamlib/rotator.h>
+#include <hamlib/amplifier.h>
+#include "benchutil.h"
+
+#define LOOKUP_ROUNDS 1000
+#define MAX_MODELS 2048
+
+
+static int models[MAX_MODELS];
+static int nmodels;
+
+
+static int collect_rig(const struct rig_caps *caps, rig_ptr_t data)
+{
+    if (nmodels < MAX_MODELS)
+    {
+        models[nmodels++] = caps->rig_model;
+    }
+
+    return 1;
+}
+
+
+static int collect_rot(const struct rot_caps *caps, rig_ptr_t data)
+{
+    if (nmodels < MAX_MODELS)
+    {
+        models[nmodels++] = caps->rot_model;
+    }
+
+    return 1;
+}
+
+
+static int collect_amp(const struct amp_caps *caps, rig_ptr_t data)
+{
+    if (nmodels < MAX_MODELS)
+    {
+        models[nmodels++] = caps->amp_model;
+    }
+
+    return 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+    int rounds = LOOKUP_ROUNDS;
+    unsigned long found = 0;
+    RIG *rig;
+    double t;
+    int i, j;
+
+    if (argc > 1)
+    {
+        rounds = atoi(argv[1]);
+    }
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    /* what an application driving a single radio pays */
+    t = bench_now();
+    rig = rig_init(RIG_MODEL_DUMMY);
+    t = bench_now() - t;
+    rig_cleanup(rig);
+    printf("rig_init, cold:          %8.1f us\n", t * 1e6);
+
+    t = bench_now();
+    rig_load_all_backends();
+    t = bench_now() - t;
+    printf("rig_load_all_backends:   %8.1f us\n", t * 1e6);
+
+    t = bench_now();
+    nmodels = 0;
+    rig_list_foreach(collect_rig, NULL);
+    t = bench_now() - t;
+    printf("rig_list_foreach:        %8.1f us, %d models\n", t * 1e6, nmodels);
+
+    t = bench_now();
+
+    for (j = 0; j < rounds; j++)
+    {
+        for (i = 0; i < nmodels; i++)
+        {
+            found += rig_get_caps(models[i]) != NULL;
+        }
+    }
+
+    t = bench_now() - t;
+    printf("rig_get_caps:            %8.1f ns\n",
+           t * 1e9 / ((double)rounds * nmodels));
+
+    t = bench_now();
+    rot_load_all_backends();
+    t = bench_now() - t;
+    nmodels = 0;
+    rot_list_foreach(collect_rot, NULL);
+    printf("rot_load_all_backends:   %8.1f us, %d models\n", t * 1e6, nmodels);
+
+    t = bench_now();
+
+    for (j = 0; j < rounds; j++)
+    {
+        for (i = 0; i < nmodels; i++)
+        {
+            found += rot_get_caps(models[i]) != NULL;
+        }
+    }
+
+    t = bench_now() - t;
+    printf("rot_get_caps:            %8.1f ns\n",
+           t * 1e9 / ((double)rounds * nmodels));
+
+    t = bench_now();
+    amp_load_all_backends();
+    t = bench_now() - t;
+    nmodels = 0;
+    amp_list_foreach(collect_amp, NULL);
+    printf("amp_load_all_backends:   %8.1f us, %d models\n", t * 1e6, nmodels);
+
+    t = bench_now();
+
+    for (j = 0; j < rounds; j++)
+    {
+        for (i = 0; i < nmodels; i++)
+        {
+            found += amp_get_caps(models[i]) != NULL;
+        }
+    }
+
+    t = bench_now() - t;
+    printf("amp_get_caps:            %8.1f ns\n",
+           t * 1e9 / ((double)rounds * nmodels));
+
+    return found ? 0 : 1;
+}
@@ -0,0 +1,1024 @@
+/*
+ * rigbench.c - Copyright (c) 2020 by the Hamlib Group
+ *
+ * This program measures the latency and throughput of a radio, or of
+ * a rigctld through netrigctl, under a few typical workloads.
+ *
+ * With -S, the radio is one of the simulators of rigsim.c, so the
+ * transaction code of the backends can be measured, and regression
+ * tested, without hardware. -Z only starts the simulator and prints its
+ * pseudo terminal, to be used with rigctl and friends until interrupted.
+ *
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <signal.h>
+
+#include <hamlib/rig.h>
+#include "rigsim.h"
+#include "benchutil.h"
+
+
+/*
+ * Each workload is a list of operations. On every iteration, each
+ * operation whose period divides the iteration number is run once and
+ * timed, along with the bytes the port sent and received meanwhile.
+ */
+
+#define MAXCONFLEN 128
+#define MAX_OPS 6
+#define DEFAULT_COUNT 100
+#define MEM_BLOCK 32            /* channels per get_channels call */
+
+struct bench_ctx
+{
+    freq_t freq;                /* where the rig was at the start */
+    setting_t level;            /* the level the poll reads, or 0 */
+    int mem_start, mem_count;   /* channels of the memory workload */
+    channel_t chans[MEM_BLOCK];
+};
+
+typedef int (*op_fn)(RIG *rig, struct bench_ctx *ctx, int i);
+
+struct op_def
+{
+    const char *name;
+    op_fn fn;
+    int every;
+    int (*avail)(const struct bench_ctx *ctx);  /* NULL when always run */
+};
+
+struct op_stats
+{
+    const struct op_def *def;
+    int count;
+    int errors;
+    double *samples;            /* seconds, sorted once done */
+    double total;               /* seconds spent in the operation */
+    unsigned long tx_bytes, rx_bytes;
+    unsigned long syscalls;
+};
+
+struct workload
+{
+    const char *name;
+    const char *desc;
+    int (*setup)(RIG *rig, struct bench_ctx *ctx);
+    void (*cleanup)(RIG *rig, struct bench_ctx *ctx);
+    struct op_def ops[MAX_OPS];
+};
+
+struct workload_result
+{
+    const struct workload *wl;
+    const char *skipped;        /* why, when it did not run */
+    double elapsed;
+    int nb_ops;
+    struct op_stats ops[MAX_OPS];
+};
+
+
+/*
+ * The operations
+ */
+
+static int op_get_freq(RIG *rig, struct bench_ctx *ctx, int i)
+{
+    freq_t freq;
+
+    return rig_get_freq(rig, RIG_VFO_CURR, &freq);
+}
+
+static int op_set_freq(RIG *rig, struct bench_ctx *ctx, int i)
+{
+    /* sweep 100 kHz up from the start, 100 Hz at a time */
+    return rig_set_freq(rig, RIG_VFO_CURR, ctx->freq + (i % 1000) * 100);
+}
+
+static int op_get_mode(RIG *rig, struct bench_ctx *ctx, int i)
+{
+    rmode_t mode;
+    pbwidth_t width;
+
+    return rig_get_mode(rig, RIG_VFO_CURR, &mode, &width);
+}
+
+static int op_get_ptt(RIG *rig, struct bench_ctx *ctx, int i)
+{
+    ptt_t ptt;
+
+    return rig_get_ptt(rig, RIG_VFO_CURR, &ptt);
+}
+
+static int op_get_level(RIG *rig, struct bench_ctx *ctx, int i)
+{
+    value_t val;
+
+    return rig_get_level(rig, RIG_VFO_CURR, ctx->level, &val);
+}
+
+static int has_level(const struct bench_ctx *ctx)
+{
+    return ctx->level != 0;
+}
+
+static int op_get_channel(RIG *rig, struct bench_ctx *ctx, int i)
+{
+    channel_t *chan = &ctx->chans[0];
+
+    memset(chan, 0, sizeof(*chan));
+    chan->vfo = RIG_VFO_MEM;
+    chan->channel_num = ctx->mem_start + i % ctx->mem_count;
+
+    return rig_get_channel(rig, chan);
+}
+
+static int op_get_channels(RIG *rig, struct bench_ctx *ctx, int i)
+{
+    int n = ctx->mem_count < MEM_BLOCK ? ctx->mem_count : MEM_BLOCK;
+    int j;
+
+    memset(ctx->chans, 0, sizeof(ctx->chans));
+
+    for (j = 0; j < n; j++)
+    {
+        ctx->chans[j].vfo = RIG_VFO_MEM;
+        ctx->chans[j].channel_num = ctx->mem_start + j;
+    }
+
+    return rig_get_channels(rig, ctx->chans, n);
+}
+
+static int op_set_split_vfo(RIG *rig, struct bench_ctx *ctx, int i)
+{
+    return rig_set_split_vfo(rig, RIG_VFO_CURR, RIG_SPLIT_ON, RIG_VFO_B);
+}
+
+static int op_set_split_freq(RIG *rig, struct bench_ctx *ctx, int i)
+{
+    return rig_set_split_freq(rig, RIG_VFO_CURR,
+                              ctx->freq + 5000 + (i % 100) * 100);
+}
+
+static int op_get_split_freq(RIG *rig, struct bench_ctx *ctx, int i)
+{
+    freq_t freq;
+
+    return rig_get_split_freq(rig, RIG_VFO_CURR, &freq);
+}
+
+static int op_get_split_vfo(RIG *rig, struct bench_ctx *ctx, int i)
+{
+    split_t split;
+    vfo_t tx_vfo;
+
+    return rig_get_split_vfo(rig, RIG_VFO_CURR, &split, &tx_vfo);
+}
+
+
+/*
+ * The workloads
+ */
+
+static int poll_setup(RIG *rig, struct bench_ctx *ctx)
+{
+    if (rig_has_get_level(rig, RIG_LEVEL_STRENGTH))
+    {
+        ctx->level = RIG_LEVEL_STRENGTH;
+    }
+    else if (rig_has_get_level(rig, RIG_LEVEL_AF))
+    {
+        ctx->level = RIG_LEVEL_AF;
+    }
+
+    return RIG_OK;
+}
+
+static int mem_setup(RIG *rig, struct bench_ctx *ctx)
+{
+    const chan_t *cl = rig->state.chan_list;
+    int i;
+
+    for (i = 0; i < CHANLSTSIZ && !RIG_IS_CHAN_END(cl[i]); i++)
+    {
+        if (cl[i].type == RIG_MTYPE_MEM)
+        {
+            ctx->mem_start = cl[i].startc;
+            ctx->mem_count = cl[i].endc - cl[i].startc + 1;
+            return RIG_OK;
+        }
+    }
+
+    return -RIG_ENAVAIL;
+}
+
+static void tune_cleanup(RIG *rig, struct bench_ctx *ctx)
+{
+    rig_set_freq(rig, RIG_VFO_CURR, ctx->freq);
+}
+
+static void split_cleanup(RIG *rig, struct bench_ctx *ctx)
+{
+    rig_set_split_vfo(rig, RIG_VFO_CURR, RIG_SPLIT_OFF, RIG_VFO_A);
+}
+
+static const struct workload workloads[] =
+{
+    {
+        "poll", "logging program poll: freq, mode, ptt and a level",
+        poll_setup, NULL,
+        {
+            { "get_freq", op_get_freq, 1 },
+            { "get_mode", op_get_mode, 1 },
+            { "get_ptt", op_get_ptt, 1 },
+            { "get_level", op_get_level, 1, has_level },
+        }
+    },
+    {
+        "tune", "tuning sweep, checking the frequency now and then",
+        NULL, tune_cleanup,
+        {
+            { "set_freq", op_set_freq, 1 },
+            { "get_freq", op_get_freq, 10 },
+        }
+    },
+    {
+        "memory", "memory dump, one channel at a time and in blocks",
+        mem_setup, NULL,
+        {
+            { "get_channel", op_get_channel, 1 },
+            { "get_channels", op_get_channels, MEM_BLOCK },
+        }
+    },
+    {
+        "split", "split operation, as for a DX pileup",
+        NULL, split_cleanup,
+        {
+            { "set_split_vfo", op_set_split_vfo, 1 },
+            { "set_split_freq", op_set_split_freq, 1 },
+            { "get_split_freq", op_get_split_freq, 1 },
+            { "get_split_vfo", op_get_split_vfo, 1 },
+        }
+    },
+    { NULL }
+};
+
+
+static const struct workload *find_workload(const char *name)
+{
+    const struct workload *wl;
+
+    for (wl = workloads; wl->name; wl++)
+    {
+        if (!strcmp(wl->name, name))
+        {
+            return wl;
+        }
+    }
+
+    return NULL;
+}
+
+
+static unsigned long port_syscalls(const hamlib_port_t *p)
+{
+    return p->io_count.select_calls + p->io_count.read_calls
+           + p->io_count.write_calls + p->io_count.flush_calls;
+}
+
+
+static double percentile(const struct op_stats *st, int p)
+{
+    return bench_percentile(st->samples, st->count, p);
+}
+
+
+static double mean(const struct op_stats *st)
+{
+    return st->count ? st->total / st->count : 0;
+}
+
+
+static int run_workload(RIG *rig, const struct workload *wl, int count,
+                        struct workload_result *res)
+{
+    static struct bench_ctx ctx;
+    const hamlib_port_t *rp = &rig->state.rigport;
+    int i, j, retcode;
+
+    memset(res, 0, sizeof(*res));
+    memset(&ctx, 0, sizeof(ctx));
+    res->wl = wl;
+
+    if (rig_get_freq(rig, RIG_VFO_CURR, &ctx.freq) != RIG_OK || ctx.freq <= 0)
+    {
+        ctx.freq = 14000000;
+    }
+
+    if (wl->setup && wl->setup(rig, &ctx) != RIG_OK)
+    {
+        res->skipped = "not supported by the rig";
+        return RIG_OK;
+    }
+
+    for (i = 0; i < MAX_OPS && wl->ops[i].name; i++)
+    {
+        /* a poll without any level only reads freq, mode and ptt */
+        if (wl->ops[i].avail && !wl->ops[i].avail(&ctx))
+        {
+            continue;
+        }
+
+        j = res->nb_ops++;
+        res->ops[j].def = &wl->ops[i];
+        res->ops[j].samples = calloc(count, sizeof(double));
+
+        if (!res->ops[j].samples)
+        {
+            return -RIG_ENOMEM;
+        }
+    }
+
+    res->elapsed = bench_now();
+
+    for (i = 0; i < count; i++)
+    {
+        for (j = 0; j < res->nb_ops; j++)
+        {
+            struct op_stats *st = &res->ops[j];
+            unsigned long tx = rp->io_count.tx_bytes;
+            unsigned long rx = rp->io_count.rx_bytes;
+            unsigned long calls = port_syscalls(rp);
+            double t;
+
+            if (i % st->def->every)
+            {
+                continue;
+            }
+
+            t = bench_now();
+            retcode = st->def->fn(rig, &ctx, i);
+            t = bench_now() - t;
+            st->samples[st->count++] = t;
+            st->total += t;
+
+            if (retcode != RIG_OK)
+            {
+                st->errors++;
+            }
+
+            st->tx_bytes += rp->io_count.tx_bytes - tx;
+            st->rx_bytes += rp->io_count.rx_bytes - rx;
+            st->syscalls += port_syscalls(rp) - calls;
+        }
+    }
+
+    res->elapsed = bench_now() - res->elapsed;
+
+    for (j = 0; j < res->nb_ops; j++)
+    {
+        qsort(res->ops[j].samples, res->ops[j].count, sizeof(double),
+              bench_cmp_double);
+    }
+
+    if (wl->cleanup)
+    {
+        wl->cleanup(rig, &ctx);
+    }
+
+    return RIG_OK;
+}
+
+
+static void free_result(struct workload_result *res)
+{
+    int j;
+
+    for (j = 0; j < res->nb_ops; j++)
+    {
+        free(res->ops[j].samples);
+    }
+}
+
+
+static void print_text(FILE *fout, const struct workload_result *res)
+{
+    int j;
+
+    if (res->skipped)
+    {
+        fprintf(fout, "%-8s skipped, %s\n", res->wl->name, res->skipped);
+        return;
+    }
+
+    for (j = 0; j < res->nb_ops; j++)
+    {
+        const struct op_stats *st = &res->ops[j];
+
+        fprintf(fout,
+                "%-8s %-15s %6d %6d %9.0f %9.1f %9.1f %9.1f %7.1f %7.1f %6.2f\n",
+                res->wl->name, st->def->name, st->count, st->errors,
+                st->total > 0 ? st->count / st->total : 0.,
+                percentile(st, 50) * 1e6, percentile(st, 95) * 1e6,
+                percentile(st, 99) * 1e6,
+                st->count ? (double)st->tx_bytes / st->count : 0.,
+                st->count ? (double)st->rx_bytes / st->count : 0.,
+                st->count ? (double)st->syscalls / st->count : 0.);
+    }
+}
+
+
+static void json_string(FILE *fout, const char *s)
+{
+    fputc('"', fout);
+
+    for (; *s; s++)
+    {
+        if (*s == '"' || *s == '\\')
+        {
+            fprintf(fout, "\\%c", *s);
+        }
+        else if ((unsigned char)*s < 0x20)
+        {
+            fprintf(fout, "\\u%04x", *s);
+        }
+        else
+        {
+            fputc(*s, fout);
+        }
+    }
+
+    fputc('"', fout);
+}
+
+
+static void print_json(FILE *fout, RIG *rig, int count,
+                       const struct workload_result *res, int nb_res)
+{
+    unsigned long tx, rx;
+    int i, j, ops;
+
+    fprintf(fout, "{\n  \"hamlib\": ");
+    json_string(fout, hamlib_version);
+    fprintf(fout, ",\n  \"model\": %d,\n  \"model_name\": ",
+            rig->caps->rig_model);
+    json_string(fout, rig->caps->model_name);
+    fprintf(fout, ",\n  \"backend_version\": ");
+    json_string(fout, rig->caps->version);
+    fprintf(fout, ",\n  \"port\": ");
+    json_string(fout, rig->state.rigport.pathname);
+    fprintf(fout, ",\n  \"iterations\": %d,\n  \"workloads\": [", count);
+
+    for (i = 0; i < nb_res; i++)
+    {
+        const struct workload_result *r = &res[i];
+
+        fprintf(fout, "%s\n    {\n      \"name\": ", i ? "," : "");
+        json_string(fout, r->wl->name);
+
+        if (r->skipped)
+        {
+            fprintf(fout, ",\n      \"skipped\": ");
+            json_string(fout, r->skipped);
+            fprintf(fout, "\n    }");
+            continue;
+        }
+
+        for (j = 0, ops = 0, tx = 0, rx = 0; j < r->nb_ops; j++)
+        {
+            ops += r->ops[j].count;
+            tx += r->ops[j].tx_bytes;
+            rx += r->ops[j].rx_bytes;
+        }
+
+        fprintf(fout, ",\n"
+                "      \"elapsed_s\": %.6f,\n"
+                "      \"ops_per_s\": %.3f,\n"
+                "      \"tx_bytes\": %lu,\n"
+                "      \"rx_bytes\": %lu,\n"
+                "      \"operations\": [",
+                r->elapsed, r->elapsed > 0 ? ops / r->elapsed : 0., tx, rx);
+
+        for (j = 0; j < r->nb_ops; j++)
+        {
+            const struct op_stats *st = &r->ops[j];
+
+            fprintf(fout, "%s\n        {\n          \"name\": ", j ? "," : "");
+            json_string(fout, st->def->name);
+            fprintf(fout, ",\n"
+                    "          \"count\": %d,\n"
+                    "          \"errors\": %d,\n"
+                    "          \"ops_per_s\": %.3f,\n"
+                    "          \"mean_us\": %.1f,\n"
+                    "          \"p50_us\": %.1f,\n"
+                    "          \"p95_us\": %.1f,\n"
+                    "          \"p99_us\": %.1f,\n"
+                    "          \"max_us\": %.1f,\n"
+                    "          \"tx_bytes\": %lu,\n"
+                    "          \"rx_bytes\": %lu,\n"
+                    "          \"syscalls\": %lu\n"
+                    "        }",
+                    st->count, st->errors,
+                    st->total > 0 ? st->count / st->total : 0.,
+                    mean(st) * 1e6,
+                    percentile(st, 50) * 1e6,
+                    percentile(st, 95) * 1e6,
+                    percentile(st, 99) * 1e6,
+                    st->count ? st->samples[st->count - 1] * 1e6 : 0.,
+                    st->tx_bytes, st->rx_bytes, st->syscalls);
+        }
+
+        fprintf(fout, "\n      ]\n    }");
+    }
+
+    fprintf(fout, "\n  ]\n}\n");
+}
+
+
+static int set_conf(RIG *rig, char *conf_parms)
+{
+    char *p, *q, *n;
+    int ret;
+
+    p = conf_parms;
+
+    while (p && *p != '\0')
+    {
+        q = strchr(p, '=');
+
+        if (!q)
+        {
+            return -RIG_EINVAL;
+        }
+
+        *q++ = '\0';
+        n = strchr(q, ',');
+
+        if (n)
+        {
+            *n++ = '\0';
+        }
+
+        ret = rig_set_conf(rig, rig_token_lookup(rig, p), q);
+
+        if (ret != RIG_OK)
+        {
+            return ret;
+        }
+
+        p = n;
+    }
+
+    return RIG_OK;
+}
+
+
+/* PARM=VAL[,PARM=VAL]... of the simulator, see struct rigsim_opts */
+static int set_sim_opts(struct rigsim_opts *opts, char *sim_parms)
+{
+    char *p, *q, *n;
+
+    for (p = sim_parms; p && *p != '\0'; p = n)
+    {
+        q = strchr(p, '=');
+
+        if (!q)
+        {
+            return -RIG_EINVAL;
+        }
+
+        *q++ = '\0';
+        n = strchr(q, ',');
+
+        if (n)
+        {
+            *n++ = '\0';
+        }
+
+        if (!strcmp(p, "baud"))
+        {
+            opts->baud = atoi(q);
+        }
+        else if (!strcmp(p, "latency"))
+        {
+            opts->latency = atoi(q);
+        }
+        else if (!strcmp(p, "echo"))
+        {
+            opts->echo = atoi(q);
+        }
+        else if (!strcmp(p, "noise"))
+        {
+            opts->noise = atoi(q);
+        }
+        else if (!strcmp(p, "error_rate"))
+        {
+            opts->error_rate = atoi(q);
+        }
+        else
+        {
+            return -RIG_EINVAL;
+        }
+    }
+
+    return RIG_OK;
+}
+
+
+static volatile sig_atomic_t interrupted;
+
+static void on_signal(int sig)
+{
+    interrupted = 1;
+}
+
+
+/* only run the simulator, for rigctl and friends, until interrupted */
+static int serve(const struct rigsim_opts *opts)
+{
+    struct rigsim sim;
+
+    if (rigsim_start(&sim, opts) < 0)
+    {
+        perror("rigsim_start");
+        return 2;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    printf("%s, model %d, on %s\n", rigsim_strproto(opts->proto),
+           rigsim_model(opts->proto), sim.pathname);
+    fflush(stdout);
+
+    while (!interrupted)
+    {
+        pause();
+    }
+
+    rigsim_stop(&sim);
+
+    return 0;
+}
+
+
+static void usage(void)
+{
+    const struct workload *wl;
+
+    printf("Usage: rigbench [OPTION]...\n"
+           "Measure the latency and throughput of a radio under typical "
+           "workloads.\n\n");
+
+    printf(
+        "  -m, --model=ID             select radio model number. See model list\n"
+        "  -r, --rig-file=DEVICE      set device of the radio to operate on\n"
+        "  -s, --serial-speed=BAUD    set serial speed of the serial port\n"
+        "  -C, --set-conf=PARM=VAL    set config parameters\n"
+        "  -w, --workload=LIST        comma separated workloads, default poll\n"
+        "  -n, --iterations=N         iterations per workload, default %d\n"
+        "  -c, --cache=MS             frontend cache timeout, default 0 (off)\n"
+        "  -S, --sim=PROTO            run against a simulated civ, kenwood or\n"
+        "                             newcat rig\n"
+        "  -O, --sim-opt=PARM=VAL     set simulator parameters: baud, latency\n"
+        "                             (us), echo, noise (ms between reports)\n"
+        "                             and error_rate (one reply in N)\n"
+        "  -Z, --serve                only run the simulator, print its port\n"
+        "  -j, --json                 print the results as JSON\n"
+        "  -v, --verbose              set verbose mode, cumulative\n"
+        "  -h, --help                 display this help and exit\n"
+        "  -V, --version              output version information and exit\n\n",
+        DEFAULT_COUNT);
+
+    printf("Workloads (or \"all\"):\n");
+
+    for (wl = workloads; wl->name; wl++)
+    {
+        printf("  %-8s %s\n", wl->name, wl->desc);
+    }
+
+    printf("\nReport bugs to <hamlib-developer@lists.sourceforge.net>.\n");
+}
+
+
+#define SHORT_OPTIONS "m:r:s:C:w:n:c:S:O:ZjvhV"
+static struct option long_options[] =
+{
+    {"model",           1, 0, 'm'},
+    {"rig-file",        1, 0, 'r'},
+    {"serial-speed",    1, 0, 's'},
+    {"set-conf",        1, 0, 'C'},
+    {"workload",        1, 0, 'w'},
+    {"iterations",      1, 0, 'n'},
+    {"cache",           1, 0, 'c'},
+    {"sim",             1, 0, 'S'},
+    {"sim-opt",         1, 0, 'O'},
+    {"serve",           0, 0, 'Z'},
+    {"json",            0, 0, 'j'},
+    {"verbose",         0, 0, 'v'},
+    {"help",            0, 0, 'h'},
+    {"version",         0, 0, 'V'},
+    {0, 0, 0, 0}
+};
+
+
+int main(int argc, char *argv[])
+{
+    struct workload_result res[sizeof(workloads) / sizeof(workloads[0])];
+    const struct workload *selected[sizeof(workloads) / sizeof(workloads[0])];
+    rig_model_t my_model = RIG_MODEL_DUMMY;
+    char conf_parms[MAXCONFLEN] = "";
+    char workload_list[MAXCONFLEN] = "poll";
+    char sim_parms[MAXCONFLEN] = "";
+    struct rigsim_opts opts;
+    const char *rig_file = NULL;
+    const char *cache = "0";
+    struct rigsim sim;
+    int sim_proto = -1;
+    int sim_only = 0;
+    int serial_rate = 0;
+    int count = DEFAULT_COUNT;
+    int verbose = 0, json = 0;
+    int nb_selected = 0;
+    int retcode, errors = 0;
+    char *tok;
+    RIG *rig;
+    int i;
+
+    while (1)
+    {
+        int c;
+        int option_index = 0;
+
+        c = getopt_long(argc, argv, SHORT_OPTIONS, long_options, &option_index);
+
+        if (c == -1)
+        {
+            break;
+        }
+
+        switch (c)
+        {
+        case 'h':
+            usage();
+            exit(0);
+
+        case 'V':
+            printf("rigbench, %s\n", hamlib_version);
+            exit(0);
+
+        case 'm':
+            my_model = atoi(optarg);
+            break;
+
+        case 'r':
+            rig_file = optarg;
+            break;
+
+        case 's':
+            serial_rate = atoi(optarg);
+            break;
+
+        case 'C':
+            if (*conf_parms != '\0')
+            {
+                strcat(conf_parms, ",");
+            }
+
+            strncat(conf_parms, optarg, MAXCONFLEN - strlen(conf_parms) - 1);
+            break;
+
+        case 'w':
+            strncpy(workload_list, optarg, MAXCONFLEN - 1);
+            break;
+
+        case 'n':
+            count = atoi(optarg);
+            break;
+
+        case 'c':
+            cache = optarg;
+            break;
+
+        case 'S':
+            sim_proto = rigsim_parse_proto(optarg);
+
+            if (sim_proto < 0)
+            {
+                fprintf(stderr, "Unknown simulator '%s'\n", optarg);
+                exit(1);
+            }
+
+            break;
+
+        case 'O':
+            if (*sim_parms != '\0')
+            {
+                strcat(sim_parms, ",");
+            }
+
+            strncat(sim_parms, optarg, MAXCONFLEN - strlen(sim_parms) - 1);
+            break;
+
+        case 'Z':
+            sim_only = 1;
+            break;
+
+        case 'j':
+            json = 1;
+            break;
+
+        case 'v':
+            verbose++;
+            break;
+
+        default:
+            usage();    /* unknown option? */
+            exit(1);
+        }
+    }
+
+    if (count < 1)
+    {
+        usage();
+        exit(1);
+    }
+
+    for (tok = strtok(workload_list, ","); tok; tok = strtok(NULL, ","))
+    {
+        const struct workload *wl;
+
+        if (!strcmp(tok, "all"))
+        {
+            for (wl = workloads; wl->name; wl++)
+            {
+                selected[nb_selected++] = wl;
+            }
+
+            break;
+        }
+
+        wl = find_workload(tok);
+
+        if (!wl)
+        {
+            fprintf(stderr, "Unknown workload '%s'\n", tok);
+            exit(1);
+        }
+
+        if (nb_selected < sizeof(selected) / sizeof(selected[0]))
+        {
+            selected[nb_selected++] = wl;
+        }
+    }
+
+    rig_set_debug(verbose);
+
+    if (sim_only && sim_proto < 0)
+    {
+        sim_proto = RIGSIM_KENWOOD;
+    }
+
+    if (sim_proto >= 0)
+    {
+        rigsim_default_opts(&opts, sim_proto);
+
+        if (set_sim_opts(&opts, sim_parms) != RIG_OK)
+        {
+            fprintf(stderr, "Simulator parameter error\n");
+            exit(1);
+        }
+
+        if (sim_only)
+        {
+            exit(serve(&opts));
+        }
+
+        if (rigsim_start(&sim, &opts) < 0)
+        {
+            perror("rigsim_start");
+            exit(2);
+        }
+
+        my_model = rigsim_model(sim_proto);
+        rig_file = sim.pathname;
+    }
+
+    rig = rig_init(my_model);
+
+    if (!rig)
+    {
+        fprintf(stderr, "Unknown rig num %d, or initialization error.\n",
+                my_model);
+        fprintf(stderr, "Please check with rigctl --list.\n");
+        exit(2);
+    }
+
+    retcode = set_conf(rig, conf_parms);
+
+    if (retcode == RIG_OK)
+    {
+        retcode = rig_set_conf(rig, rig_token_lookup(rig, "cache_timeout"),
+                               cache);
+    }
+
+    if (retcode != RIG_OK)
+    {
+        fprintf(stderr, "Config parameter error: %s\n", rigerror(retcode));
+        exit(2);
+    }
+
+    if (rig_file)
+    {
+        snprintf(rig->state.rigport.pathname, FILPATHLEN, "%s", rig_file);
+    }
+
+    if (serial_rate != 0)
+    {
+        rig->state.rigport.parm.serial.rate = serial_rate;
+    }
+
+    retcode = rig_open(rig);
+
+    if (retcode != RIG_OK)
+    {
+        fprintf(stderr, "rig_open: error = %s \n", rigerror(retcode));
+        exit(2);
+    }
+
+    if (!json)
+    {
+        printf("%s %s, %d iterations\n", rig->caps->mfg_name,
+               rig->caps->model_name, count);
+        printf("%-8s %-15s %6s %6s %9s %9s %9s %9s %7s %7s %6s\n",
+               "workload", "operation", "count", "errors", "ops/s",
+               "p50 us", "p95 us", "p99 us", "tx B/op", "rx B/op", "sys/op");
+    }
+
+    for (i = 0; i < nb_selected; i++)
+    {
+        int j;
+
+        retcode = run_workload(rig, selected[i], count, &res[i]);
+
+        if (retcode != RIG_OK)
+        {
+            fprintf(stderr, "%s: %s\n", selected[i]->name, rigerror(retcode));
+            exit(2);
+        }
+
+        for (j = 0; j < res[i].nb_ops; j++)
+        {
+            errors += res[i].ops[j].errors;
+        }
+
+        if (!json)
+        {
+            print_text(stdout, &res[i]);
+        }
+    }
+
+    if (json)
+    {
+        print_json(stdout, rig, count, res, nb_selected);
+    }
+
+    for (i = 0; i < nb_selected; i++)
+    {
+        free_result(&res[i]);
+    }
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    if (sim_proto >= 0)
+    {
+        rigsim_stop(&sim);
+    }
+
+    /* with errors injected, failures are expected */
+    return errors && !(sim_proto >= 0 && opts.error_rate) ? 1 : 0;
+}
@@ -155,8 +155,7 @@ int main(int argc, char *argv[])
     int prompt = 1;         /* Print prompt in rigctl */
     int vfo_mode = 0;       /* vfo_mode = 0 means target VFO is 'currVFO' */
     char send_cmd_term = '\r';  /* send_cmd termination char */
-    int ext_resp = 0;
-    char resp_sep = '\n';
+    struct rigctl_parser *rp;
 
     while (1)
     {
@@ -610,11 +609,16 @@ int main(int argc, char *argv[])
 
 #endif  /* HAVE_LIBREADLINE */
 
+    rp = rigctl_parser_new(stdin, interactive, prompt, vfo_mode, send_cmd_term);
+
+    if (!rp)
+    {
+        exit(1);
+    }
+
     do
     {
-        retcode = rigctl_parse(my_rig, stdin, stdout, argv, argc, NULL,
-                               interactive, prompt, vfo_mode, send_cmd_term,
-                               &ext_resp, &resp_sep);
+        retcode = rigctl_parse(my_rig, rp, stdout, argv, argc, NULL);
 
         if (retcode == 2)
         {
@@ -623,6 +627,8 @@ int main(int argc, char *argv[])
     }
     while (retcode == 0 || retcode == 2 || retcode == -RIG_ENAVAIL);
 
+    rigctl_parser_free(rp);
+
 #ifdef HAVE_LIBREADLINE
 
     if (interactive && prompt && have_rl)
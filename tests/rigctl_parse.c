@@ -35,6 +35,11 @@
 #include <unistd.h>
 #include <ctype.h>
 #include <errno.h>
+#include <math.h>
+
+#ifdef HAVE_PTHREAD
+#  include <pthread.h>
+#endif
 
 #ifdef HAVE_LIBREADLINE
 #  if defined(HAVE_READLINE_READLINE_H)
@@ -111,20 +116,53 @@ extern int read_history();
 #define ARG_IN  (ARG_IN1|ARG_IN2|ARG_IN3|ARG_IN4)
 #define ARG_OUT (ARG_OUT1|ARG_OUT2|ARG_OUT3|ARG_OUT4)
 
-/* variables for readline support */
+/* readline support */
 #ifdef HAVE_LIBREADLINE
-static char *input_line = (char *)NULL;
-static char *result = (char *)NULL;
-static char *parsed_input[sizeof(char *) * 5];
 static const int have_rl = 1;
+#else                               /* no readline */
+static const int have_rl = 0;
+#endif
 
-#ifdef HAVE_READLINE_HISTORY
-static char *rp_hist_buf = (char *)NULL;
+#define RP_LINE_SIZE    256     /* input buffer growth */
+#define RP_INPUT_MAX    65536   /* longest command accepted */
+
+/* a command runs past the end of the buffer given to rigctl_parse_buf() */
+#define RP_MORE (-1000)
+
+struct rigctl_parser
+{
+    int interactive;
+    int prompt;
+    int vfo_mode;
+    char send_cmd_term;
+    int ext_resp;               /* extended response requested */
+    char resp_sep;              /* extended response separator */
+    int last_was_ret;
+    int reading_stdin;          /* next_word() is reading stdin */
+
+    FILE *fin;                  /* refills buf, NULL if fed by buffers */
+    const char *in;             /* input being parsed */
+    size_t in_len;
+    size_t in_pos;
+    size_t cmd_start;           /* start of the command being parsed */
+    char *buf;                  /* input read from fin */
+    size_t buf_size;
+
+#ifdef HAVE_OPEN_MEMSTREAM
+    FILE *out;                  /* output of the command being parsed */
+    char *out_buf;
+    size_t out_size;
 #endif
 
-#else                               /* no readline */
-static const int have_rl = 0;
+#ifdef HAVE_LIBREADLINE
+    char *input_line;
+    char *result;
+    char *parsed_input[5];
+#ifdef HAVE_READLINE_HISTORY
+    char *rp_hist_buf;
 #endif
+#endif
+};
 
 
 struct test_table
@@ -133,7 +171,7 @@ struct test_table
     const char *name;
     int (*rig_routine)(RIG *,
                        FILE *,
-                       FILE *,
+                       struct rigctl_parser *,
                        int,
                        int,
                        int,
@@ -153,12 +191,24 @@ struct test_table
 };
 
 
-#define CHKSCN1ARG(a) if ((a) != 1) return -RIG_EINVAL; else do {} while(0)
+#define CHKSCN1ARG(a)                           \
+    do {                                        \
+        int __ret = (a);                        \
+        if (__ret == RP_MORE) return RP_MORE;   \
+        if (__ret != 1) return -RIG_EINVAL;     \
+    } while(0)
+
+/* only set_channel reads more input through the parser */
+#ifdef __GNUC__
+#define RP_UNUSED __attribute__((unused))
+#else
+#define RP_UNUSED
+#endif
 
 #define ACTION(f) rigctl_##f
 #define declare_proto_rig(f) static int (ACTION(f))(RIG *rig,           \
                                                     FILE *fout,         \
-                                                    FILE *fin,          \
+                                                    struct rigctl_parser *rp RP_UNUSED, \
                                                     int interactive,    \
                                                     int prompt,         \
                                                     int vfo_mode,       \
@@ -240,6 +290,9 @@ declare_proto_rig(recv_dtmf);
 declare_proto_rig(chk_vfo);
 declare_proto_rig(halt);
 declare_proto_rig(pause);
+declare_proto_rig(get_cache);
+declare_proto_rig(get_stats);
+declare_proto_rig(reset_stats);
 
 
 /*
@@ -321,28 +374,48 @@ static struct test_table test_list[] =
     { 0xf0, "chk_vfo",          ACTION(chk_vfo),        ARG_NOVFO, "ChkVFO" },   /* rigctld only--check for VFO mode */
     { 0xf1, "halt",             ACTION(halt),           ARG_NOVFO },   /* rigctld only--halt the daemon */
     { 0x8c, "pause",            ACTION(pause),          ARG_IN, "Seconds" },
+    { 0x8d, "get_cache",        ACTION(get_cache),      ARG_OUT | ARG_NOVFO, "Hits", "Misses" },
+    { 0x8e, "get_stats",        ACTION(get_stats),      ARG_NOVFO },
+    { 0x94, "reset_stats",      ACTION(reset_stats),    ARG_NOVFO },
     { 0x00, "", NULL },
 };
 
 
-static struct test_table *find_cmd_entry(int cmd)
+/* index in test_list of each command character, -1 if none */
+static short cmd_index[256];
+
+#ifdef HAVE_PTHREAD
+static pthread_once_t cmd_index_once = PTHREAD_ONCE_INIT;
+#endif
+
+
+static void init_cmd_index(void)
 {
     int i;
 
+    for (i = 0; i < 256; i++)
+    {
+        cmd_index[i] = -1;
+    }
+
     for (i = 0; test_list[i].cmd != 0x00; i++)
     {
-        if (test_list[i].cmd == cmd)
+        if (cmd_index[test_list[i].cmd] < 0)
         {
-            break;
+            cmd_index[test_list[i].cmd] = i;
         }
     }
+}
+
 
-    if (i >= MAXNBOPT || test_list[i].cmd == 0x00)
+static struct test_table *find_cmd_entry(int cmd)
+{
+    if (cmd <= 0 || cmd > 255 || cmd_index[cmd] < 0)
     {
         return NULL;
     }
 
-    return &test_list[i];
+    return &test_list[cmd_index[cmd]];
 }
 
 
@@ -417,29 +490,29 @@ void hash_delete_all()
 /* Frees allocated memory and sets pointers to NULL before calling readline
  * and then parses the input into space separated tokens.
  */
-static void rp_getline(const char *s)
+static void rp_getline(struct rigctl_parser *rp, const char *s)
 {
     int i;
 
     /* free allocated memory and set pointers to NULL */
-    if (input_line)
+    if (rp->input_line)
     {
-        free(input_line);
-        input_line = (char *)NULL;
+        free(rp->input_line);
+        rp->input_line = (char *)NULL;
     }
 
-    if (result)
+    if (rp->result)
     {
-        result = (char *)NULL;
+        rp->result = (char *)NULL;
     }
 
     for (i = 0; i < 5; i++)
     {
-        parsed_input[i] = NULL;
+        rp->parsed_input[i] = NULL;
     }
 
     /* Action!  Returns typed line with newline stripped. */
-    input_line = readline(s);
+    rp->input_line = readline(s);
 }
 
 
@@ -466,33 +539,213 @@ static char parse_arg(const char *arg)
 
 
 /*
- * This scanf works even in presence of signals (timer, SIGIO, ..)
+ * Get more input into a parser reading a file, a line at a time.
+ * This works even in presence of signals (timer, SIGIO, ..)
+ *
+ * returns 0 when successful, EOF at end of file or on error, RP_MORE for
+ * a parser fed by rigctl_parse_buf()
+ */
+static int rp_fill(struct rigctl_parser *rp)
+{
+    size_t len;
+
+    if (!rp->fin)
+    {
+        return RP_MORE;
+    }
+
+    /* keep the command being parsed, drop what is before */
+    if (rp->cmd_start > 0)
+    {
+        memmove(rp->buf, rp->buf + rp->cmd_start, rp->in_len - rp->cmd_start);
+        rp->in_len -= rp->cmd_start;
+        rp->in_pos -= rp->cmd_start;
+        rp->cmd_start = 0;
+    }
+
+    if (rp->buf_size - rp->in_len < RP_LINE_SIZE)
+    {
+        char *buf;
+
+        if (rp->buf_size >= RP_INPUT_MAX)
+        {
+            rig_debug(RIG_DEBUG_ERR, "%s: command too long\n", __func__);
+            return EOF;
+        }
+
+        buf = realloc(rp->buf, rp->buf_size + RP_LINE_SIZE);
+
+        if (!buf)
+        {
+            return EOF;
+        }
+
+        rp->buf = buf;
+        rp->buf_size += RP_LINE_SIZE;
+    }
+
+    rp->in = rp->buf;
+
+    while (!fgets(rp->buf + rp->in_len, rp->buf_size - rp->in_len, rp->fin))
+    {
+        if (ferror(rp->fin) && errno == EINTR)
+        {
+            clearerr(rp->fin);
+            continue;
+        }
+
+        if (ferror(rp->fin))
+        {
+            rig_debug(RIG_DEBUG_ERR, "fgets: %s\n", strerror(errno));
+        }
+
+        return EOF;
+    }
+
+    len = strlen(rp->buf + rp->in_len);
+    rp->in_len += len;
+
+    return 0;
+}
+
+
+/*
+ * Readers of the parser input, after the fashion of scanf.
+ *
+ * return 1 when successful, EOF at end of input, or RP_MORE if a parser
+ * fed by rigctl_parse_buf() ran out of input
  */
-static int scanfc(FILE *fin, const char *format, void *p)
+static int rp_getc(struct rigctl_parser *rp, unsigned char *c)
+{
+    while (rp->in_pos >= rp->in_len)
+    {
+        int ret = rp_fill(rp);
+
+        if (ret < 0)
+        {
+            return ret;
+        }
+    }
+
+    *c = rp->in[rp->in_pos++];
+
+    return 1;
+}
+
+
+/* like "%s", truncated to size - 1 characters */
+static int rp_word(struct rigctl_parser *rp, char *word, size_t size)
 {
+    unsigned char c;
+    size_t n = 0;
     int ret;
 
     do
     {
-        ret = fscanf(fin, format, p);
+        ret = rp_getc(rp, &c);
 
-        if (ret < 0)
+        if (ret < 1)
         {
-            if (errno == EINTR)
-            {
-                continue;
-            }
+            return ret;
+        }
+    }
+    while (isspace(c));
+
+    for (;;)
+    {
+        if (n + 1 < size)
+        {
+            word[n++] = c;
+        }
+
+        ret = rp_getc(rp, &c);
+
+        if (ret == RP_MORE)
+        {
+            return ret;
+        }
+
+        if (ret < 1)
+        {
+            break;
+        }
+
+        if (isspace(c))
+        {
+            /* left for the next read, as scanf does */
+            rp->in_pos--;
+            break;
+        }
+    }
+
+    word[n] = '\0';
 
-            rig_debug(RIG_DEBUG_ERR, "fscanf: %s\n", strerror(errno));
-            rig_debug(RIG_DEBUG_ERR,
-                      "fscanf: parsing '%s' with '%s'\n",
-                      (char *)p,
-                      format);
+    return 1;
+}
+
+
+/* like fgets() */
+static int rp_line(struct rigctl_parser *rp, char *line, size_t size)
+{
+    unsigned char c;
+    size_t n = 0;
+    int ret;
+
+    while (n + 1 < size)
+    {
+        ret = rp_getc(rp, &c);
+
+        if (ret == RP_MORE || (ret < 1 && n == 0))
+        {
+            return ret;
         }
 
+        if (ret < 1)
+        {
+            break;
+        }
+
+        line[n++] = c;
+
+        if (c == '\n')
+        {
+            break;
+        }
+    }
+
+    line[n] = '\0';
+
+    return 1;
+}
+
+
+/* scan one word, with a single conversion format */
+static int rp_scanf(struct rigctl_parser *rp, const char *format, void *p)
+{
+    char word[MAXARGSZ + 1];
+    int ret;
+
+    ret = rp_word(rp, word, sizeof(word));
+
+    if (ret < 1)
+    {
         return ret;
     }
-    while (1);
+
+    return sscanf(word, format, p);
+}
+
+
+/* drop a command that could not be read, or rewind it to parse it again */
+static int rp_fail(struct rigctl_parser *rp, int ret)
+{
+    if (ret == RP_MORE)
+    {
+        rp->in_pos = rp->cmd_start;
+        return RP_MORE;
+    }
+
+    return -1;
 }
 
 
@@ -505,13 +758,13 @@ static int scanfc(FILE *fin, const char *format, void *p)
  * returns <0 is error number
  * returns >=0 when successful
  */
-static int next_word(char *buffer, int argc, char *argv[], int newline)
+static int next_word(struct rigctl_parser *rp, char *buffer, int argc,
+                     char *argv[], int newline)
 {
     int ret;
     char c;
-    static int reading_stdin;
 
-    if (!reading_stdin)
+    if (!rp->reading_stdin)
     {
         if (optind >= argc)
         {
@@ -520,11 +773,11 @@ static int next_word(char *buffer, int argc, char *argv[], int newline)
         else if (newline && '-' == argv[optind][0] && 1 == strlen(argv[optind]))
         {
             ++optind;
-            reading_stdin = 1;
+            rp->reading_stdin = 1;
         }
     }
 
-    if (reading_stdin)
+    if (rp->reading_stdin)
     {
         do
         {
@@ -549,12 +802,12 @@ static int next_word(char *buffer, int argc, char *argv[], int newline)
 
         if (EOF == ret)
         {
-            reading_stdin = 0;
+            rp->reading_stdin = 0;
         }
         else if (ret < 0)
         {
             rig_debug(RIG_DEBUG_ERR, "scanf: %s\n", strerror(errno));
-            reading_stdin = 0;
+            rp->reading_stdin = 0;
         }
         else
         {
@@ -571,7 +824,7 @@ static int next_word(char *buffer, int argc, char *argv[], int newline)
         }
     }
 
-    if (!reading_stdin)
+    if (!rp->reading_stdin)
     {
         if (optind < argc)
         {
@@ -597,10 +850,134 @@ static int next_word(char *buffer, int argc, char *argv[], int newline)
     })
 
 
-int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
-                 sync_cb_t sync_cb,
-                 int interactive, int prompt, int vfo_mode, char send_cmd_term,
-                 int *ext_resp_ptr, char *resp_sep_ptr)
+/**
+ * \brief create the protocol state of a session or connection
+ * \param fin   Where to read the commands, NULL to hand them over with
+ *              rigctl_parse_buf()
+ *
+ * \return the parser, or NULL if out of memory.
+ */
+struct rigctl_parser *rigctl_parser_new(FILE *fin, int interactive, int prompt,
+                                        int vfo_mode, char send_cmd_term)
+{
+    struct rigctl_parser *rp;
+
+#ifdef HAVE_PTHREAD
+    pthread_once(&cmd_index_once, init_cmd_index);
+#else
+    if (cmd_index[0] == 0)
+    {
+        init_cmd_index();
+    }
+#endif
+
+    rp = calloc(1, sizeof(struct rigctl_parser));
+
+    if (!rp)
+    {
+        return NULL;
+    }
+
+    rp->fin = fin;
+    rp->interactive = interactive;
+    rp->prompt = prompt;
+    rp->vfo_mode = vfo_mode;
+    rp->send_cmd_term = send_cmd_term;
+    rp->resp_sep = '\n';
+    rp->last_was_ret = 1;
+
+    return rp;
+}
+
+
+void rigctl_parser_free(struct rigctl_parser *rp)
+{
+    if (!rp)
+    {
+        return;
+    }
+
+#ifdef HAVE_LIBREADLINE
+    free(rp->input_line);
+#endif
+#ifdef HAVE_OPEN_MEMSTREAM
+    if (rp->out)
+    {
+        fclose(rp->out);
+    }
+
+    free(rp->out_buf);
+#endif
+    free(rp->buf);
+    free(rp);
+}
+
+
+/**
+ * \brief parse and run the commands of a buffer
+ * \param used  Set to the length of the command parsed, 0 if the buffer
+ *              ends before the command does
+ *
+ * Parses and runs the command starting at buf, for a parser created
+ * without input file.  The rest of the buffer is left for the next calls.
+ * Nothing is written to fout for a command not complete yet: what it
+ * printed before its arguments ran out, as the extended response header,
+ * is dropped, and printed again once the command is parsed in full.
+ *
+ * \return as rigctl_parse().
+ */
+int rigctl_parse_buf(RIG *my_rig, struct rigctl_parser *rp, FILE *fout,
+                     const char *buf, size_t len, size_t *used,
+                     sync_cb_t sync_cb)
+{
+    FILE *out = fout;
+    int retcode;
+
+#ifdef HAVE_OPEN_MEMSTREAM
+    if (!rp->out)
+    {
+        rp->out = open_memstream(&rp->out_buf, &rp->out_size);
+    }
+
+    if (rp->out)
+    {
+        out = rp->out;
+        fseek(out, 0, SEEK_SET);
+    }
+#endif
+
+    rp->in = buf;
+    rp->in_len = len;
+    rp->in_pos = 0;
+
+    retcode = rigctl_parse(my_rig, rp, out, NULL, 0, sync_cb);
+
+    *used = retcode == RP_MORE ? 0 : rp->in_pos;
+
+#ifdef HAVE_OPEN_MEMSTREAM
+    if (out != fout)
+    {
+        long out_len;
+
+        fflush(out);
+        out_len = ftell(out);
+
+        if (retcode != RP_MORE && out_len > 0)
+        {
+            fwrite(rp->out_buf, 1, out_len, fout);
+        }
+    }
+#endif
+
+    rp->in = NULL;
+    rp->in_len = rp->in_pos = 0;
+
+    return retcode == RP_MORE ? 0 : retcode;
+}
+
+
+int rigctl_parse(RIG *my_rig, struct rigctl_parser *rp, FILE *fout,
+                 char *argv[], int argc, sync_cb_t sync_cb)
 {
     int retcode;        /* generic return code from functions */
     unsigned char cmd;
@@ -610,8 +987,12 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
     char arg1[MAXARGSZ + 1], *p1 = NULL;
     char arg2[MAXARGSZ + 1], *p2 = NULL;
     char arg3[MAXARGSZ + 1], *p3 = NULL;
-    static int last_was_ret = 1;
     vfo_t vfo = RIG_VFO_CURR;
+    int interactive = rp->interactive;
+    int prompt = rp->prompt;
+    int vfo_mode = rp->vfo_mode;
+
+    rp->cmd_start = rp->in_pos;
 
     /* cmd, internal, rigctld */
     if (!(interactive && prompt && have_rl))
@@ -625,9 +1006,9 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
 
             do
             {
-                if (scanfc(fin, "%c", &cmd) < 1)
+                if ((retcode = rp_getc(rp, &cmd)) < 1)
                 {
-                    return -1;
+                    return rp_fail(rp, retcode);
                 }
 
                 /* Extended response protocol requested with leading '+' on command
@@ -635,11 +1016,11 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                  */
                 if (cmd == '+' && !prompt)
                 {
-                    *ext_resp_ptr = 1;
+                    rp->ext_resp = 1;
 
-                    if (scanfc(fin, "%c", &cmd) < 1)
+                    if ((retcode = rp_getc(rp, &cmd)) < 1)
                     {
-                        return -1;
+                        return rp_fail(rp, retcode);
                     }
                 }
                 else if (cmd == '+' && prompt)
@@ -654,12 +1035,12 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                         && !prompt)
                 {
 
-                    *ext_resp_ptr = 1;
-                    *resp_sep_ptr = cmd;
+                    rp->ext_resp = 1;
+                    rp->resp_sep = cmd;
 
-                    if (scanfc(fin, "%c", &cmd) < 1)
+                    if ((retcode = rp_getc(rp, &cmd)) < 1)
                     {
-                        return -1;
+                        return rp_fail(rp, retcode);
                     }
                 }
                 else if (cmd != '\\'
@@ -679,16 +1060,16 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                     unsigned char cmd_name[MAXNAMSIZ], *pcmd = cmd_name;
                     int c_len = MAXNAMSIZ;
 
-                    if (scanfc(fin, "%c", pcmd) < 1)
+                    if ((retcode = rp_getc(rp, pcmd)) < 1)
                     {
-                        return -1;
+                        return rp_fail(rp, retcode);
                     }
 
                     while (c_len-- && (isalnum(*pcmd) || *pcmd == '_'))
                     {
-                        if (scanfc(fin, "%c", ++pcmd) < 1)
+                        if ((retcode = rp_getc(rp, ++pcmd)) < 1)
                         {
-                            return -1;
+                            return rp_fail(rp, retcode);
                         }
                     }
 
@@ -699,7 +1080,7 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
 
                 if (cmd == 0x0a || cmd == 0x0d)
                 {
-                    if (last_was_ret)
+                    if (rp->last_was_ret)
                     {
                         if (prompt)
                         {
@@ -710,21 +1091,21 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                         return 0;
                     }
 
-                    last_was_ret = 1;
+                    rp->last_was_ret = 1;
                 }
             }
             while (cmd == 0x0a || cmd == 0x0d);
 
-            last_was_ret = 0;
+            rp->last_was_ret = 0;
 
             /* comment line */
             if (cmd == '#')
             {
                 while (cmd != '\n' && cmd != '\r')
                 {
-                    if (scanfc(fin, "%c", &cmd) < 1)
+                    if ((retcode = rp_getc(rp, &cmd)) < 1)
                     {
-                        return -1;
+                        return rp_fail(rp, retcode);
                     }
                 }
 
@@ -746,7 +1127,7 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
         else
         {
             /* parse rest of command line */
-            retcode = next_word(command, argc, argv, 1);
+            retcode = next_word(rp, command, argc, argv, 1);
 
             if (EOF == retcode)
             {
@@ -783,16 +1164,16 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                     fprintf_flush(fout, "VFO: ");
                 }
 
-                if (scanfc(fin, "%s", arg1) < 1)
+                if ((retcode = rp_word(rp, arg1, sizeof(arg1))) < 1)
                 {
-                    return -1;
+                    return rp_fail(rp, retcode);
                 }
 
                 vfo = rig_parse_vfo(arg1);
             }
             else
             {
-                retcode = next_word(arg1, argc, argv, 0);
+                retcode = next_word(rp, arg1, argc, argv, 0);
 
                 if (EOF == retcode)
                 {
@@ -822,16 +1203,16 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                     fprintf_flush(fout, "%s: ", cmd_entry->arg1);
                 }
 
-                if (fgets(arg1, MAXARGSZ, fin) == NULL)
+                if ((retcode = rp_line(rp, arg1, MAXARGSZ)) < 1)
                 {
-                    return -1;
+                    return rp_fail(rp, retcode);
                 }
 
                 if (arg1[0] == 0xa)
                 {
-                    if (fgets(arg1, MAXARGSZ, fin) == NULL)
+                    if ((retcode = rp_line(rp, arg1, MAXARGSZ)) < 1)
                     {
-                        return -1;
+                        return rp_fail(rp, retcode);
                     }
                 }
 
@@ -853,7 +1234,7 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
             }
             else
             {
-                retcode = next_word(arg1, argc, argv, 0);
+                retcode = next_word(rp, arg1, argc, argv, 0);
 
                 if (EOF == retcode)
                 {
@@ -878,16 +1259,16 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                     fprintf_flush(fout, "%s: ", cmd_entry->arg1);
                 }
 
-                if (scanfc(fin, "%s", arg1) < 1)
+                if ((retcode = rp_word(rp, arg1, sizeof(arg1))) < 1)
                 {
-                    return -1;
+                    return rp_fail(rp, retcode);
                 }
 
                 p1 = arg1;
             }
             else
             {
-                retcode = next_word(arg1, argc, argv, 0);
+                retcode = next_word(rp, arg1, argc, argv, 0);
 
                 if (EOF == retcode)
                 {
@@ -917,16 +1298,16 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                     fprintf_flush(fout, "%s: ", cmd_entry->arg2);
                 }
 
-                if (scanfc(fin, "%s", arg2) < 1)
+                if ((retcode = rp_word(rp, arg2, sizeof(arg2))) < 1)
                 {
-                    return -1;
+                    return rp_fail(rp, retcode);
                 }
 
                 p2 = arg2;
             }
             else
             {
-                retcode = next_word(arg2, argc, argv, 0);
+                retcode = next_word(rp, arg2, argc, argv, 0);
 
                 if (EOF == retcode)
                 {
@@ -956,16 +1337,16 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                     fprintf_flush(fout, "%s: ", cmd_entry->arg3);
                 }
 
-                if (scanfc(fin, "%s", arg3) < 1)
+                if ((retcode = rp_word(rp, arg3, sizeof(arg3))) < 1)
                 {
-                    return -1;
+                    return rp_fail(rp, retcode);
                 }
 
                 p3 = arg3;
             }
             else
             {
-                retcode = next_word(arg3, argc, argv, 0);
+                retcode = next_word(rp, arg3, argc, argv, 0);
 
                 if (EOF == retcode)
                 {
@@ -994,29 +1375,29 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
         /* Minimum space for 32+1+32+1+128+1+128+1+128+1 = 453 chars, so
          * allocate 512 chars cleared to zero for safety.
          */
-        rp_hist_buf = (char *)calloc(512, sizeof(char));
+        rp->rp_hist_buf = (char *)calloc(512, sizeof(char));
 #endif
 
-        rl_instream = fin;
+        rl_instream = rp->fin;
         rl_outstream = fout;
 
-        rp_getline("\nRig command: ");
+        rp_getline(rp, "\nRig command: ");
 
         /* EOF (Ctl-D) received on empty input line, bail out gracefully. */
-        if (!input_line)
+        if (!rp->input_line)
         {
             fprintf_flush(fout, "\n");
             return 1;
         }
 
         /* Q or q to quit */
-        if (!(strncasecmp(input_line, "q", 1)))
+        if (!(strncasecmp(rp->input_line, "q", 1)))
         {
             return 1;
         }
 
         /* '?' for help */
-        if (!(strncmp(input_line, "?", 1)))
+        if (!(strncmp(rp->input_line, "?", 1)))
         {
             usage_rig(fout);
             fflush(fout);
@@ -1024,34 +1405,34 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
         }
 
         /* '#' for comment */
-        if (!(strncmp(input_line, "#", 1)))
+        if (!(strncmp(rp->input_line, "#", 1)))
         {
             return 0;
         }
 
         /* Blank line entered */
-        if (!(strcmp(input_line, "")))
+        if (!(strcmp(rp->input_line, "")))
         {
             fprintf(fout, "? for help, q to quit.\n");
             fflush(fout);
             return 0;
         }
 
-        rig_debug(RIG_DEBUG_BUG, "%s: input_line: %s\n", __func__, input_line);
+        rig_debug(RIG_DEBUG_BUG, "%s: rp->input_line: %s\n", __func__, rp->input_line);
 
-        /* Split input_line on any number of spaces to get the command token
+        /* Split rp->input_line on any number of spaces to get the command token
          * Tabs are intercepted by readline for completion and a newline
          * causes readline to return the typed text.  If more than one
          * argument is given, it will be parsed out later.
          */
-        result = strtok(input_line, " ");
+        rp->result = strtok(rp->input_line, " ");
 
-        /* parsed_input stores pointers into input_line where the token strings
+        /* rp->parsed_input stores pointers into rp->input_line where the token strings
          * start.
          */
-        if (result)
+        if (rp->result)
         {
-            parsed_input[0] = result;
+            rp->parsed_input[0] = rp->result;
         }
         else
         {
@@ -1060,28 +1441,28 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
             return 1;
         }
 
-        /* At this point parsed_input contains the typed text of the command
+        /* At this point rp->parsed_input contains the typed text of the command
          * with surrounding space characters removed.  If Readline History is
          * available, copy the command string into a history buffer.
          */
 
         /* Single character command */
-        if ((strlen(parsed_input[0]) == 1) && (*parsed_input[0] != '\\'))
+        if ((strlen(rp->parsed_input[0]) == 1) && (*rp->parsed_input[0] != '\\'))
         {
-            cmd = *parsed_input[0];
+            cmd = *rp->parsed_input[0];
 
 #ifdef HAVE_READLINE_HISTORY
 
             /* Store what is typed, not validated, for history. */
-            if (rp_hist_buf)
+            if (rp->rp_hist_buf)
             {
-                strncpy(rp_hist_buf, parsed_input[0], 1);
+                strncpy(rp->rp_hist_buf, rp->parsed_input[0], 1);
             }
 
 #endif
         }
-        /* Test the command token, parsed_input[0] */
-        else if ((*parsed_input[0] == '\\') && (strlen(parsed_input[0]) > 1))
+        /* Test the command token, rp->parsed_input[0] */
+        else if ((*rp->parsed_input[0] == '\\') && (strlen(rp->parsed_input[0]) > 1))
         {
             char cmd_name[MAXNAMSIZ];
 
@@ -1089,23 +1470,23 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
              * srncpy() doesn't add one even if the supplied length is less
              * than the destination array.  Truncate the source string here.
              */
-            if (strlen(parsed_input[0] + 1) >= MAXNAMSIZ)
+            if (strlen(rp->parsed_input[0] + 1) >= MAXNAMSIZ)
             {
-                *(parsed_input[0] + MAXNAMSIZ) = '\0';
+                *(rp->parsed_input[0] + MAXNAMSIZ) = '\0';
             }
 
 #ifdef HAVE_READLINE_HISTORY
 
-            if (rp_hist_buf)
+            if (rp->rp_hist_buf)
             {
-                strncpy(rp_hist_buf, parsed_input[0], MAXNAMSIZ);
+                strncpy(rp->rp_hist_buf, rp->parsed_input[0], MAXNAMSIZ);
             }
 
 #endif
             /* The starting position of the source string is the first
              * character past the initial '\'.
              */
-            snprintf(cmd_name, sizeof(cmd_name), "%s", parsed_input[0] + 1);
+            snprintf(cmd_name, sizeof(cmd_name), "%s", rp->parsed_input[0] + 1);
 
             /* Sanity check as valid multiple character commands consist of
              * alpha-numeric characters and the underscore ('_') character.
@@ -1123,7 +1504,7 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
             cmd = parse_arg(cmd_name);
         }
         /* Single '\' entered, prompt again */
-        else if ((*parsed_input[0] == '\\') && (strlen(parsed_input[0]) == 1))
+        else if ((*rp->parsed_input[0] == '\\') && (strlen(rp->parsed_input[0]) == 1))
         {
             return 0;
         }
@@ -1140,7 +1521,7 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
         {
             if (cmd == '\0')
             {
-                fprintf(stderr, "Command '%s' not found!\n", parsed_input[0]);
+                fprintf(stderr, "Command '%s' not found!\n", rp->parsed_input[0]);
             }
             else
             {
@@ -1156,27 +1537,27 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
         if (!(cmd_entry->flags & ARG_NOVFO) && vfo_mode)
         {
             /* Check if VFO was given with command. */
-            result = strtok(NULL, " ");
+            rp->result = strtok(NULL, " ");
 
-            if (result)
+            if (rp->result)
             {
                 x = 1;
-                parsed_input[x] = result;
+                rp->parsed_input[x] = rp->result;
             }
             /* Need to prompt if a VFO string was not given. */
             else
             {
                 x = 0;
-                rp_getline("VFO: ");
+                rp_getline(rp, "VFO: ");
 
-                if (!input_line)
+                if (!rp->input_line)
                 {
                     fprintf_flush(fout, "\n");
                     return 1;
                 }
 
                 /* Blank line entered */
-                if (!(strcmp(input_line, "")))
+                if (!(strcmp(rp->input_line, "")))
                 {
                     fprintf(fout, "? for help, q to quit.\n");
                     fflush(fout);
@@ -1186,11 +1567,11 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                 /* Get the first token of input, the rest, if any, will be
                  * used later.
                  */
-                result = strtok(input_line, " ");
+                rp->result = strtok(rp->input_line, " ");
 
-                if (result)
+                if (rp->result)
                 {
-                    parsed_input[x] = result;
+                    rp->parsed_input[x] = rp->result;
                 }
                 else
                 {
@@ -1202,39 +1583,39 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
             /* VFO name tokens are presently quite short.  Truncate excessively
              * long strings.
              */
-            if (strlen(parsed_input[x]) >= MAXNAMSIZ)
+            if (strlen(rp->parsed_input[x]) >= MAXNAMSIZ)
             {
-                *(parsed_input[x] + (MAXNAMSIZ - 1)) = '\0';
+                *(rp->parsed_input[x] + (MAXNAMSIZ - 1)) = '\0';
             }
 
 #ifdef HAVE_READLINE_HISTORY
 
-            if (rp_hist_buf)
+            if (rp->rp_hist_buf)
             {
-                strncat(rp_hist_buf, " ", 2);
-                strncat(rp_hist_buf, parsed_input[x], MAXNAMSIZ);
+                strncat(rp->rp_hist_buf, " ", 2);
+                strncat(rp->rp_hist_buf, rp->parsed_input[x], MAXNAMSIZ);
             }
 
 #endif
 
             /* Sanity check, VFO names are alpha only. */
-            for (j = 0; j < MAXNAMSIZ && parsed_input[x][j] != '\0'; j++)
+            for (j = 0; j < MAXNAMSIZ && rp->parsed_input[x][j] != '\0'; j++)
             {
-                if (!(isalpha((int)parsed_input[x][j])))
+                if (!(isalpha((int)rp->parsed_input[x][j])))
                 {
-                    parsed_input[x][j] = '\0';
+                    rp->parsed_input[x][j] = '\0';
 
                     break;
                 }
             }
 
-            vfo = rig_parse_vfo(parsed_input[x]);
+            vfo = rig_parse_vfo(rp->parsed_input[x]);
 
             if (vfo == RIG_VFO_NONE)
             {
                 fprintf(stderr,
                         "Warning:  VFO '%s' unrecognized, using 'currVFO' instead.\n",
-                        parsed_input[x]);
+                        rp->parsed_input[x]);
                 vfo = RIG_VFO_CURR;
             }
         }
@@ -1247,17 +1628,17 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
             /* Check for a non-existent delimiter so as to not break up
              * remaining line into separate tokens (spaces OK).
              */
-            result = strtok(NULL, "\0");
+            rp->result = strtok(NULL, "\0");
 
-            if (vfo_mode && result)
+            if (vfo_mode && rp->result)
             {
                 x = 2;
-                parsed_input[x] = result;
+                rp->parsed_input[x] = rp->result;
             }
-            else if (result)
+            else if (rp->result)
             {
                 x = 1;
-                parsed_input[x] = result;
+                rp->parsed_input[x] = rp->result;
             }
             else
             {
@@ -1267,19 +1648,19 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                 strcpy(pmptstr, cmd_entry->arg1);
                 strcat(pmptstr, ": ");
 
-                rp_getline(pmptstr);
+                rp_getline(rp, pmptstr);
 
                 /* Blank line entered */
-                if (!(strcmp(input_line, "")))
+                if (!(strcmp(rp->input_line, "")))
                 {
                     fprintf(fout, "? for help, q to quit.\n");
                     fflush(fout);
                     return 0;
                 }
 
-                if (input_line)
+                if (rp->input_line)
                 {
-                    parsed_input[x] = input_line;
+                    rp->parsed_input[x] = rp->input_line;
                 }
                 else
                 {
@@ -1289,38 +1670,38 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
             }
 
             /* The arg1 array size is MAXARGSZ + 1 so truncate it to fit if larger. */
-            if (strlen(parsed_input[x]) > MAXARGSZ)
+            if (strlen(rp->parsed_input[x]) > MAXARGSZ)
             {
-                parsed_input[x][MAXARGSZ] = '\0';
+                rp->parsed_input[x][MAXARGSZ] = '\0';
             }
 
 #ifdef HAVE_READLINE_HISTORY
 
-            if (rp_hist_buf)
+            if (rp->rp_hist_buf)
             {
-                strncat(rp_hist_buf, " ", 2);
-                strncat(rp_hist_buf, parsed_input[x], MAXARGSZ);
+                strncat(rp->rp_hist_buf, " ", 2);
+                strncat(rp->rp_hist_buf, rp->parsed_input[x], MAXARGSZ);
             }
 
 #endif
-            strcpy(arg1, parsed_input[x]);
+            strcpy(arg1, rp->parsed_input[x]);
             p1 = arg1;
         }
 
         /* Normal argument parsing. */
         else if ((cmd_entry->flags & ARG_IN1) && cmd_entry->arg1)
         {
-            result = strtok(NULL, " ");
+            rp->result = strtok(NULL, " ");
 
-            if (vfo_mode && result)
+            if (vfo_mode && rp->result)
             {
                 x = 2;
-                parsed_input[x] = result;
+                rp->parsed_input[x] = rp->result;
             }
-            else if (result)
+            else if (rp->result)
             {
                 x = 1;
-                parsed_input[x] = result;
+                rp->parsed_input[x] = rp->result;
             }
             else
             {
@@ -1330,20 +1711,20 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                 strcpy(pmptstr, cmd_entry->arg1);
                 strcat(pmptstr, ": ");
 
-                rp_getline(pmptstr);
+                rp_getline(rp, pmptstr);
 
-                if (!(strcmp(input_line, "")))
+                if (!(strcmp(rp->input_line, "")))
                 {
                     fprintf(fout, "? for help, q to quit.\n");
                     fflush(fout);
                     return 0;
                 }
 
-                result = strtok(input_line, " ");
+                rp->result = strtok(rp->input_line, " ");
 
-                if (result)
+                if (rp->result)
                 {
-                    parsed_input[x] = result;
+                    rp->parsed_input[x] = rp->result;
                 }
                 else
                 {
@@ -1352,21 +1733,21 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                 }
             }
 
-            if (strlen(parsed_input[x]) > MAXARGSZ)
+            if (strlen(rp->parsed_input[x]) > MAXARGSZ)
             {
-                parsed_input[x][MAXARGSZ] = '\0';
+                rp->parsed_input[x][MAXARGSZ] = '\0';
             }
 
 #ifdef HAVE_READLINE_HISTORY
 
-            if (rp_hist_buf)
+            if (rp->rp_hist_buf)
             {
-                strncat(rp_hist_buf, " ", 2);
-                strncat(rp_hist_buf, parsed_input[x], MAXARGSZ);
+                strncat(rp->rp_hist_buf, " ", 2);
+                strncat(rp->rp_hist_buf, rp->parsed_input[x], MAXARGSZ);
             }
 
 #endif
-            strcpy(arg1, parsed_input[x]);
+            strcpy(arg1, rp->parsed_input[x]);
             p1 = arg1;
         }
 
@@ -1376,17 +1757,17 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                 && cmd_entry->arg2)
         {
 
-            result = strtok(NULL, " ");
+            rp->result = strtok(NULL, " ");
 
-            if (vfo_mode && result)
+            if (vfo_mode && rp->result)
             {
                 x = 3;
-                parsed_input[x] = result;
+                rp->parsed_input[x] = rp->result;
             }
-            else if (result)
+            else if (rp->result)
             {
                 x = 2;
-                parsed_input[x] = result;
+                rp->parsed_input[x] = rp->result;
             }
             else
             {
@@ -1396,20 +1777,20 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                 strcpy(pmptstr, cmd_entry->arg2);
                 strcat(pmptstr, ": ");
 
-                rp_getline(pmptstr);
+                rp_getline(rp, pmptstr);
 
-                if (!(strcmp(input_line, "")))
+                if (!(strcmp(rp->input_line, "")))
                 {
                     fprintf(fout, "? for help, q to quit.\n");
                     fflush(fout);
                     return 0;
                 }
 
-                result = strtok(input_line, " ");
+                rp->result = strtok(rp->input_line, " ");
 
-                if (result)
+                if (rp->result)
                 {
-                    parsed_input[x] = result;
+                    rp->parsed_input[x] = rp->result;
                 }
                 else
                 {
@@ -1418,21 +1799,21 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                 }
             }
 
-            if (strlen(parsed_input[x]) > MAXARGSZ)
+            if (strlen(rp->parsed_input[x]) > MAXARGSZ)
             {
-                parsed_input[x][MAXARGSZ] = '\0';
+                rp->parsed_input[x][MAXARGSZ] = '\0';
             }
 
 #ifdef HAVE_READLINE_HISTORY
 
-            if (rp_hist_buf)
+            if (rp->rp_hist_buf)
             {
-                strncat(rp_hist_buf, " ", 2);
-                strncat(rp_hist_buf, parsed_input[x], MAXARGSZ);
+                strncat(rp->rp_hist_buf, " ", 2);
+                strncat(rp->rp_hist_buf, rp->parsed_input[x], MAXARGSZ);
             }
 
 #endif
-            strcpy(arg2, parsed_input[x]);
+            strcpy(arg2, rp->parsed_input[x]);
             p2 = arg2;
         }
 
@@ -1442,17 +1823,17 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                 && cmd_entry->arg3)
         {
 
-            result = strtok(NULL, " ");
+            rp->result = strtok(NULL, " ");
 
-            if (vfo_mode && result)
+            if (vfo_mode && rp->result)
             {
                 x = 4;
-                parsed_input[x] = result;
+                rp->parsed_input[x] = rp->result;
             }
-            else if (result)
+            else if (rp->result)
             {
                 x = 3;
-                parsed_input[x] = result;
+                rp->parsed_input[x] = rp->result;
             }
             else
             {
@@ -1462,20 +1843,20 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                 strcpy(pmptstr, cmd_entry->arg3);
                 strcat(pmptstr, ": ");
 
-                rp_getline(pmptstr);
+                rp_getline(rp, pmptstr);
 
-                if (!(strcmp(input_line, "")))
+                if (!(strcmp(rp->input_line, "")))
                 {
                     fprintf(fout, "? for help, q to quit.\n");
                     fflush(fout);
                     return 0;
                 }
 
-                result = strtok(input_line, " ");
+                rp->result = strtok(rp->input_line, " ");
 
-                if (result)
+                if (rp->result)
                 {
-                    parsed_input[x] = result;
+                    rp->parsed_input[x] = rp->result;
                 }
                 else
                 {
@@ -1484,31 +1865,31 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                 }
             }
 
-            if (strlen(parsed_input[x]) > MAXARGSZ)
+            if (strlen(rp->parsed_input[x]) > MAXARGSZ)
             {
-                parsed_input[x][MAXARGSZ] = '\0';
+                rp->parsed_input[x][MAXARGSZ] = '\0';
             }
 
 #ifdef HAVE_READLINE_HISTORY
 
-            if (rp_hist_buf)
+            if (rp->rp_hist_buf)
             {
-                strncat(rp_hist_buf, " ", 2);
-                strncat(rp_hist_buf, parsed_input[x], MAXARGSZ);
+                strncat(rp->rp_hist_buf, " ", 2);
+                strncat(rp->rp_hist_buf, rp->parsed_input[x], MAXARGSZ);
             }
 
 #endif
-            strcpy(arg3, parsed_input[x]);
+            strcpy(arg3, rp->parsed_input[x]);
             p3 = arg3;
         }
 
 #ifdef HAVE_READLINE_HISTORY
 
-        if (rp_hist_buf)
+        if (rp->rp_hist_buf)
         {
-            add_history(rp_hist_buf);
-            free(rp_hist_buf);
-            rp_hist_buf = (char *)NULL;
+            add_history(rp->rp_hist_buf);
+            free(rp->rp_hist_buf);
+            rp->rp_hist_buf = (char *)NULL;
         }
 
 #endif
@@ -1516,7 +1897,7 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
 
 #endif  /* HAVE_LIBREADLINE */
 
-    if (sync_cb) { sync_cb(1); }    /* lock if necessary */
+    if (sync_cb) { sync_cb(my_rig, 1); }    /* lock if necessary */
 
     if (!prompt)
     {
@@ -1533,7 +1914,7 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
      * Extended Response protocol: output received command name and arguments
      * response.  Don't send command header on '\chk_vfo' command.
      */
-    if (interactive && *ext_resp_ptr && !prompt && cmd != 0xf0)
+    if (interactive && rp->ext_resp && !prompt && cmd != 0xf0)
     {
         char a1[MAXARGSZ + 2];
         char a2[MAXARGSZ + 2];
@@ -1556,25 +1937,32 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
                 a1,
                 a2,
                 a3,
-                *resp_sep_ptr);
+                rp->resp_sep);
     }
 
     retcode = (*cmd_entry->rig_routine)(my_rig,
                                         fout,
-                                        fin,
+                                        rp,
                                         interactive,
                                         prompt,
                                         vfo_mode,
-                                        send_cmd_term,
-                                        *ext_resp_ptr,
-                                        *resp_sep_ptr,
+                                        rp->send_cmd_term,
+                                        rp->ext_resp,
+                                        rp->resp_sep,
                                         cmd_entry,
                                         vfo,
                                         p1,
                                         p2 ? p2 : "",
                                         p3 ? p3 : "");
 
-    if (sync_cb) { sync_cb(0); }    /* unlock if necessary */
+    if (sync_cb) { sync_cb(my_rig, 0); }    /* unlock if necessary */
+
+    if (retcode == RP_MORE)
+    {
+        /* arguments not received yet, parse the command again later */
+        rp->in_pos = rp->cmd_start;
+        return RP_MORE;
+    }
 
     if (retcode == RIG_EIO) { return retcode; }
 
@@ -1584,8 +1972,8 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
         if (interactive && !prompt)
         {
             fprintf(fout, NETRIGCTL_RET "%d\n", retcode);
-            *ext_resp_ptr = 0;
-            *resp_sep_ptr = '\n';
+            rp->ext_resp = 0;
+            rp->resp_sep = '\n';
         }
         else
         {
@@ -1602,17 +1990,17 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
         {
             /* netrigctl RIG_OK */
             if (!(cmd_entry->flags & ARG_OUT)
-                    && !*ext_resp_ptr && cmd != 0xf0)
+                    && !rp->ext_resp && cmd != 0xf0)
             {
                 fprintf(fout, NETRIGCTL_RET "0\n");
             }
 
             /* Extended Response protocol */
-            else if (*ext_resp_ptr && cmd != 0xf0)
+            else if (rp->ext_resp && cmd != 0xf0)
             {
                 fprintf(fout, NETRIGCTL_RET "0\n");
-                *ext_resp_ptr = 0;
-                *resp_sep_ptr = '\n';
+                rp->ext_resp = 0;
+                rp->resp_sep = '\n';
             }
         }
     }
@@ -3176,7 +3564,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "Bank Num: ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%d", &chan.bank_num));
+        CHKSCN1ARG(rp_scanf(rp, "%d", &chan.bank_num));
     }
 
 #if 0
@@ -3188,7 +3576,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "vfo (VFOA,MEM,etc...): ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%s", s));
+        CHKSCN1ARG(rp_scanf(rp, "%15s", s));
         chan.vfo = rig_parse_vfo(s);
     }
 
@@ -3201,7 +3589,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "ant: ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%d", &chan.ant));
+        CHKSCN1ARG(rp_scanf(rp, "%d", &chan.ant));
     }
 
     if (mem_caps->freq)
@@ -3211,7 +3599,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "Frequency: ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%"SCNfreq, &chan.freq));
+        CHKSCN1ARG(rp_scanf(rp, "%"SCNfreq, &chan.freq));
     }
 
     if (mem_caps->mode)
@@ -3221,7 +3609,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "mode (FM,LSB,etc...): ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%s", s));
+        CHKSCN1ARG(rp_scanf(rp, "%15s", s));
         chan.mode = rig_parse_mode(s);
     }
 
@@ -3232,7 +3620,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "width: ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%ld", &chan.width));
+        CHKSCN1ARG(rp_scanf(rp, "%ld", &chan.width));
     }
 
     if (mem_caps->tx_freq)
@@ -3242,7 +3630,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "tx freq: ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%"SCNfreq, &chan.tx_freq));
+        CHKSCN1ARG(rp_scanf(rp, "%"SCNfreq, &chan.tx_freq));
     }
 
     if (mem_caps->tx_mode)
@@ -3252,7 +3640,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "tx mode (FM,LSB,etc...): ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%s", s));
+        CHKSCN1ARG(rp_scanf(rp, "%15s", s));
         chan.tx_mode = rig_parse_mode(s);
     }
 
@@ -3263,7 +3651,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "tx width: ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%ld", &chan.tx_width));
+        CHKSCN1ARG(rp_scanf(rp, "%ld", &chan.tx_width));
     }
 
     if (mem_caps->split)
@@ -3273,7 +3661,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "split (0,1): ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%d", &status));
+        CHKSCN1ARG(rp_scanf(rp, "%d", &status));
         chan.split = status;
     }
 
@@ -3284,7 +3672,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "tx vfo (VFOA,MEM,etc...): ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%s", s));
+        CHKSCN1ARG(rp_scanf(rp, "%15s", s));
         chan.tx_vfo = rig_parse_vfo(s);
     }
 
@@ -3295,7 +3683,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "rptr shift (+-0): ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%s", s));
+        CHKSCN1ARG(rp_scanf(rp, "%15s", s));
         chan.rptr_shift = rig_parse_rptr_shift(s);
     }
 
@@ -3306,7 +3694,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "rptr offset: ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%ld", &chan.rptr_offs));
+        CHKSCN1ARG(rp_scanf(rp, "%ld", &chan.rptr_offs));
     }
 
     if (mem_caps->tuning_step)
@@ -3316,7 +3704,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "tuning step: ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%ld", &chan.tuning_step));
+        CHKSCN1ARG(rp_scanf(rp, "%ld", &chan.tuning_step));
     }
 
     if (mem_caps->rit)
@@ -3326,7 +3714,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "rit (Hz,0=off): ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%ld", &chan.rit));
+        CHKSCN1ARG(rp_scanf(rp, "%ld", &chan.rit));
     }
 
     if (mem_caps->xit)
@@ -3336,7 +3724,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "xit (Hz,0=off): ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%ld", &chan.xit));
+        CHKSCN1ARG(rp_scanf(rp, "%ld", &chan.xit));
     }
 
     if (mem_caps->funcs)
@@ -3346,7 +3734,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "funcs: ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%lx", &chan.funcs));
+        CHKSCN1ARG(rp_scanf(rp, "%lx", &chan.funcs));
     }
 
 #if 0
@@ -3366,7 +3754,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "ctcss tone freq in tenth of Hz (0=off): ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%d", &chan.ctcss_tone));
+        CHKSCN1ARG(rp_scanf(rp, "%d", &chan.ctcss_tone));
     }
 
     if (mem_caps->ctcss_sql)
@@ -3376,7 +3764,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "ctcss sql freq in tenth of Hz (0=off): ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%d", &chan.ctcss_sql));
+        CHKSCN1ARG(rp_scanf(rp, "%d", &chan.ctcss_sql));
     }
 
     if (mem_caps->dcs_code)
@@ -3386,7 +3774,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "dcs code: ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%d", &chan.dcs_code));
+        CHKSCN1ARG(rp_scanf(rp, "%d", &chan.dcs_code));
     }
 
     if (mem_caps->dcs_sql)
@@ -3396,7 +3784,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "dcs sql: ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%d", &chan.dcs_sql));
+        CHKSCN1ARG(rp_scanf(rp, "%d", &chan.dcs_sql));
     }
 
     if (mem_caps->scan_group)
@@ -3406,7 +3794,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "scan group: ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%d", &chan.scan_group));
+        CHKSCN1ARG(rp_scanf(rp, "%d", &chan.scan_group));
     }
 
     if (mem_caps->flags)
@@ -3416,7 +3804,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "flags: ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%d", &chan.flags));
+        CHKSCN1ARG(rp_scanf(rp, "%d", &chan.flags));
     }
 
     if (mem_caps->channel_desc)
@@ -3426,7 +3814,7 @@ declare_proto_rig(set_channel)
             fprintf_flush(fout, "channel desc: ");
         }
 
-        CHKSCN1ARG(scanfc(fin, "%s", s));
+        CHKSCN1ARG(rp_scanf(rp, "%15s", s));
         strcpy(chan.channel_desc, s);
     }
 
@@ -4200,3 +4588,141 @@ declare_proto_rig(pause)
     sleep(seconds);
     return RIG_OK;
 }
+
+
+/* '0x8d' */
+declare_proto_rig(get_cache)
+{
+    int status;
+    unsigned long hits, misses;
+
+    status = rig_get_cache_stats(rig, &hits, &misses);
+
+    if (status != RIG_OK)
+    {
+        return status;
+    }
+
+    if ((interactive && prompt) || (interactive && !prompt && ext_resp))
+    {
+        fprintf(fout, "%s: ", cmd->arg1);
+    }
+
+    fprintf(fout, "%lu%c", hits, resp_sep);
+
+    if ((interactive && prompt) || (interactive && !prompt && ext_resp))
+    {
+        fprintf(fout, "%s: ", cmd->arg2);
+    }
+
+    fprintf(fout, "%lu%c", misses, resp_sep);
+
+    return status;
+}
+
+
+/* the non empty buckets, as upper_bound_us:count, if any */
+static void print_stats_hist(FILE *fout, const unsigned long *hist)
+{
+    const char *sep = " hist=";
+    int i;
+
+    for (i = 0; i < RIG_STATS_HIST_SIZE; i++)
+    {
+        if (!hist[i])
+        {
+            continue;
+        }
+
+        if (i == RIG_STATS_HIST_SIZE - 1)
+        {
+            fprintf(fout, "%sinf:%lu", sep, hist[i]);
+        }
+        else
+        {
+            fprintf(fout, "%s%lu:%lu", sep, 1UL << i, hist[i]);
+        }
+
+        sep = ",";
+    }
+
+    fprintf(fout, "\n");
+}
+
+
+static void print_port_stats(FILE *fout,
+                             const char *name,
+                             const struct rig_port_stats *ps)
+{
+    fprintf(fout, "%s: tx=%lu rx=%lu timeouts=%lu retries=%lu syscalls=%lu",
+            name, ps->tx_bytes, ps->rx_bytes, ps->timeouts, ps->retries,
+            ps->syscalls);
+    print_stats_hist(fout, ps->hist);
+}
+
+
+/*
+ * '0x8e'
+ *
+ * One line per operation called so far, then the port counters.
+ * hist lists the non empty latency buckets as upper_bound_us:count,
+ * for the ports those of the calls they served.
+ */
+declare_proto_rig(get_stats)
+{
+    struct rig_stats *stats;
+    int status;
+    int op;
+
+    stats = malloc(sizeof(*stats));
+
+    if (!stats)
+    {
+        return -RIG_ENOMEM;
+    }
+
+    status = rig_get_stats(rig, stats);
+
+    if (status != RIG_OK)
+    {
+        free(stats);
+        return status;
+    }
+
+    for (op = 0; op < RIG_STATS_NB_OPS; op++)
+    {
+        const struct rig_op_stats *os = &stats->op[op];
+        double mean, var;
+
+        if (!os->count)
+        {
+            continue;
+        }
+
+        mean = os->total_us / os->count;
+        var = os->total_sq_us / os->count - mean * mean;
+
+        fprintf(fout,
+                "%s: count=%lu errors=%lu retries=%lu timeouts=%lu tx=%lu "
+                "rx=%lu mean_us=%.0f jitter_us=%.0f max_us=%.0f",
+                rig_strstatsop(op), os->count, os->errors, os->retries,
+                os->timeouts, os->tx_bytes, os->rx_bytes,
+                mean, var > 0 ? sqrt(var) : 0, os->max_us);
+        print_stats_hist(fout, os->hist);
+    }
+
+    print_port_stats(fout, "rigport", &stats->rigport);
+    print_port_stats(fout, "pttport", &stats->pttport);
+    print_port_stats(fout, "dcdport", &stats->dcdport);
+
+    free(stats);
+
+    return RIG_OK;
+}
+
+
+/* '0x94' */
+declare_proto_rig(reset_stats)
+{
+    return rig_reset_stats(rig);
+}
@@ -45,9 +45,23 @@ int dump_chan(FILE *, RIG *, channel_t *);
 int print_conf_list(const struct confparams *cfp, rig_ptr_t data);
 int set_conf(RIG *my_rig, char *conf_parms);
 
-typedef void (*sync_cb_t)(int);
-int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc, sync_cb_t sync_cb,
-                 int interactive, int prompt, int vfo_mode, char send_cmd_term,
-                 int * ext_resp_ptr, char * resp_sep_ptr);
+typedef void (*sync_cb_t)(RIG *, int);
+
+/*
+ * Protocol state of one rigctl session or rigctld connection.  Commands
+ * are read line by line from fin, or, with fin NULL, from the buffers
+ * handed to rigctl_parse_buf().
+ */
+struct rigctl_parser;
+
+struct rigctl_parser *rigctl_parser_new(FILE *fin, int interactive, int prompt,
+                                        int vfo_mode, char send_cmd_term);
+void rigctl_parser_free(struct rigctl_parser *rp);
+
+int rigctl_parse(RIG *my_rig, struct rigctl_parser *rp, FILE *fout,
+                 char *argv[], int argc, sync_cb_t sync_cb);
+int rigctl_parse_buf(RIG *my_rig, struct rigctl_parser *rp, FILE *fout,
+                     const char *buf, size_t len, size_t *used,
+                     sync_cb_t sync_cb);
 
 #endif  /* RIGCTL_PARSE_H */
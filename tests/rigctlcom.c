@@ -40,9 +40,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
-#include <ctype.h>
 #include <errno.h>
 #include <signal.h>
+#include <stdarg.h>
+#include <sys/time.h>
+
+#ifdef HAVE_SYS_SELECT_H
+#  include <sys/select.h>
+#endif
 
 #include <getopt.h>
 
@@ -79,7 +84,7 @@
  * NB: do NOT use -W since it's reserved by POSIX.
  * TODO: add an option to read from a file
  */
-#define SHORT_OPTIONS "m:r:R:p:d:P:D:s:S:c:C:lLuvhVZ"
+#define SHORT_OPTIONS "m:r:R:p:d:P:D:s:S:c:C:i:lLuvhVZ"
 static struct option long_options[] =
 {
     {"model",           1, 0, 'm'},
@@ -93,6 +98,7 @@ static struct option long_options[] =
     {"serial-speed2",   1, 0, 'S'},
     {"civaddr",         1, 0, 'c'},
     {"set-conf",        1, 0, 'C'},
+    {"poll-interval",   1, 0, 'i'},
     {"list",            0, 0, 'l'},
     {"show-conf",       0, 0, 'L'},
     {"dump-caps",       0, 0, 'u'},
@@ -103,11 +109,52 @@ static struct option long_options[] =
     {0, 0, 0, 0}
 };
 
+#define MAX_COM_PORTS 8         /* virtual COM ports served at once */
+#define COM_CMD_SIZE 64         /* longest TS-2000 command */
+
+/*
+ * A program on one of the virtual COM ports
+ */
+struct com_client
+{
+    hamlib_port_t port;
+    int ai;                     /* auto information mode, set by AIn; */
+    char cmd[COM_CMD_SIZE];     /* command being received */
+    size_t len;
+};
+
+/*
+ * What the IF, FA, FB, MD, FR, FT and DC queries are answered from.
+ * Refreshed every poll_interval ms, and after any command which may
+ * have changed the rig.
+ */
+struct ts2000_snapshot
+{
+    freq_t freq_a;
+    freq_t freq_b;
+    rmode_t mode;
+    vfo_t vfo;
+    ptt_t ptt;
+    split_t split;
+    vfo_t tx_vfo;
+};
+
+#define COM_TIMEOUT 50          /* ms, to wait for the rest of a command */
+
 void usage();
-static int handle_ts2000(void *arg);
+static int64_t com_now(void);
+static int com_wait(int64_t timeout);
+static void com_read(struct com_client *c);
+static void snapshot_refresh(void);
+static void init_ts2000_index(void);
+static int handle_ts2000(struct com_client *c, const char *arg);
 
 static RIG *my_rig;             /* handle to rig */
-static hamlib_port_t my_com;    /* handle to virtual COM port */
+static struct com_client my_com[MAX_COM_PORTS]; /* virtual COM ports */
+static int ncom;
+static struct ts2000_snapshot snap;
+static int snap_stale = 1;      /* refresh before answering */
+static int snap_want_b;         /* a program queried FB */
 static int verbose;
 
 #ifdef HAVE_SIG_ATOMIC_T
@@ -198,14 +245,17 @@ int main(int argc, char *argv[])
 
     int show_conf = 0;
     int dump_caps_opt = 0;
-    const char *rig_file = NULL, *rig_file2 = NULL, *ptt_file = NULL,
-                *dcd_file = NULL;
+    const char *rig_file = NULL, *ptt_file = NULL, *dcd_file = NULL;
+    const char *rig_file2[MAX_COM_PORTS];
     ptt_type_t ptt_type = RIG_PTT_NONE;
     dcd_type_t dcd_type = RIG_DCD_NONE;
     int serial_rate = 0;
     int serial_rate2 = 115200;  /* virtual com port default speed */
     char *civaddr = NULL;       /* NULL means no need to set conf */
     char conf_parms[MAXCONFLEN] = "";
+    int poll_interval = 250;    /* ms between snapshot refreshes */
+    int64_t next_poll = 0;
+    int i;
 
     printf("rigctlcom Version 1.1\n");
 
@@ -262,7 +312,13 @@ int main(int argc, char *argv[])
                 exit(1);
             }
 
-            rig_file2 = optarg;
+            if (ncom == MAX_COM_PORTS)
+            {
+                fprintf(stderr, "At most %d -R com ports\n", MAX_COM_PORTS);
+                exit(1);
+            }
+
+            rig_file2[ncom++] = optarg;
             break;
 
 
@@ -392,6 +448,22 @@ int main(int argc, char *argv[])
             serial_rate2 = atoi(optarg);
             break;
 
+        case 'i':
+            if (!optarg)
+            {
+                usage();        /* wrong arg count */
+                exit(1);
+            }
+
+            poll_interval = atoi(optarg);
+
+            if (poll_interval < 1)
+            {
+                poll_interval = 1;
+            }
+
+            break;
+
 
         case 'C':
             if (!optarg)
@@ -478,13 +550,16 @@ int main(int argc, char *argv[])
         strncpy(my_rig->state.rigport.pathname, rig_file, FILPATHLEN - 1);
     }
 
-    if (!rig_file2)
+    if (!ncom)
     {
         fprintf(stderr, "-R com port not provided\n");
         exit(2);
     }
 
-    strncpy(my_com.pathname, rig_file2, FILPATHLEN - 1);
+    for (i = 0; i < ncom; i++)
+    {
+        strncpy(my_com[i].port.pathname, rig_file2[i], FILPATHLEN - 1);
+    }
 
     /*
      * ex: RIG_PTT_PARALLEL and /dev/parport0
@@ -517,7 +592,10 @@ int main(int argc, char *argv[])
 
     if (serial_rate2 != 0)
     {
-        my_com.parm.serial.rate = serial_rate2;
+        for (i = 0; i < ncom; i++)
+        {
+            my_com[i].port.parm.serial.rate = serial_rate2;
+        }
     }
 
 
@@ -567,97 +645,229 @@ int main(int argc, char *argv[])
     /*
      * main loop
      */
-    my_com.type.rig = RIG_PORT_SERIAL;
-    my_com.parm.serial.data_bits = 8;
-    my_com.parm.serial.stop_bits = 1;
-    my_com.timeout = 5000;
-    my_com.parm.serial.parity = RIG_PARITY_NONE;
-    my_com.parm.serial.handshake = RIG_HANDSHAKE_NONE;
+    for (i = 0; i < ncom; i++)
+    {
+        hamlib_port_t *port = &my_com[i].port;
+
+        port->type.rig = RIG_PORT_SERIAL;
+        port->parm.serial.data_bits = 8;
+        port->parm.serial.stop_bits = 1;
+        port->timeout = COM_TIMEOUT;
+        port->parm.serial.parity = RIG_PARITY_NONE;
+        port->parm.serial.handshake = RIG_HANDSHAKE_NONE;
+
+        if (port_open(port) != RIG_OK)
+        {
+            rig_debug(RIG_DEBUG_ERR, "Unable to open %s\n", port->pathname);
+            exit(2);
+        }
 
-    int status = port_open(&my_com);
+        if (verbose > 0)
+        {
+            fprintf(stderr, " %s opened for application program\n",
+                    port->pathname);
+        }
+    }
+
+    init_ts2000_index();
 
-    if (status != RIG_OK)
+    while (!ctrl_c)
     {
-        rig_debug(RIG_DEBUG_ERR, "Unable to open %s\n", my_com.pathname);
-        exit(2);
+        int64_t now = com_now();
+        int ready;
+
+        if (snap_stale || now >= next_poll)
+        {
+            snapshot_refresh();
+            next_poll = now + poll_interval;
+        }
+
+        ready = com_wait(next_poll - now);
+
+        for (i = 0; i < ncom; i++)
+        {
+            if (ready & (1 << i))
+            {
+                com_read(&my_com[i]);
+            }
+        }
     }
 
-    if (verbose > 0)
+    rig_close(my_rig);          /* close port */
+    rig_cleanup(my_rig);        /* if you care about memory */
+
+    return 0;
+}
+
+
+static int64_t com_now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+
+/*
+ * Wait up to timeout ms for commands, and return the ports which have
+ * some as a bit mask.
+ */
+static int com_wait(int64_t timeout)
+{
+#ifdef WIN32
+    /* no select() on serial ports, read_string() waits on each of them */
+    return (1 << ncom) - 1;
+#else
+    fd_set rfds;
+    struct timeval tv;
+    int i, maxfd = -1, ready = 0;
+
+    FD_ZERO(&rfds);
+
+    for (i = 0; i < ncom; i++)
     {
-        fprintf(stderr, " %s opened for application program\n", my_com.pathname);
+        FD_SET(my_com[i].port.fd, &rfds);
+
+        if (my_com[i].port.fd > maxfd)
+        {
+            maxfd = my_com[i].port.fd;
+        }
     }
 
-    do
+    if (timeout < 0)
+    {
+        timeout = 0;
+    }
+
+    tv.tv_sec = timeout / 1000;
+    tv.tv_usec = (timeout % 1000) * 1000;
+
+    if (select(maxfd + 1, &rfds, NULL, NULL, &tv) <= 0)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < ncom; i++)
     {
-        char ts2000[1024];
-        char *stop_set = ";\n\r";
+        if (FD_ISSET(my_com[i].port.fd, &rfds))
+        {
+            ready |= 1 << i;
+        }
+    }
+
+    return ready;
+#endif
+}
 
-        memset(ts2000, 0, sizeof(ts2000));
-        serial_flush(&my_com);  // get rid of anything in the queue
 
-        status = read_string(&my_com,
-                             ts2000,
-                             sizeof(ts2000),
-                             stop_set,
-                             strlen(stop_set));
+/*
+ * Run the commands received on a port.  A command may come in pieces,
+ * and several in one write.
+ */
+static void com_read(struct com_client *c)
+{
+    char buf[COM_CMD_SIZE];
+    char *stop_set = ";\n\r";
+    int n, i;
+
+    do
+    {
+        n = read_string(&c->port, buf, sizeof(buf), stop_set,
+                        strlen(stop_set));
 
-        rig_debug(RIG_DEBUG_TRACE, "%s: status=%d\n", __func__, status);
+        if (n == -RIG_EIO)
+        {
+            /* the program went away, don't spin on its port */
+            usleep(COM_TIMEOUT * 1000);
+            return;
+        }
 
-        if (strlen(ts2000) > 0)
+        for (i = 0; i < n; i++)
         {
-            int retval = handle_ts2000(ts2000);
+            int retval;
+
+            if (buf[i] == '\n' || buf[i] == '\r')
+            {
+                continue;
+            }
+
+            if (c->len == sizeof(c->cmd) - 1)
+            {
+                rig_debug(RIG_DEBUG_ERR, "%s: command too long on %s\n",
+                          __func__, c->port.pathname);
+                c->len = 0;
+            }
+
+            c->cmd[c->len++] = buf[i];
+
+            if (buf[i] != ';')
+            {
+                continue;
+            }
+
+            c->cmd[c->len] = '\0';
+            c->len = 0;
+
+            retval = handle_ts2000(c, c->cmd);
 
             if (retval != RIG_OK)
             {
                 rig_debug(RIG_DEBUG_ERR, "%s: %s\n", __func__, rigerror(retval));
             }
         }
-
     }
-    while (retcode == 0 && !ctrl_c);
-
-    rig_close(my_rig);          /* close port */
-    rig_cleanup(my_rig);        /* if you care about memory */
-
-    return 0;
+    while (n > 0 && c->port.rx.count > 0);
 }
 
 
-static rmode_t ts2000_get_mode()
+static int ts2000_mode(rmode_t mode)
 {
-    rmode_t mode;
-    pbwidth_t width;
-    rig_get_mode(my_rig, RIG_VFO_A, &mode, &width);
-
     // Perhaps we should emulate a rig that has PKT modes instead??
     switch (mode)
     {
-    case RIG_MODE_LSB:   mode = 1; break;
+    case RIG_MODE_LSB:   return 1;
 
-    case RIG_MODE_USB:   mode = 2; break;
+    case RIG_MODE_USB:   return 2;
 
-    case RIG_MODE_CW:    mode = 3; break;
+    case RIG_MODE_CW:    return 3;
 
-    case RIG_MODE_FM:    mode = 4; break;
+    case RIG_MODE_FM:    return 4;
 
-    case RIG_MODE_AM:    mode = 5; break;
+    case RIG_MODE_AM:    return 5;
 
-    case RIG_MODE_RTTY:  mode = 6; break;
+    case RIG_MODE_RTTY:  return 6;
 
-    case RIG_MODE_CWR:   mode = 7; break;
+    case RIG_MODE_CWR:   return 7;
 
-    case RIG_MODE_NONE:  mode = 8; break;
+    case RIG_MODE_NONE:  return 8;
 
-    case RIG_MODE_RTTYR: mode = 9; break;
+    case RIG_MODE_RTTYR: return 9;
 
-    case RIG_MODE_PKTUSB: mode = 2; break; // need to change to a TS_2000 mode
+    case RIG_MODE_PKTUSB: return 2; // need to change to a TS_2000 mode
 
-    case RIG_MODE_PKTLSB: mode = 1; break; // need to change to a TS_2000 mode
+    case RIG_MODE_PKTLSB: return 1; // need to change to a TS_2000 mode
 
-    default: mode = 0; break;
+    default: return 0;
     }
+}
+
+
+static int ts2000_vfo(vfo_t vfo)
+{
+    switch (vfo)
+    {
+    case RIG_VFO_A:
+        return 0;
+
+    case RIG_VFO_B:
+        return 1;
 
-    return mode;
+    default:
+        rig_debug(RIG_DEBUG_ERR, "%s: unexpected vfo=%d\n", __func__, vfo);
+        return 0;
+    }
 }
 
 
@@ -678,839 +888,796 @@ static int write_block2(void *func,
 }
 
 
-/*
- * This handles the TS-2000 emulation
- */
-static int handle_ts2000(void *arg)
+static int ts2000_reply(struct com_client *c, const char *fmt, ...)
 {
-    // Handle all the queries
-    if (strcmp(arg, "ID;") == 0)
-    {
-        char *reply = "ID019;";
-        return write_block2((void *)__func__, &my_com, reply, strlen(reply));
-    }
+    char response[64];
+    va_list ap;
 
-    if (strcmp(arg, "AI;") == 0)
-    {
-        char *reply = "AI0;";
-        return write_block2((void *)__func__, &my_com, reply, strlen(reply));
-    }
-    else if (strcmp(arg, "IF;") == 0)
-    {
-        freq_t freq;            // P1
-        int freq_step = 10;     // P2 just use default value for now
-        int rit_xit_freq = 0;   // P3 dummy value for now
-        int rit = 0;            // P4 dummy value for now
-        int xit = 0;            // P5 dummy value for now
-        int bank1 = 0;          // P6 dummy value for now
-        int bank2 = 0;          // P7 dummy value for now
-        ptt_t ptt;              // P8
-        rmode_t mode;           // P9
-        vfo_t vfo;              // P10
-        int scan = 0;           // P11 dummy value for now
-        split_t split = 0;      // P1 2
-        int p13 = 0;            // P13 Tone dummy value for now
-        int p14 = 0;            // P14 Tone Freq dummy value for now
-        int p15 = 0;            // P15 Shift status dummy value for now
-        char response[64];
-        int retval = rig_get_freq(my_rig, RIG_VFO_A, &freq);
+    va_start(ap, fmt);
+    vsnprintf(response, sizeof(response), fmt, ap);
+    va_end(ap);
 
-        if (retval != RIG_OK)
-        {
-            return retval;
-        }
+    return write_block2((void *)__func__, &c->port, response, strlen(response));
+}
 
-        mode = ts2000_get_mode();
-        retval = rig_get_ptt(my_rig, RIG_VFO_A, &ptt);
 
-        if (retval != RIG_OK)
-        {
-            return retval;
-        }
+/* answer "?;" to what the rig cannot do */
+static int ts2000_refuse(struct com_client *c, int retval)
+{
+    if (retval == -RIG_ENIMPL || retval == -RIG_ENAVAIL)
+    {
+        return ts2000_reply(c, "?;");
+    }
 
-        if (ptt)
-        {
-            retval = rig_get_split_vfo(my_rig, RIG_VFO_CURR, &split, &vfo);
-        }
-        else
-        {
-            retval = rig_get_vfo(my_rig, &vfo);
-        }
+    return retval;
+}
 
-        if (retval != RIG_OK)
-        {
-            return retval;
-        }
 
-        switch (vfo)
-        {
-        case RIG_VFO_A:
-            vfo = 0;
-            break;
+static int ts2000_unknown(const char *arg)
+{
+    rig_debug(RIG_DEBUG_ERR,
+              "*********************************\n%s: unknown cmd='%s'\n",
+              __func__,
+              arg);
+    return -RIG_EINVAL;
+}
 
-        case RIG_VFO_B:
-            vfo = 1;
-            break;
 
-        default:
-            rig_debug(RIG_DEBUG_ERR, "%s: unexpected vfo=%d\n", __func__, vfo);
-        }
+static int ts2000_if_reply(struct com_client *c)
+{
+    int freq_step = 10;     // P2 just use default value for now
+    int rit_xit_freq = 0;   // P3 dummy value for now
+    int rit = 0;            // P4 dummy value for now
+    int xit = 0;            // P5 dummy value for now
+    int bank1 = 0;          // P6 dummy value for now
+    int bank2 = 0;          // P7 dummy value for now
+    int scan = 0;           // P11 dummy value for now
+    int p13 = 0;            // P13 Tone dummy value for now
+    int p14 = 0;            // P14 Tone Freq dummy value for now
+    int p15 = 0;            // P15 Shift status dummy value for now
+    vfo_t vfo = snap.ptt && snap.split ? snap.tx_vfo : snap.vfo;
+
+    return ts2000_reply(c,
+                        "IF%011"PRIll"%04d+%05d%1d%1d%1d%02d%1d%1d%1d%1d%1d%1d%02d%1d;",
+                        (uint64_t)snap.freq_a,
+                        freq_step,
+                        rit_xit_freq,
+                        rit, xit,
+                        bank1,
+                        bank2,
+                        snap.ptt != RIG_PTT_OFF,
+                        ts2000_mode(snap.mode),
+                        ts2000_vfo(vfo),
+                        scan,
+                        snap.split != RIG_SPLIT_OFF,
+                        p13,
+                        p14,
+                        p15);
+}
 
-        snprintf(response,
-                 sizeof(response),
-                 "IF%011"PRIll"%04d+%05d%1d%1d%1d%02d%1d%1"PRIll"%1d%1d%1d%1d%02d%1d;",
-                 (uint64_t)freq,
-                 freq_step,
-                 rit_xit_freq,
-                 rit, xit,
-                 bank1,
-                 bank2,
-                 ptt,
-                 mode,
-                 vfo,
-                 scan,
-                 split,
-                 p13,
-                 p14,
-                 p15);
 
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
-    }
-    else if (strcmp(arg, "MD;") == 0)
-    {
-        rmode_t mode = ts2000_get_mode();
-        char response[32];
+/*
+ * Read the state the queries are answered from, and tell the programs
+ * in auto information mode what changed.
+ */
+static void snapshot_refresh(void)
+{
+    static int have_snap;
+    struct ts2000_snapshot old = snap;
+    struct rig_multi req[5];
+    int freq_a = -1, freq_b = -1, mode = -1, vfo, ptt;
+    int want_b = snap_want_b;
+    int retval, i, n = 0;
 
-        snprintf(response, sizeof(response), "MD%1d;", (int)mode);
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
-    }
-    else if (strcmp(arg, "AG0;") == 0)
+    /*
+     * VFO B only when it can be read without switching VFO, or when a
+     * program wants it.
+     */
+    if (my_rig->caps->targetable_vfo & RIG_TARGETABLE_FREQ)
     {
-        char response[32];
-
-        snprintf(response, sizeof(response), "AG0000;");
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
+        want_b = 1;
     }
-    else if (strcmp(arg, "FA;") == 0)
-    {
-        freq_t freq = 0;
-        int retval = rig_get_freq(my_rig, RIG_VFO_A, &freq);
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: get freqA failed: %s\n", __func__,
-                      rigerror(retval));
-            return retval;
-        }
+    for (i = 0; i < ncom && !want_b; i++)
+    {
+        want_b = my_com[i].ai;
+    }
 
-        char response[32];
+    memset(req, 0, sizeof(req));
 
-        snprintf(response, sizeof(response), "FA%011"PRIll";", (uint64_t)freq);
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
+    /* no VFO switch while transmitting, the other VFO keeps its value */
+    if (snap.ptt == RIG_PTT_OFF || snap.vfo != RIG_VFO_B)
+    {
+        freq_a = n;
+        req[n].what = RIG_MULTI_FREQ;
+        req[n++].vfo = RIG_VFO_A;
+        mode = n;
+        req[n].what = RIG_MULTI_MODE;
+        req[n++].vfo = RIG_VFO_A;
     }
-    else if (strcmp(arg, "FB;") == 0)
+
+    if (want_b && (snap.ptt == RIG_PTT_OFF || snap.vfo == RIG_VFO_B))
     {
-        freq_t freq = 0;
-        int retval = rig_get_freq(my_rig, RIG_VFO_B, &freq);
+        freq_b = n;
+        req[n].what = RIG_MULTI_FREQ;
+        req[n++].vfo = RIG_VFO_B;
+    }
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: get freqB failed: %s\n", __func__,
-                      rigerror(retval));
-            return retval;
-        }
+    vfo = n;
+    req[n++].what = RIG_MULTI_VFO;
+    ptt = n;
+    req[n].what = RIG_MULTI_PTT;
+    req[n++].vfo = RIG_VFO_CURR;
 
-        char response[32];
+    snap_stale = 0;
 
-        snprintf(response, sizeof(response), "FB%011"PRIll";", (uint64_t)freq);
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
-    }
-    else if (strcmp(arg, "SA;") == 0)
-    {
-        char response[32];
+    /* a value which cannot be read keeps the last one */
+    retval = rig_get_multi(my_rig, req, n);
 
-        snprintf(response, sizeof(response), "SA0;");
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
-    }
-    else if (strcmp(arg, "RX;") == 0)
+    if (retval != RIG_OK)
     {
-        char response[32];
-
-        snprintf(response, sizeof(response), "RX0;");
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
+        rig_debug(RIG_DEBUG_ERR, "%s: %s\n", __func__, rigerror(retval));
+        return;
     }
-    // Now some commands to set things
-    else if (strcmp(arg, "TX;") == 0)
+
+    if (freq_a >= 0 && req[freq_a].status == RIG_OK)
     {
-        return rig_set_ptt(my_rig, RIG_VFO_A, 1);
+        snap.freq_a = req[freq_a].val.freq;
     }
-    else if (strcmp(arg, "AI0;") == 0)
+
+    if (freq_b >= 0 && req[freq_b].status == RIG_OK)
     {
-        // nothing to do
-        return RIG_OK;
+        snap.freq_b = req[freq_b].val.freq;
     }
-    else if (strcmp(arg, ";") == 0)
+
+    if (mode >= 0 && req[mode].status == RIG_OK)
     {
-        // nothing to do
-        return RIG_OK;
+        snap.mode = req[mode].val.mode.mode;
     }
-    else if (strcmp(arg, "FR0;") == 0)
+
+    if (req[vfo].status == RIG_OK) { snap.vfo = req[vfo].val.vfo; }
+
+    if (req[ptt].status == RIG_OK) { snap.ptt = req[ptt].val.ptt; }
+
+    retval = rig_get_split_vfo(my_rig, RIG_VFO_A, &snap.split, &snap.tx_vfo);
+
+    if (retval != RIG_OK)
     {
-        return rig_set_vfo(my_rig, RIG_VFO_A);
+        snap.split = RIG_SPLIT_OFF;
+        snap.tx_vfo = snap.vfo;
     }
-    else if (strcmp(arg, "FR1;") == 0)
+
+    if (!have_snap)
     {
-        return rig_set_vfo(my_rig, RIG_VFO_B);
+        have_snap = 1;
+        return;
     }
-    else if (strcmp(arg, "FR;") == 0)
-    {
-        vfo_t vfo;
-        int retval = rig_get_vfo(my_rig, &vfo);
 
-        if (retval != RIG_OK)
+    for (i = 0; i < ncom; i++)
+    {
+        if (!my_com[i].ai)
         {
-            rig_debug(RIG_DEBUG_ERR, "%s: get vfo failed: %s\n", __func__,
-                      rigerror(retval));
-            return retval;
+            continue;
         }
 
-        int nvfo = 0;
+        if (snap.freq_a != old.freq_a
+                || snap.mode != old.mode
+                || snap.vfo != old.vfo
+                || snap.ptt != old.ptt
+                || snap.split != old.split
+                || snap.tx_vfo != old.tx_vfo)
+        {
+            ts2000_if_reply(&my_com[i]);
+        }
 
-        if (vfo == RIG_VFO_A) { nvfo = 0; }
-        else if (vfo == RIG_VFO_B) { nvfo = 1; }
-        else
+        if (snap.freq_b != old.freq_b)
         {
-            retval = -RIG_EPROTO;
-            return retval;
+            ts2000_reply(&my_com[i], "FB%011"PRIll";", (uint64_t)snap.freq_b);
         }
+    }
+}
 
-        char response[32];
-        snprintf(response, sizeof(response), "FR%c;", nvfo + '0');
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
 
-        return retval;
-    }
-    else if (strcmp(arg, "FT;") == 0)
+/* the snapshot, up to date with the commands run so far */
+static const struct ts2000_snapshot *snapshot(void)
+{
+    if (snap_stale)
     {
-        vfo_t vfo, vfo_curr = RIG_VFO_A;
-        split_t split;
-        int retval = rig_get_split_vfo(my_rig, vfo_curr, &split, &vfo);
+        snapshot_refresh();
+    }
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: get split vfo failed: %s\n", __func__,
-                      rigerror(retval));
-            return retval;
-        }
+    return &snap;
+}
 
-        int nvfo = 0;
 
-        if (vfo == RIG_VFO_A) { nvfo = 0; }
-        else if (vfo == RIG_VFO_B) { nvfo = 1; }
-        else
-        {
-            retval = -RIG_EPROTO;
-            return retval;
-        }
+/*
+ * The TS-2000 commands.  Each handler gets the whole command, query
+ * ("XX;") or set, and any set marks the snapshot stale.
+ */
+static int ts2000_id(struct com_client *c, const char *arg)
+{
+    if (strcmp(arg, "ID;") == 0)
+    {
+        return ts2000_reply(c, "ID019;");
+    }
 
-        char response[32];
-        snprintf(response, sizeof(response), "FT%c;", nvfo + '0');
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
+    return ts2000_unknown(arg);
+}
 
-        return retval;
-    }
-    else if (strcmp(arg, "TN;") == 0)
-    {
-        tone_t val;
-        int retval = rig_get_ctcss_tone(my_rig, RIG_VFO_CURR, &val);
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: get_func XIT failed: %s\n", __func__,
-                      rigerror(retval));
-            return retval;
-        }
+static int ts2000_ai(struct com_client *c, const char *arg)
+{
+    int ai;
 
-        char response[32];
-        snprintf(response, sizeof(response), "TN%02d;", val);
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
-    }
-    else if (strncmp(arg, "TN", 2) == 0)
+    if (strcmp(arg, "AI;") == 0)
     {
-        int ival = 0;
-        sscanf(arg, "TN%d", &ival);
-        tone_t val = ival;
-        int retval = rig_set_ctcss_tone(my_rig, RIG_VFO_CURR, val);
-
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: set_ctcss_tone failed: %s\n", __func__,
-                      rigerror(retval));
-        }
-
-        return retval;
+        return ts2000_reply(c, "AI%d;", c->ai);
     }
-    else if (strcmp(arg, "PA;") == 0)
+
+    if (sscanf(arg, "AI%1d;", &ai) != 1 || ai < 0 || ai > 3)
     {
-        int valA;
-        int retval = rig_get_func(my_rig, RIG_VFO_A, RIG_FUNC_AIP, &valA);
+        return ts2000_unknown(arg);
+    }
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: get_func preamp A failed: %s\n", __func__,
-                      rigerror(retval));
+    c->ai = ai;
 
-            if (retval == -RIG_ENIMPL || retval == -RIG_ENAVAIL)
-            {
-                char *response = "?;";
-                return write_block2((void *)__func__, &my_com, response, strlen(response));
-            }
+    return RIG_OK;
+}
 
-            return retval;
-        }
 
-        int valB;
-        retval = rig_get_func(my_rig, RIG_VFO_B, RIG_FUNC_AIP, &valB);
+static int ts2000_if(struct com_client *c, const char *arg)
+{
+    if (strcmp(arg, "IF;") == 0)
+    {
+        snapshot();
+        return ts2000_if_reply(c);
+    }
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: get_func preamp B failed: %s\n", __func__,
-                      rigerror(retval));
-            return retval;
-        }
+    return ts2000_unknown(arg);
+}
 
-        char response[32];
-        snprintf(response, sizeof(response), "PA%c%c;", valA + '0', valB + '0');
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
-    }
-    else if (strncmp(arg, "PA", 2) == 0)
+
+static int ts2000_md(struct com_client *c, const char *arg)
+{
+    rmode_t mode;
+    int imode = 0;
+
+    if (strcmp(arg, "MD;") == 0)
     {
-        int valA = 0;
-        int valB = 0;
-        int n = sscanf(arg, "PA%1d%1d", &valA, &valB);
+        return ts2000_reply(c, "MD%1d;", ts2000_mode(snapshot()->mode));
+    }
 
-        if (n != 2)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: error parsing preamp cmd '%s'\n", __func__,
-                      (char *)arg);
-        }
+    sscanf(arg + 2, "%d", &imode);
 
-        int retval = rig_set_func(my_rig, RIG_VFO_A, RIG_FUNC_AIP, valA);
+    switch (imode)
+    {
+    case 1: mode = RIG_MODE_LSB; break;
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: set_func preamp failed: %s\n", __func__,
-                      rigerror(retval));
-            return retval;
-        }
+    case 2: mode = RIG_MODE_USB; break;
 
-        retval = rig_set_func(my_rig, RIG_VFO_B, RIG_FUNC_AIP, valB);
+    case 3: mode = RIG_MODE_CW; break;
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: set_func preamp failed: %s\n", __func__,
-                      rigerror(retval));
-            return retval;
-        }
+    case 4: mode = RIG_MODE_FM; break;
 
-        return retval;
-    }
-    else if (strcmp(arg, "XT;") == 0)
-    {
-        int val;
-        int retval = rig_get_func(my_rig, RIG_VFO_CURR, RIG_FUNC_XIT, &val);
+    case 5: mode = RIG_MODE_AM; break;
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: get_func XIT failed: %s\n", __func__,
-                      rigerror(retval));
+    case 6: mode = RIG_MODE_RTTY; break;
 
-            if (retval == -RIG_ENIMPL || retval == -RIG_ENAVAIL)
-            {
-                char *response = "?;";
-                return write_block2((void *)__func__, &my_com, response, strlen(response));
-            }
+    case 7: mode = RIG_MODE_CWR; break;
 
-            return retval;
-        }
+    case 9: mode = RIG_MODE_RTTYR; break;
 
-        char response[32];
-        snprintf(response, sizeof(response), "XT%c;", val + '0');
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
+    default:
+        rig_debug(RIG_DEBUG_ERR, "%s: error parsing '%s'\n", __func__, arg);
+        return -RIG_EPROTO;
     }
-    else if (strncmp(arg, "XT", 2) == 0)
-    {
-        int val = 0;
-        sscanf(arg, "XT%d", &val);
-        int retval = rig_set_func(my_rig, RIG_VFO_CURR, RIG_FUNC_XIT, val);
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: set_func XIT failed: %s\n", __func__,
-                      rigerror(retval));
+    snap_stale = 1;
 
-            if (retval == -RIG_ENIMPL || retval == -RIG_ENAVAIL)
-            {
-                char *response = "?;";
-                return write_block2((void *)__func__, &my_com, response, strlen(response));
-            }
-        }
+    return rig_set_mode(my_rig, RIG_VFO_A, mode, RIG_PASSBAND_NOCHANGE);
+}
 
-        return retval;
+
+static int ts2000_freq(struct com_client *c, const char *arg, vfo_t vfo,
+                       freq_t snap_freq)
+{
+    freq_t freq;
+
+    if (arg[2] == ';')
+    {
+        return ts2000_reply(c, "%.2s%011"PRIll";", arg, (uint64_t)snap_freq);
     }
-    else if (strcmp(arg, "NR;") == 0)
+
+    if (sscanf(arg + 2, "%"SCNfreq, &freq) != 1)
     {
-        int val;
-        int retval = rig_get_func(my_rig, RIG_VFO_CURR, RIG_FUNC_NR, &val);
+        return ts2000_unknown(arg);
+    }
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: get NR failed: %s\n", __func__, rigerror(retval));
+    snap_stale = 1;
 
-            if (retval == -RIG_ENIMPL || retval == -RIG_ENAVAIL)
-            {
-                char *response = "?;";
-                return write_block2((void *)__func__, &my_com, response, strlen(response));
-            }
+    return rig_set_freq(my_rig, vfo, freq);
+}
 
-            return retval;
-        }
 
-        char response[32];
-        snprintf(response, sizeof(response), "NR%c;", val + '0');
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
-    }
-    else if (strncmp(arg, "NR", 2) == 0)
+static int ts2000_fa(struct com_client *c, const char *arg)
+{
+    return ts2000_freq(c, arg, RIG_VFO_A, snapshot()->freq_a);
+}
+
+
+static int ts2000_fb(struct com_client *c, const char *arg)
+{
+    /* VFO B is polled from the first query on */
+    if (strcmp(arg, "FB;") == 0 && !snap_want_b)
     {
-        int val = 0;
-        sscanf(arg, "NR%d", &val);
-        int retval = rig_set_func(my_rig, RIG_VFO_CURR, RIG_FUNC_NR, val);
+        snap_want_b = 1;
+        snap_stale = 1;
+    }
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: set NR failed: %s\n", __func__, rigerror(retval));
+    return ts2000_freq(c, arg, RIG_VFO_B, snapshot()->freq_b);
+}
 
-            if (retval == -RIG_ENIMPL || retval == -RIG_ENAVAIL)
-            {
-                char *response = "?;";
-                return write_block2((void *)__func__, &my_com, response, strlen(response));
-            }
-        }
 
-        return retval;
-    }
-    else if (strcmp(arg, "NB;") == 0)
+static int ts2000_sa(struct com_client *c, const char *arg)
+{
+    if (strcmp(arg, "SA;") == 0)
     {
-        int val;
-        int retval = rig_get_func(my_rig, RIG_VFO_CURR, RIG_FUNC_NB, &val);
-
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: get func NB failed: %s\n", __func__,
-                      rigerror(retval));
+        return ts2000_reply(c, "SA0;");
+    }
 
-            if (retval == -RIG_ENIMPL || retval == -RIG_ENAVAIL)
-            {
-                char *response = "?;";
-                return write_block2((void *)__func__, &my_com, response, strlen(response));
-            }
+    return ts2000_unknown(arg);
+}
 
-            return retval;
-        }
 
-        char response[32];
-        snprintf(response, sizeof(response), "NB%c;", val + '0');
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
-    }
-    else if (strncmp(arg, "NB", 2) == 0)
+static int ts2000_rx(struct com_client *c, const char *arg)
+{
+    if (strcmp(arg, "RX;") == 0)
     {
-        int val = 0;
-        sscanf(arg, "NB%d", &val);
-        int retval = rig_set_func(my_rig, RIG_VFO_CURR, RIG_FUNC_NB, val);
+        return ts2000_reply(c, "RX0;");
+    }
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: set_ant failed: %s\n", __func__,
-                      rigerror(retval));
+    return ts2000_unknown(arg);
+}
 
-            if (retval == -RIG_ENIMPL || retval == -RIG_ENAVAIL)
-            {
-                char *response = "?;";
-                return write_block2((void *)__func__, &my_com, response, strlen(response));
-            }
-        }
 
-        return retval;
-    }
-    else if (strcmp(arg, "AG;") == 0)
+static int ts2000_tx(struct com_client *c, const char *arg)
+{
+    (void) c;
+    if (strcmp(arg, "TX;") == 0)
     {
-        value_t val;
-        int retval = rig_get_level(my_rig, RIG_VFO_CURR, RIG_LEVEL_AF, &val);
+        snap_stale = 1;
+        return rig_set_ptt(my_rig, RIG_VFO_A, 1);
+    }
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: get_level AF failed: %s\n", __func__,
-                      rigerror(retval));
+    return ts2000_unknown(arg);
+}
 
-            if (retval == -RIG_ENIMPL || retval == -RIG_ENAVAIL)
-            {
-                char *response = "?;";
-                return write_block2((void *)__func__, &my_com, response, strlen(response));
-            }
 
-            return retval;
-        }
+static int ts2000_fr(struct com_client *c, const char *arg)
+{
+    vfo_t vfo;
 
-        char response[32];
-        int level = val.f * 255;
-        snprintf(response, sizeof(response), "AG0%03d;", level);
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
+    if (strcmp(arg, "FR0;") == 0)
+    {
+        snap_stale = 1;
+        return rig_set_vfo(my_rig, RIG_VFO_A);
     }
-    else if (strncmp(arg, "AG", 2) == 0)
+    else if (strcmp(arg, "FR1;") == 0)
     {
-        int level = 0;
-        int n = sscanf(arg, "AG%d", &level);
+        snap_stale = 1;
+        return rig_set_vfo(my_rig, RIG_VFO_B);
+    }
+    else if (strcmp(arg, "FR;") != 0)
+    {
+        return ts2000_unknown(arg);
+    }
 
-        if (n != 1)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: af level cmd parse failed: %s\n", __func__,
-                      (char *)arg);
-            return -RIG_EPROTO;
-        }
+    vfo = snapshot()->vfo;
 
-        value_t val;
-        val.f = level / 255.0;
-        int retval = rig_set_level(my_rig, RIG_VFO_CURR, RIG_LEVEL_AF, val);
+    if (vfo != RIG_VFO_A && vfo != RIG_VFO_B)
+    {
+        return -RIG_EPROTO;
+    }
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: set_level AF failed: %s\n", __func__,
-                      rigerror(retval));
-        }
+    return ts2000_reply(c, "FR%c;", ts2000_vfo(vfo) + '0');
+}
 
-        return retval;
+
+static int ts2000_ft(struct com_client *c, const char *arg)
+{
+    vfo_t vfo;
+
+    if (strcmp(arg, "FT0;") == 0)
+    {
+        snap_stale = 1;
+        return rig_set_split_vfo(my_rig, RIG_VFO_A, RIG_SPLIT_OFF, RIG_VFO_A);
+    }
+    else if (strcmp(arg, "FT1;") == 0)
+    {
+        snap_stale = 1;
+        return rig_set_split_vfo(my_rig, RIG_VFO_A, RIG_SPLIT_ON, RIG_VFO_B);
     }
-    else if (strcmp(arg, "PR;") == 0)
+    else if (strcmp(arg, "FT;") != 0)
     {
-        value_t val;
-        int retval = rig_get_level(my_rig, RIG_VFO_CURR, RIG_LEVEL_COMP, &val);
+        return ts2000_unknown(arg);
+    }
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: get_level speech processor failed: %s\n",
-                      __func__, rigerror(retval));
+    vfo = snapshot()->tx_vfo;
 
-            if (retval == -RIG_ENIMPL || retval == -RIG_ENAVAIL)
-            {
-                char *response = "?;";
-                return write_block2((void *)__func__, &my_com, response, strlen(response));
-            }
+    if (vfo != RIG_VFO_A && vfo != RIG_VFO_B)
+    {
+        return -RIG_EPROTO;
+    }
 
-            return retval;
-        }
+    return ts2000_reply(c, "FT%c;", ts2000_vfo(vfo) + '0');
+}
 
-        char response[32];
-        int speechLevel = val.f * 255;
-        snprintf(response, sizeof(response), "PR%03d;", speechLevel);
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
-    }
-    else if (strncmp(arg, "PR", 2) == 0)
-    {
-        int speechLevel = 0;
-        int n = sscanf(arg, "PR%d", &speechLevel);
 
-        if (n != 1)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: speech level cmd parse failed: %s\n", __func__,
-                      (char *)arg);
-            return -RIG_EPROTO;
-        }
+static int ts2000_dc(struct com_client *c, const char *arg)
+{
+    vfo_t vfo_curr = RIG_VFO_A;
+    int isplit;
+    int retval;
 
-        value_t val;
-        val.f = speechLevel / 255.0;
-        int retval = rig_set_level(my_rig, RIG_VFO_CURR, RIG_LEVEL_COMP, val);
+    if (strcmp(arg, "DC;") == 0)
+    {
+        return ts2000_reply(c, "DC%c;", snapshot()->split + '0');
+    }
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: set_level AGC failed: %s\n", __func__,
-                      rigerror(retval));
-        }
+    // Expecting DCnn -- but we dont' care about the control param
+    if (sscanf(arg, "DC%d", &isplit) != 1)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: error parsing '%s'\n", __func__, arg);
+        return -RIG_EPROTO;
+    }
 
-        if (retval == -RIG_ENIMPL || retval == -RIG_ENAVAIL)
-        {
-            char *response = "?;";
-            return write_block2((void *)__func__, &my_com, response, strlen(response));
-        }
+    snap_stale = 1;
+    retval = rig_set_split_vfo(my_rig, vfo_curr, isplit, RIG_VFO_SUB);
 
+    if (retval != RIG_OK)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: rig set split vfo failed '%s'\n", __func__,
+                  rigerror(retval));
         return retval;
     }
-    else if (strcmp(arg, "GT;") == 0)
+
+    return ts2000_reply(c, "DC%c;", isplit + '0');
+}
+
+
+static int ts2000_tn(struct com_client *c, const char *arg)
+{
+    tone_t val;
+    int ival = 0;
+    int retval;
+
+    if (strcmp(arg, "TN;") == 0)
     {
-        value_t val;
-        int retval = rig_get_level(my_rig, RIG_VFO_CURR, RIG_LEVEL_AGC, &val);
+        retval = rig_get_ctcss_tone(my_rig, RIG_VFO_CURR, &val);
 
         if (retval != RIG_OK)
         {
-            rig_debug(RIG_DEBUG_ERR, "%s: get_level AGC failed: %s\n", __func__,
+            rig_debug(RIG_DEBUG_ERR, "%s: get_ctcss_tone failed: %s\n", __func__,
                       rigerror(retval));
-
-            if (retval == -RIG_ENIMPL || retval == -RIG_ENAVAIL)
-            {
-                char *response = "?;";
-                return write_block2((void *)__func__, &my_com, response, strlen(response));
-            }
-
             return retval;
         }
 
-        char response[32];
-        int agcLevel = val.f * 255;
-        snprintf(response, sizeof(response), "GT%03d;", agcLevel);
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
+        return ts2000_reply(c, "TN%02d;", val);
     }
-    else if (strncmp(arg, "GT", 2) == 0)
+
+    sscanf(arg, "TN%d", &ival);
+    val = ival;
+    retval = rig_set_ctcss_tone(my_rig, RIG_VFO_CURR, val);
+
+    if (retval != RIG_OK)
     {
-        int agcLevel = 0;
-        int n = sscanf(arg, "GT%d", &agcLevel);
+        rig_debug(RIG_DEBUG_ERR, "%s: set_ctcss_tone failed: %s\n", __func__,
+                  rigerror(retval));
+    }
 
-        if (n != 1)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: AGC cmd parse failed: %s\n", __func__,
-                      (char *)arg);
-            return -RIG_EPROTO;
-        }
+    return retval;
+}
 
-        value_t val;
-        val.f = agcLevel / 255.0;
-        int retval = rig_set_level(my_rig, RIG_VFO_CURR, RIG_LEVEL_AGC, val);
+
+static int ts2000_pa(struct com_client *c, const char *arg)
+{
+    int valA = 0;
+    int valB = 0;
+    int retval;
+
+    if (strcmp(arg, "PA;") == 0)
+    {
+        retval = rig_get_func(my_rig, RIG_VFO_A, RIG_FUNC_AIP, &valA);
 
         if (retval != RIG_OK)
         {
-            rig_debug(RIG_DEBUG_ERR, "%s: set_level AGC failed: %s\n", __func__,
+            rig_debug(RIG_DEBUG_ERR, "%s: get_func preamp A failed: %s\n", __func__,
                       rigerror(retval));
+            return ts2000_refuse(c, retval);
         }
 
-        return retval;
-    }
-    else if (strcmp(arg, "SQ;") == 0)
-    {
-        value_t val;
-        int retval = rig_get_level(my_rig, RIG_VFO_CURR, RIG_LEVEL_SQL, &val);
+        retval = rig_get_func(my_rig, RIG_VFO_B, RIG_FUNC_AIP, &valB);
 
         if (retval != RIG_OK)
         {
-            rig_debug(RIG_DEBUG_ERR, "%s: get_level squelch failed: %s\n", __func__,
+            rig_debug(RIG_DEBUG_ERR, "%s: get_func preamp B failed: %s\n", __func__,
                       rigerror(retval));
-
-            if (retval == -RIG_ENIMPL || retval == -RIG_ENAVAIL)
-            {
-                char *response = "?;";
-                return write_block2((void *)__func__, &my_com, response, strlen(response));
-            }
-
             return retval;
         }
 
-        char response[32];
-        int sqlev = val.f * 255;
-        snprintf(response, sizeof(response), "SQ%03d;", sqlev);
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
+        return ts2000_reply(c, "PA%c%c;", valA + '0', valB + '0');
     }
-    else if (strncmp(arg, "SQ", 2) == 0)
+
+    if (sscanf(arg, "PA%1d%1d", &valA, &valB) != 2)
     {
-        int sqlev = 0;
-        int n = sscanf(arg, "SQ%d", &sqlev);
+        rig_debug(RIG_DEBUG_ERR, "%s: error parsing preamp cmd '%s'\n", __func__,
+                  arg);
+    }
 
-        if (n != 1)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: squelch cmd parse failed: %s\n", __func__,
-                      (char *)arg);
-            return -RIG_EPROTO;
-        }
+    retval = rig_set_func(my_rig, RIG_VFO_A, RIG_FUNC_AIP, valA);
 
-        value_t val;
-        val.f = sqlev / 255.0;
-        int retval = rig_set_level(my_rig, RIG_VFO_CURR, RIG_LEVEL_SQL, val);
+    if (retval != RIG_OK)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: set_func preamp failed: %s\n", __func__,
+                  rigerror(retval));
+        return retval;
+    }
 
-        if (retval != RIG_OK)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: set_level squelch failed: %s\n", __func__,
-                      rigerror(retval));
+    retval = rig_set_func(my_rig, RIG_VFO_B, RIG_FUNC_AIP, valB);
 
-            if (retval == -RIG_ENIMPL || retval == -RIG_ENAVAIL)
-            {
-                char *response = "?;";
-                return write_block2((void *)__func__, &my_com, response, strlen(response));
-            }
-        }
-
-        return retval;
+    if (retval != RIG_OK)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: set_func preamp failed: %s\n", __func__,
+                  rigerror(retval));
     }
-    else if (strcmp(arg, "DC;") == 0)
+
+    return retval;
+}
+
+
+/* XT, NR and NB, on/off functions */
+static int ts2000_func(struct com_client *c, const char *arg, setting_t func)
+{
+    int val = 0;
+    int retval;
+
+    if (arg[2] == ';')
     {
-        vfo_t vfo, vfo_curr = RIG_VFO_A;
-        split_t split;
-        int retval = rig_get_split_vfo(my_rig, vfo_curr, &split, &vfo);
+        retval = rig_get_func(my_rig, RIG_VFO_CURR, func, &val);
 
         if (retval != RIG_OK)
         {
-            rig_debug(RIG_DEBUG_ERR, "%s: get split vfo failed: %s\n", __func__,
-                      rigerror(retval));
-            return retval;
+            rig_debug(RIG_DEBUG_ERR, "%s: get_func %s failed: %s\n", __func__,
+                      rig_strfunc(func), rigerror(retval));
+            return ts2000_refuse(c, retval);
         }
 
-        char response[32];
-        snprintf(response, sizeof(response), "DC%c;", split + '0');
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
-
-        return retval;
+        return ts2000_reply(c, "%.2s%c;", arg, val + '0');
     }
-    else if (strncmp(arg, "DC", 2) == 0)
+
+    sscanf(arg + 2, "%d", &val);
+    retval = rig_set_func(my_rig, RIG_VFO_CURR, func, val);
+
+    if (retval != RIG_OK)
     {
-        vfo_t vfo_curr = RIG_VFO_A;
-        split_t split;
-        int isplit;
-        // Expecting DCnn -- but we dont' care about the control param
-        int n = sscanf(arg, "DC%d", &isplit);
+        rig_debug(RIG_DEBUG_ERR, "%s: set_func %s failed: %s\n", __func__,
+                  rig_strfunc(func), rigerror(retval));
+        return ts2000_refuse(c, retval);
+    }
+
+    return retval;
+}
 
-        if (n != 1)
-        {
-            rig_debug(RIG_DEBUG_ERR, "%s: error parsing '%s'\n", __func__, (char *)arg);
-            return -RIG_EPROTO;
-        }
 
-        split = isplit;
-        int retval = rig_set_split_vfo(my_rig, vfo_curr, split, RIG_VFO_SUB);
+static int ts2000_xt(struct com_client *c, const char *arg)
+{
+    return ts2000_func(c, arg, RIG_FUNC_XIT);
+}
+
+
+static int ts2000_nr(struct com_client *c, const char *arg)
+{
+    return ts2000_func(c, arg, RIG_FUNC_NR);
+}
+
+
+static int ts2000_nb(struct com_client *c, const char *arg)
+{
+    return ts2000_func(c, arg, RIG_FUNC_NB);
+}
+
+
+/* AG, PR, GT and SQ, levels from 0 to 255 */
+static int ts2000_level(struct com_client *c, const char *arg, setting_t level,
+                        const char *fmt)
+{
+    value_t val;
+    int ival = 0;
+    int retval;
+
+    if (arg[2] == ';')
+    {
+        retval = rig_get_level(my_rig, RIG_VFO_CURR, level, &val);
 
         if (retval != RIG_OK)
         {
-            rig_debug(RIG_DEBUG_ERR, "%s: rig set split vfo failed '%s'\n", __func__,
-                      rigerror(retval));
-            return retval;
+            rig_debug(RIG_DEBUG_ERR, "%s: get_level %s failed: %s\n", __func__,
+                      rig_strlevel(level), rigerror(retval));
+            return ts2000_refuse(c, retval);
         }
 
-        char response[32];
-        snprintf(response, sizeof(response), "DC%c;", split + '0');
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
-
-        return retval;
+        return ts2000_reply(c, fmt, (int)(val.f * 255));
     }
-    else if (strcmp(arg, "FT0;") == 0)
+
+    if (sscanf(arg + 2, "%d", &ival) != 1)
     {
-        return rig_set_split_vfo(my_rig, RIG_VFO_A, RIG_VFO_A, 0);
+        rig_debug(RIG_DEBUG_ERR, "%s: %s cmd parse failed: %s\n", __func__,
+                  rig_strlevel(level), arg);
+        return -RIG_EPROTO;
     }
-    else if (strcmp(arg, "FT1;") == 0)
+
+    val.f = ival / 255.0;
+    retval = rig_set_level(my_rig, RIG_VFO_CURR, level, val);
+
+    if (retval != RIG_OK)
     {
-        return rig_set_split_vfo(my_rig, RIG_VFO_B, RIG_VFO_B, 0);
+        rig_debug(RIG_DEBUG_ERR, "%s: set_level %s failed: %s\n", __func__,
+                  rig_strlevel(level), rigerror(retval));
+        return ts2000_refuse(c, retval);
     }
-    else if (strncmp(arg, "FA0", 3) == 0)
-    {
-        freq_t freq;
 
-        sscanf(arg + 2, "%"SCNfreq, &freq);
-        return rig_set_freq(my_rig, RIG_VFO_A, freq);
-    }
-    else if (strncmp(arg, "FB0", 3) == 0)
-    {
-        freq_t freq;
+    return retval;
+}
 
-        sscanf(arg + 2, "%"SCNfreq, &freq);
-        return rig_set_freq(my_rig, RIG_VFO_A, freq);
-    }
-    else if (strncmp(arg, "MD", 2) == 0)
+
+static int ts2000_ag(struct com_client *c, const char *arg)
+{
+    /* main receiver AF gain */
+    if (strcmp(arg, "AG0;") == 0)
     {
-        mode_t mode = 0;
-        int imode = 0;
+        arg = "AG;";
+    }
 
-        sscanf(arg + 2, "%d", &imode);
+    return ts2000_level(c, arg, RIG_LEVEL_AF, "AG0%03d;");
+}
 
-        switch (imode)
-        {
-        case 0: mode = RIG_MODE_NONE; break;
 
-        case 1: mode = RIG_MODE_LSB ; break;
+static int ts2000_pr(struct com_client *c, const char *arg)
+{
+    return ts2000_level(c, arg, RIG_LEVEL_COMP, "PR%03d;");
+}
 
-        case 2: mode = RIG_MODE_USB; break;
 
-        case 3: mode = RIG_MODE_CW; break;
+static int ts2000_gt(struct com_client *c, const char *arg)
+{
+    return ts2000_level(c, arg, RIG_LEVEL_AGC, "GT%03d;");
+}
 
-        case 4: mode = RIG_MODE_AM; break;
 
-        case 5: mode = RIG_MODE_FM; break;
+static int ts2000_sq(struct com_client *c, const char *arg)
+{
+    return ts2000_level(c, arg, RIG_LEVEL_SQL, "SQ%03d;");
+}
 
-        case 6: mode = RIG_MODE_RTTY; break;
 
-        case 7: mode = RIG_MODE_CWR; break;
+static int ts2000_ps(struct com_client *c, const char *arg)
+{
+    if (strcmp(arg, "PS1;") == 0 || strcmp(arg, "PS0;") == 0)
+    {
+        return RIG_OK;
+    }
 
-        case 8: mode = RIG_MODE_NONE; break;
+    return ts2000_reply(c, "PS1;");
+}
 
-        case 9: mode = RIG_MODE_RTTYR; break;
-        }
 
-        char response[32];
+/* known to the TS-2000 but not emulated */
+static int ts2000_unsupported(struct com_client *c, const char *arg)
+{
+    (void) arg;
+    return ts2000_reply(c, "?;");
+}
 
-        snprintf(response, sizeof(response), "MD%c;", mode + '0');
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
-    }
-    else if (strcmp(arg, "PS1;") == 0)
+
+typedef int (*ts2000_handler_t)(struct com_client *c, const char *arg);
+
+static const struct
+{
+    const char *name;
+    ts2000_handler_t handler;
+} ts2000_cmds[] =
+{
+    { "AG", ts2000_ag },
+    { "AI", ts2000_ai },
+    { "DC", ts2000_dc },
+    { "FA", ts2000_fa },
+    { "FB", ts2000_fb },
+    { "FR", ts2000_fr },
+    { "FT", ts2000_ft },
+    { "GT", ts2000_gt },
+    { "ID", ts2000_id },
+    { "IF", ts2000_if },
+    { "MD", ts2000_md },
+    { "NB", ts2000_nb },
+    { "NR", ts2000_nr },
+    { "PA", ts2000_pa },
+    { "PR", ts2000_pr },
+    { "PS", ts2000_ps },
+    { "RX", ts2000_rx },
+    { "SA", ts2000_sa },
+    { "SQ", ts2000_sq },
+    { "TN", ts2000_tn },
+    { "TX", ts2000_tx },
+    { "XT", ts2000_xt },
+    { "AC", ts2000_unsupported },
+    { "AM", ts2000_unsupported },
+    { "AN", ts2000_unsupported },
+    { "BC", ts2000_unsupported },
+    { "CA", ts2000_unsupported },
+    { "CT", ts2000_unsupported },
+    { "DQ", ts2000_unsupported },
+    { "FS", ts2000_unsupported },
+    { "LK", ts2000_unsupported },
+    { "LT", ts2000_unsupported },
+    { "MF", ts2000_unsupported },
+    { "MG", ts2000_unsupported },
+    { "NL", ts2000_unsupported },
+    { "NT", ts2000_unsupported },
+    { "PC", ts2000_unsupported },
+    { "RA", ts2000_unsupported },
+    { "RG", ts2000_unsupported },
+    { "RL", ts2000_unsupported },
+    { "SB", ts2000_unsupported },
+    { "SC", ts2000_unsupported },
+    { "SH", ts2000_unsupported },
+    { "SL", ts2000_unsupported },
+    { "TO", ts2000_unsupported },
+    { "TS", ts2000_unsupported },
+    { "VX", ts2000_unsupported },
+    { NULL, NULL }
+};
+
+/* the handlers, by the two letters of the command */
+#define TS2000_INDEX(s) (((s)[0] - 'A') * 26 + (s)[1] - 'A')
+
+static ts2000_handler_t ts2000_index[26 * 26];
+
+
+static void init_ts2000_index(void)
+{
+    int i;
+
+    for (i = 0; ts2000_cmds[i].name; i++)
     {
-        return RIG_OK;
+        ts2000_index[TS2000_INDEX(ts2000_cmds[i].name)] = ts2000_cmds[i].handler;
     }
-    else if (strcmp(arg, "PS0;") == 0)
+}
+
+
+/*
+ * This handles the TS-2000 emulation
+ */
+static int handle_ts2000(struct com_client *c, const char *arg)
+{
+    ts2000_handler_t handler = NULL;
+
+    if (strcmp(arg, ";") == 0)
     {
+        // nothing to do
         return RIG_OK;
     }
-    else if (strncmp(arg, "PS", 2) == 0)
-    {
-        char response[32];
-
-        snprintf(response, sizeof(response), "PS1;");
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
-    }
-    else if (strncmp(arg, "SB", 2) == 0
-             || strncmp(arg, "AC", 2) == 0
-             || strncmp(arg, "AM", 2) == 0
-             || strncmp(arg, "AN", 2) == 0
-             || strncmp(arg, "BC", 2) == 0
-             || strncmp(arg, "CA", 2) == 0
-             || strncmp(arg, "CT", 2) == 0
-             || strncmp(arg, "DQ", 2) == 0
-             || strncmp(arg, "FS", 2) == 0
-             || strncmp(arg, "LT", 2) == 0
-             || strncmp(arg, "NL", 2) == 0
-             || strncmp(arg, "NT", 2) == 0
-             || strncmp(arg, "LK", 2) == 0
-             || strncmp(arg, "MF", 2) == 0
-             || strncmp(arg, "MG", 2) == 0
-             || strncmp(arg, "PC", 2) == 0
-             || strncmp(arg, "RA", 2) == 0
-             || strncmp(arg, "RG", 2) == 0
-             || strncmp(arg, "RL", 2) == 0
-             || strncmp(arg, "SC", 2) == 0
-             || strncmp(arg, "SL", 2) == 0
-             || strncmp(arg, "SH", 2) == 0
-             || strncmp(arg, "TN", 2) == 0
-             || strncmp(arg, "TO", 2) == 0
-             || strncmp(arg, "TS", 2) == 0
-             || strncmp(arg, "VX", 2) == 0
-            )
-    {
-        char response[32];
-
-        snprintf(response, sizeof(response), "?;");
-        return write_block2((void *)__func__, &my_com, response, strlen(response));
+
+    if (arg[0] >= 'A' && arg[0] <= 'Z' && arg[1] >= 'A' && arg[1] <= 'Z')
+    {
+        handler = ts2000_index[TS2000_INDEX(arg)];
     }
-    else
+
+    if (!handler)
     {
-        rig_debug(RIG_DEBUG_ERR,
-                  "*********************************\n%s: unknown cmd='%s'\n",
-                  __func__,
-                  (char *)arg);
-        return -RIG_EINVAL;
+        return ts2000_unknown(arg);
     }
 
-    // Handle all the settings
-    return RIG_OK;
+    return handler(c, arg);
 }
 
 
@@ -1530,13 +1697,14 @@ void usage()
     printf(
         "  -m, --model=ID                select radio model number. See model list (-l)\n"
         "  -r, --rig-file=DEVICE         set device of the radio to operate on\n"
-        "  -R, --rig-file2=DEVICE        set device of the virtual com port to operate on\n"
+        "  -R, --rig-file2=DEVICE        set device of a virtual com port to operate on, repeatable\n"
         "  -p, --ptt-file=DEVICE         set device of the PTT device to operate on\n"
         "  -d, --dcd-file=DEVICE         set device of the DCD device to operate on\n"
         "  -P, --ptt-type=TYPE           set type of the PTT device to operate on\n"
         "  -D, --dcd-type=TYPE           set type of the DCD device to operate on\n"
         "  -s, --serial-speed=BAUD       set serial speed of the serial port\n"
         "  -S, --serial-speed2=BAUD      set serial speed of the virtual com port [default=115200]\n"
+        "  -i, --poll-interval=MS        refresh the radio state every MS ms [default=250]\n"
         "  -c, --civaddr=ID              set CI-V address, decimal (for Icom rigs only)\n"
         "  -C, --set-conf=PARM=VAL       set config parameters\n"
         "  -L, --show-conf               list all config parameters\n"
@@ -77,6 +77,7 @@
 #include "sprintflst.h"
 
 #include "rigctl_parse.h"
+#include "netserver.h"
 
 
 /*
@@ -111,8 +112,38 @@ static struct option long_options[] =
 };
 
 
+#define MAXCONFLEN 128
+#define MAX_RIGS 16
+
+/*
+ * One radio served by this daemon, with its own listening port
+ * and its own lock, so clients of different radios never wait
+ * on each other.
+ */
+struct rigctld_rig
+{
+    RIG *rig;
+    rig_model_t model;
+    int model_set;
+    const char *rig_file, *ptt_file, *dcd_file;
+    ptt_type_t ptt_type;
+    dcd_type_t dcd_type;
+    int serial_rate;
+    char *civaddr;      /* NULL means no need to set conf */
+    char conf_parms[MAXCONFLEN];
+    const char *portno;
+    char portbuf[NI_MAXSERV];
+    int sock_listen;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_t lock;
+    unsigned client_count;
+#endif
+};
+
+
 struct handle_data
 {
+    struct rigctld_rig *srv;
     RIG *rig;
     int sock;
     struct sockaddr_storage cli_addr;
@@ -125,12 +156,10 @@ void *handle_socket(void *arg);
 void usage(void);
 
 
-#ifdef HAVE_PTHREAD
-static unsigned client_count;
-#endif
-
-static RIG *my_rig;             /* handle to rig (instance) */
+static struct rigctld_rig rigs[MAX_RIGS];
+static int nrigs = 1;
 static int verbose;
+static int vfo_mode;    /* vfo_mode=0 means target VFO is current VFO */
 
 #ifdef HAVE_SIG_ATOMIC_T
 static sig_atomic_t volatile ctrl_c;
@@ -141,27 +170,148 @@ static int volatile ctrl_c;
 const char *portno = "4532";
 const char *src_addr = NULL; /* INADDR_ANY */
 
-#define MAXCONFLEN 128
 
-static void sync_callback(int lock)
+static void sync_callback(RIG *rig, int lock)
 {
 #ifdef HAVE_PTHREAD
-    static pthread_mutex_t client_lock = PTHREAD_MUTEX_INITIALIZER;
+    int i;
+
+    for (i = 0; i < nrigs; i++)
+    {
+        if (rigs[i].rig == rig)
+        {
+            break;
+        }
+    }
+
+    if (i == nrigs)
+    {
+        return;
+    }
 
     if (lock)
     {
-        pthread_mutex_lock(&client_lock);
+        pthread_mutex_lock(&rigs[i].lock);
         rig_debug(RIG_DEBUG_VERBOSE, "%s: client lock engaged\n", __func__);
     }
     else
     {
         rig_debug(RIG_DEBUG_VERBOSE, "%s: client lock disengaged\n", __func__);
-        pthread_mutex_unlock(&client_lock);
+        pthread_mutex_unlock(&rigs[i].lock);
     }
 
 #endif
 }
 
+#ifdef HAVE_NETSERVER
+/*
+ * Protocol state of one client
+ */
+struct client_data
+{
+    struct rigctl_parser *rp;
+};
+
+
+static int quit_requested(void)
+{
+    return ctrl_c;
+}
+
+
+static void client_open(struct netserver_client *client)
+{
+    struct rigctld_rig *r = client->data;
+    struct client_data *cd;
+    RIG *my_rig = client->dev;
+    int retcode;
+
+    cd = calloc(1, sizeof(struct client_data));
+
+    if (cd)
+    {
+        cd->rp = rigctl_parser_new(NULL, 1, 0, vfo_mode, '\r');
+
+        if (!cd->rp)
+        {
+            free(cd);
+            cd = NULL;
+        }
+    }
+
+    client->priv = cd;
+
+    if (!r->client_count++)
+    {
+        retcode = rig_open(my_rig);
+
+        if (RIG_OK == retcode && verbose > 0)
+        {
+            printf("Opened rig model %d, '%s'\n",
+                   my_rig->caps->rig_model,
+                   my_rig->caps->model_name);
+        }
+    }
+}
+
+
+static int client_parse(struct netserver_client *client, const char *buf,
+                        size_t len, size_t *used, FILE *fout)
+{
+    struct client_data *cd = client->priv;
+    int retcode;
+
+    if (!cd)
+    {
+        return 1;
+    }
+
+    /* the device lock is already held by the server core */
+    retcode = rigctl_parse_buf(client->dev, cd->rp, fout, buf, len, used,
+                               NULL);
+
+    return !(retcode == 0 || retcode == 2 || retcode == -RIG_ENAVAIL);
+}
+
+
+static void client_close(struct netserver_client *client)
+{
+    struct rigctld_rig *r = client->data;
+    struct client_data *cd = client->priv;
+    RIG *my_rig = client->dev;
+
+    if (cd)
+    {
+        rigctl_parser_free(cd->rp);
+        free(cd);
+    }
+
+    client->priv = NULL;
+
+    /* Release rig if there are no clients */
+    if (!--r->client_count)
+    {
+        rig_close(my_rig);
+
+        if (verbose > 0)
+        {
+            printf("Closed rig model %d, '%s - no clients, will reopen for new clients'\n",
+                   my_rig->caps->rig_model,
+                   my_rig->caps->model_name);
+        }
+    }
+}
+
+
+static const struct netserver_ops client_ops =
+{
+    .open = client_open,
+    .close = client_close,
+    .parse_buf = client_parse,
+};
+#endif  /* HAVE_NETSERVER */
+
+
 #ifdef WIN32
 static BOOL WINAPI CtrlHandler(DWORD fdwCtrlType)
 {
@@ -215,46 +365,276 @@ static void handle_error(enum rig_debug_level_e lvl, const char *msg)
         rig_debug(lvl, "%s: Network error %d: %s\n", msg, e, (char*)lpMsgBuf);
         LocalFree(lpMsgBuf);
     }
-    else
+    else
+    {
+        rig_debug(lvl, "%s: Network error %d\n", msg, e);
+    }
+
+#else
+    e = errno;
+    rig_debug(lvl, "%s: Network error %d: %s\n", msg, e, strerror(e));
+#endif
+}
+
+
+/*
+ * Prepare the listening socket of one radio.
+ * Exits on error, as there is nothing to serve without it.
+ */
+static int open_listen_socket(const char *port)
+{
+    struct addrinfo hints, *result, *saved_result;
+    int sock_listen;
+    int sockopt;
+    int reuseaddr = 1;
+    int retcode;
+
+    memset(&hints, 0, sizeof(struct addrinfo));
+    hints.ai_family = AF_UNSPEC;    /* Allow IPv4 or IPv6 */
+    hints.ai_socktype = SOCK_STREAM;/* TCP socket */
+    hints.ai_flags = AI_PASSIVE;    /* For wildcard IP address */
+    hints.ai_protocol = 0;          /* Any protocol */
+
+    retcode = getaddrinfo(src_addr, port, &hints, &result);
+
+    if (retcode != 0)
+    {
+        fprintf(stderr, "getaddrinfo: %s\n", gai_strerror(retcode));
+        exit(2);
+    }
+
+    saved_result = result;
+
+    do
+    {
+        sock_listen = socket(result->ai_family,
+                             result->ai_socktype,
+                             result->ai_protocol);
+
+        if (sock_listen < 0)
+        {
+            handle_error(RIG_DEBUG_ERR, "socket");
+            freeaddrinfo(saved_result);     /* No longer needed */
+            exit(2);
+        }
+
+        if (setsockopt(sock_listen,
+                       SOL_SOCKET,
+                       SO_REUSEADDR,
+                       (char *)&reuseaddr,
+                       sizeof(reuseaddr))
+                < 0)
+        {
+
+            handle_error(RIG_DEBUG_ERR, "setsockopt");
+            freeaddrinfo(saved_result);     /* No longer needed */
+            exit(1);
+        }
+
+#ifdef IPV6_V6ONLY
+
+        if (AF_INET6 == result->ai_family)
+        {
+            /* allow IPv4 mapped to IPv6 clients Windows and BSD default
+               this to 1 (i.e. disallowed) and we prefer it off */
+            sockopt = 0;
+
+            if (setsockopt(sock_listen,
+                           IPPROTO_IPV6,
+                           IPV6_V6ONLY,
+                           (char *)&sockopt,
+                           sizeof(sockopt))
+                    < 0)
+            {
+
+                handle_error(RIG_DEBUG_ERR, "setsockopt");
+                freeaddrinfo(saved_result);     /* No longer needed */
+                exit(1);
+            }
+        }
+
+#endif
+
+        if (0 == bind(sock_listen, result->ai_addr, result->ai_addrlen))
+        {
+            break;
+        }
+
+        handle_error(RIG_DEBUG_WARN, "binding failed (trying next interface)");
+#ifdef __MINGW32__
+        closesocket(sock_listen);
+#else
+        close(sock_listen);
+#endif
+    }
+    while ((result = result->ai_next) != NULL);
+
+    freeaddrinfo(saved_result);     /* No longer needed */
+
+    if (NULL == result)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: bind error - no available interface\n", __func__);
+        exit(1);
+    }
+
+    if (listen(sock_listen, 4) < 0)
+    {
+        handle_error(RIG_DEBUG_ERR, "listeningn");
+        exit(1);
+    }
+
+    return sock_listen;
+}
+
+
+/*
+ * Create one radio from its options, check that it opens,
+ * then close it again until a client shows up.
+ */
+static void init_rig(struct rigctld_rig *r, int show_conf, int dump_caps_opt)
+{
+    RIG *my_rig;
+    int retcode;
+
+    my_rig = rig_init(r->model);
+
+    if (!my_rig)
+    {
+        fprintf(stderr,
+                "Unknown rig num %d, or initialization error.\n",
+                r->model);
+
+        fprintf(stderr, "Please check with --list option.\n");
+        exit(2);
+    }
+
+    r->rig = my_rig;
+
+    retcode = set_conf(my_rig, r->conf_parms);
+
+    if (retcode != RIG_OK)
+    {
+        fprintf(stderr, "Config parameter error: %s\n", rigerror(retcode));
+        exit(2);
+    }
+
+    if (r->rig_file)
+    {
+        strncpy(my_rig->state.rigport.pathname, r->rig_file, FILPATHLEN - 1);
+    }
+
+    /*
+     * ex: RIG_PTT_PARALLEL and /dev/parport0
+     */
+    if (r->ptt_type != RIG_PTT_NONE)
+    {
+        my_rig->state.pttport.type.ptt = r->ptt_type;
+    }
+
+    if (r->dcd_type != RIG_DCD_NONE)
+    {
+        my_rig->state.dcdport.type.dcd = r->dcd_type;
+    }
+
+    if (r->ptt_file)
+    {
+        strncpy(my_rig->state.pttport.pathname, r->ptt_file, FILPATHLEN - 1);
+    }
+
+    if (r->dcd_file)
+    {
+        strncpy(my_rig->state.dcdport.pathname, r->dcd_file, FILPATHLEN - 1);
+    }
+
+    /* FIXME: bound checking and port type == serial */
+    if (r->serial_rate != 0)
+    {
+        my_rig->state.rigport.parm.serial.rate = r->serial_rate;
+    }
+
+    if (r->civaddr)
+    {
+        rig_set_conf(my_rig, rig_token_lookup(my_rig, "civaddr"), r->civaddr);
+    }
+
+    /*
+     * print out conf parameters
+     */
+    if (show_conf)
+    {
+        rig_token_foreach(my_rig, print_conf_list, (rig_ptr_t)my_rig);
+    }
+
+    /*
+     * print out conf parameters, and exits immediately
+     * We may be interested only in only caps, and rig_open may fail.
+     */
+    if (dump_caps_opt)
+    {
+        dumpcaps(my_rig, stdout);
+        return;
+    }
+
+    /* open and close rig connection to check early for issues */
+    retcode = rig_open(my_rig);
+
+    if (retcode != RIG_OK)
+    {
+        fprintf(stderr, "rig_open: error = %s \n", rigerror(retcode));
+        exit(2);
+    }
+
+    if (verbose > 0)
+    {
+        printf("Opened rig model %d, '%s'\n",
+               my_rig->caps->rig_model,
+               my_rig->caps->model_name);
+    }
+
+    rig_debug(RIG_DEBUG_VERBOSE, "Backend version: %s, Status: %s\n",
+              my_rig->caps->version, rig_strstatus(my_rig->caps->status));
+
+    rig_close(my_rig);          /* we will reopen for clients */
+
+    if (verbose > 0)
     {
-        rig_debug(lvl, "%s: Network error %d\n", msg, e);
+        printf("Closed rig model %d, '%s - will reopen for clients'\n",
+               my_rig->caps->rig_model,
+               my_rig->caps->model_name);
     }
 
-#else
-    e = errno;
-    rig_debug(lvl, "%s: Network error %d: %s\n", msg, e, strerror(e));
+#ifdef HAVE_PTHREAD
+    pthread_mutex_init(&r->lock, NULL);
 #endif
 }
 
 
 int main(int argc, char *argv[])
 {
-    rig_model_t my_model = RIG_MODEL_DUMMY;
-
-    int retcode;        /* generic return code from functions */
+    struct rigctld_rig *cur = &rigs[0];
 
     int show_conf = 0;
     int dump_caps_opt = 0;
-    const char *rig_file = NULL, *ptt_file = NULL, *dcd_file = NULL;
-    ptt_type_t ptt_type = RIG_PTT_NONE;
-    dcd_type_t dcd_type = RIG_DCD_NONE;
-    int serial_rate = 0;
-    char *civaddr = NULL;   /* NULL means no need to set conf */
-    char conf_parms[MAXCONFLEN] = "";
 
-    struct addrinfo hints, *result, *saved_result;
-    int sock_listen;
-    int sockopt;
-    int reuseaddr = 1;
+    int i;
+#ifndef HAVE_NETSERVER
+    int retcode;        /* generic return code from functions */
     char host[NI_MAXHOST];
     char serv[NI_MAXSERV];
-
 #ifdef HAVE_PTHREAD
     pthread_t thread;
     pthread_attr_t attr;
 #endif
     struct handle_data *arg;
-    int vfo_mode = 0; /* vfo_mode=0 means target VFO is current VFO */
+#endif
+
+    for (i = 0; i < MAX_RIGS; i++)
+    {
+        rigs[i].model = RIG_MODEL_DUMMY;
+        rigs[i].ptt_type = RIG_PTT_NONE;
+        rigs[i].dcd_type = RIG_DCD_NONE;
+        rigs[i].sock_listen = -1;
+    }
 
     while (1)
     {
@@ -289,7 +669,20 @@ int main(int argc, char *argv[])
                 exit(1);
             }
 
-            my_model = atoi(optarg);
+            /* each further -m starts the options of a new radio */
+            if (cur->model_set)
+            {
+                if (nrigs == MAX_RIGS)
+                {
+                    fprintf(stderr, "Too many radios, max %d\n", MAX_RIGS);
+                    exit(1);
+                }
+
+                cur = &rigs[nrigs++];
+            }
+
+            cur->model = atoi(optarg);
+            cur->model_set = 1;
             break;
 
         case 'r':
@@ -299,7 +692,7 @@ int main(int argc, char *argv[])
                 exit(1);
             }
 
-            rig_file = optarg;
+            cur->rig_file = optarg;
             break;
 
         case 'p':
@@ -309,7 +702,7 @@ int main(int argc, char *argv[])
                 exit(1);
             }
 
-            ptt_file = optarg;
+            cur->ptt_file = optarg;
             break;
 
         case 'd':
@@ -319,7 +712,7 @@ int main(int argc, char *argv[])
                 exit(1);
             }
 
-            dcd_file = optarg;
+            cur->dcd_file = optarg;
             break;
 
         case 'P':
@@ -331,31 +724,31 @@ int main(int argc, char *argv[])
 
             if (!strcmp(optarg, "RIG"))
             {
-                ptt_type = RIG_PTT_RIG;
+                cur->ptt_type = RIG_PTT_RIG;
             }
             else if (!strcmp(optarg, "DTR"))
             {
-                ptt_type = RIG_PTT_SERIAL_DTR;
+                cur->ptt_type = RIG_PTT_SERIAL_DTR;
             }
             else if (!strcmp(optarg, "RTS"))
             {
-                ptt_type = RIG_PTT_SERIAL_RTS;
+                cur->ptt_type = RIG_PTT_SERIAL_RTS;
             }
             else if (!strcmp(optarg, "PARALLEL"))
             {
-                ptt_type = RIG_PTT_PARALLEL;
+                cur->ptt_type = RIG_PTT_PARALLEL;
             }
             else if (!strcmp(optarg, "CM108"))
             {
-                ptt_type = RIG_PTT_CM108;
+                cur->ptt_type = RIG_PTT_CM108;
             }
             else if (!strcmp(optarg, "NONE"))
             {
-                ptt_type = RIG_PTT_NONE;
+                cur->ptt_type = RIG_PTT_NONE;
             }
             else
             {
-                ptt_type = atoi(optarg);
+                cur->ptt_type = atoi(optarg);
             }
 
             break;
@@ -369,31 +762,31 @@ int main(int argc, char *argv[])
 
             if (!strcmp(optarg, "RIG"))
             {
-                dcd_type = RIG_DCD_RIG;
+                cur->dcd_type = RIG_DCD_RIG;
             }
             else if (!strcmp(optarg, "DSR"))
             {
-                dcd_type = RIG_DCD_SERIAL_DSR;
+                cur->dcd_type = RIG_DCD_SERIAL_DSR;
             }
             else if (!strcmp(optarg, "CTS"))
             {
-                dcd_type = RIG_DCD_SERIAL_CTS;
+                cur->dcd_type = RIG_DCD_SERIAL_CTS;
             }
             else if (!strcmp(optarg, "CD"))
             {
-                dcd_type = RIG_DCD_SERIAL_CAR;
+                cur->dcd_type = RIG_DCD_SERIAL_CAR;
             }
             else if (!strcmp(optarg, "PARALLEL"))
             {
-                dcd_type = RIG_DCD_PARALLEL;
+                cur->dcd_type = RIG_DCD_PARALLEL;
             }
             else if (!strcmp(optarg, "NONE"))
             {
-                dcd_type = RIG_DCD_NONE;
+                cur->dcd_type = RIG_DCD_NONE;
             }
             else
             {
-                dcd_type = atoi(optarg);
+                cur->dcd_type = atoi(optarg);
             }
 
             break;
@@ -405,7 +798,7 @@ int main(int argc, char *argv[])
                 exit(1);
             }
 
-            civaddr = optarg;
+            cur->civaddr = optarg;
             break;
 
         case 's':
@@ -415,7 +808,7 @@ int main(int argc, char *argv[])
                 exit(1);
             }
 
-            serial_rate = atoi(optarg);
+            cur->serial_rate = atoi(optarg);
             break;
 
         case 'C':
@@ -425,12 +818,14 @@ int main(int argc, char *argv[])
                 exit(1);
             }
 
-            if (*conf_parms != '\0')
+            if (*cur->conf_parms != '\0')
             {
-                strcat(conf_parms, ",");
+                strcat(cur->conf_parms, ",");
             }
 
-            strncat(conf_parms, optarg, MAXCONFLEN - strlen(conf_parms));
+            strncat(cur->conf_parms,
+                    optarg,
+                    MAXCONFLEN - strlen(cur->conf_parms) - 1);
             break;
 
         case 't':
@@ -440,7 +835,7 @@ int main(int argc, char *argv[])
                 exit(1);
             }
 
-            portno = optarg;
+            cur->portno = optarg;
             break;
 
         case 'T':
@@ -495,110 +890,34 @@ int main(int argc, char *argv[])
     rig_debug(RIG_DEBUG_VERBOSE, "%s",
               "Report bugs to <hamlib-developer@lists.sourceforge.net>\n\n");
 
-    my_rig = rig_init(my_model);
-
-    if (!my_rig)
-    {
-        fprintf(stderr,
-                "Unknown rig num %d, or initialization error.\n",
-                my_model);
-
-        fprintf(stderr, "Please check with --list option.\n");
-        exit(2);
-    }
-
-    retcode = set_conf(my_rig, conf_parms);
-
-    if (retcode != RIG_OK)
-    {
-        fprintf(stderr, "Config parameter error: %s\n", rigerror(retcode));
-        exit(2);
-    }
-
-    if (rig_file)
-    {
-        strncpy(my_rig->state.rigport.pathname, rig_file, FILPATHLEN - 1);
-    }
-
-    /*
-     * ex: RIG_PTT_PARALLEL and /dev/parport0
-     */
-    if (ptt_type != RIG_PTT_NONE)
-    {
-        my_rig->state.pttport.type.ptt = ptt_type;
-    }
-
-    if (dcd_type != RIG_DCD_NONE)
-    {
-        my_rig->state.dcdport.type.dcd = dcd_type;
-    }
-
-    if (ptt_file)
-    {
-        strncpy(my_rig->state.pttport.pathname, ptt_file, FILPATHLEN - 1);
-    }
-
-    if (dcd_file)
-    {
-        strncpy(my_rig->state.dcdport.pathname, dcd_file, FILPATHLEN - 1);
-    }
-
-    /* FIXME: bound checking and port type == serial */
-    if (serial_rate != 0)
-    {
-        my_rig->state.rigport.parm.serial.rate = serial_rate;
-    }
-
-    if (civaddr)
+    for (i = 0; i < nrigs; i++)
     {
-        rig_set_conf(my_rig, rig_token_lookup(my_rig, "civaddr"), civaddr);
-    }
+        init_rig(&rigs[i], show_conf, dump_caps_opt);
 
-    /*
-     * print out conf parameters
-     */
-    if (show_conf)
-    {
-        rig_token_foreach(my_rig, print_conf_list, (rig_ptr_t)my_rig);
+        /* radios without -t take the next even port, see rotctld */
+        if (!rigs[i].portno)
+        {
+            if (i == 0)
+            {
+                rigs[i].portno = portno;
+            }
+            else
+            {
+                snprintf(rigs[i].portbuf, sizeof(rigs[i].portbuf), "%d",
+                         atoi(rigs[i - 1].portno) + 2);
+                rigs[i].portno = rigs[i].portbuf;
+            }
+        }
     }
 
-    /*
-     * print out conf parameters, and exits immediately
-     * We may be interested only in only caps, and rig_open may fail.
-     */
     if (dump_caps_opt)
     {
-        dumpcaps(my_rig, stdout);
-        rig_cleanup(my_rig); /* if you care about memory */
-        exit(0);
-    }
-
-    /* open and close rig connection to check early for issues */
-    retcode = rig_open(my_rig);
-
-    if (retcode != RIG_OK)
-    {
-        fprintf(stderr, "rig_open: error = %s \n", rigerror(retcode));
-        exit(2);
-    }
-
-    if (verbose > 0)
-    {
-        printf("Opened rig model %d, '%s'\n",
-               my_rig->caps->rig_model,
-               my_rig->caps->model_name);
-    }
-
-    rig_debug(RIG_DEBUG_VERBOSE, "Backend version: %s, Status: %s\n",
-              my_rig->caps->version, rig_strstatus(my_rig->caps->status));
-
-    rig_close(my_rig);          /* we will reopen for clients */
+        for (i = 0; i < nrigs; i++)
+        {
+            rig_cleanup(rigs[i].rig); /* if you care about memory */
+        }
 
-    if (verbose > 0)
-    {
-        printf("Closed rig model %d, '%s - will reopen for clients'\n",
-               my_rig->caps->rig_model,
-               my_rig->caps->model_name);
+        exit(0);
     }
 
 #ifdef __MINGW32__
@@ -613,6 +932,7 @@ int main(int argc, char *argv[])
 #  endif
 
     WSADATA wsadata;
+    int sockopt;
 
     if (WSAStartup(MAKEWORD(1, 1), &wsadata) == SOCKET_ERROR)
     {
@@ -626,100 +946,18 @@ int main(int argc, char *argv[])
 #endif
 
     /*
-     * Prepare listening socket
+     * Prepare listening sockets
      */
-    memset(&hints, 0, sizeof(struct addrinfo));
-    hints.ai_family = AF_UNSPEC;    /* Allow IPv4 or IPv6 */
-    hints.ai_socktype = SOCK_STREAM;/* TCP socket */
-    hints.ai_flags = AI_PASSIVE;    /* For wildcard IP address */
-    hints.ai_protocol = 0;          /* Any protocol */
-
-    retcode = getaddrinfo(src_addr, portno, &hints, &result);
-
-    if (retcode != 0)
-    {
-        fprintf(stderr, "getaddrinfo: %s\n", gai_strerror(retcode));
-        exit(2);
-    }
-
-    saved_result = result;
-
-    do
+    for (i = 0; i < nrigs; i++)
     {
-        sock_listen = socket(result->ai_family,
-                             result->ai_socktype,
-                             result->ai_protocol);
-
-        if (sock_listen < 0)
-        {
-            handle_error(RIG_DEBUG_ERR, "socket");
-            freeaddrinfo(saved_result);     /* No longer needed */
-            exit(2);
-        }
-
-        if (setsockopt(sock_listen,
-                       SOL_SOCKET,
-                       SO_REUSEADDR,
-                       (char *)&reuseaddr,
-                       sizeof(reuseaddr))
-                < 0)
-        {
-
-            handle_error(RIG_DEBUG_ERR, "setsockopt");
-            freeaddrinfo(saved_result);     /* No longer needed */
-            exit(1);
-        }
-
-#ifdef IPV6_V6ONLY
-
-        if (AF_INET6 == result->ai_family)
-        {
-            /* allow IPv4 mapped to IPv6 clients Windows and BSD default
-               this to 1 (i.e. disallowed) and we prefer it off */
-            sockopt = 0;
-
-            if (setsockopt(sock_listen,
-                           IPPROTO_IPV6,
-                           IPV6_V6ONLY,
-                           (char *)&sockopt,
-                           sizeof(sockopt))
-                    < 0)
-            {
-
-                handle_error(RIG_DEBUG_ERR, "setsockopt");
-                freeaddrinfo(saved_result);     /* No longer needed */
-                exit(1);
-            }
-        }
+        rigs[i].sock_listen = open_listen_socket(rigs[i].portno);
 
-#endif
-
-        if (0 == bind(sock_listen, result->ai_addr, result->ai_addrlen))
+        if (verbose > 0 && nrigs > 1)
         {
-            break;
+            printf("Serving rig model %d on port %s\n",
+                   rigs[i].rig->caps->rig_model,
+                   rigs[i].portno);
         }
-
-        handle_error(RIG_DEBUG_WARN, "binding failed (trying next interface)");
-#ifdef __MINGW32__
-        closesocket(sock_listen);
-#else
-        close(sock_listen);
-#endif
-    }
-    while ((result = result->ai_next) != NULL);
-
-    freeaddrinfo(saved_result);     /* No longer needed */
-
-    if (NULL == result)
-    {
-        rig_debug(RIG_DEBUG_ERR, "%s: bind error - no available interface\n", __func__);
-        exit(1);
-    }
-
-    if (listen(sock_listen, 4) < 0)
-    {
-        handle_error(RIG_DEBUG_ERR, "listeningn");
-        exit(1);
     }
 
 #if HAVE_SIGACTION
@@ -776,27 +1014,42 @@ int main(int argc, char *argv[])
 #endif
 #endif
 
+#ifdef HAVE_NETSERVER
+
+    for (i = 0; i < nrigs; i++)
+    {
+        netserver_listen(rigs[i].sock_listen, &client_ops, rigs[i].rig,
+                         &rigs[i]);
+    }
+
+    netserver_run(NETSERVER_WORKERS, quit_requested);
+#else
+
     /*
      * main loop accepting connections
      */
     do
     {
-        arg = malloc(sizeof(struct handle_data));
-
-        if (!arg)
-        {
-            rig_debug(RIG_DEBUG_ERR, "malloc: %s\n", strerror(errno));
-            exit(1);
-        }
-
         /* use select to allow for periodic checks for CTRL+C */
         fd_set set;
         struct timeval timeout;
+        int maxfd = 0;
+
         FD_ZERO(&set);
-        FD_SET(sock_listen, &set);
+
+        for (i = 0; i < nrigs; i++)
+        {
+            FD_SET(rigs[i].sock_listen, &set);
+
+            if (rigs[i].sock_listen > maxfd)
+            {
+                maxfd = rigs[i].sock_listen;
+            }
+        }
+
         timeout.tv_sec = 5;
         timeout.tv_usec = 0;
-        retcode = select(sock_listen + 1, &set, NULL, NULL, &timeout);
+        retcode = select(maxfd + 1, &set, NULL, NULL, &timeout);
 
         if (-1 == retcode)
         {
@@ -811,72 +1064,100 @@ int main(int argc, char *argv[])
         }
         else
         {
-            arg->rig = my_rig;
-            arg->clilen = sizeof(arg->cli_addr);
-            arg->vfo_mode = vfo_mode;
-            arg->sock = accept(sock_listen,
-                               (struct sockaddr *)&arg->cli_addr,
-                               &arg->clilen);
-
-            if (arg->sock < 0)
-            {
-                handle_error(RIG_DEBUG_ERR, "accept");
-                break;
-            }
+            retcode = 0;
 
-            if ((retcode = getnameinfo((struct sockaddr const *)&arg->cli_addr,
-                                       arg->clilen,
-                                       host,
-                                       sizeof(host),
-                                       serv,
-                                       sizeof(serv),
-                                       NI_NOFQDN))
-                    < 0)
+            for (i = 0; i < nrigs; i++)
             {
-                rig_debug(RIG_DEBUG_WARN,
-                          "Peer lookup error: %s",
-                          gai_strerror(retcode));
-            }
-
-            rig_debug(RIG_DEBUG_VERBOSE,
-                      "Connection opened from %s:%s\n",
-                      host,
-                      serv);
+                if (!FD_ISSET(rigs[i].sock_listen, &set))
+                {
+                    continue;
+                }
+
+                arg = malloc(sizeof(struct handle_data));
+
+                if (!arg)
+                {
+                    rig_debug(RIG_DEBUG_ERR, "malloc: %s\n", strerror(errno));
+                    exit(1);
+                }
+
+                arg->srv = &rigs[i];
+                arg->rig = rigs[i].rig;
+                arg->clilen = sizeof(arg->cli_addr);
+                arg->vfo_mode = vfo_mode;
+                arg->sock = accept(rigs[i].sock_listen,
+                                   (struct sockaddr *)&arg->cli_addr,
+                                   &arg->clilen);
+
+                if (arg->sock < 0)
+                {
+                    handle_error(RIG_DEBUG_ERR, "accept");
+                    free(arg);
+                    retcode = -1;
+                    break;
+                }
+
+                if ((retcode = getnameinfo((struct sockaddr const *)&arg->cli_addr,
+                                           arg->clilen,
+                                           host,
+                                           sizeof(host),
+                                           serv,
+                                           sizeof(serv),
+                                           NI_NOFQDN))
+                        < 0)
+                {
+                    rig_debug(RIG_DEBUG_WARN,
+                              "Peer lookup error: %s",
+                              gai_strerror(retcode));
+                }
+
+                rig_debug(RIG_DEBUG_VERBOSE,
+                          "Connection opened from %s:%s\n",
+                          host,
+                          serv);
 
 #ifdef HAVE_PTHREAD
-            pthread_attr_init(&attr);
-            pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+                pthread_attr_init(&attr);
+                pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
 
-            retcode = pthread_create(&thread, &attr, handle_socket, arg);
+                retcode = pthread_create(&thread, &attr, handle_socket, arg);
 
-            if (retcode != 0)
-            {
-                rig_debug(RIG_DEBUG_ERR, "pthread_create: %s\n", strerror(retcode));
-                break;
-            }
+                if (retcode != 0)
+                {
+                    rig_debug(RIG_DEBUG_ERR, "pthread_create: %s\n", strerror(retcode));
+                    break;
+                }
 
 #else
-            handle_socket(arg);
+                handle_socket(arg);
+                retcode = 0;
 #endif
+            }
         }
     }
     while (retcode == 0 && !ctrl_c);
 
-#ifdef HAVE_PTHREAD
-    /* allow threads to finish current action */
-    sync_callback(1);
+#endif  /* !HAVE_NETSERVER */
 
-    if (client_count)
+    for (i = 0; i < nrigs; i++)
     {
-        rig_debug(RIG_DEBUG_WARN, "%d outstanding client(s)\n", client_count);
-    }
+#ifdef HAVE_PTHREAD
+        /* allow threads to finish current action */
+        pthread_mutex_lock(&rigs[i].lock);
 
-    rig_close(my_rig);
-    sync_callback(0);
+        if (rigs[i].client_count)
+        {
+            rig_debug(RIG_DEBUG_WARN, "%d outstanding client(s)\n",
+                      rigs[i].client_count);
+        }
+
+        rig_close(rigs[i].rig);
+        pthread_mutex_unlock(&rigs[i].lock);
 #else
-    rig_close(my_rig); /* close port */
+        rig_close(rigs[i].rig); /* close port */
 #endif
-    rig_cleanup(my_rig); /* if you care about memory */
+        rig_cleanup(rigs[i].rig); /* if you care about memory */
+    }
 
 #ifdef __MINGW32__
     WSACleanup();
@@ -892,14 +1173,14 @@ int main(int argc, char *argv[])
 void *handle_socket(void *arg)
 {
     struct handle_data *handle_data_arg = (struct handle_data *)arg;
+    RIG *my_rig = handle_data_arg->rig;
     FILE *fsockin;
     FILE *fsockout;
     int retcode = RIG_OK;
     char host[NI_MAXHOST];
     char serv[NI_MAXSERV];
     char send_cmd_term = '\r';  /* send_cmd termination char */
-    int ext_resp = 0;
-    char resp_sep = '\n';
+    struct rigctl_parser *rp;
 
 #ifdef __MINGW32__
     int sock_osfhandle = _open_osfhandle(handle_data_arg->sock, _O_RDONLY);
@@ -935,10 +1216,23 @@ void *handle_socket(void *arg)
         goto handle_exit;
     }
 
+    rp = rigctl_parser_new(fsockin, 1, 0, handle_data_arg->vfo_mode,
+                           send_cmd_term);
+
+    if (!rp)
+    {
+        fclose(fsockin);
+#ifndef __MINGW32__
+        fclose(fsockout);
+#endif
+
+        goto handle_exit;
+    }
+
 #ifdef HAVE_PTHREAD
-    sync_callback(1);
+    sync_callback(my_rig, 1);
 
-    if (!client_count++)
+    if (!handle_data_arg->srv->client_count++)
     {
         retcode = rig_open(my_rig);
 
@@ -950,7 +1244,7 @@ void *handle_socket(void *arg)
         }
     }
 
-    sync_callback(0);
+    sync_callback(my_rig, 0);
 #else
     retcode = rig_open(my_rig);
 
@@ -965,9 +1259,7 @@ void *handle_socket(void *arg)
 
     do
     {
-        retcode = rigctl_parse(handle_data_arg->rig, fsockin, fsockout, NULL, 0,
-                               sync_callback,
-                               1, 0, handle_data_arg->vfo_mode, send_cmd_term, &ext_resp, &resp_sep);
+        retcode = rigctl_parse(my_rig, rp, fsockout, NULL, 0, sync_callback);
 
         if (ferror(fsockin) || ferror(fsockout))
         {
@@ -982,10 +1274,10 @@ void *handle_socket(void *arg)
     while (retcode == 0 || retcode == 2 || retcode == -RIG_ENAVAIL);
 
 #ifdef HAVE_PTHREAD
-    sync_callback(1);
+    sync_callback(my_rig, 1);
 
     /* Release rig if there are no clients */
-    if (!--client_count)
+    if (!--handle_data_arg->srv->client_count)
     {
         rig_close(my_rig);
 
@@ -997,7 +1289,7 @@ void *handle_socket(void *arg)
         }
     }
 
-    sync_callback(0);
+    sync_callback(my_rig, 0);
 #else
     rig_close(my_rig);
 
@@ -1028,6 +1320,7 @@ void *handle_socket(void *arg)
               host,
               serv);
 
+    rigctl_parser_free(rp);
     fclose(fsockin);
 #ifndef __MINGW32__
     fclose(fsockout);
@@ -1055,7 +1348,8 @@ void usage(void)
 
 
     printf(
-        "  -m, --model=ID                select radio model number. See model list\n"
+        "  -m, --model=ID                select radio model number. See model list,\n"
+        "                                repeat to serve several radios\n"
         "  -r, --rig-file=DEVICE         set device of the radio to operate on\n"
         "  -p, --ptt-file=DEVICE         set device of the PTT device to operate on\n"
         "  -d, --dcd-file=DEVICE         set device of the DCD device to operate on\n"
@@ -1064,6 +1358,7 @@ void usage(void)
         "  -s, --serial-speed=BAUD       set serial speed of the serial port\n"
         "  -c, --civaddr=ID              set CI-V address, decimal (for Icom rigs only)\n"
         "  -t, --port=NUM                set TCP listening port, default %s\n"
+        "                                or the previous radio's port plus two\n"
         "  -T, --listen-addr=IPADDR      set listening IP address, default ANY\n"
         "  -C, --set-conf=PARM=VAL       set config parameters\n"
         "  -L, --show-conf               list all config parameters\n"
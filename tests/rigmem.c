@@ -32,6 +32,7 @@
 #include <unistd.h>
 #include <ctype.h>
 #include <errno.h>
+#include <sys/time.h>
 
 #include <getopt.h>
 
@@ -57,6 +58,9 @@ extern int csv_load(RIG *rig, const char *infilename);
 extern int csv_parm_save(RIG *rig, const char *outfilename);
 extern int csv_parm_load(RIG *rig, const char *infilename);
 
+extern int sync_begin(RIG *rig, const char *path);
+extern int sync_end(RIG *rig, int clear);
+
 /*
  * Prototypes
  */
@@ -65,13 +69,14 @@ void version();
 int set_conf(RIG *rig, char *conf_parms);
 
 int clear_chans(RIG *rig, const char *infilename);
+static int print_progress(RIG *rig, int done, int total, rig_ptr_t arg);
 
 /*
  * Reminder: when adding long options,
  *      keep up to date SHORT_OPTIONS, usage()'s output and man page. thanks.
  * NB: do NOT use -W since it's reserved by POSIX.
  */
-#define SHORT_OPTIONS "m:r:s:c:C:p:axvhV"
+#define SHORT_OPTIONS "m:r:s:c:C:p:S:axvhV"
 static struct option long_options[] =
 {
     {"model",           1, 0, 'm'},
@@ -80,6 +85,7 @@ static struct option long_options[] =
     {"civaddr",         1, 0, 'c'},
     {"set-conf",        1, 0, 'C'},
     {"set-separator",   1, 0, 'p'},
+    {"sync-cache",      1, 0, 'S'},
     {"all",             0, 0, 'a'},
 #ifdef HAVE_XML2
     {"xml",             0, 0, 'x'},
@@ -102,7 +108,9 @@ int main(int argc, char *argv[])
     int retcode;        /* generic return code from functions */
 
     int verbose = 0, xml = 0;
+    struct timeval start;
     const char *rig_file = NULL;
+    const char *sync_cache = NULL;
     int serial_rate = 0;
     char *civaddr = NULL;   /* NULL means no need to set conf */
     char conf_parms[MAXCONFLEN] = "";
@@ -195,6 +203,16 @@ int main(int argc, char *argv[])
             csv_sep = optarg[0];
             break;
 
+        case 'S':
+            if (!optarg)
+            {
+                usage();    /* wrong arg count */
+                exit(1);
+            }
+
+            sync_cache = optarg;
+            break;
+
         case 'a':
             all++;
             break;
@@ -309,6 +327,13 @@ int main(int argc, char *argv[])
     /* on some rigs, this accelerates the backup/restore */
     rig_set_vfo(rig, RIG_VFO_MEM);
 
+    if (verbose > 0)
+    {
+        rig_set_chan_progress_callback(rig, print_progress, NULL);
+    }
+
+    gettimeofday(&start, NULL);
+
     if (!strcmp(argv[optind], "save"))
     {
         if (xml)
@@ -331,6 +356,32 @@ int main(int argc, char *argv[])
             retcode = csv_load(rig, argv[optind + 1]);
         }
     }
+    else if (!strcmp(argv[optind], "sync"))
+    {
+        retcode = sync_begin(rig, sync_cache);
+
+        if (retcode == RIG_OK)
+        {
+            if (xml)
+            {
+                retcode = xml_load(rig, argv[optind + 1]);
+            }
+            else
+            {
+                retcode = csv_load(rig, argv[optind + 1]);
+            }
+
+            /* only clear channels once the whole file went through */
+            if (retcode == RIG_OK)
+            {
+                retcode = sync_end(rig, 1);
+            }
+            else
+            {
+                sync_end(rig, 0);
+            }
+        }
+    }
     else if (!strcmp(argv[optind], "save_parm"))
     {
         if (xml)
@@ -363,6 +414,16 @@ int main(int argc, char *argv[])
         exit(1);
     }
 
+    if (verbose > 0)
+    {
+        struct timeval end;
+
+        gettimeofday(&end, NULL);
+        fprintf(stderr, "%s took %.3f s\n", argv[optind],
+                (end.tv_sec - start.tv_sec)
+                + (end.tv_usec - start.tv_usec) / 1e6);
+    }
+
     rig_close(rig);     /* close port */
     rig_cleanup(rig);   /* if you care about memory */
 
@@ -396,6 +457,7 @@ void usage()
         "  -c, --civaddr=ID              set CI-V address, decimal (for Icom rigs only)\n"
         "  -C, --set-conf=PARM=VAL       set config parameters\n"
         "  -p, --set-separator=SEP       set character separator instead of the CSV comma\n"
+        "  -S, --sync-cache=FILE         set the channel hash cache used by sync\n"
         "  -a, --all                     bypass mem_caps, apply to all fields of channel_t\n"
 #ifdef HAVE_XML2
         "  -x, --xml                     use XML format instead of CSV\n"
@@ -409,6 +471,7 @@ void usage()
         "COMMANDs:\n"
         "  load\n"
         "  save\n"
+        "  sync\n"
         "  load_parm\n"
         "  save_parm\n"
         "  clear\n\n"
@@ -458,6 +521,21 @@ int set_conf(RIG *rig, char *conf_parms)
 }
 
 
+static int print_progress(RIG *rig, int done, int total, rig_ptr_t arg)
+{
+    (void) rig;
+    (void) arg;
+    fprintf(stderr, "\r%d/%d channels", done, total);
+
+    if (done == total)
+    {
+        fprintf(stderr, "\n");
+    }
+
+    return RIG_OK;
+}
+
+
 /*
  * Pretty nasty, clears everything you have in rig memory
  */
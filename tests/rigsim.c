@@ -0,0 +1,879 @@
+/*
+ *  Hamlib test tools - protocol simulators on a pseudo terminal
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#define _XOPEN_SOURCE 600
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <termios.h>
+#include <sys/time.h>
+#include <sys/select.h>
+#include <sys/wait.h>
+
+#include <hamlib/rig.h>
+#include "rigsim.h"
+
+
+#define CIV_ADDR        0x94    /* IC-7300 */
+#define CIV_MAXFRAME    64
+
+#define CAT_MAX_VALUES  48
+#define CAT_VALUE_LEN   48
+#define CAT_MAXCMD      64
+
+
+struct cat_value
+{
+    char key[4];                /* the read command, e.g. "MD0" */
+    char value[CAT_VALUE_LEN];  /* the reply, without the ';' */
+};
+
+struct sim
+{
+    struct rigsim_opts opts;
+    int fd;
+    unsigned int rand_state;
+    double next_noise;
+
+    /* Kenwood and newcat */
+    struct cat_value values[CAT_MAX_VALUES];
+    int nb_values;
+    int tx;
+
+    /* CI-V */
+    unsigned long long freq[2];
+    int vfo;
+    unsigned char mode[2], filter[2], data[2];
+    unsigned char ptt, split;
+    unsigned char level[256][2];        /* 0x14 */
+    unsigned char meter[256][2];        /* 0x15 */
+    unsigned char func[256];            /* 0x16 */
+};
+
+
+/*
+ * The commands a backend needs on open and for the common calls, with
+ * their initial replies. A command longer than its key sets the value.
+ */
+static const struct cat_value kenwood_values[] =
+{
+    { "ID", "ID019" },
+    { "FA", "FA00014250000" },
+    { "FB", "FB00007100000" },
+    { "MD", "MD2" },
+    { "AI", "AI0" },
+    { "PS", "PS1" },
+    { "FR", "FR0" },
+    { "FT", "FT0" },
+    { "AG0", "AG0100" },
+    { "RG", "RG255" },
+    { "SQ0", "SQ0000" },
+    { "PC", "PC100" },
+    { "SM0", "SM00005" },
+    { "RA", "RA00" },
+    { "PA", "PA00" },
+    { "NB", "NB0" },
+    { "NR", "NR0" },
+    { "RT", "RT0" },
+    { "XT", "XT0" },
+    { "FW", "FW0000" },
+    { "", "" }
+};
+
+static const struct cat_value newcat_values[] =
+{
+    { "ID", "ID0570" },
+    { "AI", "AI0" },
+    { "FA", "FA014074000" },
+    { "FB", "FB007100000" },
+    { "MD0", "MD02" },
+    { "VS", "VS0" },
+    { "FT", "FT0" },
+    { "FR", "FR0" },
+    { "TX", "TX0" },
+    { "PS", "PS1" },
+    { "SH0", "SH016" },
+    { "NA0", "NA00" },
+    { "AG0", "AG0128" },
+    { "RG0", "RG0255" },
+    { "SQ0", "SQ0000" },
+    { "PC", "PC100" },
+    { "SM0", "SM0050" },
+    { "RA0", "RA00" },
+    { "PA0", "PA00" },
+    { "NB0", "NB00" },
+    { "NR0", "NR00" },
+    { "", "" }
+};
+
+
+static double now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+
+/* the time len bytes take on the line, 10 bits each */
+static void sim_pace(struct sim *sim, int len)
+{
+    if (sim->opts.baud > 0)
+    {
+        usleep(len * 10 * 1000000LL / sim->opts.baud);
+    }
+}
+
+
+static void sim_write(struct sim *sim, const void *buf, int len)
+{
+    sim_pace(sim, len);
+
+    if (write(sim->fd, buf, len) < 0)
+    {
+        exit(0);
+    }
+}
+
+
+static void sim_noise(struct sim *sim);
+
+
+/*
+ * Sends a reply after the latency of the rig, preceded by an unsolicited
+ * report when one is due, and goes wrong once in error_rate replies.
+ */
+static void sim_reply(struct sim *sim, const void *buf, int len)
+{
+    if (sim->opts.latency > 0)
+    {
+        usleep(sim->opts.latency);
+    }
+
+    if (sim->opts.noise > 0 && now() >= sim->next_noise)
+    {
+        sim_noise(sim);
+    }
+
+    if (sim->opts.error_rate > 0
+            && rand_r(&sim->rand_state) % sim->opts.error_rate == 0)
+    {
+        static const unsigned char civ_nak[] =
+        {
+            0xfe, 0xfe, 0xe0, CIV_ADDR, 0xfa, 0xfd
+        };
+
+        switch (rand_r(&sim->rand_state) % 3)
+        {
+        case 0:
+            /* lost */
+            return;
+
+        case 1:
+            /* rejected */
+            if (sim->opts.proto == RIGSIM_CIV)
+            {
+                sim_write(sim, civ_nak, sizeof(civ_nak));
+            }
+            else
+            {
+                sim_write(sim, "?;", 2);
+            }
+
+            return;
+
+        default:
+            /* cut short */
+            len /= 2;
+            break;
+        }
+    }
+
+    sim_write(sim, buf, len);
+}
+
+
+/*
+ * Kenwood and newcat
+ */
+
+static struct cat_value *cat_find(struct sim *sim, const char *cmd)
+{
+    struct cat_value *best = NULL;
+    int best_len = 0;
+    int i;
+
+    for (i = 0; i < sim->nb_values; i++)
+    {
+        int len = strlen(sim->values[i].key);
+
+        if (len > best_len && !strncmp(cmd, sim->values[i].key, len))
+        {
+            best = &sim->values[i];
+            best_len = len;
+        }
+    }
+
+    return best;
+}
+
+
+static const char *cat_get(struct sim *sim, const char *key, int offset)
+{
+    const struct cat_value *v = cat_find(sim, key);
+
+    return v ? v->value + offset : "";
+}
+
+
+static void cat_if(struct sim *sim, char *reply, int size)
+{
+    if (sim->opts.proto == RIGSIM_KENWOOD)
+    {
+        /* freq, step, rit, rit/xit on, memory, tx, mode, ..., split */
+        snprintf(reply, size, "IF%s     +000000000%d%s00%d0000;",
+                 cat_get(sim, "FA", 2), sim->tx, cat_get(sim, "MD", 2),
+                 strcmp(cat_get(sim, "FR", 2), cat_get(sim, "FT", 2)) != 0);
+    }
+    else
+    {
+        /* memory, freq, clarifier, mode, vfo, ctcss, shift */
+        snprintf(reply, size, "IF001%s+000000%s00000;",
+                 cat_get(sim, "FA", 2), cat_get(sim, "MD0", 3));
+    }
+}
+
+
+static void cat_command(struct sim *sim, const char *cmd)
+{
+    char reply[CAT_VALUE_LEN + 8];
+    struct cat_value *v;
+    int len;
+
+    if (sim->opts.proto == RIGSIM_KENWOOD
+            && (!strncmp(cmd, "TX", 2) || !strcmp(cmd, "RX")))
+    {
+        sim->tx = cmd[0] == 'T';
+        return;
+    }
+
+    if (!strcmp(cmd, "IF"))
+    {
+        cat_if(sim, reply, sizeof(reply));
+        sim_reply(sim, reply, strlen(reply));
+        return;
+    }
+
+    v = cat_find(sim, cmd);
+
+    if (!v)
+    {
+        sim_reply(sim, "?;", 2);
+        return;
+    }
+
+    len = strlen(cmd);
+
+    if (len == strlen(v->key))
+    {
+        len = snprintf(reply, sizeof(reply), "%s;", v->value);
+        sim_reply(sim, reply, len);
+    }
+    else if (len < CAT_VALUE_LEN)
+    {
+        /* sets are not answered */
+        strcpy(v->value, cmd);
+    }
+}
+
+
+static void cat_noise(struct sim *sim)
+{
+    char report[CAT_VALUE_LEN + 2];
+    int len;
+
+    len = snprintf(report, sizeof(report), "%s;", cat_get(sim, "FA", 0));
+    sim_write(sim, report, len);
+}
+
+
+static void cat_input(struct sim *sim, const unsigned char *buf, int len)
+{
+    static char cmd[CAT_MAXCMD];
+    static int cmd_len;
+    int i;
+
+    for (i = 0; i < len; i++)
+    {
+        if (buf[i] != ';')
+        {
+            if (cmd_len < CAT_MAXCMD - 1)
+            {
+                cmd[cmd_len++] = buf[i];
+            }
+
+            continue;
+        }
+
+        cmd[cmd_len] = '\0';
+        cmd_len = 0;
+        cat_command(sim, cmd);
+    }
+}
+
+
+/*
+ * CI-V
+ */
+
+static int civ_to_bcd(unsigned char *bcd, unsigned long long freq)
+{
+    int i;
+
+    /* 10 digits, least significant first */
+    for (i = 0; i < 5; i++)
+    {
+        bcd[i] = freq % 10;
+        freq /= 10;
+        bcd[i] |= (freq % 10) << 4;
+        freq /= 10;
+    }
+
+    return 5;
+}
+
+
+static unsigned long long civ_from_bcd(const unsigned char *bcd, int len)
+{
+    unsigned long long freq = 0;
+    int i;
+
+    for (i = len - 1; i >= 0; i--)
+    {
+        freq = freq * 100 + (bcd[i] >> 4) * 10 + (bcd[i] & 0x0f);
+    }
+
+    return freq;
+}
+
+
+static void civ_send(struct sim *sim, int to, const unsigned char *data,
+                     int len)
+{
+    unsigned char frame[CIV_MAXFRAME];
+
+    frame[0] = 0xfe;
+    frame[1] = 0xfe;
+    frame[2] = to;
+    frame[3] = CIV_ADDR;
+    memcpy(frame + 4, data, len);
+    frame[4 + len] = 0xfd;
+
+    sim_reply(sim, frame, len + 5);
+}
+
+
+static void civ_ack(struct sim *sim, int to, int ok)
+{
+    unsigned char ack = ok ? 0xfb : 0xfa;
+
+    civ_send(sim, to, &ack, 1);
+}
+
+
+/*
+ * Handles cmd (sub) data..., len bytes between the addresses and FD.
+ */
+static void civ_command(struct sim *sim, int from, const unsigned char *cmd,
+                        int len)
+{
+    unsigned char reply[CIV_MAXFRAME];
+    int sub = len > 1 ? cmd[1] : -1;
+    int v = sim->vfo;
+
+    reply[0] = cmd[0];
+    reply[1] = sub;
+
+    switch (cmd[0])
+    {
+    case 0x03:
+        civ_send(sim, from, reply, 1 + civ_to_bcd(reply + 1, sim->freq[v]));
+        return;
+
+    case 0x04:
+        reply[1] = sim->mode[v];
+        reply[2] = sim->filter[v];
+        civ_send(sim, from, reply, 3);
+        return;
+
+    case 0x05:
+        if (len < 6)
+        {
+            break;
+        }
+
+        sim->freq[v] = civ_from_bcd(cmd + 1, 5);
+        civ_ack(sim, from, 1);
+        return;
+
+    case 0x06:
+        sim->mode[v] = sub;
+
+        if (len > 2)
+        {
+            sim->filter[v] = cmd[2];
+        }
+
+        civ_ack(sim, from, 1);
+        return;
+
+    case 0x07:
+        if (sub == 0x00 || sub == 0x01)
+        {
+            sim->vfo = sub;
+        }
+
+        civ_ack(sim, from, 1);
+        return;
+
+    case 0x0f:
+        if (len == 1)
+        {
+            reply[1] = sim->split;
+            civ_send(sim, from, reply, 2);
+            return;
+        }
+
+        sim->split = sub;
+        civ_ack(sim, from, 1);
+        return;
+
+    case 0x14:
+    case 0x15:
+        if (len == 2)
+        {
+            unsigned char *p = cmd[0] == 0x14 ? sim->level[sub]
+                               : sim->meter[sub];
+
+            reply[2] = p[0];
+            reply[3] = p[1];
+            civ_send(sim, from, reply, 4);
+            return;
+        }
+
+        if (cmd[0] == 0x15 || len != 4)
+        {
+            break;
+        }
+
+        sim->level[sub][0] = cmd[2];
+        sim->level[sub][1] = cmd[3];
+        civ_ack(sim, from, 1);
+        return;
+
+    case 0x16:
+        if (len == 2)
+        {
+            reply[2] = sim->func[sub];
+            civ_send(sim, from, reply, 3);
+            return;
+        }
+
+        sim->func[sub] = cmd[2];
+        civ_ack(sim, from, 1);
+        return;
+
+    case 0x19:
+        reply[2] = CIV_ADDR;
+        civ_send(sim, from, reply, 3);
+        return;
+
+    case 0x1a:
+        if (sub != 0x06)
+        {
+            break;
+        }
+
+        if (len == 2)
+        {
+            reply[2] = sim->data[v];
+            reply[3] = sim->data[v] ? 1 : 0;
+            civ_send(sim, from, reply, 4);
+            return;
+        }
+
+        sim->data[v] = cmd[2];
+        civ_ack(sim, from, 1);
+        return;
+
+    case 0x1c:
+        if (sub != 0x00)
+        {
+            break;
+        }
+
+        if (len == 2)
+        {
+            reply[2] = sim->ptt;
+            civ_send(sim, from, reply, 3);
+            return;
+        }
+
+        sim->ptt = cmd[2];
+        civ_ack(sim, from, 1);
+        return;
+
+    case 0x25:
+        if (sub != 0x00 && sub != 0x01)
+        {
+            break;
+        }
+
+        /* 0 is the selected VFO, 1 the other one */
+        v = sub ? !sim->vfo : sim->vfo;
+
+        if (len == 2)
+        {
+            civ_send(sim, from, reply, 2 + civ_to_bcd(reply + 2, sim->freq[v]));
+            return;
+        }
+
+        if (len < 7)
+        {
+            break;
+        }
+
+        sim->freq[v] = civ_from_bcd(cmd + 2, 5);
+        civ_ack(sim, from, 1);
+        return;
+
+    default:
+        break;
+    }
+
+    civ_ack(sim, from, 0);
+}
+
+
+static void civ_noise(struct sim *sim)
+{
+    unsigned char frame[12];
+
+    /* transceive broadcast of the frequency */
+    frame[0] = 0xfe;
+    frame[1] = 0xfe;
+    frame[2] = 0x00;
+    frame[3] = CIV_ADDR;
+    frame[4] = 0x00;
+    civ_to_bcd(frame + 5, sim->freq[sim->vfo]);
+    frame[10] = 0xfd;
+
+    sim_write(sim, frame, 11);
+}
+
+
+static void civ_input(struct sim *sim, const unsigned char *buf, int len)
+{
+    static unsigned char frame[CIV_MAXFRAME];
+    static int frame_len;
+    int i;
+
+    for (i = 0; i < len; i++)
+    {
+        if (frame_len < CIV_MAXFRAME)
+        {
+            frame[frame_len++] = buf[i];
+        }
+
+        if (buf[i] != 0xfd)
+        {
+            continue;
+        }
+
+        /* skip any number of preamble bytes */
+        while (frame_len > 2 && frame[0] == 0xfe && frame[1] == 0xfe
+                && frame[2] == 0xfe)
+        {
+            memmove(frame, frame + 1, --frame_len);
+        }
+
+        if (frame_len >= 6 && frame[0] == 0xfe && frame[1] == 0xfe
+                && frame[2] == CIV_ADDR && frame_len < CIV_MAXFRAME)
+        {
+            if (sim->opts.echo)
+            {
+                sim_write(sim, frame, frame_len);
+            }
+
+            civ_command(sim, frame[3], frame + 4, frame_len - 5);
+        }
+
+        frame_len = 0;
+    }
+}
+
+
+static void sim_noise(struct sim *sim)
+{
+    if (sim->opts.proto == RIGSIM_CIV)
+    {
+        civ_noise(sim);
+    }
+    else
+    {
+        cat_noise(sim);
+    }
+
+    sim->next_noise = now() + sim->opts.noise / 1000.0;
+}
+
+
+/*
+ * The simulated rig, until the other end goes away.
+ */
+static void sim_run(int fd, const struct rigsim_opts *opts)
+{
+    static struct sim sim;
+    const struct cat_value *values;
+
+    sim.opts = *opts;
+    sim.fd = fd;
+    sim.rand_state = opts->seed;
+    sim.next_noise = now() + opts->noise / 1000.0;
+
+    values = opts->proto == RIGSIM_KENWOOD ? kenwood_values : newcat_values;
+
+    for (sim.nb_values = 0; values[sim.nb_values].key[0]; sim.nb_values++)
+    {
+        sim.values[sim.nb_values] = values[sim.nb_values];
+    }
+
+    sim.freq[0] = 14074000;
+    sim.freq[1] = 7074000;
+    sim.mode[0] = sim.mode[1] = 0x01;   /* USB */
+    sim.filter[0] = sim.filter[1] = 0x01;
+    sim.meter[0x02][0] = 0x01;          /* S9 */
+    sim.meter[0x02][1] = 0x20;
+
+    for (;;)
+    {
+        unsigned char buf[256];
+        struct timeval tv, *ptv = NULL;
+        fd_set rfds;
+        int len;
+
+        if (sim.opts.noise > 0)
+        {
+            double wait = sim.next_noise - now();
+
+            if (wait <= 0)
+            {
+                sim_noise(&sim);
+                continue;
+            }
+
+            tv.tv_sec = (long)wait;
+            tv.tv_usec = (long)((wait - tv.tv_sec) * 1000000);
+            ptv = &tv;
+        }
+
+        FD_ZERO(&rfds);
+        FD_SET(fd, &rfds);
+
+        if (select(fd + 1, &rfds, NULL, NULL, ptv) <= 0)
+        {
+            continue;
+        }
+
+        len = read(fd, buf, sizeof(buf));
+
+        if (len <= 0)
+        {
+            break;
+        }
+
+        /* the time the command took to come in */
+        sim_pace(&sim, len);
+
+        if (sim.opts.proto == RIGSIM_CIV)
+        {
+            civ_input(&sim, buf, len);
+        }
+        else
+        {
+            cat_input(&sim, buf, len);
+        }
+    }
+
+    exit(0);
+}
+
+
+void rigsim_default_opts(struct rigsim_opts *opts, rigsim_proto_t proto)
+{
+    memset(opts, 0, sizeof(*opts));
+
+    opts->proto = proto;
+    opts->echo = proto == RIGSIM_CIV;
+    opts->seed = 1;
+}
+
+
+/*
+ * Starts a simulated rig on a new pseudo terminal.
+ * Returns 0, or -1 with errno set.
+ */
+int rigsim_start(struct rigsim *sim, const struct rigsim_opts *opts)
+{
+    struct termios tio;
+
+    memset(sim, 0, sizeof(*sim));
+    sim->slave = -1;
+
+    sim->master = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (sim->master < 0)
+    {
+        return -1;
+    }
+
+    if (grantpt(sim->master) < 0 || unlockpt(sim->master) < 0)
+    {
+        close(sim->master);
+        return -1;
+    }
+
+    strncpy(sim->pathname, ptsname(sim->master), FILPATHLEN - 1);
+
+    /* hold the slave open in raw mode so that nothing gets echoed
+       before the backend sets up the port */
+    sim->slave = open(sim->pathname, O_RDWR | O_NOCTTY);
+
+    if (sim->slave < 0 || tcgetattr(sim->slave, &tio) < 0)
+    {
+        rigsim_stop(sim);
+        return -1;
+    }
+
+    cfmakeraw(&tio);
+    tcsetattr(sim->slave, TCSANOW, &tio);
+
+    sim->pid = fork();
+
+    if (sim->pid < 0)
+    {
+        rigsim_stop(sim);
+        return -1;
+    }
+
+    if (sim->pid == 0)
+    {
+        close(sim->slave);
+        sim_run(sim->master, opts);
+    }
+
+    return 0;
+}
+
+
+void rigsim_stop(struct rigsim *sim)
+{
+    if (sim->pid > 0)
+    {
+        kill(sim->pid, SIGTERM);
+        waitpid(sim->pid, NULL, 0);
+        sim->pid = 0;
+    }
+
+    if (sim->slave >= 0)
+    {
+        close(sim->slave);
+        sim->slave = -1;
+    }
+
+    if (sim->master >= 0)
+    {
+        close(sim->master);
+        sim->master = -1;
+    }
+}
+
+
+rig_model_t rigsim_model(rigsim_proto_t proto)
+{
+    switch (proto)
+    {
+    case RIGSIM_CIV:
+        return RIG_MODEL_IC7300;
+
+    case RIGSIM_KENWOOD:
+        return RIG_MODEL_TS2000;
+
+    case RIGSIM_NEWCAT:
+        return RIG_MODEL_FT991;
+    }
+
+    return RIG_MODEL_NONE;
+}
+
+
+const char *rigsim_strproto(rigsim_proto_t proto)
+{
+    switch (proto)
+    {
+    case RIGSIM_CIV:
+        return "civ";
+
+    case RIGSIM_KENWOOD:
+        return "kenwood";
+
+    case RIGSIM_NEWCAT:
+        return "newcat";
+    }
+
+    return "";
+}
+
+
+/*
+ * Returns the protocol named s, or -1.
+ */
+int rigsim_parse_proto(const char *s)
+{
+    int i;
+
+    for (i = 0; i < RIGSIM_NB_PROTO; i++)
+    {
+        if (!strcmp(s, rigsim_strproto(i)))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
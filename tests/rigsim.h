@@ -0,0 +1,72 @@
+/*
+ *  Hamlib test tools - protocol simulators on a pseudo terminal
+ *  Copyright (c) 2020 by the Hamlib Group
+ *
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _RIGSIM_H
+#define _RIGSIM_H 1
+
+#include <sys/types.h>
+#include <hamlib/rig.h>
+
+/*
+ * A simulated rig is a child process answering on the master side of a
+ * pseudo terminal. Backends open the slave side, rigsim.pathname, as if
+ * it were a serial port, so the whole transaction code of the backend
+ * and of iofunc.c is exercised without hardware.
+ */
+
+typedef enum
+{
+    RIGSIM_CIV,         /* Icom CI-V, as an IC-7300 */
+    RIGSIM_KENWOOD,     /* Kenwood, as a TS-2000 */
+    RIGSIM_NEWCAT       /* Yaesu newcat, as an FT-991 */
+} rigsim_proto_t;
+
+#define RIGSIM_NB_PROTO 3
+
+struct rigsim_opts
+{
+    rigsim_proto_t proto;
+    int baud;           /* pace the bytes as on a serial line, 0 for none */
+    int latency;        /* us before the rig starts to answer */
+    int echo;           /* CI-V: echo the commands as the bus does */
+    int noise;          /* ms between unsolicited reports, 0 for none */
+    int error_rate;     /* one reply in error_rate goes wrong, 0 for none */
+    unsigned int seed;  /* for the error injection */
+};
+
+struct rigsim
+{
+    pid_t pid;
+    int master;
+    int slave;          /* held open so the tty keeps its raw settings */
+    char pathname[FILPATHLEN];
+};
+
+extern void rigsim_default_opts(struct rigsim_opts *opts,
+                                rigsim_proto_t proto);
+extern int rigsim_start(struct rigsim *sim, const struct rigsim_opts *opts);
+extern void rigsim_stop(struct rigsim *sim);
+
+extern rig_model_t rigsim_model(rigsim_proto_t proto);
+extern const char *rigsim_strproto(rigsim_proto_t proto);
+extern int rigsim_parse_proto(const char *s);
+
+#endif /* _RIGSIM_H */
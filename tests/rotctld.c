@@ -65,6 +65,7 @@
 #include "misc.h"
 
 #include "rotctl_parse.h"
+#include "netserver.h"
 
 struct handle_data
 {
@@ -113,6 +114,32 @@ elevation_t el_offset;
 #define MAXCONFLEN 128
 
 
+#ifdef HAVE_NETSERVER
+/* runs until killed, as always */
+static int quit_never(void)
+{
+    return 0;
+}
+
+
+static int client_parse(struct netserver_client *client, FILE *fin,
+                        FILE *fout)
+{
+    int retcode;
+
+    retcode = rotctl_parse(client->dev, fin, fout, NULL, 0, 1, 0, '\r');
+
+    return !(retcode == 0 || retcode == 2);
+}
+
+
+static const struct netserver_ops client_ops =
+{
+    .parse = client_parse,
+};
+#endif  /* HAVE_NETSERVER */
+
+
 static void handle_error(enum rig_debug_level_e lvl, const char *msg)
 {
     int e;
@@ -167,14 +194,15 @@ int main(int argc, char *argv[])
     int sock_listen;
     int reuseaddr = 1;
     int sockopt;
+#ifndef HAVE_NETSERVER
     char host[NI_MAXHOST];
     char serv[NI_MAXSERV];
-
 #ifdef HAVE_PTHREAD
     pthread_t thread;
     pthread_attr_t attr;
 #endif
     struct handle_data *arg;
+#endif
 
     while (1)
     {
@@ -532,6 +560,11 @@ int main(int argc, char *argv[])
 #endif
 #endif
 
+#ifdef HAVE_NETSERVER
+    netserver_listen(sock_listen, &client_ops, my_rot, NULL);
+    netserver_run(NETSERVER_WORKERS, quit_never);
+#else
+
     /*
      * main loop accepting connections
      */
@@ -595,6 +628,8 @@ int main(int argc, char *argv[])
     }
     while (retcode == 0);
 
+#endif  /* !HAVE_NETSERVER */
+
     rot_close(my_rot); /* close port */
     rot_cleanup(my_rot); /* if you care about memory */
 
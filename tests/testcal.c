@@ -0,0 +1,223 @@
+/*
+ * Test program for the compiled calibration tables.
+ *
+ * Loads the S-meter and meter tables of every registered rig into an
+ * opened dummy rig, and checks that rig_raw2val_meter() and
+ * rig_raw2val_batch() give exactly what rig_raw2val() and
+ * rig_raw2val_float() give, over and around the range of each table.
+ *
+ * With -b [count], also times the conversion of count S-meter samples
+ * of the IC-7300 table by rig_raw2val(), rig_raw2val_meter() and
+ * rig_raw2val_batch().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <hamlib/rig.h>
+#include "benchutil.h"
+#include "cal.h"
+
+
+#define BATCH_COUNT 1000000
+#define MARGIN 3
+
+static RIG *my_rig;
+static int checked, errors;
+
+
+static void check_table(const struct rig_caps *caps,
+                        rig_cal_t meter,
+                        const cal_table_float_t *fcal,
+                        const cal_table_t *cal)
+{
+    int size = cal ? cal->size : fcal->size;
+    int raw_min, raw_max, count, raw, i;
+    int *rawval;
+    float *val;
+
+    if (size == 0)
+    {
+        return;
+    }
+
+    raw_min = (cal ? cal->table[0].raw : fcal->table[0].raw) - MARGIN;
+    raw_max = (cal ? cal->table[size - 1].raw : fcal->table[size - 1].raw)
+              + MARGIN;
+
+    if (raw_max < raw_min)
+    {
+        return;
+    }
+
+    count = raw_max - raw_min + 1;
+    rawval = calloc(count, sizeof(int));
+    val = calloc(count, sizeof(float));
+
+    if (!rawval || !val)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(2);
+    }
+
+    if (cal)
+    {
+        rig_set_cal(my_rig, meter, cal);
+    }
+    else
+    {
+        rig_set_cal_float(my_rig, meter, fcal);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        rawval[i] = raw_min + i;
+    }
+
+    rig_raw2val_batch(my_rig, meter, rawval, val, count);
+
+    for (i = 0; i < count; i++)
+    {
+        float expected;
+
+        raw = rawval[i];
+        expected = cal ? rig_raw2val(raw, cal) : rig_raw2val_float(raw, fcal);
+
+        if (rig_raw2val_meter(my_rig, meter, raw) != expected
+                || val[i] != expected)
+        {
+            printf("%s %s, meter %d, raw %d: %g and %g, expected %g\n",
+                   caps->mfg_name, caps->model_name, meter, raw,
+                   rig_raw2val_meter(my_rig, meter, raw), val[i], expected);
+            errors++;
+        }
+    }
+
+    checked++;
+    free(rawval);
+    free(val);
+}
+
+
+static int check_caps(const struct rig_caps *caps, rig_ptr_t data)
+{
+    check_table(caps, RIG_CAL_STR, NULL, &caps->str_cal);
+    check_table(caps, RIG_CAL_SWR, &caps->swr_cal, NULL);
+    check_table(caps, RIG_CAL_ALC, &caps->alc_cal, NULL);
+    check_table(caps, RIG_CAL_RFPOWER_METER, &caps->rfpower_meter_cal, NULL);
+    check_table(caps, RIG_CAL_COMP_METER, &caps->comp_meter_cal, NULL);
+    check_table(caps, RIG_CAL_VD_METER, &caps->vd_meter_cal, NULL);
+    check_table(caps, RIG_CAL_ID_METER, &caps->id_meter_cal, NULL);
+
+    return 1;   /* !=0, we want them all! */
+}
+
+
+static void bench(int count)
+{
+    const struct rig_caps *caps = rig_get_caps(RIG_MODEL_IC7300);
+    int *rawval;
+    float *val;
+    double t, t_one, t_meter, t_batch;
+    volatile float sink = 0;
+    int i;
+
+    rawval = calloc(count, sizeof(int));
+    val = calloc(count, sizeof(float));
+
+    if (!caps || !rawval || !val)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(2);
+    }
+
+    srand(1);
+
+    for (i = 0; i < count; i++)
+    {
+        rawval[i] = rand() % 256;
+    }
+
+    rig_set_cal(my_rig, RIG_CAL_STR, &caps->str_cal);
+
+    t = bench_now();
+
+    for (i = 0; i < count; i++)
+    {
+        sink += rig_raw2val(rawval[i], &caps->str_cal);
+    }
+
+    t_one = bench_now() - t;
+
+    t = bench_now();
+
+    for (i = 0; i < count; i++)
+    {
+        sink += rig_raw2val_meter(my_rig, RIG_CAL_STR, rawval[i]);
+    }
+
+    t_meter = bench_now() - t;
+
+    t = bench_now();
+    rig_raw2val_batch(my_rig, RIG_CAL_STR, rawval, val, count);
+    t_batch = bench_now() - t;
+
+    printf("%d IC-7300 S-meter samples\n", count);
+    printf("  rig_raw2val:\t\t%.1f Msamples/s\n", count / t_one / 1e6);
+    printf("  rig_raw2val_meter:\t%.1f Msamples/s\n", count / t_meter / 1e6);
+    printf("  rig_raw2val_batch:\t%.1f Msamples/s\n", count / t_batch / 1e6);
+
+    free(rawval);
+    free(val);
+}
+
+
+int main(int argc, char *argv[])
+{
+    int count = 0;
+    int retcode;
+
+    if (argc > 1)
+    {
+        if (strcmp(argv[1], "-b"))
+        {
+            fprintf(stderr, "Usage: %s [-b [<count>]]\n", argv[0]);
+            exit(1);
+        }
+
+        count = argc > 2 ? atoi(argv[2]) : BATCH_COUNT;
+    }
+
+    rig_set_debug(RIG_DEBUG_WARN);
+    rig_load_all_backends();
+
+    my_rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!my_rig)
+    {
+        fprintf(stderr, "rig_init failed\n");
+        exit(2);
+    }
+
+    retcode = rig_open(my_rig);
+
+    if (retcode != RIG_OK)
+    {
+        fprintf(stderr, "rig_open: error = %s\n", rigerror(retcode));
+        exit(2);
+    }
+
+    rig_list_foreach(check_caps, NULL);
+
+    printf("%d tables checked, %d errors\n", checked, errors);
+
+    if (count > 0)
+    {
+        bench(count);
+    }
+
+    rig_close(my_rig);
+    rig_cleanup(my_rig);
+
+    return errors ? 1 : 0;
+}
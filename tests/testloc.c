@@ -8,6 +8,9 @@
  * to >= 1 or <= 6.  If two locators are given, then the qrb is also
  * calculated.
  *
+ * With -b [count], checks locator2longlat_batch() and qrb_batch() against
+ * their one point versions over count generated locators, and times both.
+ *
  *
  */
 
@@ -15,6 +18,137 @@
 #include <stdlib.h>
 #include <string.h>
 #include <hamlib/rotator.h>
+#include "benchutil.h"
+
+
+#define BATCH_COUNT 20000
+
+
+static int batch_test(int count)
+{
+    static const int range[] = { 18, 10, 24, 10, 24, 10 };
+    char (*locs)[13];
+    const char **loc_list;
+    double *lon, *lat, *dist, *az;
+    int *status, *loc_status;
+    double lon1, lat1, d1, a1, t, t_one, t_batch;
+    int i, j, ret, errors = 0;
+    unsigned seed = 1;
+
+    locs = calloc(count, sizeof(*locs));
+    loc_list = calloc(count, sizeof(*loc_list));
+    lon = calloc(count, sizeof(double));
+    lat = calloc(count, sizeof(double));
+    dist = calloc(count, sizeof(double));
+    az = calloc(count, sizeof(double));
+    status = calloc(count, sizeof(int));
+    loc_status = calloc(count, sizeof(int));
+
+    if (!locs || !loc_list || !lon || !lat || !dist || !az || !status
+            || !loc_status)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 2;
+    }
+
+    /* time the math, not the debug output */
+    rig_set_debug(RIG_DEBUG_WARN);
+
+    /* 2 to 12 characters, mixed case, one in 64 malformed */
+    for (i = 0; i < count; i++)
+    {
+        int pairs = 1 + i % 6;
+
+        for (j = 0; j < pairs * 2; j++)
+        {
+            int r = range[j / 2];
+            char base = r == 10 ? '0' : ((i & 1) ? 'a' : 'A');
+
+            seed = seed * 1103515245 + 12345;
+            locs[i][j] = base + (seed >> 16) % r;
+        }
+
+        if (i % 64 == 63)
+        {
+            locs[i][pairs * 2 - 1] = '/';
+        }
+
+        loc_list[i] = locs[i];
+    }
+
+    ret = locator2longlat_batch(lon, lat, loc_status, loc_list, count);
+
+    if (ret != -RIG_EINVAL)
+    {
+        printf("locator2longlat_batch: malformed locators not reported\n");
+        errors++;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        ret = locator2longlat(&lon1, &lat1, loc_list[i]);
+
+        if (ret != loc_status[i]
+                || (ret == RIG_OK && (lon1 != lon[i] || lat1 != lat[i])))
+        {
+            printf("locator2longlat_batch: %s gives %d %f %f, "
+                   "expected %d %f %f\n", loc_list[i], loc_status[i],
+                   lon[i], lat[i], ret, lon1, lat1);
+            errors++;
+        }
+    }
+
+    locator2longlat(&lon1, &lat1, "EM79UT96LW");
+    qrb_batch(lon1, lat1, lon, lat, dist, az, status, count);
+
+    for (i = 0; i < count; i++)
+    {
+        if (loc_status[i] != RIG_OK)
+        {
+            continue;
+        }
+
+        ret = qrb(lon1, lat1, lon[i], lat[i], &d1, &a1);
+
+        if (ret != status[i]
+                || (ret == RIG_OK && (d1 != dist[i] || a1 != az[i])))
+        {
+            printf("qrb_batch: %s gives %d %f %f, expected %d %f %f\n",
+                   loc_list[i], status[i], dist[i], az[i], ret, d1, a1);
+            errors++;
+        }
+    }
+
+    t = bench_now();
+
+    for (i = 0; i < count; i++)
+    {
+        locator2longlat(&lon[i], &lat[i], loc_list[i]);
+        qrb(lon1, lat1, lon[i], lat[i], &dist[i], &az[i]);
+    }
+
+    t_one = bench_now() - t;
+
+    t = bench_now();
+    locator2longlat_batch(lon, lat, loc_status, loc_list, count);
+    qrb_batch(lon1, lat1, lon, lat, dist, az, status, count);
+    t_batch = bench_now() - t;
+
+    printf("%d locators, %d errors\n", count, errors);
+    printf("  one at a time:\t%.0f locators/s\n", count / t_one);
+    printf("  batch:\t%.0f locators/s\n", count / t_batch);
+
+    free(locs);
+    free(loc_list);
+    free(lon);
+    free(lat);
+    free(dist);
+    free(az);
+    free(status);
+    free(loc_status);
+
+    return errors ? 1 : 0;
+}
 
 
 int main(int argc, char *argv[])
@@ -27,11 +161,17 @@ int main(int argc, char *argv[])
     if (argc < 2)
     {
         fprintf(stderr,
-                "Usage: %s <locator1> <precision> [<locator2>]\n",
-                argv[0]);
+                "Usage: %s <locator1> <precision> [<locator2>]\n"
+                "       %s -b [<count>]\n",
+                argv[0], argv[0]);
         exit(1);
     }
 
+    if (!strcmp(argv[1], "-b"))
+    {
+        exit(batch_test(argc > 2 ? atoi(argv[2]) : BATCH_COUNT));
+    }
+
     loc1 = argv[1];
     loc_len = argc > 2 ? atoi(argv[2]) : strlen(loc1) / 2;
     loc2 = argc > 3 ? argv[3] : NULL;
@@ -0,0 +1,149 @@
+/*
+ * Test program for the rigctld command parser fed by buffers.
+ *
+ * Runs a script of rigctld commands against a dummy rig through
+ * rigctl_parse_buf(), once all in one buffer, then split in two at every
+ * byte as the network may deliver it, and checks that the answers are
+ * always the same: a command cut short must print nothing until it is
+ * complete, not even its extended response header or the prompts of
+ * set_channel.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <hamlib/rig.h>
+#include "rigctl_parse.h"
+
+
+#ifdef HAVE_OPEN_MEMSTREAM
+
+static const char script[] =
+    "F 14100000\n"
+    "f\n"
+    "+f\n"
+    "+F 7050000\n"
+    "M USB 2400\n"
+    "m\n"
+    "+\\set_mode LSB 1800\n"
+    "\\get_mode\n"
+    /* prompts for the fields of the channel as it reads them */
+    "+H 1 0 0 145500000 FM 15000 145500000 FM 15000 0 + 600000 12500 0 0"
+    " 0 885 885 0 0 0 0 TEST\n"
+    "f\n";
+
+
+/* what rigctld answers to in, fed first len1 bytes then the rest */
+static char *run(RIG *rig, const char *in, size_t len, size_t len1)
+{
+    struct rigctl_parser *rp;
+    char *out = NULL;
+    size_t out_len = 0;
+    size_t consumed = 0, avail = len1;
+    FILE *fout;
+
+    rp = rigctl_parser_new(NULL, 1, 0, 0, '\r');
+    fout = open_memstream(&out, &out_len);
+
+    if (!rp || !fout)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(2);
+    }
+
+    rig_set_freq(rig, RIG_VFO_CURR, 3500000);
+
+    while (consumed < len)
+    {
+        size_t used = 0;
+
+        /* blank lines between commands, as netserver skips them */
+        while (consumed < avail && strchr(" \t\r\n", in[consumed]))
+        {
+            consumed++;
+        }
+
+        if (consumed < avail)
+        {
+            rigctl_parse_buf(rig, rp, fout, in + consumed, avail - consumed,
+                             &used, NULL);
+        }
+
+        if (used == 0)
+        {
+            if (avail == len)
+            {
+                break;
+            }
+
+            /* the rest of the input comes in */
+            avail = len;
+        }
+
+        consumed += used;
+    }
+
+    fclose(fout);
+    rigctl_parser_free(rp);
+
+    return out;
+}
+
+
+int main(int argc, char *argv[])
+{
+    size_t len = strlen(script);
+    char *ref;
+    RIG *rig;
+    int errors = 0;
+    size_t i;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig || rig_open(rig) != RIG_OK)
+    {
+        fprintf(stderr, "Unable to open the dummy rig\n");
+        exit(2);
+    }
+
+    ref = run(rig, script, len, len);
+    printf("%s", ref);
+
+    for (i = 1; i < len; i++)
+    {
+        char *out = run(rig, script, len, i);
+
+        if (strcmp(out, ref))
+        {
+            printf("split after %u bytes:\n%s", (unsigned)i, out);
+            errors++;
+        }
+
+        free(out);
+    }
+
+    printf("%u splits, %d differing\n", (unsigned)len - 1, errors);
+
+    free(ref);
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    return errors ? 1 : 0;
+}
+
+#else   /* !HAVE_OPEN_MEMSTREAM */
+
+int main(int argc, char *argv[])
+{
+    printf("no open_memstream, skipped\n");
+
+    return 77;  /* skipped */
+}
+
+#endif  /* HAVE_OPEN_MEMSTREAM */
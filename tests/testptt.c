@@ -0,0 +1,252 @@
+/*
+ * Test program for the timed PTT and the held PTT port.
+ *
+ * Keys a dummy rig with rig_set_ptt_at(), then with rig_set_ptt_at_async()
+ * while the worker is busy with slow reads, and checks the PTT went on
+ * neither before its time nor later than LATE_MAX.
+ *
+ * With -p device, also keys the RTS line of that serial port, with and
+ * without the "ptt_hold" configuration parameter, and checks the port is
+ * held open, or seized for the transmission only.  This moves the lines
+ * of the port, so mind what is plugged in.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <hamlib/rig.h>
+
+
+#define LATE_MAX 20000          /* us */
+#define READ_DELAY 20000        /* us, of each read of the slow rig */
+#define NB_READS 40
+
+static int (*backend_set_ptt)(RIG *rig, vfo_t vfo, ptt_t ptt);
+static int (*backend_get_level)(RIG *rig, vfo_t vfo, setting_t level,
+                                value_t *val);
+static int64_t keyed;           /* when set_ptt reached the backend */
+static volatile int ptt_status; /* of the async keying, 1 once done */
+static int errors;
+
+
+static int64_t now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+
+static int log_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
+{
+    keyed = now();
+
+    return backend_set_ptt(rig, vfo, ptt);
+}
+
+
+static int slow_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
+{
+    usleep(READ_DELAY);
+
+    return backend_get_level(rig, vfo, level, val);
+}
+
+
+static void check_keyed(const char *what, int64_t when)
+{
+    int64_t late = keyed - when;
+    int ok = late >= 0 && late <= LATE_MAX;
+
+    printf("%-32s %6.1f ms late%s\n", what, late / 1000.,
+           ok ? "" : "  FAILED");
+
+    if (!ok)
+    {
+        errors++;
+    }
+}
+
+
+static void ptt_done(RIG *rig, const struct rig_multi *result, rig_ptr_t arg)
+{
+    ptt_status = result->status == RIG_OK ? 1 : -1;
+}
+
+
+static void timed_ptt(void)
+{
+    static struct rig_caps caps;
+    struct rig_multi req;
+    int64_t when;
+    setting_t level;
+    ptt_t ptt;
+    int n = 0;
+    RIG *rig;
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig)
+    {
+        fprintf(stderr, "rig_init failed\n");
+        exit(2);
+    }
+
+    /* the dummy rig, with slow reads and the keying time logged */
+    caps = *rig->caps;
+    backend_set_ptt = caps.set_ptt;
+    caps.set_ptt = log_set_ptt;
+    backend_get_level = caps.get_level;
+    caps.get_level = slow_get_level;
+    rig->caps = &caps;
+
+    rig_set_conf(rig, rig_token_lookup(rig, "cache_timeout"), "0");
+
+    if (rig_open(rig) != RIG_OK)
+    {
+        fprintf(stderr, "rig_open failed\n");
+        exit(2);
+    }
+
+    when = now() + 50000;
+    rig_set_ptt_at(rig, RIG_VFO_CURR, RIG_PTT_ON, when);
+    check_keyed("rig_set_ptt_at", when);
+
+    if (rig_get_ptt(rig, RIG_VFO_CURR, &ptt) != RIG_OK || ptt != RIG_PTT_ON)
+    {
+        printf("PTT not on  FAILED\n");
+        errors++;
+    }
+
+    when = now();
+    rig_set_ptt_at(rig, RIG_VFO_CURR, RIG_PTT_OFF, when - 1000000);
+    check_keyed("rig_set_ptt_at, time passed", when);
+
+    if (rig_async_start(rig, 0) != RIG_OK)
+    {
+        fprintf(stderr, "rig_async_start failed\n");
+        exit(2);
+    }
+
+    /* the keying is due while the worker is busy with the reads */
+    when = now() + NB_READS * READ_DELAY / 4;
+    rig_set_ptt_at_async(rig, RIG_VFO_CURR, RIG_PTT_ON, when, ptt_done, NULL);
+
+    memset(&req, 0, sizeof(req));
+    req.what = RIG_MULTI_LEVEL;
+    req.vfo = RIG_VFO_CURR;
+
+    /* distinct levels, identical reads would be coalesced */
+    for (level = 1; level && n < NB_READS; level <<= 1)
+    {
+        if (rig_has_get_level(rig, level))
+        {
+            req.level = level;
+            rig_get_async(rig, &req, NULL, NULL);
+            n++;
+        }
+    }
+
+    while (!ptt_status)
+    {
+        usleep(1000);
+    }
+
+    check_keyed("rig_set_ptt_at_async, busy", when);
+
+    if (ptt_status < 0)
+    {
+        printf("rig_set_ptt_at_async failed  FAILED\n");
+        errors++;
+    }
+
+    rig_async_stop(rig);
+    rig_close(rig);
+    rig_cleanup(rig);
+}
+
+
+/* PTT on the RTS line of device, held open or not */
+static void ptt_hold(const char *device, int hold)
+{
+    RIG *rig;
+    ptt_t ptt;
+    int fd, ok = 1;
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig)
+    {
+        fprintf(stderr, "rig_init failed\n");
+        exit(2);
+    }
+
+    rig->state.pttport.type.ptt = RIG_PTT_SERIAL_RTS;
+    strncpy(rig->state.pttport.pathname, device, FILPATHLEN - 1);
+    rig_set_conf(rig, rig_token_lookup(rig, "ptt_hold"), hold ? "1" : "0");
+
+    if (rig_open(rig) != RIG_OK)
+    {
+        fprintf(stderr, "rig_open of PTT port %s failed\n", device);
+        exit(2);
+    }
+
+    /* held from rig_open(), else only while transmitting */
+    fd = rig->state.pttport.fd;
+    ok &= hold ? fd >= 0 : fd < 0;
+
+    rig_set_ptt(rig, RIG_VFO_CURR, RIG_PTT_ON);
+    ok &= rig->state.pttport.fd >= 0 && (!hold || rig->state.pttport.fd == fd);
+    ok &= rig_get_ptt(rig, RIG_VFO_CURR, &ptt) == RIG_OK && ptt == RIG_PTT_ON;
+
+    rig_set_ptt(rig, RIG_VFO_CURR, RIG_PTT_OFF);
+    ok &= hold ? rig->state.pttport.fd == fd : rig->state.pttport.fd < 0;
+    ok &= rig_get_ptt(rig, RIG_VFO_CURR, &ptt) == RIG_OK && ptt == RIG_PTT_OFF;
+
+    rig_close(rig);
+    ok &= rig->state.pttport.fd < 0;
+
+    printf("%-32s %s\n", hold ? "ptt_hold=1" : "ptt_hold=0",
+           ok ? "ok" : "FAILED");
+
+    if (!ok)
+    {
+        errors++;
+    }
+
+    rig_cleanup(rig);
+}
+
+
+int main(int argc, char *argv[])
+{
+    const char *device = NULL;
+    int c;
+
+    while ((c = getopt(argc, argv, "p:")) != -1)
+    {
+        if (c != 'p')
+        {
+            fprintf(stderr, "Usage: %s [-p ptt_device]\n", argv[0]);
+            exit(2);
+        }
+
+        device = optarg;
+    }
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    timed_ptt();
+
+    if (device)
+    {
+        ptt_hold(device, 1);
+        ptt_hold(device, 0);
+    }
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,177 @@
+/*
+ * Test program for the deferred VFO restore.
+ *
+ * Runs operations on the other VFO of a dummy rig, which cannot target
+ * them, with the "vfo_restore_delay" configuration parameter set, and
+ * checks the VFOs the frontend selects on the rig: the previous VFO must
+ * only come back on an operation on RIG_VFO_CURR or on that VFO, once
+ * the delay expired, or never when rig_set_vfo() adopted the other one.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <hamlib/rig.h>
+
+
+#define RESTORE_DELAY 100       /* ms */
+#define MAX_SELECTS 8
+
+static int (*backend_set_vfo)(RIG *rig, vfo_t vfo);
+static vfo_t selects[MAX_SELECTS];
+static int nb_selects;
+static int errors;
+
+
+static int log_set_vfo(RIG *rig, vfo_t vfo)
+{
+    if (nb_selects < MAX_SELECTS)
+    {
+        selects[nb_selects++] = vfo;
+    }
+
+    return backend_set_vfo(rig, vfo);
+}
+
+
+/* the VFOs selected since the last call, against those expected */
+static void check(const char *what, int count, ...)
+{
+    va_list ap;
+    int i, ok = count == nb_selects;
+
+    va_start(ap, count);
+
+    for (i = 0; i < count; i++)
+    {
+        vfo_t vfo = va_arg(ap, vfo_t);
+
+        if (ok && selects[i] != vfo)
+        {
+            ok = 0;
+        }
+    }
+
+    va_end(ap);
+
+    printf("%-28s", what);
+
+    for (i = 0; i < nb_selects; i++)
+    {
+        printf(" %s", rig_strvfo(selects[i]));
+    }
+
+    printf("%s\n", ok ? "" : "  FAILED");
+
+    if (!ok)
+    {
+        errors++;
+    }
+
+    nb_selects = 0;
+}
+
+
+static void check_vfo(RIG *rig, const char *what, vfo_t expected)
+{
+    vfo_t vfo = RIG_VFO_NONE;
+    int retcode = rig_get_vfo(rig, &vfo);
+
+    printf("%-28s %s%s\n", what, rig_strvfo(vfo),
+           retcode == RIG_OK && vfo == expected ? "" : "  FAILED");
+
+    if (retcode != RIG_OK || vfo != expected)
+    {
+        errors++;
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    static struct rig_caps caps;
+    char delay[16];
+    freq_t freq;
+    rmode_t mode;
+    pbwidth_t width;
+    RIG *rig;
+    int retcode;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig)
+    {
+        fprintf(stderr, "rig_init failed\n");
+        exit(2);
+    }
+
+    /* the dummy rig, selecting its VFOs through log_set_vfo() */
+    caps = *rig->caps;
+    caps.targetable_vfo = 0;
+    backend_set_vfo = caps.set_vfo;
+    caps.set_vfo = log_set_vfo;
+    rig->caps = &caps;
+
+    snprintf(delay, sizeof(delay), "%d", RESTORE_DELAY);
+    rig_set_conf(rig, rig_token_lookup(rig, "vfo_restore_delay"), delay);
+    rig_set_conf(rig, rig_token_lookup(rig, "cache_timeout"), "0");
+
+    retcode = rig_open(rig);
+
+    if (retcode != RIG_OK)
+    {
+        fprintf(stderr, "rig_open: error = %s\n", rigerror(retcode));
+        exit(2);
+    }
+
+    rig_set_vfo(rig, RIG_VFO_A);
+    nb_selects = 0;
+
+    /* VFO B twice, then the current VFO */
+    rig_get_freq(rig, RIG_VFO_B, &freq);
+    rig_get_mode(rig, RIG_VFO_B, &mode, &width);
+    check("VFO B twice", 1, RIG_VFO_B);
+    check_vfo(rig, "get_vfo while on VFO B", RIG_VFO_A);
+    check("get_vfo", 0);
+    rig_get_freq(rig, RIG_VFO_CURR, &freq);
+    check("then VFO CURR", 1, RIG_VFO_A);
+
+    /* VFO B, then the VFO to restore */
+    rig_get_freq(rig, RIG_VFO_B, &freq);
+    rig_get_freq(rig, RIG_VFO_A, &freq);
+    check("VFO B, then VFO A", 2, RIG_VFO_B, RIG_VFO_A);
+
+    /* VFO B, and again once the delay expired */
+    rig_get_freq(rig, RIG_VFO_B, &freq);
+    usleep(2 * RESTORE_DELAY * 1000);
+    rig_get_freq(rig, RIG_VFO_B, &freq);
+    check("VFO B, again after the delay", 3, RIG_VFO_B, RIG_VFO_A,
+          RIG_VFO_B);
+    rig_restore_vfo(rig);
+    check("rig_restore_vfo", 1, RIG_VFO_A);
+    rig_restore_vfo(rig);
+    check("nothing left to restore", 0);
+
+    /* VFO B, then adopted by rig_set_vfo() */
+    rig_get_freq(rig, RIG_VFO_B, &freq);
+    rig_set_vfo(rig, RIG_VFO_B);
+    rig_get_freq(rig, RIG_VFO_CURR, &freq);
+    check("VFO B, then set_vfo B", 1, RIG_VFO_B);
+    check_vfo(rig, "get_vfo once adopted", RIG_VFO_B);
+
+    /* no restore delay, VFO A back at once */
+    rig_set_vfo(rig, RIG_VFO_A);
+    rig_set_conf(rig, rig_token_lookup(rig, "vfo_restore_delay"), "0");
+    nb_selects = 0;
+    rig_get_freq(rig, RIG_VFO_B, &freq);
+    check("VFO B without delay", 2, RIG_VFO_B, RIG_VFO_A);
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    return errors ? 1 : 0;
+}
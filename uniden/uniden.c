@@ -128,7 +128,7 @@ uniden_transaction(RIG *rig, const char *cmdstr, int cmd_len,
     size_t reply_len = BUFSZ;
 
     rs = &rig->state;
-    rs->hold_decode = 1;
+    Hold_Decode(rig);
 
 transaction_write:
 
@@ -266,7 +266,7 @@ transaction_write:
 
     retval = RIG_OK;
 transaction_quit:
-    rs->hold_decode = 0;
+    Unhold_Decode(rig);
     return retval;
 }
 
@@ -105,9 +105,9 @@ typedef struct _yaesu_newcat_commands
  * PR - Speech Proc ON/OFF, and BC - Auto Notch filter ON/OFF.
  * The FT-450 returns -RIG_ENVAIL for these unavailable CAT commands.
  *
- * NOTE: The following table must be in alphabetical order by the
- * command.  This is because it is searched using a binary search
- * to determine whether or not a command is valid for a given rig.
+ * The column of the rig is copied once by newcat_init() into a bit
+ * per command in priv->valid_cmds, which newcat_valid_command() checks.
+ * Please keep the table in alphabetical order by the command anyway.
  *
  * The list of supported commands is obtained from the rig's operator's
  * or CAT programming manual.
@@ -267,6 +267,7 @@ static int newcat_get_rigid(RIG *rig);
 static int newcat_get_vfo_mode(RIG *rig, vfo_t *vfo_mode);
 static int newcat_vfomem_toggle(RIG *rig);
 static ncboolean newcat_valid_command(RIG *rig, char const *const command);
+static void newcat_init_valid_commands(RIG *rig);
 
 /*
  * ************************************
@@ -313,6 +314,8 @@ int newcat_init(RIG *rig)
     priv->current_mem = NC_MEM_CHANNEL_NONE;
     priv->fast_set_commands = FALSE;
 
+    newcat_init_valid_commands(rig);
+
     return RIG_OK;
 }
 
@@ -4293,11 +4296,63 @@ int newcat_get_trn(RIG *rig, int *trn)
 }
 
 
+/*
+ * Reads one Auto Information report sent by the rig and decodes it.
+ */
 int newcat_decode_event(RIG *rig)
 {
+    char buf[NEWCAT_DATA_LEN];
+    int rc;
+
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
-    return -RIG_ENAVAIL;
+    rc = read_string(&rig->state.rigport, buf, sizeof(buf), &cat_term,
+                     sizeof(cat_term));
+
+    if (rc < 0)
+    {
+        return rc;
+    }
+
+    if (rc == 0 || buf[rc - 1] != cat_term)
+    {
+        return -RIG_EPROTO;
+    }
+
+    return newcat_decode_report(rig, buf);
+}
+
+
+/*
+ * Calls the callbacks matching an Auto Information report, terminator
+ * included. Only the frequency reports are decoded so far, the others
+ * need per model knowledge that lives in the get functions.
+ */
+int newcat_decode_report(RIG *rig, const char *report)
+{
+    freq_t freq;
+
+    rig_debug(RIG_DEBUG_TRACE, "%s: '%s'\n", __func__, report);
+
+    if (report[0] == 'F' && (report[1] == 'A' || report[1] == 'B')
+            && strlen(report) > 3)
+    {
+        if (!rig->callbacks.freq_event)
+        {
+            return -RIG_ENAVAIL;
+        }
+
+        sscanf(report + 2, "%"SCNfreq, &freq);
+
+        return rig->callbacks.freq_event(rig,
+                                         report[1] == 'A' ? RIG_VFO_A : RIG_VFO_B,
+                                         freq, rig->callbacks.freq_arg);
+    }
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: unsupported report '%s'\n", __func__,
+              report);
+
+    return -RIG_ENIMPL;
 }
 
 
@@ -4697,146 +4752,105 @@ const char *newcat_get_info(RIG *rig)
  * commands (for a rig).
  */
 
-ncboolean newcat_valid_command(RIG *rig, char const *const command)
+/*
+ * Copies the column of valid_commands[] for this rig into
+ * priv->valid_cmds, so newcat_valid_command() does not have to look the
+ * model and the command up on every call.
+ */
+void newcat_init_valid_commands(RIG *rig)
 {
-    const struct rig_caps *caps;
-    ncboolean is_ft450;
-    ncboolean is_ft891;
-    ncboolean is_ft950;
-    ncboolean is_ft991;
-    ncboolean is_ft2000;
-    ncboolean is_ft9000;
-    ncboolean is_ft5000;
-    ncboolean is_ft1200;
-    ncboolean is_ft3000;
-    ncboolean is_ft101;
-    int search_high;
-    int search_index;
-    int search_low;
+    struct newcat_priv_data *priv = (struct newcat_priv_data *)rig->state.priv;
+    int i;
 
-    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
-    rig_debug(RIG_DEBUG_TRACE, "%s %s\n", __func__, command);
+    memset(priv->valid_cmds, 0, sizeof(priv->valid_cmds));
 
-    if (!rig)
+    for (i = 0; i < valid_commands_count; i++)
     {
-        rig_debug(RIG_DEBUG_ERR, "%s: Rig argument is invalid\n", __func__);
-        return FALSE;
-    }
+        const yaesu_newcat_commands_t *vc = &valid_commands[i];
+        ncboolean valid;
 
-    caps = rig->caps;
+        /*
+         * Note it is possible for several model variants to exist;
+         * i.e., all the FT-9000 variants.
+         */
+        switch (rig->caps->rig_model)
+        {
+        case RIG_MODEL_FT450:
+            valid = vc->ft450;
+            break;
 
-    if (!caps)
-    {
-        rig_debug(RIG_DEBUG_ERR, "%s: Rig capabilities not valid\n", __func__);
-        return FALSE;
-    }
+        case RIG_MODEL_FT891:
+            valid = vc->ft891;
+            break;
 
-    /*
-     * Determine the type of rig from the model number.  Note it is
-     * possible for several model variants to exist; i.e., all the
-     * FT-9000 variants.
-     */
+        case RIG_MODEL_FT950:
+            valid = vc->ft950;
+            break;
 
-    is_ft450 = newcat_is_rig(rig, RIG_MODEL_FT450);
-    is_ft891 = newcat_is_rig(rig, RIG_MODEL_FT891);
-    is_ft950 = newcat_is_rig(rig, RIG_MODEL_FT950);
-    is_ft991 = newcat_is_rig(rig, RIG_MODEL_FT991);
-    is_ft2000 = newcat_is_rig(rig, RIG_MODEL_FT2000);
-    is_ft9000 = newcat_is_rig(rig, RIG_MODEL_FT9000);
-    is_ft5000 = newcat_is_rig(rig, RIG_MODEL_FTDX5000);
-    is_ft1200 = newcat_is_rig(rig, RIG_MODEL_FT1200);
-    is_ft3000 = newcat_is_rig(rig, RIG_MODEL_FTDX3000);
-    is_ft101 = newcat_is_rig(rig, RIG_MODEL_FTDX101D);
+        case RIG_MODEL_FT991:
+            valid = vc->ft991;
+            break;
 
+        case RIG_MODEL_FT2000:
+            valid = vc->ft2000;
+            break;
 
-    if (!is_ft450 && !is_ft950 && !is_ft891 && !is_ft991 && !is_ft2000
-            && !is_ft5000 && !is_ft9000 && !is_ft1200 && !is_ft3000 && !is_ft101)
-    {
-        rig_debug(RIG_DEBUG_ERR, "%s: '%s' is unknown\n",
-                  __func__, caps->model_name);
-        return FALSE;
-    }
+        case RIG_MODEL_FT9000:
+            valid = vc->ft9000;
+            break;
 
-    /*
-     * Make sure the command is known, and then check to make sure
-     * is it valud for the rig.
-     */
+        case RIG_MODEL_FTDX5000:
+            valid = vc->ft5000;
+            break;
 
-    search_low = 0;
-    search_high = valid_commands_count;
+        case RIG_MODEL_FT1200:
+            valid = vc->ft1200;
+            break;
 
-    while (search_low <= search_high)
-    {
-        int search_test;
+        case RIG_MODEL_FTDX3000:
+            valid = vc->ft3000;
+            break;
 
-        search_index = (search_low + search_high) / 2;
-        search_test = strcmp(valid_commands[search_index].command, command);
+        case RIG_MODEL_FTDX101D:
+            valid = vc->ft101;
+            break;
 
-        if (search_test > 0)
-        {
-            search_high = search_index - 1;
-        }
-        else if (search_test < 0)
-        {
-            search_low = search_index + 1;
+        default:
+            rig_debug(RIG_DEBUG_ERR, "%s: '%s' is unknown\n",
+                      __func__, rig->caps->model_name);
+            return;
         }
-        else
+
+        if (valid && cat_cmd_ok(vc->command))
         {
-            /*
-             * The command is valid.  Now make sure it is supported by the rig.
-             */
-            if (is_ft450 && valid_commands[search_index].ft450)
-            {
-                return TRUE;
-            }
-            else if (is_ft891 && valid_commands[search_index].ft891)
-            {
-                return TRUE;
-            }
-            else if (is_ft950 && valid_commands[search_index].ft950)
-            {
-                return TRUE;
-            }
-            else if (is_ft991 && valid_commands[search_index].ft991)
-            {
-                return TRUE;
-            }
-            else if (is_ft2000 && valid_commands[search_index].ft2000)
-            {
-                return TRUE;
-            }
-            else if (is_ft5000 && valid_commands[search_index].ft5000)
-            {
-                return TRUE;
-            }
-            else if (is_ft9000 && valid_commands[search_index].ft9000)
-            {
-                return TRUE;
-            }
-            else if (is_ft1200 && valid_commands[search_index].ft1200)
-            {
-                return TRUE;
-            }
-            else if (is_ft3000 && valid_commands[search_index].ft3000)
-            {
-                return TRUE;
-            }
-            else if (is_ft101 && valid_commands[search_index].ft101)
-            {
-                return TRUE;
-            }
-            else
-            {
-                rig_debug(RIG_DEBUG_TRACE, "%s: '%s' command '%s' not supported\n",
-                          __func__, caps->model_name, command);
-                return FALSE;
-            }
+            cat_cmd_set(priv->valid_cmds, vc->command);
         }
     }
+}
+
+
+ncboolean newcat_valid_command(RIG *rig, char const *const command)
+{
+    const struct newcat_priv_data *priv;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
-    rig_debug(RIG_DEBUG_TRACE, "%s: '%s' command '%s' not valid\n",
-              __func__, caps->model_name, command);
-    return FALSE;
+    if (!rig || !rig->state.priv)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: Rig argument is invalid\n", __func__);
+        return FALSE;
+    }
+
+    priv = (const struct newcat_priv_data *)rig->state.priv;
+
+    if (!cat_cmd_isset(priv->valid_cmds, command))
+    {
+        rig_debug(RIG_DEBUG_TRACE, "%s: '%s' command '%s' not supported\n",
+                  __func__, rig->caps->model_name, command);
+        return FALSE;
+    }
+
+    return TRUE;
 }
 
 
@@ -6130,6 +6144,69 @@ int newcat_vfomem_toggle(RIG *rig)
     return newcat_set_cmd(rig);
 }
 
+/*
+ * Auto Information reports read while waiting for a reply. They are
+ * decoded once the command is over, as callbacks may talk to the rig.
+ */
+struct newcat_reports
+{
+    int count;
+    char report[NEWCAT_MAX_REPORTS][NEWCAT_REPORT_LEN];
+};
+
+
+/*
+ * Reads a reply into priv->ret_data. With AI on, well terminated strings
+ * which do not start like expect are kept in reports and skipped, so that
+ * the reply is waited for without resending the command.
+ */
+static int newcat_read_reply(RIG *rig, const char *expect,
+                             struct newcat_reports *reports)
+{
+    struct newcat_priv_data *priv = (struct newcat_priv_data *)rig->state.priv;
+    int rc;
+
+    for (;;)
+    {
+        rc = read_string(&rig->state.rigport, priv->ret_data,
+                         sizeof(priv->ret_data), &cat_term, sizeof(cat_term));
+
+        if (rc <= 2 || priv->ret_data[rc - 1] != cat_term
+                || !strncmp(priv->ret_data, expect, 2)
+                || rig->state.transceive == RIG_TRN_OFF
+                || reports->count == NEWCAT_MAX_REPORTS
+                || rc >= NEWCAT_REPORT_LEN)
+        {
+            return rc;
+        }
+
+        rig_debug(RIG_DEBUG_TRACE, "%s: report '%s' before reply\n", __func__,
+                  priv->ret_data);
+        strcpy(reports->report[reports->count++], priv->ret_data);
+    }
+}
+
+
+static void newcat_decode_reports(RIG *rig,
+                                  const struct newcat_reports *reports)
+{
+    int i;
+
+    if (rig->state.transceive == RIG_TRN_OFF)
+    {
+        return;
+    }
+
+    for (i = 0; i < reports->count; i++)
+    {
+        newcat_decode_report(rig, reports->report[i]);
+    }
+}
+
+
+static int newcat_get_reply(RIG *rig, struct newcat_reports *reports);
+static int newcat_set_verify(RIG *rig, struct newcat_reports *reports);
+
 /*
  * Writes a null  terminated command string from  priv->cmd_str to the
  * CAT  port and  returns a  response from  the rig  in priv->ret_data
@@ -6142,6 +6219,18 @@ int newcat_vfomem_toggle(RIG *rig)
  * 'retry' retries to receive a valid response are made.
  */
 int newcat_get_cmd(RIG *rig)
+{
+    struct newcat_reports reports;
+    int rc;
+
+    reports.count = 0;
+    rc = newcat_get_reply(rig, &reports);
+    newcat_decode_reports(rig, &reports);
+
+    return rc;
+}
+
+static int newcat_get_reply(RIG *rig, struct newcat_reports *reports)
 {
     struct rig_state *state = &rig->state;
     struct newcat_priv_data *priv = (struct newcat_priv_data *)rig->state.priv;
@@ -6150,6 +6239,11 @@ int newcat_get_cmd(RIG *rig)
 
     while (rc != RIG_OK && retry_count++ <= state->rigport.retry)
     {
+        if (retry_count > 1)
+        {
+            state->rigport.io_count.retries++;
+        }
+
         if (rc != -RIG_BUSBUSY)
         {
             /* send the command */
@@ -6163,8 +6257,7 @@ int newcat_get_cmd(RIG *rig)
         }
 
         /* read the reply */
-        if ((rc = read_string(&state->rigport, priv->ret_data, sizeof(priv->ret_data),
-                              &cat_term, sizeof(cat_term))) <= 0)
+        if ((rc = newcat_read_reply(rig, priv->cmd_str, reports)) <= 0)
         {
             continue;             /* usually a timeout - retry */
         }
@@ -6230,11 +6323,7 @@ int newcat_get_cmd(RIG *rig)
         if ((priv->ret_data[0] != priv->cmd_str[0]
                 || priv->ret_data[1] != priv->cmd_str[1]))
         {
-            /*
-             * TODO: When RIG_TRN is enabled, we can pass the string
-             * to the decoder for callback. That way we don't ignore
-             * any commands.
-             */
+            /* more reports than newcat_read_reply() keeps */
             rig_debug(RIG_DEBUG_ERR, "%s: wrong reply %.2s for command %.2s\n",
                       __func__, priv->ret_data, priv->cmd_str);
             rc = -RIG_BUSBUSY;    /* retry read only */
@@ -6255,6 +6344,18 @@ int newcat_get_cmd(RIG *rig)
  * 'retry' retries to receive a valid response are made.
  */
 int newcat_set_cmd(RIG *rig)
+{
+    struct newcat_reports reports;
+    int rc;
+
+    reports.count = 0;
+    rc = newcat_set_verify(rig, &reports);
+    newcat_decode_reports(rig, &reports);
+
+    return rc;
+}
+
+static int newcat_set_verify(RIG *rig, struct newcat_reports *reports)
 {
     struct rig_state *state = &rig->state;
     struct newcat_priv_data *priv = (struct newcat_priv_data *)rig->state.priv;
@@ -6267,6 +6368,11 @@ int newcat_set_cmd(RIG *rig)
 
     while (rc != RIG_OK && retry_count++ <= state->rigport.retry)
     {
+        if (retry_count > 1)
+        {
+            state->rigport.io_count.retries++;
+        }
+
         serial_flush(&state->rigport);  /* discard any unsolicited data */
         /* send the command */
         rig_debug(RIG_DEBUG_TRACE, "cmd_str = %s\n", priv->cmd_str);
@@ -6293,8 +6399,7 @@ int newcat_set_cmd(RIG *rig)
         }
 
         /* read the reply */
-        if ((rc = read_string(&state->rigport, priv->ret_data, sizeof(priv->ret_data),
-                              &cat_term, sizeof(cat_term))) <= 0)
+        if ((rc = newcat_read_reply(rig, verify_cmd, reports)) <= 0)
         {
             continue;             /* usually a timeout - retry */
         }
@@ -6337,8 +6442,7 @@ int newcat_set_cmd(RIG *rig)
                 rig_debug(RIG_DEBUG_WARN, "%s: Rig busy - retrying\n", __func__);
 
                 /* read the verify command reply */
-                if ((rc = read_string(&state->rigport, priv->ret_data, sizeof(priv->ret_data),
-                                      &cat_term, sizeof(cat_term))) > 0)
+                if ((rc = newcat_read_reply(rig, verify_cmd, reports)) > 0)
                 {
                     rig_debug(RIG_DEBUG_TRACE, "%s: read count = %d, ret_data = %s\n",
                               __func__, rc, priv->ret_data);
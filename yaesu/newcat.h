@@ -35,6 +35,7 @@
 
 #include <tones.h>
 #include <token.h>
+#include "misc.h"
 
 /* Handy constants */
 
@@ -54,6 +55,8 @@ typedef char ncboolean;
 
 /* Hopefully large enough for future use, 128 chars plus '\0' */
 #define NEWCAT_DATA_LEN                 129
+#define NEWCAT_MAX_REPORTS              8   /* reports kept per command */
+#define NEWCAT_REPORT_LEN               48
 
 /* arbitrary value for now.  11 bits (8N2+1) == 2.2917 mS @ 4800 bps */
 #define NEWCAT_DEFAULT_READ_TIMEOUT     (NEWCAT_DATA_LEN * 5)
@@ -88,6 +91,7 @@ struct newcat_priv_data {
     int trn_state;  /* AI state found at startup */
 		int fast_set_commands; /* do not check for ACK/NAK; needed for high throughput > 100 commands/s */
     int width_frequency; /* found at startup */
+    unsigned char valid_cmds[CAT_CMD_SET_SIZE]; /* from valid_commands[] */
 };
 
 
@@ -124,6 +128,7 @@ struct newcat_priv_data {
  */
 
 int newcat_get_cmd(RIG * rig);
+int newcat_decode_report(RIG *rig, const char *report);
 int newcat_set_cmd (RIG *rig);
 
 int newcat_init(RIG *rig);